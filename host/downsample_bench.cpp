@@ -0,0 +1,170 @@
+/**
+ * Downsampling Benchmark (host)
+ *
+ * Runs the firmware downsamplers (src/Downsample.h) over a synthetic
+ * 1M-point series (daily cycle + random walk + noise, with short spikes
+ * and sensor dropouts) and reports:
+ *   - that lttb() picks the same points as a textbook array LTTB on a
+ *     gap-free series,
+ *   - throughput of lttb() and minMax() for several output sizes,
+ *   - how many spikes survive LTTB, min/max buckets and plain decimation.
+ *
+ * Build:  g++ -O2 -std=c++17 -Isrc host/downsample_bench.cpp -o downsample_bench
+ * Usage:  downsample_bench [points]     (exit code 1 on a mismatch)
+ */
+
+#include "Downsample.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Downsample::Point;
+
+const uint32_t kSpikeSpacing = 7919;       // Samples between spikes
+
+double seconds(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+struct Series {
+  std::vector<float> x, y;
+  std::vector<uint32_t> spikes;           // Index of each spike's peak
+};
+
+/**
+ * Temperature-like series at 1 Hz
+ * Spikes are 3 samples wide (door opened, sun patch); dropouts are NAN runs.
+ */
+Series makeSeries(uint32_t n, bool gaps) {
+  Series s;
+  s.x.resize(n);
+  s.y.resize(n);
+  std::mt19937 rng(42);
+  std::normal_distribution<float> noise(0.0f, 0.05f);
+  std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+
+  float walk = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    walk += noise(rng) * 0.1f;
+    s.x[i] = (float)i;
+    s.y[i] = 22.0f + 4.0f * sinf(i * 2.0f * (float)M_PI / 86400.0f) + walk + noise(rng);
+  }
+  for (uint32_t i = 1000; i + 2 < n; i += kSpikeSpacing) {  // ~126 spikes per 1M
+    const float h = (uni(rng) < 0.5f ? -1.0f : 1.0f) * (3.0f + 4.0f * uni(rng));
+    s.y[i - 1] += h * 0.5f;
+    s.y[i] += h;
+    s.y[i + 1] += h * 0.5f;
+    s.spikes.push_back(i);
+  }
+  if (gaps) {
+    for (uint32_t i = 5000; i + 600 < n; i += 100003) {
+      for (uint32_t k = 0; k < 600; k++) s.y[i + k] = NAN;    // 10 min dropout
+    }
+  }
+  return s;
+}
+
+/**
+ * Textbook LTTB over arrays (reference for a gap-free series)
+ */
+std::vector<uint32_t> referenceLttb(const Series& s, uint32_t threshold) {
+  const uint32_t n = s.x.size();
+  std::vector<uint32_t> out;
+  uint32_t a = 0;
+  out.push_back(0);
+  for (uint32_t b = 0; b < threshold - 2; b++) {
+    const uint32_t lo = 1 + (uint32_t)((uint64_t)b * (n - 2) / (threshold - 2));
+    const uint32_t hi = 1 + (uint32_t)((uint64_t)(b + 1) * (n - 2) / (threshold - 2));
+    uint32_t nhi = 1 + (uint32_t)((uint64_t)(b + 2) * (n - 2) / (threshold - 2));
+    if (nhi > n) nhi = n;
+    float cx = 0, cy = 0;
+    for (uint32_t i = hi; i < nhi; i++) { cx += s.x[i]; cy += s.y[i]; }
+    cx /= (nhi - hi);
+    cy /= (nhi - hi);
+    float best = -1;
+    uint32_t pick = lo;
+    for (uint32_t i = lo; i < hi; i++) {
+      const float area = fabsf((s.x[a] - cx) * (s.y[i] - s.y[a]) - (s.x[a] - s.x[i]) * (cy - s.y[a]));
+      if (area > best) { best = area; pick = i; }
+    }
+    out.push_back(pick);
+    a = pick;
+  }
+  out.push_back(n - 1);
+  return out;
+}
+
+/**
+ * A spike survives if a chosen point lies on it (peak or shoulder)
+ */
+int spikesKept(const Series& s, const std::vector<uint32_t>& idx) {
+  int kept = 0;
+  size_t j = 0;
+  for (uint32_t sp : s.spikes) {
+    while (j < idx.size() && idx[j] + 1 < sp) j++;
+    if (j < idx.size() && idx[j] <= sp + 1) kept++;
+  }
+  return kept;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t n = argc > 1 ? (uint32_t)atoi(argv[1]) : 1000000;
+  int failures = 0;
+
+  auto src = [](const Series& s) {
+    return [&s](uint32_t i, Point& p) { p.x = s.x[i]; p.y = s.y[i]; return !std::isnan(p.y); };
+  };
+
+  // Correctness against the reference
+  const Series clean = makeSeries(n, false);
+  for (uint32_t threshold : {3u, 240u, 1000u, 10000u}) {
+    if (threshold >= n) continue;
+    std::vector<uint32_t> got;
+    Downsample::lttb(src(clean), n, threshold, [&](uint32_t i, const Point&) { got.push_back(i); });
+    const std::vector<uint32_t> ref = referenceLttb(clean, threshold);
+    const bool same = got == ref;
+    printf("LTTB %6u points: %s reference\n", threshold, same ? "matches" : "DIFFERS from");
+    if (!same) failures++;
+  }
+
+  // Throughput and spike retention, with dropouts
+  const Series s = makeSeries(n, true);
+  printf("\nSeries: %u points, %zu spikes, dropouts\n", n, s.spikes.size());
+  printf("%-8s %7s %8s %10s %8s\n", "method", "buckets", "points", "Mpts/s", "spikes");
+  for (uint32_t buckets : {240u, 1000u, 10000u}) {
+    std::vector<uint32_t> idx;
+    idx.reserve(2 * buckets + 2);
+    auto collect = [&](uint32_t i, const Point&) { idx.push_back(i); };
+
+    const int reps = 5;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) { idx.clear(); Downsample::lttb(src(s), n, buckets, collect); }
+    double dt = seconds(t0) / reps;
+    printf("%-8s %7u %8zu %10.1f %5d/%zu\n", "lttb", buckets, idx.size(), n / dt / 1e6, spikesKept(s, idx), s.spikes.size());
+
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) { idx.clear(); Downsample::minMax(src(s), n, buckets, collect); }
+    dt = seconds(t0) / reps;
+    const int mmKept = spikesKept(s, idx);
+    printf("%-8s %7u %8zu %10.1f %5d/%zu\n", "minmax", buckets, idx.size(), n / dt / 1e6, mmKept, s.spikes.size());
+    if (n / buckets < kSpikeSpacing && mmKept != (int)s.spikes.size()) {
+      // Spikes are further apart than a bucket, so min/max must keep every one
+      printf("  min/max lost spikes\n");
+      failures++;
+    }
+
+    idx.clear();
+    const uint32_t stride = n / buckets ? n / buckets : 1;
+    for (uint32_t i = 0; i < n; i += stride) idx.push_back(i);
+    printf("%-8s %7u %8zu %10s %5d/%zu\n", "stride", buckets, idx.size(), "-", spikesKept(s, idx), s.spikes.size());
+  }
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,867 @@
+/**
+ * Fleet Telemetry Collector (host)
+ *
+ * Ingest service for many devices speaking the push protocol
+ * (src/PushProtocol.*): Data datagrams over UDP, or the same Data frames
+ * back to back over TCP (no Acks there; TCP is reliable already).
+ *
+ *   - One receiver thread per core. Each has its own epoll set and its own
+ *     UDP and TCP sockets on the port (SO_REUSEPORT), so the kernel spreads
+ *     devices over receivers by address and a device always lands on the
+ *     same one; its Push::Peer (dedupe, Acks) and clock offset need no
+ *     locking.
+ *   - UDP is read with recvmmsg and Acks go out with sendmmsg, up to
+ *     kBatch datagrams per system call.
+ *   - Readings are handed to sink shards (device id hash) through
+ *     single-producer single-consumer rings, one per receiver and shard, so
+ *     a device's readings reach one sink in order without locks.
+ *   - With --store, sinks append the readings to a FleetDb::Store
+ *     (host/fleetdb/); each device has a single writer that way. A
+ *     FleetDb::Compactor rolls them up, applies retention and merges
+ *     segments in the background on low-priority threads.
+ *
+ *   fleet_collector [options]              Collect, printing a line per second
+ *     --port <n>         UDP and TCP port (default 4211)
+ *     --threads <n>      Receivers and sinks (default: cores)
+ *     --store <dir>      Keep the readings in a fleet store
+ *     --flush <s>        Write partial store blocks every s seconds (default 60)
+ *     --retain <days>    Keep raw readings this long (default: forever; rollups
+ *                        are kept)
+ *     --compactors <n>   Background maintenance threads (default 1)
+ *
+ *   fleet_collector --bench [seconds]      Load generator on loopback: UDP at full
+ *                                          rate and at half of it, and TCP;
+ *                                          readings/s, loss and end-to-end latency
+ *                                          percentiles (send to sink)
+ *
+ *   fleet_collector --store-check [dir] [hours]
+ *                                          The firmware's Sender on loopback into
+ *                                          the collector with a store, over a link
+ *                                          that loses and reorders datagrams; checks
+ *                                          every reading and rollup in the store
+ *
+ * Build:  g++ -O2 -std=c++17 -pthread -Isrc -Ihost host/fleet_collector.cpp src/PushProtocol.cpp host/fleetdb/Codec.cpp host/fleetdb/Segment.cpp host/fleetdb/Series.cpp host/fleetdb/FleetStore.cpp host/fleetdb/Compactor.cpp -o fleet_collector
+ */
+
+#include "PushProtocol.h"
+#include "fleetdb/Compactor.h"
+#include "fleetdb/FleetStore.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <functional>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const uint16_t kDefaultPort = 4211;    // PUSH_PORT
+const int      kBatch = 64;            // Datagrams per recvmmsg / sendmmsg
+const size_t   kRingSize = 1 << 16;    // Readings per receiver -> sink ring
+
+uint64_t nowNs() {
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * One reading on its way to a sink
+ */
+struct Reading {
+  uint64_t      id;
+  int64_t       time;                  // Unix seconds (receive time minus the reading's age)
+  HistorySample s;
+};
+
+/**
+ * Lock-free single-producer single-consumer ring
+ */
+class SpscRing {
+public:
+  explicit SpscRing(size_t size) : buf_(size), mask_(size - 1) {}
+
+  bool push(const Reading& r) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tailCache_ > mask_) {
+      tailCache_ = tail_.load(std::memory_order_acquire);
+      if (head - tailCache_ > mask_) return false;
+    }
+    buf_[head & mask_] = r;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Take up to max readings
+   * @return Number taken
+   */
+  size_t pop(Reading* out, size_t max) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t n = std::min(max, head_.load(std::memory_order_acquire) - tail);
+    for (size_t i = 0; i < n; i++) out[i] = buf_[(tail + i) & mask_];
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+private:
+  std::vector<Reading> buf_;
+  size_t mask_;
+  alignas(64) std::atomic<size_t> head_{0};
+  size_t tailCache_ = 0;                 // Producer's view of tail_
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+/**
+ * Log-linear latency histogram: 8 sub-buckets per power of two (<= 12.5 %
+ * error), exact below 16 ns
+ */
+class Histogram {
+public:
+  void add(uint64_t ns) {
+    if (ns < 16) {
+      counts_[ns]++;
+    } else {
+      const int e = 63 - __builtin_clzll(ns) - 3;
+      counts_[16 + (e - 1) * 8 + (int)(ns >> e) - 8]++;
+    }
+    total_++;
+  }
+
+  void merge(const Histogram& o) {
+    for (size_t i = 0; i < kBuckets; i++) counts_[i] += o.counts_[i];
+    total_ += o.total_;
+  }
+
+  /**
+   * Upper bound of the bucket holding quantile q
+   */
+  uint64_t quantile(double q) const {
+    uint64_t want = (uint64_t)std::ceil(q * total_), seen = 0;
+    for (size_t i = 0; i < kBuckets; i++) {
+      seen += counts_[i];
+      if (seen >= want && counts_[i]) {
+        if (i < 16) return i + 1;
+        return (uint64_t)((i - 16) % 8 + 9) << ((i - 16) / 8 + 1);
+      }
+    }
+    return 0;
+  }
+
+  uint64_t total() const { return total_; }
+
+private:
+  static const size_t kBuckets = 8 * 64;
+  uint64_t counts_[kBuckets] = {};
+  uint64_t total_ = 0;
+};
+
+// =============================================================================
+// Service
+// =============================================================================
+
+struct Options {
+  uint16_t port = kDefaultPort;
+  int      threads = (int)std::max(1u, std::thread::hardware_concurrency());
+  bool     timestamps = false;         // Bench: record t holds the send time (us)
+  FleetDb::Store* store = nullptr;     // Keep the readings here
+  std::function<int64_t()> now;        // Wall clock in s (default: time())
+};
+
+/**
+ * Counters a thread owns and others read
+ */
+struct alignas(64) Counters {
+  std::atomic<uint64_t> datagrams{0}, readings{0}, duplicates{0}, lost{0}, acks{0}, malformed{0}, stalls{0};
+};
+
+struct Totals {
+  uint64_t datagrams, readings, duplicates, lost, acks, malformed, stalls;
+};
+
+class Service {
+public:
+  explicit Service(const Options& o) : opt_(o), rx_(o.threads), sinks_(o.threads) {
+    for (int r = 0; r < o.threads; r++) {
+      for (int s = 0; s < o.threads; s++) rings_.emplace_back(new SpscRing(kRingSize));
+    }
+  }
+
+  ~Service() { stop(); }
+
+  bool start() {
+    for (int i = 0; i < opt_.threads; i++) {
+      const int udp = bindSocket(SOCK_DGRAM), tcp = bindSocket(SOCK_STREAM);
+      if (udp < 0 || tcp < 0 || listen(tcp, 1024) < 0) { perror("bind"); return false; }
+      threads_.emplace_back(&Service::receive, this, i, udp, tcp);
+    }
+    for (int i = 0; i < opt_.threads; i++) threads_.emplace_back(&Service::sink, this, i);
+    return true;
+  }
+
+  void stop() {
+    running_ = false;
+    for (auto& t : threads_) t.join();
+    threads_.clear();
+  }
+
+  uint64_t ingested() const {
+    uint64_t n = 0;
+    for (const auto& s : sinks_) n += s.readings;
+    return n;
+  }
+
+  Totals totals() const {
+    Totals t{};
+    for (const auto& c : rx_) {
+      t.datagrams += c.datagrams;
+      t.duplicates += c.duplicates;
+      t.lost += c.lost;
+      t.acks += c.acks;
+      t.malformed += c.malformed;
+      t.stalls += c.stalls;
+    }
+    t.readings = ingested();
+    return t;
+  }
+
+  size_t devices() const { return devices_; }
+
+  /**
+   * Merged latency histogram of the sinks (timestamps mode; call after stop)
+   */
+  Histogram latency() const {
+    Histogram h;
+    for (const auto& s : latency_) h.merge(s);
+    return h;
+  }
+
+private:
+  struct Conn {
+    std::vector<uint8_t> buf;
+  };
+
+  /**
+   * Receive state of one device. Record times are seconds of device uptime;
+   * a reading cannot arrive before it was taken, so arrival - t is never
+   * below the true offset and its minimum is the best estimate (a backlog
+   * or a retransmission only gives a larger one). A reboot starts over.
+   */
+  struct Device {
+    Push::Peer peer;
+    int64_t    offset = INT64_MAX;                  // Wall-clock s at uptime 0
+  };
+
+  Options                  opt_;
+  std::atomic<bool>        running_{true};
+  std::vector<Counters>    rx_;
+  std::vector<Counters>    sinks_;
+  std::vector<std::unique_ptr<SpscRing>> rings_;    // [receiver * threads + sink]
+  std::vector<Histogram>   latency_ = std::vector<Histogram>(opt_.threads);
+  std::atomic<size_t>      devices_{0};
+  std::vector<std::thread> threads_;
+
+  int bindSocket(int type) {
+    const int fd = socket(AF_INET, type | SOCK_NONBLOCK, 0);
+    const int one = 1, rcvbuf = 8 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof one);
+    if (type == SOCK_DGRAM) setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof rcvbuf);
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_addr.s_addr = htonl(INADDR_ANY);
+    a.sin_port = htons(opt_.port);
+    if (fd < 0 || bind(fd, (sockaddr*)&a, sizeof a) < 0) return -1;
+    return fd;
+  }
+
+  /**
+   * Account for one Data frame and queue its readings
+   * @return true if an Ack should go out now (written to ack)
+   */
+  bool ingest(int self, std::unordered_map<uint64_t, Device>& known, const uint8_t* p, size_t len,
+              uint8_t* ack) {
+    Counters& c = rx_[self];
+    Push::Header h;
+    if (!Push::parse(p, len, h) || h.type != Push::Data) { c.malformed++; return false; }
+    c.datagrams++;
+    auto it = known.find(h.id);
+    if (it == known.end()) {
+      it = known.emplace(h.id, Device()).first;
+      devices_++;
+    }
+    Device& dev = it->second;
+    Push::Peer& peer = dev.peer;
+    const uint32_t lost = peer.lost, restarts = peer.restarts;
+    bool ackNow = false;
+    if (peer.accept(h, ackNow)) {
+      SpscRing& ring = *rings_[self * opt_.threads + (int)((h.id * 0x9E3779B97F4A7C15ull >> 32) % opt_.threads)];
+      if (peer.restarts != restarts) dev.offset = INT64_MAX;
+      const int64_t now = opt_.now ? opt_.now() : (int64_t)::time(nullptr);
+      dev.offset = std::min(dev.offset, now - Push::record(p, h.count - 1).t);
+      for (int i = 0; i < h.count; i++) {
+        const HistorySample s = Push::record(p, i);
+        const Reading r{h.id, dev.offset + s.t, s};
+        while (!ring.push(r) && running_) {           // Sink behind: back-pressure into the socket
+          c.stalls++;
+          std::this_thread::yield();
+        }
+      }
+    } else {
+      c.duplicates++;
+    }
+    c.lost += peer.lost - lost;
+    if (ackNow) peer.ack(h.id, ack);
+    return ackNow;
+  }
+
+  void receive(int self, int udp, int tcp) {
+    Counters& c = rx_[self];
+    std::unordered_map<uint64_t, Device> known;
+    std::unordered_map<int, Conn> conns;
+    const int ep = epoll_create1(0);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = udp;
+    epoll_ctl(ep, EPOLL_CTL_ADD, udp, &ev);
+    ev.data.fd = tcp;
+    epoll_ctl(ep, EPOLL_CTL_ADD, tcp, &ev);
+
+    // recvmmsg / sendmmsg batches
+    std::vector<uint8_t> in(kBatch * Push::kMaxDatagram);
+    std::vector<uint8_t> out(kBatch * Push::kAckSize);
+    mmsghdr rmsg[kBatch], smsg[kBatch];
+    iovec riov[kBatch], siov[kBatch];
+    sockaddr_in from[kBatch];
+    for (int i = 0; i < kBatch; i++) {
+      riov[i] = {&in[i * Push::kMaxDatagram], Push::kMaxDatagram};
+      rmsg[i].msg_hdr = msghdr{};
+      rmsg[i].msg_hdr.msg_iov = &riov[i];
+      rmsg[i].msg_hdr.msg_iovlen = 1;
+      rmsg[i].msg_hdr.msg_name = &from[i];
+    }
+
+    epoll_event events[64];
+    while (running_) {
+      const int n = epoll_wait(ep, events, 64, 100);
+      for (int e = 0; e < n; e++) {
+        const int fd = events[e].data.fd;
+        if (fd == udp) {
+          for (;;) {
+            for (int i = 0; i < kBatch; i++) rmsg[i].msg_hdr.msg_namelen = sizeof from[i];
+            const int got = recvmmsg(udp, rmsg, kBatch, MSG_DONTWAIT, nullptr);
+            if (got <= 0) break;
+            int acks = 0;
+            for (int i = 0; i < got; i++) {
+              uint8_t* ack = &out[acks * Push::kAckSize];
+              if (!ingest(self, known, (uint8_t*)riov[i].iov_base, rmsg[i].msg_len, ack)) continue;
+              siov[acks] = {ack, Push::kAckSize};
+              smsg[acks].msg_hdr = msghdr{};
+              smsg[acks].msg_hdr.msg_iov = &siov[acks];
+              smsg[acks].msg_hdr.msg_iovlen = 1;
+              smsg[acks].msg_hdr.msg_name = &from[i];
+              smsg[acks].msg_hdr.msg_namelen = rmsg[i].msg_hdr.msg_namelen;
+              acks++;
+            }
+            if (acks) c.acks += std::max(0, sendmmsg(udp, smsg, acks, MSG_DONTWAIT));
+            if (got < kBatch) break;
+          }
+        } else if (fd == tcp) {
+          int s;
+          while ((s = accept4(tcp, nullptr, nullptr, SOCK_NONBLOCK)) >= 0) {
+            ev.data.fd = s;
+            epoll_ctl(ep, EPOLL_CTL_ADD, s, &ev);
+            conns[s];
+          }
+        } else {
+          Conn& k = conns[fd];
+          uint8_t buf[65536];
+          ssize_t got;
+          bool closed = false;
+          while ((got = recv(fd, buf, sizeof buf, 0)) > 0) k.buf.insert(k.buf.end(), buf, buf + got);
+          if (got == 0 || (got < 0 && errno != EAGAIN)) closed = true;
+          // Frames back to back; the header's count gives the length
+          size_t off = 0;
+          uint8_t ack[Push::kAckSize];
+          while (k.buf.size() - off >= Push::kHeader) {
+            const size_t len = Push::kHeader + k.buf[off + 2] * Push::kRecord;
+            if (k.buf.size() - off < len) break;
+            if (k.buf[off] != Push::kMagic) { closed = true; break; }
+            ingest(self, known, &k.buf[off], len, ack);
+            off += len;
+          }
+          k.buf.erase(k.buf.begin(), k.buf.begin() + off);
+          if (closed) {
+            close(fd);
+            conns.erase(fd);
+          }
+        }
+      }
+    }
+    for (auto& k : conns) close(k.first);
+    close(udp);
+    close(tcp);
+    close(ep);
+  }
+
+  void store(const Reading& r) {
+    FleetDb::Sample s;
+    s.t = r.time;
+    s.v[FleetDb::Temp] = r.s.tempC10;                // HistorySample::kNoValue == kMissing
+    s.v[FleetDb::Humidity] = r.s.humidity10;
+    s.v[FleetDb::Soil] = r.s.soilPct < 0 ? FleetDb::kMissing : r.s.soilPct;
+    s.v[FleetDb::Light] = r.s.lightPct < 0 ? FleetDb::kMissing : r.s.lightPct;
+    opt_.store->append(r.id, s);                     // Drops readings too late for the reorder window
+  }
+
+  void sink(int self) {
+    Counters& c = sinks_[self];
+    Histogram& lat = latency_[self];
+    std::vector<Reading> batch(1024);
+    for (;;) {
+      size_t got = 0;
+      for (int r = 0; r < opt_.threads; r++) {
+        const size_t n = rings_[r * opt_.threads + self]->pop(batch.data(), batch.size());
+        if (opt_.timestamps) {
+          const uint32_t nowUs = (uint32_t)(nowNs() / 1000);
+          for (size_t i = 0; i < n; i++) lat.add((uint64_t)(uint32_t)(nowUs - batch[i].s.t) * 1000);
+        }
+        if (opt_.store) {
+          for (size_t i = 0; i < n; i++) store(batch[i]);
+        }
+        got += n;
+      }
+      c.readings.fetch_add(got, std::memory_order_relaxed);
+      if (!got) {
+        if (!running_) break;
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
+  }
+};
+
+volatile sig_atomic_t g_stop = 0;
+
+void onSignal(int) { g_stop = 1; }
+
+int runCollector(int argc, char** argv) {
+  Options o;
+  const char* storeDir = nullptr;
+  int flushS = 60;
+  FleetDb::Options storeOptions;
+  FleetDb::Compactor::Config compaction;
+  compaction.threads = 1;
+  for (int i = 0; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--port")) o.port = (uint16_t)atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--threads")) o.threads = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--store")) storeDir = argv[i + 1];
+    else if (!strcmp(argv[i], "--flush")) flushS = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--retain")) storeOptions.retention[FleetDb::Raw] = (int64_t)(atof(argv[i + 1]) * 86400);
+    else if (!strcmp(argv[i], "--compactors")) compaction.threads = (size_t)atoi(argv[i + 1]);
+    else { fprintf(stderr, "unknown option %s\n", argv[i]); return 2; }
+  }
+  std::unique_ptr<FleetDb::Store> store;
+  std::unique_ptr<FleetDb::Compactor> compactor;
+  if (storeDir) {
+    store.reset(new FleetDb::Store(storeDir, storeOptions));
+    if (!store->open()) { perror(storeDir); return 1; }
+    o.store = store.get();
+    compactor.reset(new FleetDb::Compactor(*store, compaction));
+    compactor->start();
+  }
+  Service svc(o);
+  if (!svc.start()) return 1;
+  printf("Collecting on UDP/TCP %u with %d receivers and sinks%s%s\n", o.port, o.threads,
+         storeDir ? " into " : "", storeDir ? storeDir : "");
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  uint64_t last = 0;
+  for (int tick = 1; !g_stop; tick++) {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    if (store && flushS > 0 && tick % flushS == 0) store->flush();
+    const Totals t = svc.totals();
+    printf("%zu devices  %llu readings/s  %llu datagrams  %llu dups  %llu lost  %llu acks\n", svc.devices(),
+           (unsigned long long)(t.readings - last), (unsigned long long)t.datagrams,
+           (unsigned long long)t.duplicates, (unsigned long long)t.lost, (unsigned long long)t.acks);
+    fflush(stdout);
+    last = t.readings;
+  }
+  svc.stop();
+  if (compactor) compactor->stop();
+  return store && !store->close() ? 1 : 0;       // Seal the active segments
+}
+
+// =============================================================================
+// Load Generator
+// =============================================================================
+
+struct Load {
+  bool     tcp = false;
+  int      devices = 10000;
+  int      threads = 1;
+  int      sockets = 8;                // Per thread: source ports / connections
+  double   rate = 0;                   // Readings/s in total, 0 = as fast as possible
+};
+
+/**
+ * Devices are spread over the thread's sockets (source ports or connections);
+ * each pass sends one Data frame of kMaxBatch readings, stamped with the send
+ * time, for each of the next kBatch devices of one socket
+ */
+void generate(const Load& load, uint16_t port, int self, std::atomic<bool>& running, std::atomic<uint64_t>& sent) {
+  const int first = load.devices * self / load.threads, count = load.devices * (self + 1) / load.threads - first;
+  const int sockets = std::min(load.sockets, count);
+  std::vector<uint32_t> seq(count, 0);
+  const uint32_t kEpoch = 1;                        // One boot per device
+  std::vector<int> fds, cursor(sockets, 0);
+  sockaddr_in to{};
+  to.sin_family = AF_INET;
+  to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  to.sin_port = htons(port);
+  for (int i = 0; i < sockets; i++) {
+    const int fd = socket(AF_INET, load.tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+    const int one = 1, sndbuf = 4 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof sndbuf);
+    if (load.tcp) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+    if (connect(fd, (sockaddr*)&to, sizeof to) < 0) { perror("connect"); return; }
+    fds.push_back(fd);
+  }
+
+  const size_t frameLen = Push::kHeader + Push::kMaxBatch * Push::kRecord;
+  std::vector<uint8_t> frames(kBatch * frameLen);
+  mmsghdr msgs[kBatch];
+  iovec iov[kBatch];
+  const double perThread = load.rate / load.threads;
+  const uint64_t t0 = nowNs();
+  uint64_t mine = 0;
+  uint8_t drain[Push::kAckSize * 16];
+
+  for (int pass = 0; running; pass++) {
+    if (perThread > 0) {                            // Pace to the requested rate
+      const double due = (nowNs() - t0) * 1e-9 * perThread;
+      if (mine >= due) { std::this_thread::sleep_for(std::chrono::microseconds(20)); continue; }
+    }
+    // Socket k serves devices k, k + sockets, k + 2 * sockets, ...
+    const int k = pass % sockets, perSocket = (count - k + sockets - 1) / sockets;
+    const uint32_t stamp = (uint32_t)(nowNs() / 1000);
+    for (int n = 0; n < kBatch; n++) {
+      const int d = k + sockets * (cursor[k]++ % perSocket);
+      uint8_t* f = &frames[n * frameLen];
+      const uint64_t id = 0x5A0000000000ull + first + d;
+      const uint32_t s = seq[d]++;
+      f[0] = Push::kMagic;
+      f[1] = Push::Data;
+      f[2] = Push::kMaxBatch;
+      f[3] = 0;
+      memcpy(f + 4, &id, 8);                        // Little-endian host
+      memcpy(f + 12, &s, 4);
+      memcpy(f + 16, &s, 4);                        // base: nothing held for resend
+      memcpy(f + 20, &kEpoch, 4);
+      for (int r = 0; r < Push::kMaxBatch; r++) {
+        uint8_t* p = f + Push::kHeader + r * Push::kRecord;
+        const int16_t temp = (int16_t)(200 + r), hum = 550;
+        memcpy(p, &stamp, 4);
+        memcpy(p + 4, &temp, 2);
+        memcpy(p + 6, &hum, 2);
+        p[8] = 40;
+        p[9] = (uint8_t)(s % 100);
+      }
+      iov[n] = {f, frameLen};
+      msgs[n].msg_hdr = msghdr{};
+      msgs[n].msg_hdr.msg_iov = &iov[n];
+      msgs[n].msg_hdr.msg_iovlen = 1;
+    }
+    int n = kBatch;
+    if (load.tcp) {
+      size_t off = 0;
+      const size_t total = kBatch * frameLen;
+      while (off < total) {
+        const ssize_t w = send(fds[k], &frames[off], total - off, MSG_NOSIGNAL);
+        if (w <= 0) { perror("send"); return; }
+        off += w;
+      }
+    } else {
+      n = std::max(0, sendmmsg(fds[k], msgs, kBatch, 0));
+      while (recv(fds[k], drain, sizeof drain, MSG_DONTWAIT) > 0) {}   // Discard Acks
+    }
+    mine += (uint64_t)n * Push::kMaxBatch;
+    sent += (uint64_t)n * Push::kMaxBatch;
+  }
+  for (int fd : fds) close(fd);
+}
+
+struct BenchResult {
+  double   readingsPerSec;
+  uint64_t sent, ingested;
+  Totals   totals;
+  Histogram latency;
+};
+
+BenchResult runLoad(const Load& load, double seconds) {
+  Options o;
+  o.port = 42110;
+  o.timestamps = true;
+  Service svc(o);
+  BenchResult r{};
+  if (!svc.start()) exit(1);
+  std::atomic<bool> running{true};
+  std::atomic<uint64_t> sent{0};
+  std::vector<std::thread> gens;
+  for (int i = 0; i < load.threads; i++) gens.emplace_back(generate, std::cref(load), o.port, i, std::ref(running), std::ref(sent));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));     // Warm up
+  const uint64_t in0 = svc.ingested(), t0 = nowNs();
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  const uint64_t in1 = svc.ingested(), t1 = nowNs();
+  running = false;
+  for (auto& t : gens) t.join();
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));     // Drain the rings
+  svc.stop();
+
+  r.readingsPerSec = (in1 - in0) / ((t1 - t0) * 1e-9);
+  r.sent = sent;
+  r.ingested = svc.ingested();
+  r.totals = svc.totals();
+  r.latency = svc.latency();
+  return r;
+}
+
+int runBench(double seconds) {
+  const int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+  printf("Loopback, %d receiver/sink thread pairs, %d generator threads, 10000 devices, %d readings per frame\n\n",
+         cores, std::max(1, cores / 2), Push::kMaxBatch);
+  printf("%-18s %12s %8s %8s %9s %9s %9s %9s\n", "load", "readings/s", "loss %", "acks/dg", "p50 us", "p99 us",
+         "p99.9 us", "max us");
+
+  Load udp;
+  udp.threads = std::max(1, cores / 2);
+  const BenchResult full = runLoad(udp, seconds);
+  Load half = udp;
+  half.rate = full.readingsPerSec / 2;
+  Load tcp = udp;
+  tcp.tcp = true;
+
+  struct Row { const char* name; BenchResult r; };
+  const Row rows[] = {
+    {"UDP, full rate", full},
+    {"UDP, half rate", runLoad(half, seconds)},
+    {"TCP, full rate", runLoad(tcp, seconds)},
+  };
+  int failures = 0;
+  for (const Row& row : rows) {
+    const BenchResult& r = row.r;
+    const double loss = r.sent ? 100.0 * (r.sent - std::min(r.sent, r.ingested)) / r.sent : 0;
+    printf("%-18s %12.0f %8.2f %8.3f %9.1f %9.1f %9.1f %9.1f\n", row.name, r.readingsPerSec, loss,
+           r.totals.datagrams ? (double)r.totals.acks / r.totals.datagrams : 0.0, r.latency.quantile(0.5) / 1e3,
+           r.latency.quantile(0.99) / 1e3, r.latency.quantile(0.999) / 1e3, r.latency.quantile(1) / 1e3);
+    // Nothing is delivered twice or made up; TCP loses nothing
+    if (r.totals.duplicates || r.totals.malformed || r.ingested > r.sent) failures++;
+    if (&row == &rows[2] && r.ingested != r.sent) failures++;
+  }
+  printf("\n%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
+
+// =============================================================================
+// Store Check
+// =============================================================================
+
+HistorySample checkSample(int device, uint32_t t) {
+  HistorySample s;
+  s.t = t;
+  s.tempC10 = (int16_t)(180 + device + t / 10 % 60);
+  s.humidity10 = (int16_t)(450 + t / 10 % 200);
+  s.soilPct = (int8_t)(t / 10 % 101);
+  s.lightPct = t % 970 == 0 ? -1 : (int8_t)((t / 10 + device) % 101);   // Now and then no reading
+  return s;
+}
+
+/**
+ * Devices run the firmware's Push::Sender against a Service with a store
+ * and a Compactor, over loopback with 5 % of datagrams lost each way and
+ * 10 % held back for 1-30 s, so retransmissions and stragglers reach the
+ * store behind newer readings. One step is a simulated second, on a clock
+ * the collector shares; each device reports every 2 s (a datagram per
+ * 16 s), and the store is flushed every simulated minute as the collector
+ * does. The link runs clean for the first two minutes: the collector learns
+ * each device's clock from its first datagram. Afterwards the store is
+ * reopened and must hold every reading once, at its time, with 1 min
+ * rollups that count them all.
+ */
+int runStoreCheck(const char* dir, double hours) {
+  const int devices = 100, sockets = 4;
+  const uint32_t kReportS = 2, kPerMinute = 60 / kReportS;
+  const int64_t kStart = 1767225600;               // 2026-01-01
+  const uint32_t steps = (uint32_t)(hours * 3600), kCleanS = 120;
+  std::atomic<int64_t> clock{kStart};
+
+  FleetDb::Store store(dir);
+  if (!store.open()) { perror(dir); return 1; }
+  FleetDb::Compactor::Config compaction;
+  compaction.threads = 1;
+  compaction.intervalMs = 100;
+  compaction.now = [&] { return clock.load(); };
+  FleetDb::Compactor compactor(store, compaction);
+  compactor.start();
+  Options o;
+  o.port = 42111;
+  o.threads = 2;
+  o.store = &store;
+  o.now = [&] { return clock.load(); };
+  Service svc(o);
+  if (!svc.start()) return 1;
+
+  std::vector<int> fds;
+  sockaddr_in to{};
+  to.sin_family = AF_INET;
+  to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  to.sin_port = htons(o.port);
+  for (int i = 0; i < sockets; i++) {
+    const int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (connect(fd, (sockaddr*)&to, sizeof to) < 0) { perror("connect"); return 1; }
+    fds.push_back(fd);
+  }
+  const uint64_t kIdBase = 0x5C0000000000ull;
+  std::vector<Push::Sender> senders;
+  std::vector<std::vector<bool>> arrived(devices);  // By seq: a copy reached the collector
+  for (int d = 0; d < devices; d++) senders.emplace_back(kIdBase + d, 1 + d, 8, 8, 3000, 60000);
+
+  struct Held {
+    uint32_t at;
+    int      device;
+    std::vector<uint8_t> bytes;
+  };
+  std::vector<Held> held;
+  std::mt19937 rng(11);
+  uint64_t offered = 0, dropped = 0, reordered = 0, wantIngested = 0;
+  uint8_t buf[Push::kMaxDatagram];
+
+  // Send one datagram and account for the readings the collector will take
+  auto send = [&](int d, const uint8_t* p, size_t len) {
+    Push::Header h;
+    Push::parse(p, len, h);
+    if (h.seq >= arrived[d].size()) arrived[d].resize(h.seq + 1);
+    if (!arrived[d][h.seq]) wantIngested += h.count;
+    arrived[d][h.seq] = true;
+    ::send(fds[d % sockets], p, len, 0);
+  };
+
+  uint32_t step = 0;
+  for (;; step++) {
+    clock = kStart + step;
+    const uint32_t nowMs = step * 1000;
+    const bool clean = step < kCleanS;
+    for (size_t i = 0; i < held.size();) {
+      if (held[i].at > step) { i++; continue; }
+      send(held[i].device, held[i].bytes.data(), held[i].bytes.size());
+      held.erase(held.begin() + i);
+    }
+    bool busy = !held.empty();
+    for (int d = 0; d < devices; d++) {
+      if (step < steps && (step + d) % kReportS == 0) {
+        senders[d].add(checkSample(d, step), nowMs);
+        offered++;
+      }
+      size_t len;
+      while ((len = senders[d].nextDatagram(buf, nowMs)) > 0) {
+        const uint32_t r = rng() % 100;
+        if (!clean && r < 5) { dropped++; continue; }
+        if (!clean && r < 15) {
+          held.push_back({step + 1 + (uint32_t)(rng() % 30), d, {buf, buf + len}});
+          reordered++;
+          continue;
+        }
+        send(d, buf, len);
+      }
+      busy |= senders[d].inFlight() > 0;
+    }
+    // Let the collector take this second's datagrams before the clock moves
+    for (const uint64_t t0 = nowNs(); svc.ingested() < wantIngested && nowNs() - t0 < 2000000000ull;) {
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    for (int fd : fds) {
+      ssize_t n;
+      while ((n = recv(fd, buf, sizeof buf, 0)) > 0) {
+        Push::Header h;
+        if (!Push::parse(buf, n, h) || h.id - kIdBase >= (uint64_t)devices) continue;
+        if (!clean && rng() % 100 < 5) { dropped++; continue; }
+        senders[h.id - kIdBase].onDatagram(buf, n, nowMs);
+      }
+    }
+    if (step % 60 == 59) store.flush();
+    if (step >= steps + 60 && !busy) break;         // Partial batches went after PUSH_MAX_DELAY_MS
+  }
+  svc.stop();
+  compactor.stop();
+  const FleetDb::Stats written = store.stats();
+  if (!store.close()) { perror(dir); return 1; }
+
+  FleetDb::Store check(dir);
+  if (!check.open()) { perror(dir); return 1; }
+  uint64_t stored = 0, bad = 0, evicted = 0, rolledRows = 0, rolledCount = 0;
+  for (int d = 0; d < devices; d++) {
+    const uint64_t id = kIdBase + d;
+    evicted += senders[d].evicted();
+    uint32_t next = (kReportS - d % kReportS) % kReportS;   // Uptime of the next expected reading
+    check.scan(id, INT64_MIN, INT64_MAX, FleetDb::kAllChannels, [&](const FleetDb::ColumnView& c) {
+      for (size_t i = 0; i < c.n; i++, next += kReportS) {
+        const HistorySample s = checkSample(d, next);
+        bad += c.t[i] != kStart + next || c.v[FleetDb::Temp][i] != s.tempC10 ||
+               c.v[FleetDb::Humidity][i] != s.humidity10 || c.v[FleetDb::Soil][i] != s.soilPct ||
+               c.v[FleetDb::Light][i] != (s.lightPct < 0 ? FleetDb::kMissing : s.lightPct);
+      }
+      stored += c.n;
+    });
+    // Mostly rolled up while stragglers were still coming in: every complete
+    // minute holds all its readings
+    check.maintain(id, kStart + steps);
+    check.scanRollups(id, FleetDb::Minute, INT64_MIN, INT64_MAX, FleetDb::kAllChannels,
+                      [&](const FleetDb::RollupView& c) {
+      for (size_t i = 0; i < c.n; i++) {
+        rolledRows++;
+        rolledCount += c.count[FleetDb::Temp][i];
+        bad += c.count[FleetDb::Temp][i] != kPerMinute;
+      }
+    });
+  }
+  printf("%d devices, %.1f h at one reading per %u s; %llu datagrams lost and %llu held back 1-30 s\n\n",
+         devices, hours, kReportS, (unsigned long long)dropped, (unsigned long long)reordered);
+  printf("Store       %llu of %llu readings, %llu rejected, %llu mismatched, %llu evicted by the devices\n",
+         (unsigned long long)stored, (unsigned long long)offered, (unsigned long long)written.rejected,
+         (unsigned long long)bad, (unsigned long long)evicted);
+  printf("Rollups     %llu 1 min rows over %llu readings\n", (unsigned long long)rolledRows,
+         (unsigned long long)rolledCount);
+  const bool ok = stored == offered && !bad && !written.rejected && !evicted && rolledRows > 0;
+  printf("\n%s\n", ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 2 && !strcmp(argv[1], "--bench")) return runBench(argc > 2 ? atof(argv[2]) : 2);
+  if (argc >= 2 && !strcmp(argv[1], "--store-check")) {
+    return runStoreCheck(argc > 2 ? argv[2] : "fleet_check", argc > 3 ? atof(argv[3]) : 1);
+  }
+  if (argc == 1 || argv[1][0] == '-') return runCollector(argc - 1, argv + 1);
+  fprintf(stderr, "usage: %s [--port n] [--threads n]\n"
+                  "       %s --bench [seconds]\n"
+                  "       %s --store-check [dir] [hours]\n", argv[0], argv[0], argv[0]);
+  return 2;
+}
@@ -0,0 +1,611 @@
+/**
+ * Virtual Device Fleet Simulator (host)
+ *
+ * Runs thousands of virtual SmartArium devices on the firmware's own
+ * acquisition code: src/Sensors.*, src/Utils.*, src/AdcCal.*, src/Pm.* and
+ * src/Radio.* are built unmodified against the Arduino shim in host/sim/,
+ * whose pins read a synthetic plant bench per device:
+ *   - light: sun by time of day with a cloud factor per day; on every
+ *     third bench an LED grow light from 18:00 to 23:00 with 100 or 120 Hz
+ *     ripple, seen through the LDR divider,
+ *   - soil: water content drying by evapotranspiration (faster in light
+ *     and heat) until the grower waters the bench back to field capacity
+ *     over three minutes, seen through the capacitive probe,
+ *   - air: DHT22 temperature and humidity with a daily cycle, a rise after
+ *     watering, 0.1 resolution and occasional failed reads.
+ * Each device boots at a random time of day and runs the firmware loop
+ * (sensors, send-on-delta serial reports, UDP push batching) in virtual
+ * time, yielding PM_IDLE_SLICE_MS per pass as under DFS.
+ *
+ * Telemetry leaves in the firmware's formats: serial report lines
+ * (--trace prints one device's), and push protocol datagrams, which go to
+ * an in-process collector (every reading checked on arrival) or with
+ * --push to a real one, e.g. host/fleet_collector. The firmware keeps state
+ * in globals, so each core runs one worker process over its share of the
+ * devices.
+ *
+ * Reports device-seconds simulated per wall-second, what the firmware did
+ * per device-hour, and how close its readings stay to the model: soil
+ * percentage error and grow-light detection against the truth.
+ *
+ * Build:  g++ -O2 -std=c++17 -Isrc -Ihost/sim host/fleet_sim.cpp host/sim/Arduino.cpp src/Sensors.cpp src/Utils.cpp src/AdcCal.cpp src/Pm.cpp src/Radio.cpp src/AdaptiveSampler.cpp src/AnalogFilter.cpp src/Flicker.cpp src/SendOnDelta.cpp src/PushProtocol.cpp src/History.cpp -o fleet_sim
+ * Usage:  fleet_sim [devices] [hours] [--workers n] [--push host:port] [--trace device]
+ *         (exit code 1 if a pushed reading arrives corrupted)
+ */
+
+#include "Sensors.h"
+#include "Pm.h"
+#include "PushProtocol.h"
+#include "SendOnDelta.h"
+#include "esp_adc_cal.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <netdb.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const uint64_t kIdBase = 0x24A1700000000000ull;
+const uint32_t kSliceMs = 60000;                    // Devices take turns per simulated minute
+const uint32_t kPushSliceMs = 1000;                 // With a real collector: acks well inside PUSH_RTO_MS
+
+// Report deadbands as in src/main.cpp
+const Deadband kReportBands[4] = {
+  {TEMP_DEADBAND_ABS,     TEMP_DEADBAND_REL},
+  {HUMIDITY_DEADBAND_ABS, HUMIDITY_DEADBAND_REL},
+  {SOIL_DEADBAND_ABS,     SOIL_DEADBAND_REL},
+  {LIGHT_DEADBAND_ABS,    LIGHT_DEADBAND_REL},
+};
+
+/**
+ * Small fast generator (splitmix64); one per device
+ */
+struct Rng {
+  uint64_t s;
+
+  uint64_t next() {
+    uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+
+  double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+  /**
+   * Approximately standard normal (sum of four uniforms)
+   */
+  double normal() {
+    return (uniform() + uniform() + uniform() + uniform() - 2.0) * 1.7320508;
+  }
+};
+
+double hash01(uint64_t a, uint64_t b) {
+  Rng r{a * 0x9E3779B97F4A7C15ull ^ b};
+  return r.uniform();
+}
+
+esp_adc_cal_characteristics_t adcCurve() {
+  esp_adc_cal_characteristics_t c;
+  esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, ADC_DEFAULT_VREF_MV, &c);
+  return c;
+}
+
+const esp_adc_cal_characteristics_t kAdc = adcCurve();
+
+/**
+ * Code the ADC returns for a pin voltage, with conversion noise
+ */
+int toCode(double mv, Rng& rng, double noiseCodes) {
+  const double code = (mv - kAdc.coeff_b) * 65536.0 / kAdc.coeff_a + noiseCodes * rng.normal();
+  return code < 0 ? 0 : code > 4095 ? 4095 : (int)lround(code);
+}
+
+// =============================================================================
+// Plant Bench Model
+// =============================================================================
+
+class Plant : public Sim::Board {
+public:
+  Plant(int device) : device_(device), rng_{(uint64_t)device * 7919 + 1} {
+    phaseS_ = rng_.uniform() * 86400;
+    grow_ = device % 3 == 0;
+    flickerHz_ = device % 2 ? 120 : 100;
+    tempOffset_ = rng_.normal();
+    dryRate_ = 2.9e-6 * (0.7 + 0.6 * rng_.uniform());
+    waterAt_ = 0.12 + 0.08 * rng_.uniform();
+    theta_ = waterAt_ + 0.02 + (kFieldCapacity - waterAt_ - 0.02) * rng_.uniform();
+  }
+
+  int analogRead(int pin) override {
+    if (pin == SOIL_ADC_PIN) {
+      advanceSoil();
+      return toCode(soilMv() + 6 * rng_.normal(), rng_, 1.5);
+    }
+    if (pin == LDR_ADC_PIN) return toCode(ldrMv(lux(seconds(), true)), rng_, 2);
+    return 0;
+  }
+
+  void readDht(float& tempC, float& humidity) override {
+    advanceSoil();
+    if (rng_.uniform() < 0.002) {                   // Checksum or timeout
+      tempC = humidity = NAN;
+      return;
+    }
+    const double t = airC();
+    tempC = (float)(lround((t + 0.05 * rng_.normal()) * 10) / 10.0);
+    const double h = 62 - 2.2 * (t - 22) + 10 * exp(-(seconds() - wateredS_) / 7200) + 0.3 * rng_.normal();
+    humidity = (float)(lround(std::min(99.0, std::max(15.0, h)) * 10) / 10.0);
+  }
+
+  /**
+   * What perfect acquisition would report now
+   */
+  int soilPctTruth() {
+    advanceSoil();
+    return Utils::mapConstrainBi((int)lround(soilMv()), SOIL_MV_WATER, SOIL_MV_AIR, 100, 0);
+  }
+
+  bool growLightOn() const { return grow_ && growHours(hourOf(seconds())); }
+
+private:
+  static constexpr double kFieldCapacity = 0.40;    // Volumetric water content after watering
+  static constexpr double kSaturation = 0.50;       // Probe reads SOIL_MV_WATER here
+  static constexpr double kWateringS = 180;
+
+  int      device_;
+  Rng      rng_;
+  double   phaseS_;                                 // Time of day at boot
+  bool     grow_;
+  double   flickerHz_;
+  double   tempOffset_;
+  double   dryRate_;                                // Water content lost per second in full sun
+  double   waterAt_;                                // The grower waters below this
+  double   theta_;
+  double   soilS_ = 0;                              // Time the water content is for
+  double   wateringUntilS_ = -1;
+  double   wateredS_ = -1e9;
+
+  double seconds() const { return phaseS_ + us * 1e-6; }
+  static double hourOf(double s) { return fmod(s, 86400) / 3600; }
+  static bool growHours(double h) { return h >= 18 && h < 23; }
+
+  double sun(double s) const {
+    const double h = hourOf(s);
+    const double cloud = 0.35 + 0.65 * hash01(device_, (uint64_t)(s / 86400));
+    return std::max(0.0, sin(2 * M_PI * (h - 6) / 24)) * cloud;
+  }
+
+  double lux(double s, bool ripple) const {
+    double l = 2 + 20000 * sun(s);
+    if (grow_ && growHours(hourOf(s))) {
+      l += 8000 * (1 + (ripple ? 0.4 * cos(2 * M_PI * flickerHz_ * s) : 0));
+    }
+    return l;
+  }
+
+  /**
+   * LDR (20 kOhm at 10 lux, gamma 0.7) under a 10 kOhm divider to 3.3 V
+   */
+  static double ldrMv(double lux) {
+    const double r = 20000 * pow(lux / 10, -0.7);
+    return 3300 * 10000 / (10000 + r);
+  }
+
+  double soilMv() const {
+    return SOIL_MV_AIR - (SOIL_MV_AIR - SOIL_MV_WATER) * theta_ / kSaturation;
+  }
+
+  double airC() const {
+    const double s = seconds();
+    return 21 + tempOffset_ + 4 * sin(2 * M_PI * (hourOf(s) - 9) / 24) + 3 * sun(s) + (growLightOn() ? 1.5 : 0);
+  }
+
+  /**
+   * Integrate drying and watering up to now
+   */
+  void advanceSoil() {
+    const double s = seconds();
+    const double dt = s - soilS_;
+    if (soilS_ == 0 || dt <= 0) {
+      if (soilS_ == 0) soilS_ = s;
+      return;
+    }
+    soilS_ = s;
+    if (s < wateringUntilS_) {
+      theta_ = std::min(kFieldCapacity, theta_ + (kFieldCapacity - waterAt_) * dt / kWateringS);
+      return;
+    }
+    const double light = 0.15 + 0.85 * sun(s) + (growLightOn() ? 0.3 : 0);
+    theta_ -= dryRate_ * light * airC() / 22 * dt;
+    if (theta_ < waterAt_) {
+      wateringUntilS_ = s + kWateringS;
+      wateredS_ = s;
+    }
+  }
+};
+
+// =============================================================================
+// Virtual Device
+// =============================================================================
+
+/**
+ * Totals of one worker, sent to the parent
+ */
+struct Totals {
+  double   deviceSeconds = 0;
+  double   cpuSeconds = 0;
+  uint64_t passes = 0;                              // Firmware loop passes
+  uint64_t dhtReads = 0, soilReads = 0, ldrReads = 0;
+  uint64_t reports = 0;                             // Serial report lines
+  uint64_t datagrams = 0, retransmits = 0;
+  uint64_t delivered = 0, corrupted = 0;            // Readings at the in-process collector
+  uint64_t growTransitions = 0;
+  uint64_t soilChecks = 0;
+  double   soilAbsError = 0;
+  int      soilMaxError = 0;
+  uint64_t growOnChecks = 0, growOnDetected = 0;    // Light source checks, grow light on
+  uint64_t growOffChecks = 0, growOffDetected = 0;  // and off
+
+  void add(const Totals& o) {
+    deviceSeconds += o.deviceSeconds;
+    cpuSeconds += o.cpuSeconds;
+    passes += o.passes;
+    dhtReads += o.dhtReads;
+    soilReads += o.soilReads;
+    ldrReads += o.ldrReads;
+    reports += o.reports;
+    datagrams += o.datagrams;
+    retransmits += o.retransmits;
+    delivered += o.delivered;
+    corrupted += o.corrupted;
+    growTransitions += o.growTransitions;
+    soilChecks += o.soilChecks;
+    soilAbsError += o.soilAbsError;
+    soilMaxError = std::max(soilMaxError, o.soilMaxError);
+    growOnChecks += o.growOnChecks;
+    growOnDetected += o.growOnDetected;
+    growOffChecks += o.growOffChecks;
+    growOffDetected += o.growOffDetected;
+  }
+};
+
+/**
+ * Serial port of a traced device
+ */
+class Console : public Print {
+public:
+  size_t write(uint8_t c) override { return fputc(c, stdout) == EOF ? 0 : 1; }
+};
+
+/**
+ * One device: the firmware's sensing and reporting loop (src/main.cpp)
+ * over a plant bench
+ */
+class Device {
+public:
+  Device(int index, bool trace)
+      : index_(index), id_(kIdBase + index), plant_(index),
+        sender_(id_, (uint32_t)(hash01(id_, 0) * 4294967295.0), PUSH_BATCH, PUSH_WINDOW, PUSH_RTO_MS, PUSH_MAX_DELAY_MS), trace_(trace) {}
+
+  /**
+   * Power-on (Sensors::begin() as in setup())
+   */
+  void boot() {
+    Sim::setBoard(&plant_);
+    sensors_.begin();
+  }
+
+  /**
+   * Run loop passes until the virtual clock reaches untilMs
+   * @param send Transmit a datagram (in-process collector when null)
+   */
+  template <class Send>
+  void run(uint64_t untilMs, Totals& t, Send&& send) {
+    Sim::setBoard(&plant_);
+    while (plant_.us < untilMs * 1000) {
+      const uint64_t before = plant_.us;
+      pass(t, send);
+      if (plant_.us == before) plant_.us += 1000;   // PM_POLICY 0 never yields: count 1 ms
+      t.passes++;
+    }
+  }
+
+  /**
+   * Ack from a real collector
+   */
+  void onDatagram(const uint8_t* p, size_t len) {
+    sender_.onDatagram(p, len, (uint32_t)(plant_.us / 1000));
+  }
+
+  /**
+   * Add the firmware's own counters at the end of the run
+   */
+  void finish(Totals& t) const {
+    t.deviceSeconds += plant_.us * 1e-6;
+    t.dhtReads += const_cast<Sensors&>(sensors_).dhtSampler().samples();
+    t.soilReads += const_cast<Sensors&>(sensors_).soilSampler().samples();
+    t.ldrReads += const_cast<Sensors&>(sensors_).ldrSampler().samples();
+    t.datagrams += sender_.sent();
+    t.retransmits += sender_.retransmits();
+    t.growTransitions += sensors_.growLights().transitions();
+  }
+
+  uint64_t id() const { return id_; }
+
+private:
+  int          index_;
+  uint64_t     id_;
+  Plant        plant_;
+  Sensors      sensors_;
+  SendOnDelta  report_{kReportBands, 4, REPORT_MAX_SILENCE_MS, REPORT_SETTLE_MS};
+  Utils::Ticker serialTick_{1000};
+  Push::Sender sender_;
+  Push::Peer   peer_;                               // In-process collector
+  std::deque<HistorySample> expected_;              // Offered, not yet delivered
+  uint32_t     growSeen_ = 0;
+  bool         trace_;
+  Console      serial_;
+
+  template <class Send>
+  void pass(Totals& t, Send& send) {
+    const uint32_t now = millis();
+
+    // Push uplink first, as PushClient::update() in loop()
+    uint8_t buf[Push::kMaxDatagram];
+    size_t len;
+    while ((len = sender_.nextDatagram(buf, now)) > 0) {
+      if (!send(buf, len)) deliver(buf, len, now, t);
+    }
+
+    sensors_.update(now);
+    const Readings r = sensors_.current();
+
+    if (serialTick_.due(now)) {
+      check(r, t);
+      const float values[4] = {r.tempC, r.humidity, r.soilPct < 0 ? NAN : (float)r.soilPct,
+                               r.lightPct < 0 ? NAN : (float)r.lightPct};
+      if (report_.offer(now, values) != SendOnDelta::None) {
+        t.reports++;
+        if (trace_) printReport(r);
+        HistorySample s;
+        s.t = now / 1000;
+        s.tempC10 = HistorySample::encode10(r.tempC);
+        s.humidity10 = HistorySample::encode10(r.humidity);
+        s.soilPct = (int8_t)r.soilPct;
+        s.lightPct = (int8_t)r.lightPct;
+        sender_.add(s, now);
+        expected_.push_back(s);
+      }
+    }
+
+    const GrowLightLog& grow = sensors_.growLights();
+    if (grow.transitions() != growSeen_) {
+      growSeen_ = grow.transitions();
+      if (trace_) {
+        serial_.print(F("Grow light ")); serial_.print(grow.on() ? F("ON") : F("OFF"));
+        serial_.print(F(" at ")); serial_.print(grow.event(0).ms / 1000);
+        serial_.print(F(" s, duty ")); serial_.print(grow.dutyPct(now), 1);
+        serial_.println(F(" %"));
+      }
+    }
+    Pm::idle();
+  }
+
+  /**
+   * Compare the readings with the model once per second
+   */
+  void check(const Readings& r, Totals& t) {
+    if (r.soilPct >= 0) {
+      const int e = abs(r.soilPct - plant_.soilPctTruth());
+      t.soilChecks++;
+      t.soilAbsError += e;
+      t.soilMaxError = std::max(t.soilMaxError, e);
+    }
+    if (r.lightSource == LightSource::Unknown) return;
+    const bool artificial = r.lightSource == LightSource::Artificial;
+    if (plant_.growLightOn()) {
+      t.growOnChecks++;
+      t.growOnDetected += artificial;
+    } else {
+      t.growOffChecks++;
+      t.growOffDetected += artificial;
+    }
+  }
+
+  /**
+   * The collector's side of a datagram: dedupe, check, acknowledge
+   */
+  void deliver(const uint8_t* p, size_t len, uint32_t now, Totals& t) {
+    Push::Header h;
+    if (!Push::parse(p, len, h) || h.type != Push::Data) return;
+    bool ackNow = false;
+    if (peer_.accept(h, ackNow)) {
+      for (int i = 0; i < h.count; i++) {
+        const HistorySample s = Push::record(p, i);
+        const bool match = !expected_.empty() && s.t == expected_.front().t &&
+                           s.tempC10 == expected_.front().tempC10 && s.humidity10 == expected_.front().humidity10 &&
+                           s.soilPct == expected_.front().soilPct && s.lightPct == expected_.front().lightPct;
+        if (!expected_.empty()) expected_.pop_front();
+        t.delivered++;
+        t.corrupted += !match;
+      }
+    }
+    if (ackNow) {
+      uint8_t ack[Push::kAckSize];
+      sender_.onDatagram(ack, peer_.ack(id_, ack), now);
+    }
+  }
+
+  /**
+   * Serial report line, as loop() prints it
+   */
+  void printReport(const Readings& r) {
+    serial_.print(F("Temp: "));
+    if (isnan(r.tempC)) serial_.print(F("--.-")); else serial_.print(r.tempC, 1);
+    serial_.print(F(" C, Humidity: "));
+    if (isnan(r.humidity)) serial_.print(F("--.-")); else serial_.print(r.humidity, 1);
+    serial_.print(F(" %, Soil: "));
+    if (r.soilPct < 0) serial_.print(F("--")); else serial_.print(r.soilPct);
+    serial_.print(F(" %, Light: "));
+    if (r.lightPct < 0) serial_.print(F("--")); else serial_.print(r.lightPct);
+    serial_.println(F(" %"));
+  }
+};
+
+// =============================================================================
+// Workers
+// =============================================================================
+
+int openUdp(const std::string& target) {
+  std::string host = target, port = std::to_string(PUSH_PORT);
+  const size_t colon = target.rfind(':');
+  if (colon != std::string::npos) { host = target.substr(0, colon); port = target.substr(colon + 1); }
+  addrinfo hints{}, *res = nullptr;
+  hints.ai_socktype = SOCK_DGRAM;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) return -1;
+  int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) != 0) { close(fd); fd = -1; }
+  freeaddrinfo(res);
+  return fd;
+}
+
+/**
+ * Simulate devices w, w + workers, ... for the given time
+ */
+Totals runWorker(int w, int workers, int devices, double hours, const std::string& push, int trace) {
+  Totals t;
+  Pm::begin((Pm::Policy)PM_POLICY);
+  std::vector<std::unique_ptr<Device>> fleet;
+  for (int d = w; d < devices; d += workers) {
+    fleet.emplace_back(new Device(d, d == trace));
+    fleet.back()->boot();
+  }
+
+  int fd = -1;
+  if (!push.empty() && (fd = openUdp(push)) < 0) {
+    fprintf(stderr, "cannot reach %s\n", push.c_str());
+    exit(2);
+  }
+  auto send = [&](const uint8_t* p, size_t len) {
+    if (fd < 0) return false;
+    if (::send(fd, p, len, 0) < 0 && errno != ECONNREFUSED) perror("send");
+    return true;
+  };
+
+  const uint64_t endMs = (uint64_t)(hours * 3600000);
+  const uint64_t slice = fd < 0 ? kSliceMs : kPushSliceMs;
+  for (uint64_t until = std::min(slice, endMs);; until = std::min(until + slice, endMs)) {
+    for (auto& d : fleet) d->run(until, t, send);
+    if (fd >= 0) {                                  // Acks for this worker's devices
+      uint8_t buf[Push::kMaxDatagram];
+      ssize_t n;
+      while ((n = recv(fd, buf, sizeof buf, MSG_DONTWAIT)) > 0) {
+        Push::Header h;
+        if (!Push::parse(buf, (size_t)n, h) || h.type != Push::Ack || h.id < kIdBase) continue;
+        const uint64_t d = h.id - kIdBase;
+        if (d < (uint64_t)devices && (int)(d % workers) == w) fleet[d / workers]->onDatagram(buf, (size_t)n);
+      }
+    }
+    if (until == endMs) break;
+  }
+  for (auto& d : fleet) d->finish(t);
+  if (fd >= 0) close(fd);
+  timespec cpu;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+  t.cpuSeconds = cpu.tv_sec + cpu.tv_nsec * 1e-9;
+  return t;
+}
+
+double perHour(uint64_t n, const Totals& t) {
+  return t.deviceSeconds > 0 ? n * 3600.0 / t.deviceSeconds : 0;
+}
+
+double pct(uint64_t n, uint64_t of) {
+  return of ? 100.0 * n / of : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int devices = 1000;
+  double hours = 1;
+  int workers = (int)std::max(1u, std::thread::hardware_concurrency());
+  std::string push;
+  int trace = -1;
+  int i = 1;
+  if (i < argc && argv[i][0] != '-') devices = atoi(argv[i++]);
+  if (i < argc && argv[i][0] != '-') hours = atof(argv[i++]);
+  for (; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--workers")) workers = std::max(1, atoi(argv[i + 1]));
+    else if (!strcmp(argv[i], "--push")) push = argv[i + 1];
+    else if (!strcmp(argv[i], "--trace")) trace = atoi(argv[i + 1]);
+    else { fprintf(stderr, "unknown option %s\n", argv[i]); return 2; }
+  }
+  if (i < argc) { fprintf(stderr, "usage: %s [devices] [hours] [--workers n] [--push host:port] [--trace device]\n", argv[0]); return 2; }
+  workers = std::min(workers, std::max(1, devices));
+  if (trace < 0) {
+    printf("%d devices x %.2f h on %d worker processes, push to %s\n\n", devices, hours, workers,
+           push.empty() ? "in-process collector" : push.c_str());
+  }
+  fflush(stdout);
+
+  const auto t0 = std::chrono::steady_clock::now();
+  std::vector<pid_t> pids;
+  std::vector<int> pipes;
+  for (int w = 0; w < workers; w++) {
+    int fds[2];
+    if (pipe(fds) != 0) { perror("pipe"); return 1; }
+    const pid_t pid = fork();
+    if (pid < 0) { perror("fork"); return 1; }
+    if (pid == 0) {
+      close(fds[0]);
+      const Totals t = runWorker(w, workers, devices, hours, push, trace);
+      fflush(stdout);
+      const bool ok = write(fds[1], &t, sizeof t) == (ssize_t)sizeof t;
+      _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    pids.push_back(pid);
+    pipes.push_back(fds[0]);
+  }
+  Totals t;
+  int failed = 0;
+  for (int w = 0; w < workers; w++) {
+    Totals part;
+    if (read(pipes[w], &part, sizeof part) != (ssize_t)sizeof part) failed++;
+    else t.add(part);
+    close(pipes[w]);
+    int status;
+    waitpid(pids[w], &status, 0);
+  }
+  const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  if (trace >= 0) return failed || t.corrupted ? 1 : 0;
+  if (failed) { fprintf(stderr, "%d workers failed\n", failed); return 1; }
+
+  printf("Simulated   %.0f device-s in %.1f s = %.0f device-s per wall-s (%.0f per CPU-s)\n",
+         t.deviceSeconds, wall, t.deviceSeconds / wall, t.deviceSeconds / t.cpuSeconds);
+  printf("Firmware    per device-hour: %.0f loop passes, %.0f DHT22, %.0f soil and %.0f LDR reads\n",
+         perHour(t.passes, t), perHour(t.dhtReads, t), perHour(t.soilReads, t), perHour(t.ldrReads, t));
+  printf("Telemetry   per device-hour: %.1f serial reports, %.1f push datagrams (%.2f retransmitted)\n",
+         perHour(t.reports, t), perHour(t.datagrams, t), perHour(t.retransmits, t));
+  if (push.empty()) {
+    printf("Collector   %llu readings delivered, %llu corrupted\n", (unsigned long long)t.delivered,
+           (unsigned long long)t.corrupted);
+  }
+  printf("Soil        %.2f %% mean and %d %% worst error against the model (%llu checks)\n",
+         t.soilChecks ? t.soilAbsError / t.soilChecks : 0.0, t.soilMaxError, (unsigned long long)t.soilChecks);
+  printf("Grow light  detected %.1f %% of the time it is on, %.2f %% of the time it is off; %llu transitions\n",
+         pct(t.growOnDetected, t.growOnChecks), pct(t.growOffDetected, t.growOffChecks),
+         (unsigned long long)t.growTransitions);
+  printf("\n%s\n", t.corrupted ? "FAILED" : "OK");
+  return t.corrupted ? 1 : 0;
+}
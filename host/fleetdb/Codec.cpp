@@ -0,0 +1,420 @@
+/**
+ * Fleet Store Block Codec Implementation
+ */
+
+#include "Codec.h"
+#include <algorithm>
+#include <string.h>
+
+using namespace FleetDb;
+
+namespace {
+
+// Payload bits per bucket after the prefix
+const int kTimeBits[5]   = {0, 7, 12, 20, 64};
+const int kNarrowBits[5] = {0, 4, 8, 12, 17};      // int16 channels
+const int kWideBits[5]   = {0, 8, 16, 32, 64};     // Counts and sums
+
+class BitWriter {
+public:
+  explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+  /**
+   * Append the low n (<= 32) bits of v
+   */
+  void put(uint64_t v, int n) {
+    acc_ |= (v & ((1ull << n) - 1)) << fill_;
+    fill_ += n;
+    while (fill_ >= 8) {
+      out_.push_back((uint8_t)acc_);
+      acc_ >>= 8;
+      fill_ -= 8;
+    }
+  }
+
+  void flush() {
+    if (fill_) out_.push_back((uint8_t)acc_);
+    acc_ = 0;
+    fill_ = 0;
+  }
+
+private:
+  std::vector<uint8_t>& out_;
+  uint64_t acc_ = 0;
+  int      fill_ = 0;
+};
+
+class BitReader {
+public:
+  BitReader(const uint8_t* p, size_t len) : p_(p), end_(p + len) {}
+
+  /**
+   * Skip a run of up to limit zero bits (unchanged values); return its length
+   */
+  size_t zeros(size_t limit) {
+    refill();
+    size_t z = buf_ ? __builtin_ctzll(buf_) : 64;
+    if (z > (size_t)avail_) z = avail_;
+    if (z > limit) z = limit;
+    buf_ = z < 64 ? buf_ >> z : 0;
+    avail_ -= (int)z;
+    return z;
+  }
+
+  /**
+   * Prefix and payload of a narrow bucket (<= 21 bits) from one refill
+   */
+  uint64_t narrow() {
+    refill();
+    int b = __builtin_ctzll(~buf_);
+    if (b > 4) b = 4;
+    const int used = b < 4 ? b + 1 : 4, bits = kNarrowBits[b];
+    const uint64_t v = (buf_ >> used) & ((1ull << bits) - 1);
+    buf_ >>= used + bits;
+    avail_ -= used + bits;
+    return v;
+  }
+
+  /**
+   * Prefix and payload of a bucket from one refill when both fit (payloads
+   * up to 32 bits), else read in two steps
+   */
+  uint64_t bucketed(const int* bits) {
+    refill();
+    int b = __builtin_ctzll(~buf_);
+    if (b > 4) b = 4;
+    const int used = b < 4 ? b + 1 : 4, n = bits[b];
+    if (n <= 32 && used + n <= avail_) {
+      const uint64_t v = (buf_ >> used) & ((1ull << n) - 1);
+      buf_ >>= used + n;
+      avail_ -= used + n;
+      return v;
+    }
+    buf_ >>= used;
+    avail_ -= used;
+    if (n > 32) {
+      const uint64_t lo = get(32);
+      return lo | get(n - 32) << 32;
+    }
+    return n ? get(n) : 0;
+  }
+
+  uint64_t get(int n) {
+    refill();
+    const uint64_t v = buf_ & ((1ull << n) - 1);
+    buf_ >>= n;
+    avail_ -= n;
+    return v;
+  }
+
+private:
+  const uint8_t* p_;
+  const uint8_t* end_;
+  uint64_t buf_ = 0;
+  int      avail_ = 0;
+
+  void refill() {
+    if (avail_ > 32) return;
+    if (end_ - p_ >= 8) {                           // Fast path: whole bytes at once
+      uint64_t w;
+      memcpy(&w, p_, 8);
+      const int take = (63 - avail_) / 8;
+      buf_ |= (take == 8 ? w : w & ((1ull << (8 * take)) - 1)) << avail_;
+      p_ += take;
+      avail_ += 8 * take;
+    } else {
+      while (avail_ <= 56 && p_ < end_) {
+        buf_ |= (uint64_t)*p_++ << avail_;
+        avail_ += 8;
+      }
+    }
+  }
+};
+
+inline uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+inline int64_t unzigzag(uint64_t z) { return (int64_t)(z >> 1) ^ -(int64_t)(z & 1); }
+
+void putBucketed(BitWriter& w, uint64_t z, const int* bits) {
+  int b = 0;
+  while (b < 4 && (z >> bits[b]) != 0) b++;
+  if (b < 4) w.put((1u << b) - 1, b + 1);           // b ones, then a zero
+  else w.put(0xF, 4);
+  if (bits[b] > 32) {
+    w.put(z, 32);
+    w.put(z >> 32, bits[b] - 32);
+  } else if (bits[b]) {
+    w.put(z, bits[b]);
+  }
+}
+
+
+/**
+ * Block under construction: header, column size table, columns
+ */
+class BlockWriter {
+public:
+  BlockWriter(std::vector<uint8_t>& out, uint32_t magic, int columns, size_t n, int64_t tFirst, int64_t tLast)
+    : out_(out), at_(out.size()), columns_(columns) {
+    h_.magic = magic;
+    h_.count = (uint16_t)n;
+    h_.columns = (uint8_t)columns;
+    h_.tFirst = tFirst;
+    h_.tLast = tLast;
+    out.resize(at_ + sizeof h_ + 4 * columns);
+  }
+
+  template <class Get>
+  void times(size_t n, Get t) {
+    BitWriter w(out_);
+    int64_t prevDelta = 0;
+    for (size_t i = 1; i < n; i++) {
+      const int64_t delta = t(i) - t(i - 1);
+      putBucketed(w, zigzag(delta - prevDelta), kTimeBits);
+      prevDelta = delta;
+    }
+    w.flush();
+    endColumn();
+  }
+
+  template <class Get>
+  void values(size_t n, const int* bits, Get v) {
+    BitWriter w(out_);
+    int64_t prev = 0;
+    for (size_t i = 0; i < n; i++) {
+      const int64_t x = v(i);
+      putBucketed(w, zigzag(x - prev), bits);
+      prev = x;
+    }
+    w.flush();
+    endColumn();
+  }
+
+  void finish() {
+    const size_t body = at_ + sizeof h_;
+    h_.payload = (uint32_t)(out_.size() - body);
+    memcpy(&out_[body], sizes_.data(), 4 * columns_);
+    h_.check = fnv1a(&out_[body], h_.payload);
+    memcpy(&out_[at_], &h_, sizeof h_);
+  }
+
+private:
+  std::vector<uint8_t>& out_;
+  size_t      at_;
+  int         columns_;
+  BlockHeader h_{};
+  std::vector<uint32_t> sizes_;
+  size_t      columnStart_ = 0;
+
+  void endColumn() {
+    const size_t start = sizes_.empty() ? at_ + sizeof h_ + 4 * columns_ : columnStart_;
+    sizes_.push_back((uint32_t)(out_.size() - start));
+    columnStart_ = out_.size();
+  }
+};
+
+/**
+ * Columns of an encoded block
+ */
+class BlockReader {
+public:
+  explicit BlockReader(const uint8_t* p) {
+    memcpy(&h, p, sizeof h);
+    sizes_ = p + sizeof h;
+    col_ = sizes_ + 4 * h.columns;
+  }
+
+  BlockHeader h;
+
+  /**
+   * Reader over the next column
+   */
+  BitReader column() {
+    uint32_t n;
+    memcpy(&n, sizes_ + 4 * index_++, 4);
+    const uint8_t* c = col_;
+    col_ += n;
+    return BitReader(c, n);
+  }
+
+  void times(int64_t* t) {
+    BitReader r = column();
+    const size_t n = h.count;
+    int64_t at = h.tFirst, delta = 0;
+    t[0] = at;
+    for (size_t i = 1; i < n;) {
+      // Steady rate: a run of zero bits is a run of equal deltas
+      const size_t run = r.zeros(n - i);
+      for (size_t j = 0; j < run; j++) t[i + j] = at += delta;
+      i += run;
+      if (i == n) break;
+      delta += unzigzag(r.bucketed(kTimeBits));
+      t[i++] = at += delta;
+    }
+  }
+
+  void narrow(int16_t* v, size_t n) {
+    BitReader r = column();
+    int32_t prev = 0;
+    for (size_t i = 0; i < n;) {
+      const size_t run = r.zeros(n - i);            // Unchanged values
+      for (size_t j = 0; j < run; j++) v[i + j] = (int16_t)prev;
+      i += run;
+      if (i == n) break;
+      prev += (int32_t)unzigzag(r.narrow());
+      v[i++] = (int16_t)prev;
+    }
+  }
+
+  template <class T>
+  void wide(T* v, size_t n) {
+    BitReader r = column();
+    int64_t prev = 0;
+    for (size_t i = 0; i < n;) {
+      const size_t run = r.zeros(n - i);            // Unchanged values
+      for (size_t j = 0; j < run; j++) v[i + j] = (T)prev;
+      i += run;
+      if (i == n) break;
+      prev += unzigzag(r.bucketed(kWideBits));
+      v[i++] = (T)prev;
+    }
+  }
+
+  void skip() {
+    column();
+  }
+
+private:
+  const uint8_t* sizes_;
+  const uint8_t* col_;
+  int            index_ = 0;
+};
+
+/**
+ * Rows of a block up to until, from its decoded times
+ */
+size_t rowsUntil(const BlockHeader& h, const int64_t* t, int64_t until) {
+  return h.tLast <= until ? h.count : std::upper_bound(t, t + h.count, until) - t;
+}
+
+}  // namespace
+
+uint32_t FleetDb::fnv1a(const uint8_t* p, size_t len) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; i++) h = (h ^ p[i]) * 16777619u;
+  return h;
+}
+
+ColumnView Columns::slice(size_t from, size_t to) const {
+  ColumnView c;
+  c.n = to - from;
+  c.t = t + from;
+  for (int k = 0; k < kChannels; k++) c.v[k] = v[k] + from;
+  return c;
+}
+
+void Columns::load(const Sample* rows, size_t count) {
+  n = count;
+  for (size_t i = 0; i < count; i++) {
+    t[i] = rows[i].t;
+    for (int k = 0; k < kChannels; k++) v[k][i] = rows[i].v[k];
+  }
+}
+
+RollupView RollupColumns::slice(size_t from, size_t to) const {
+  RollupView c;
+  c.n = to - from;
+  c.t = t + from;
+  for (int k = 0; k < kChannels; k++) {
+    c.min[k] = min[k] + from;
+    c.max[k] = max[k] + from;
+    c.count[k] = count[k] + from;
+    c.sum[k] = sum[k] + from;
+  }
+  return c;
+}
+
+void RollupColumns::load(const Rollup* rows, size_t count_) {
+  n = count_;
+  for (size_t i = 0; i < count_; i++) {
+    t[i] = rows[i].t;
+    for (int k = 0; k < kChannels; k++) {
+      min[k][i] = rows[i].min[k];
+      max[k][i] = rows[i].max[k];
+      count[k][i] = rows[i].count[k];
+      sum[k][i] = rows[i].sum[k];
+    }
+  }
+}
+
+void FleetDb::encodeBlock(const Sample* s, size_t n, std::vector<uint8_t>& out) {
+  BlockWriter w(out, kSampleMagic, 1 + kChannels, n, s[0].t, s[n - 1].t);
+  w.times(n, [&](size_t i) { return s[i].t; });
+  for (int k = 0; k < kChannels; k++) w.values(n, kNarrowBits, [&](size_t i) { return (int64_t)s[i].v[k]; });
+  w.finish();
+}
+
+void FleetDb::encodeBlock(const Rollup* s, size_t n, std::vector<uint8_t>& out) {
+  BlockWriter w(out, kRollupMagic, 1 + 4 * kChannels, n, s[0].t, s[n - 1].t);
+  w.times(n, [&](size_t i) { return s[i].t; });
+  for (int k = 0; k < kChannels; k++) {
+    w.values(n, kNarrowBits, [&](size_t i) { return (int64_t)s[i].min[k]; });
+    w.values(n, kNarrowBits, [&](size_t i) { return (int64_t)s[i].max[k]; });
+    w.values(n, kWideBits, [&](size_t i) { return (int64_t)s[i].count[k]; });
+    w.values(n, kWideBits, [&](size_t i) { return s[i].sum[k]; });
+  }
+  w.finish();
+}
+
+bool FleetDb::validBlock(const uint8_t* p, size_t avail) {
+  if (avail < sizeof(BlockHeader)) return false;
+  BlockHeader h;
+  memcpy(&h, p, sizeof h);
+  const int columns = h.magic == kSampleMagic ? 1 + kChannels : h.magic == kRollupMagic ? 1 + 4 * kChannels : -1;
+  if (h.columns != columns || h.count == 0 || h.count > kMaxBlock || h.tLast < h.tFirst) return false;
+  return h.size() <= avail && h.payload >= 4u * columns && fnv1a(p + sizeof h, h.payload) == h.check;
+}
+
+void FleetDb::decodeBlock(const uint8_t* p, uint32_t channelMask, Columns& out, int64_t until) {
+  BlockReader r(p);
+  r.times(out.t);
+  out.n = rowsUntil(r.h, out.t, until);
+  for (int k = 0; k < kChannels; k++) {
+    if (channelMask >> k & 1) r.narrow(out.v[k], out.n);
+    else r.skip();
+  }
+}
+
+void FleetDb::decodeBlock(const uint8_t* p, uint32_t channelMask, RollupColumns& out, int64_t until) {
+  BlockReader r(p);
+  r.times(out.t);
+  out.n = rowsUntil(r.h, out.t, until);
+  for (int k = 0; k < kChannels; k++) {
+    if (channelMask >> k & 1) {
+      r.narrow(out.min[k], out.n);
+      r.narrow(out.max[k], out.n);
+      r.wide(out.count[k], out.n);
+      r.wide(out.sum[k], out.n);
+    } else {
+      for (int c = 0; c < 4; c++) r.skip();
+    }
+  }
+}
+
+Sample FleetDb::row(const Columns& c, size_t i) {
+  Sample s;
+  s.t = c.t[i];
+  for (int k = 0; k < kChannels; k++) s.v[k] = c.v[k][i];
+  return s;
+}
+
+Rollup FleetDb::row(const RollupColumns& c, size_t i) {
+  Rollup r;
+  r.t = c.t[i];
+  for (int k = 0; k < kChannels; k++) {
+    r.min[k] = c.min[k][i];
+    r.max[k] = c.max[k][i];
+    r.count[k] = c.count[k][i];
+    r.sum[k] = c.sum[k][i];
+  }
+  return r;
+}
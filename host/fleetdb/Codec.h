@@ -0,0 +1,145 @@
+/**
+ * Fleet Store Block Codec
+ *
+ * A block holds up to kMaxBlock consecutive rows of one series as separate
+ * bit-packed columns, so a scan decodes only the columns it needs:
+ *   - time: delta-of-delta, 1 bit per row at a steady rate
+ *   - values: zigzag delta from the previous row, 1 bit when unchanged.
+ *     The channels are fixed-point integers (not float bit patterns), so a
+ *     plain delta beats an XOR code here.
+ * Both use prefix buckets (0, 10, 110, 1110, 1111 + payload), written LSB
+ * first so the decoder can read them from a 64-bit window.
+ *
+ * Two row kinds share the format: raw samples (four int16 channels) and
+ * rollups (min, max, count and sum per channel over a time bucket).
+ *
+ * Block layout: BlockHeader, a u32 byte size per column (time first), then
+ * the columns, each padded to a byte.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace FleetDb {
+
+  enum Channel { Temp, Humidity, Soil, Light, kChannels };
+
+  static const int16_t  kMissing  = -32768;         // No value (sensor error, gap)
+  static const size_t   kMaxBlock = 4096;           // Rows per block
+  static const uint32_t kAllChannels = (1u << kChannels) - 1;
+
+  /**
+   * One reading of one device
+   * temp and humidity in tenths, soil and light in percent
+   */
+  struct Sample {
+    int64_t t;                                      // Unix seconds
+    int16_t v[kChannels];
+  };
+
+  /**
+   * Aggregate of the valid samples in [t, t + bucket width); min and max
+   * are kMissing where count is 0
+   */
+  struct Rollup {
+    int64_t  t;
+    int16_t  min[kChannels];
+    int16_t  max[kChannels];
+    uint32_t count[kChannels];
+    int64_t  sum[kChannels];
+  };
+
+  struct BlockHeader {
+    uint32_t magic;
+    uint16_t count;                                 // Rows
+    uint8_t  columns;                               // Including time
+    uint8_t  reserved;
+    int64_t  tFirst;
+    int64_t  tLast;
+    uint32_t payload;                               // Bytes after the header
+    uint32_t check;                                 // FNV-1a of the payload
+
+    size_t size() const { return sizeof(BlockHeader) + payload; }
+  };
+
+  static const uint32_t kSampleMagic = 0x4B4C4246;  // "FBLK"
+  static const uint32_t kRollupMagic = 0x504C5246;  // "FRLP"
+
+  /**
+   * Decoded sample columns (or a slice of them); pointers stay valid until
+   * the next decode into the same buffer
+   */
+  struct ColumnView {
+    size_t         n = 0;
+    const int64_t* t = nullptr;
+    const int16_t* v[kChannels] = {};
+  };
+
+  /**
+   * Decode buffer for one sample block
+   */
+  struct Columns {
+    size_t  n = 0;
+    int64_t t[kMaxBlock];
+    int16_t v[kChannels][kMaxBlock];
+
+    /**
+     * Rows [from, to)
+     */
+    ColumnView slice(size_t from, size_t to) const;
+    void load(const Sample* rows, size_t n);
+  };
+
+  struct RollupView {
+    size_t          n = 0;
+    const int64_t*  t = nullptr;
+    const int16_t*  min[kChannels] = {};
+    const int16_t*  max[kChannels] = {};
+    const uint32_t* count[kChannels] = {};
+    const int64_t*  sum[kChannels] = {};
+  };
+
+  /**
+   * Decode buffer for one rollup block
+   */
+  struct RollupColumns {
+    size_t   n = 0;
+    int64_t  t[kMaxBlock];
+    int16_t  min[kChannels][kMaxBlock];
+    int16_t  max[kChannels][kMaxBlock];
+    uint32_t count[kChannels][kMaxBlock];
+    int64_t  sum[kChannels][kMaxBlock];
+
+    RollupView slice(size_t from, size_t to) const;
+    void load(const Rollup* rows, size_t n);
+  };
+
+  /**
+   * Append an encoded block of n (1..kMaxBlock) rows with increasing t
+   */
+  void encodeBlock(const Sample* rows, size_t n, std::vector<uint8_t>& out);
+  void encodeBlock(const Rollup* rows, size_t n, std::vector<uint8_t>& out);
+
+  /**
+   * Check a block's header and checksum
+   * @param avail Bytes available at p
+   */
+  bool validBlock(const uint8_t* p, size_t avail);
+
+  /**
+   * Decode the time column and the channels in mask. Rows after until are
+   * left out, and their values are not decoded.
+   */
+  void decodeBlock(const uint8_t* p, uint32_t channelMask, Columns& out, int64_t until = INT64_MAX);
+  void decodeBlock(const uint8_t* p, uint32_t channelMask, RollupColumns& out, int64_t until = INT64_MAX);
+
+  /**
+   * Row i of decoded columns (all channels must have been decoded)
+   */
+  Sample row(const Columns& c, size_t i);
+  Rollup row(const RollupColumns& c, size_t i);
+
+  uint32_t fnv1a(const uint8_t* p, size_t len);
+}
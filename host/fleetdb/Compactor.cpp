@@ -0,0 +1,92 @@
+/**
+ * Fleet Store Compactor Implementation
+ */
+
+#include "Compactor.h"
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace FleetDb;
+
+Compactor::Compactor(Store& store, const Config& config) : store_(store), cfg_(config) {
+  if (cfg_.threads < 1) cfg_.threads = 1;
+  if (!cfg_.now) cfg_.now = [] { return (int64_t)time(nullptr); };
+}
+
+Compactor::~Compactor() { stop(); }
+
+void Compactor::start() {
+  for (size_t i = 0; i < cfg_.threads; i++) workers_.emplace_back(&Compactor::worker, this);
+  scheduler_ = std::thread(&Compactor::schedule, this);
+}
+
+void Compactor::enqueueAll() {
+  const std::vector<uint64_t> ids = store_.devices();
+  std::lock_guard<std::mutex> lock(m_);
+  for (uint64_t id : ids) {
+    if (pending_.insert(id).second) queue_.push_back(id);
+    else if (running_.count(id)) again_.insert(id);  // May have missed new rows
+  }
+  work_.notify_all();
+}
+
+void Compactor::kick() { enqueueAll(); }
+
+void Compactor::drain() {
+  std::unique_lock<std::mutex> lock(m_);
+  idle_.wait(lock, [this] { return stop_ || (queue_.empty() && running_.empty()); });
+}
+
+void Compactor::stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    if (stop_) return;
+    stop_ = true;
+  }
+  work_.notify_all();
+  tick_.notify_all();
+  idle_.notify_all();
+  for (std::thread& t : workers_) t.join();
+  if (scheduler_.joinable()) scheduler_.join();
+  workers_.clear();
+}
+
+Compactor::Totals Compactor::totals() const {
+  std::lock_guard<std::mutex> lock(m_);
+  return totals_;
+}
+
+void Compactor::worker() {
+  // Per-thread on Linux: only this worker yields to ingest
+  setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), cfg_.nice);
+  std::unique_lock<std::mutex> lock(m_);
+  for (;;) {
+    work_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    if (stop_) return;
+    const uint64_t id = queue_.front();
+    queue_.pop_front();
+    running_.insert(id);
+    lock.unlock();
+    const Maintenance m = store_.maintain(id, cfg_.now());
+    lock.lock();
+    running_.erase(id);
+    if (again_.erase(id)) queue_.push_back(id);
+    else pending_.erase(id);
+    totals_.jobs++;
+    totals_.rollups += m.rollups;
+    totals_.merged += m.merged;
+    totals_.dropped += m.dropped;
+    if (queue_.empty() && running_.empty()) idle_.notify_all();
+    else work_.notify_one();
+  }
+}
+
+void Compactor::schedule() {
+  for (;;) {
+    enqueueAll();
+    std::unique_lock<std::mutex> lock(m_);
+    if (tick_.wait_for(lock, std::chrono::milliseconds(cfg_.intervalMs), [this] { return stop_; })) return;
+  }
+}
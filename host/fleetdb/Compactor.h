@@ -0,0 +1,80 @@
+/**
+ * Fleet Store Compactor
+ *
+ * Runs Store::maintain() for every device in the background: a scheduler
+ * thread queues all devices every interval (a device already queued is
+ * not queued twice; one being worked on goes back in the queue when its
+ * job ends), and a fixed number of worker threads take them from the
+ * queue, never two on the same device. Workers run at a lower priority than
+ * ingest (nice 10) and a device's maintenance only holds its series locks
+ * for bookkeeping, so appends and queries carry on while it runs.
+ */
+
+#pragma once
+#include "FleetStore.h"
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <unordered_set>
+
+namespace FleetDb {
+
+  class Compactor {
+  public:
+    struct Config {
+      size_t   threads = 2;                         // Workers (at least one)
+      uint32_t intervalMs = 10000;                  // Between passes over all devices
+      int      nice = 10;                           // Worker priority relative to the process
+      std::function<int64_t()> now;                 // Clock for retention (default: time())
+    };
+
+    struct Totals {
+      uint64_t jobs = 0;                            // Device maintenance runs
+      uint64_t rollups = 0;
+      uint64_t merged = 0;
+      uint64_t dropped = 0;
+    };
+
+    Compactor(Store& store, const Config& config);
+    ~Compactor();                                   // stop()
+
+    void start();
+
+    /**
+     * Queue every device now instead of at the next interval
+     */
+    void kick();
+
+    /**
+     * Wait until the queue is empty and no job is running
+     */
+    void drain();
+
+    /**
+     * Finish the running jobs and join the threads
+     */
+    void stop();
+
+    Totals totals() const;
+
+  private:
+    Store& store_;
+    Config cfg_;
+
+    mutable std::mutex m_;
+    std::condition_variable work_, idle_, tick_;
+    std::deque<uint64_t> queue_;
+    std::unordered_set<uint64_t> pending_;          // Queued or running
+    std::unordered_set<uint64_t> running_;
+    std::unordered_set<uint64_t> again_;            // Queued again while running
+    bool   stop_ = false;
+    Totals totals_;
+
+    std::vector<std::thread> workers_;
+    std::thread scheduler_;
+
+    void enqueueAll();
+    void worker();
+    void schedule();
+  };
+}
@@ -0,0 +1,286 @@
+/**
+ * Fleet Store Implementation
+ */
+
+#include "FleetStore.h"
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+using namespace FleetDb;
+
+namespace {
+
+const char* const kTierDirs[kTiers] = {"raw", "1m", "1h", "1d"};
+
+int64_t floorTo(int64_t t, int64_t width) {
+  return t >= 0 ? t / width * width : -((-t + width - 1) / width) * width;
+}
+
+/**
+ * Rollup row being filled
+ */
+struct Bucket {
+  Rollup r;
+  bool   open = false;
+
+  void start(int64_t t) {
+    r.t = t;
+    for (int k = 0; k < kChannels; k++) {
+      r.min[k] = r.max[k] = kMissing;
+      r.count[k] = 0;
+      r.sum[k] = 0;
+    }
+    open = true;
+  }
+
+  void add(int k, int16_t v) {
+    if (v == kMissing) return;
+    if (!r.count[k] || v < r.min[k]) r.min[k] = v;
+    if (!r.count[k] || v > r.max[k]) r.max[k] = v;
+    r.count[k]++;
+    r.sum[k] += v;
+  }
+
+  void add(int k, int16_t mn, int16_t mx, uint32_t count, int64_t sum) {
+    if (!count) return;
+    if (!r.count[k] || mn < r.min[k]) r.min[k] = mn;
+    if (!r.count[k] || mx > r.max[k]) r.max[k] = mx;
+    r.count[k] += count;
+    r.sum[k] += sum;
+  }
+};
+
+}  // namespace
+
+Store::Store(const std::string& dir, const Options& options) : dir_(dir), opt_(options) {
+  opt_.blockSamples = std::max<size_t>(1, std::min(opt_.blockSamples, kMaxBlock));
+  opt_.blockRollups = std::max<size_t>(1, std::min(opt_.blockRollups, kMaxBlock));
+  opt_.segmentBlocks = std::max<size_t>(1, opt_.segmentBlocks);
+}
+
+Store::~Store() { close(); }
+
+bool Store::openDevice(Device& d, const std::string& dir) {
+  if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST) return false;
+  if (!d.raw.open(dir + "/" + kTierDirs[Raw], opt_.blockSamples, opt_.segmentBlocks, opt_.segmentSpan[Raw],
+                  opt_.reorderS)) {
+    return false;
+  }
+  for (int k = Minute; k < kTiers; k++) {
+    if (!d.rollup[k - 1].open(dir + "/" + kTierDirs[k], opt_.blockRollups, opt_.segmentBlocks, opt_.segmentSpan[k])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Store::open() {
+  if (mkdir(dir_.c_str(), 0755) < 0 && errno != EEXIST) return false;
+  std::unique_lock<std::shared_mutex> lock(devicesMutex_);
+  DIR* dir = opendir(dir_.c_str());
+  if (!dir) return false;
+  bool ok = true;
+  while (dirent* e = readdir(dir)) {
+    char* end;
+    const uint64_t id = strtoull(e->d_name, &end, 16);
+    if (strlen(e->d_name) != 16 || *end) continue;
+    std::unique_ptr<Device> d(new Device());
+    if (!openDevice(*d, dir_ + "/" + e->d_name)) { ok = false; break; }
+    devices_[id] = std::move(d);
+  }
+  closedir(dir);
+  return ok;
+}
+
+Store::Device* Store::find(uint64_t id) const {
+  std::shared_lock<std::shared_mutex> lock(devicesMutex_);
+  auto it = devices_.find(id);
+  return it == devices_.end() ? nullptr : it->second.get();
+}
+
+Store::Device* Store::device(uint64_t id) {
+  if (Device* d = find(id)) return d;
+  std::unique_lock<std::shared_mutex> lock(devicesMutex_);
+  std::unique_ptr<Device>& d = devices_[id];
+  if (!d) {
+    char name[17];
+    snprintf(name, sizeof name, "%016llx", (unsigned long long)id);
+    d.reset(new Device());
+    if (!openDevice(*d, dir_ + "/" + name)) {
+      devices_.erase(id);
+      return nullptr;
+    }
+  }
+  return d.get();
+}
+
+bool Store::append(uint64_t id, const Sample& s) {
+  Device* d = device(id);
+  if (!d) return false;
+  if (!d->raw.accepts(s.t)) {                        // One writer per device: append() agrees
+    rejected_++;
+    return false;
+  }
+  return d->raw.append(s);
+}
+
+bool Store::flush() {
+  bool ok = true;
+  std::shared_lock<std::shared_mutex> lock(devicesMutex_);
+  for (auto& e : devices_) ok &= e.second->raw.flush();
+  return ok;
+}
+
+bool Store::close() {
+  bool ok = true;
+  std::shared_lock<std::shared_mutex> lock(devicesMutex_);
+  for (auto& e : devices_) {
+    ok &= e.second->raw.seal();
+    for (auto& r : e.second->rollup) ok &= r.seal();
+  }
+  return ok;
+}
+
+bool Store::seal(uint64_t id) {
+  Device* d = find(id);
+  if (!d) return true;
+  bool ok = d->raw.seal();
+  for (auto& r : d->rollup) ok &= r.seal();
+  return ok;
+}
+
+uint64_t Store::scan(uint64_t id, int64_t t0, int64_t t1, uint32_t channels, const ScanFn& fn) const {
+  const Device* d = find(id);
+  return d ? d->raw.scan(t0, t1, channels, fn) : 0;
+}
+
+uint64_t Store::scanRollups(uint64_t id, Tier tier, int64_t t0, int64_t t1, uint32_t channels,
+                            const RollupFn& fn) const {
+  const Device* d = find(id);
+  return d && tier > Raw && tier < kTiers ? d->rollup[tier - 1].scan(t0, t1, channels, fn) : 0;
+}
+
+int64_t Store::rolledUntil(uint64_t id, Tier tier) const {
+  const Device* d = find(id);
+  if (!d || tier <= Raw || tier >= kTiers) return INT64_MIN;
+  const int64_t last = d->rollup[tier - 1].lastT();
+  return last == INT64_MIN ? INT64_MIN : last + kTierSeconds[tier];
+}
+
+/**
+ * Add the complete buckets of a tier from the tier below it
+ * @return Rows added
+ */
+uint64_t Store::rollUp(Device& d, int tier) {
+  const int64_t width = kTierSeconds[tier];
+  Series<RollupRows>& out = d.rollup[tier - 1];
+
+  // A source bucket is complete once a later row exists and nothing can
+  // still land in it: raw rows up to settledT() (the reorder window is
+  // still open after it), rollup rows in time order
+  const int64_t srcLast = tier == Minute ? d.raw.settledT() : d.rollup[tier - 2].lastT();
+  if (srcLast == INT64_MIN) return 0;
+  const int64_t until = floorTo(srcLast + kTierSeconds[tier - 1], width);   // Exclusive
+  const int64_t last = out.lastT();
+  const int64_t from = last == INT64_MIN ? INT64_MIN : last + width;
+  if (from >= until) return 0;
+
+  uint64_t rows = 0;
+  Bucket b;
+  auto emit = [&] {
+    if (b.open) {
+      out.append(b.r);
+      rows++;
+    }
+  };
+  if (tier == Minute) {
+    d.raw.scan(from, until - 1, kAllChannels, [&](const ColumnView& c) {
+      for (size_t i = 0; i < c.n; i++) {
+        const int64_t t = floorTo(c.t[i], width);
+        if (!b.open || t != b.r.t) { emit(); b.start(t); }
+        for (int k = 0; k < kChannels; k++) b.add(k, c.v[k][i]);
+      }
+    });
+  } else {
+    d.rollup[tier - 2].scan(from, until - 1, kAllChannels, [&](const RollupView& c) {
+      for (size_t i = 0; i < c.n; i++) {
+        const int64_t t = floorTo(c.t[i], width);
+        if (!b.open || t != b.r.t) { emit(); b.start(t); }
+        for (int k = 0; k < kChannels; k++) b.add(k, c.min[k][i], c.max[k][i], c.count[k][i], c.sum[k][i]);
+      }
+    });
+  }
+  emit();
+  return rows;
+}
+
+Maintenance Store::maintain(uint64_t id, int64_t now) {
+  Maintenance m;
+  Device* d = find(id);
+  if (!d) return m;
+
+  for (int k = Minute; k < kTiers; k++) {
+    m.rollups += rollUp(*d, k);
+    // Rollups can be rebuilt from the tier below while it is kept, so their
+    // head buffers are written out only now and then
+    if (d->rollup[k - 1].headSince() < now - opt_.rollupFlushS) d->rollup[k - 1].flush();
+  }
+
+  // Retention: never past what the next tier has rolled up and written to a
+  // segment, so a crash cannot lose rows from both tiers
+  for (int k = Raw; k < kTiers; k++) {
+    if (opt_.retention[k] <= 0) continue;
+    int64_t cutoff = now - opt_.retention[k];
+    if (k + 1 < kTiers) {
+      const Series<RollupRows>& next = d->rollup[k];
+      const int64_t rolled = next.lastT();
+      if (rolled == INT64_MIN) continue;
+      cutoff = std::min({cutoff, rolled + kTierSeconds[k + 1], next.headSince()});
+    }
+    m.dropped += k == Raw ? d->raw.dropBefore(cutoff) : d->rollup[k - 1].dropBefore(cutoff);
+  }
+
+  m.merged += d->raw.compact();
+  for (auto& r : d->rollup) m.merged += r.compact();
+  return m;
+}
+
+std::vector<uint64_t> Store::devices() const {
+  std::shared_lock<std::shared_mutex> lock(devicesMutex_);
+  std::vector<uint64_t> ids;
+  for (const auto& e : devices_) ids.push_back(e.first);
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+Stats Store::stats() const {
+  Stats st;
+  std::shared_lock<std::shared_mutex> lock(devicesMutex_);
+  st.devices = devices_.size();
+  for (const auto& e : devices_) {
+    for (int k = Raw; k < kTiers; k++) {
+      const SeriesStats s = k == Raw ? e.second->raw.stats() : e.second->rollup[k - 1].stats();
+      st.tier[k].segments += s.segments;
+      st.tier[k].blocks += s.blocks;
+      st.tier[k].rows += s.rows;
+      st.tier[k].bytes += s.bytes;
+    }
+  }
+  st.rejected = rejected_;
+  return st;
+}
+
+Stats Store::stats(uint64_t id) const {
+  Stats st;
+  const Device* d = find(id);
+  if (!d) return st;
+  st.devices = 1;
+  st.tier[Raw] = d->raw.stats();
+  for (int k = Minute; k < kTiers; k++) st.tier[k] = d->rollup[k - 1].stats();
+  return st;
+}
@@ -0,0 +1,162 @@
+/**
+ * Fleet Store
+ *
+ * Durable per-device history for the collector side. Each device has a raw
+ * series and three rollup tiers (Series.h), each a directory of append-only
+ * segment files holding compressed column blocks (Codec.h):
+ *
+ *   <dir>/<device id hex>/raw|1m|1h|1d/<segment range>.seg
+ *
+ * Appends collect in the raw head buffer until a block is full
+ * (Options::blockSamples), then the block is encoded and appended to the
+ * active segment; a full segment is sealed with its time index and a new
+ * one started. A sample may arrive up to Options::reorderS seconds after a
+ * newer one (a retransmission recovered by the push protocol); the head
+ * buffer keeps that window open and in order. flush() writes partial
+ * blocks of the rows out of the window, so samples still in head buffers
+ * are what a crash loses.
+ *
+ * maintain() (run by a Compactor in the background) keeps the rest in
+ * shape: it rolls complete buckets up into the 1 min, 1 h and 1 day tiers
+ * (min, max, count and sum per channel), drops segments past each tier's
+ * retention (never raw data that is not rolled up yet) and merges small
+ * segments into full blocks.
+ *
+ * Appends for one device come from one thread at a time (the collector
+ * shards devices over its sinks), and maintain() for one device from one
+ * thread at a time; scans run concurrently with both, on a snapshot.
+ */
+
+#pragma once
+#include "Series.h"
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace FleetDb {
+
+  enum Tier { Raw, Minute, Hour, Day, kTiers };
+
+  static const int64_t kTierSeconds[kTiers] = {1, 60, 3600, 86400};
+
+  struct Options {
+    size_t  blockSamples = 1024;                    // Rows per block (<= kMaxBlock)
+    size_t  blockRollups = 256;                     // Rows per rollup block, ~4x as wide
+    size_t  segmentBlocks = 64;                     // Blocks per segment
+    int64_t retention[kTiers] = {};                 // Seconds kept per tier, 0 = forever
+    // Longest time one segment covers per tier (retention drops whole segments)
+    int64_t segmentSpan[kTiers] = {86400, 86400, 30 * 86400, 366 * 86400};
+    int64_t rollupFlushS = 3600;                    // Write rollup head buffers older than this
+    // Raw samples this much older than a device's newest still go in: about
+    // what a device holds for resend (PUSH_WINDOW x PUSH_BATCH readings)
+    int64_t reorderS = 600;
+  };
+
+  struct Stats {
+    size_t      devices = 0;
+    SeriesStats tier[kTiers];
+    uint64_t    rejected = 0;                       // Appends too late or for a time already stored
+  };
+
+  /**
+   * What one maintain() call did
+   */
+  struct Maintenance {
+    uint64_t rollups = 0;                           // Rows added to the rollup tiers
+    size_t   merged = 0;                            // Segments replaced by merges
+    size_t   dropped = 0;                           // Segments past retention
+  };
+
+  class Store {
+  public:
+    Store(const std::string& dir, const Options& options = Options());
+    ~Store();
+
+    /**
+     * Create the directory or load the segments in it
+     * @return false on an I/O error
+     */
+    bool open();
+
+    /**
+     * Add a sample; it may be up to Options::reorderS older than the
+     * device's newest, but not at a time the device already has
+     * @return false if it is too late or a duplicate (the sample is
+     *         dropped) or on an I/O error
+     */
+    bool append(uint64_t device, const Sample& s);
+
+    /**
+     * Encode the raw head buffers into (possibly short) blocks
+     */
+    bool flush();
+
+    /**
+     * Flush and seal every active segment
+     */
+    bool close();
+
+    /**
+     * Flush and seal one device's active segments, e.g. when it goes quiet
+     * (only active segments hold a file descriptor); appends start new ones
+     */
+    bool seal(uint64_t device);
+
+    using ScanFn = std::function<void(const ColumnView&)>;
+    using RollupFn = std::function<void(const RollupView&)>;
+
+    /**
+     * Visit a device's samples with t0 <= t <= t1 in time order, in slices
+     * of at most one block
+     * @param channels Bit mask of Channel values to decode (others are left
+     *                 unset in the views)
+     * @return Samples visited
+     */
+    uint64_t scan(uint64_t device, int64_t t0, int64_t t1, uint32_t channels, const ScanFn& fn) const;
+
+    /**
+     * Same for a rollup tier (bucket start times)
+     */
+    uint64_t scanRollups(uint64_t device, Tier tier, int64_t t0, int64_t t1, uint32_t channels,
+                         const RollupFn& fn) const;
+
+    /**
+     * End (exclusive) of the buckets a rollup tier holds for a device: later
+     * rows are only in the tiers below (INT64_MIN when it has none)
+     */
+    int64_t rolledUntil(uint64_t device, Tier tier) const;
+
+    /**
+     * Roll up, apply retention and merge for one device
+     * @param now Current time (Unix seconds) for retention
+     */
+    Maintenance maintain(uint64_t device, int64_t now);
+
+    std::vector<uint64_t> devices() const;
+    Stats stats() const;
+
+    /**
+     * One device's tiers (devices is 0 if it is unknown)
+     */
+    Stats stats(uint64_t device) const;
+    const std::string& dir() const { return dir_; }
+    const Options& options() const { return opt_; }
+
+  private:
+    struct Device {
+      Series<SampleRows> raw;
+      Series<RollupRows> rollup[kTiers - 1];        // Minute, Hour, Day
+    };
+
+    std::string dir_;
+    Options     opt_;
+    mutable std::shared_mutex devicesMutex_;
+    std::unordered_map<uint64_t, std::unique_ptr<Device>> devices_;
+    std::atomic<uint64_t> rejected_{0};
+
+    Device* find(uint64_t id) const;
+    Device* device(uint64_t id);                    // Created on first use
+    bool openDevice(Device& d, const std::string& dir);
+    uint64_t rollUp(Device& d, int tier);
+  };
+}
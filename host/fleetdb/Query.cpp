@@ -0,0 +1,305 @@
+/**
+ * Fleet Store Queries Implementation
+ */
+
+#include "Query.h"
+#include <algorithm>
+#include <array>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace FleetDb;
+
+namespace {
+
+int64_t floorTo(int64_t t, int64_t width) {
+  return t >= 0 ? t / width * width : -((-t + width - 1) / width) * width;
+}
+
+int64_t ceilTo(int64_t t, int64_t width) {
+  return -floorTo(-t, width);
+}
+
+/**
+ * Running aggregate of one cell on one worker
+ */
+struct Acc {
+  uint64_t count = 0;
+  int64_t  sum = 0;
+  int32_t  min = INT16_MAX;
+  int32_t  max = INT16_MIN;
+};
+
+/**
+ * Exact value counts over the range seen so far, for percentiles
+ */
+struct Histogram {
+  int32_t base = 0;
+  std::vector<uint32_t> counts;
+
+  void add(int16_t v, uint32_t n = 1) {
+    if (counts.empty()) {
+      base = v;
+      counts.assign(1, 0);
+    } else if (v < base) {
+      counts.insert(counts.begin(), (size_t)(base - v), 0);
+      base = v;
+    } else if ((size_t)(v - base) >= counts.size()) {
+      counts.resize((size_t)(v - base) + 1, 0);
+    }
+    counts[v - base] += n;
+  }
+
+  void merge(const Histogram& o) {
+    for (size_t i = 0; i < o.counts.size(); i++) {
+      if (o.counts[i]) add((int16_t)(o.base + (int32_t)i), o.counts[i]);
+    }
+  }
+
+  /**
+   * Value of the rank-th smallest sample (1-based)
+   */
+  int16_t at(uint64_t rank) const {
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+      seen += counts[i];
+      if (seen >= rank) return (int16_t)(base + (int32_t)i);
+    }
+    return kMissing;
+  }
+};
+
+/**
+ * Count, sum, min and max of the valid values in v[0, n), n <= kMaxBlock
+ */
+void aggregate(const int16_t* v, size_t n, Acc& a) {
+  size_t i = 0;
+  int32_t mn = a.min, mx = a.max;
+  int64_t sum = 0;
+  uint64_t missing = 0;
+#ifdef __SSE2__
+  if (n >= 8) {
+    const __m128i kMiss = _mm_set1_epi16(kMissing), kOnes = _mm_set1_epi16(1);
+    __m128i vmin = _mm_set1_epi16(INT16_MAX), vmax = _mm_set1_epi16(INT16_MIN);
+    __m128i vsum = _mm_setzero_si128(), vmiss = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+      const __m128i x = _mm_loadu_si128((const __m128i*)(v + i));
+      const __m128i m = _mm_cmpeq_epi16(x, kMiss);
+      vmin = _mm_min_epi16(vmin, _mm_xor_si128(x, m));            // kMissing ^ 0xFFFF = INT16_MAX
+      vmax = _mm_max_epi16(vmax, x);                              // kMissing is INT16_MIN
+      vsum = _mm_add_epi32(vsum, _mm_madd_epi16(_mm_andnot_si128(m, x), kOnes));
+      vmiss = _mm_sub_epi16(vmiss, m);                            // Lanes stay below 512
+    }
+    int16_t lmin[8], lmax[8], lmiss[8];
+    int32_t lsum[4];
+    _mm_storeu_si128((__m128i*)lmin, vmin);
+    _mm_storeu_si128((__m128i*)lmax, vmax);
+    _mm_storeu_si128((__m128i*)lmiss, vmiss);
+    _mm_storeu_si128((__m128i*)lsum, vsum);
+    for (int k = 0; k < 8; k++) {
+      mn = std::min<int32_t>(mn, lmin[k]);
+      mx = std::max<int32_t>(mx, lmax[k]);
+      missing += (uint16_t)lmiss[k];
+    }
+    for (int k = 0; k < 4; k++) sum += lsum[k];
+  }
+#endif
+  for (; i < n; i++) {
+    const int16_t x = v[i];
+    if (x == kMissing) {
+      missing++;
+      continue;
+    }
+    mn = std::min<int32_t>(mn, x);
+    mx = std::max<int32_t>(mx, x);
+    sum += x;
+  }
+  a.count += n - missing;
+  a.sum += sum;
+  a.min = mn;
+  a.max = mx;
+}
+
+/**
+ * Same over rollup rows [0, n)
+ */
+void aggregate(const int16_t* mins, const int16_t* maxs, const uint32_t* counts, const int64_t* sums, size_t n,
+               Acc& a) {
+  for (size_t i = 0; i < n; i++) {
+    if (!counts[i]) continue;
+    a.min = std::min<int32_t>(a.min, mins[i]);
+    a.max = std::max<int32_t>(a.max, maxs[i]);
+    a.count += counts[i];
+    a.sum += sums[i];
+  }
+}
+
+/**
+ * Part of one device's range read from one tier
+ */
+struct Piece {
+  uint32_t device;                                  // Index into the query's devices
+  Tier     tier;
+  int64_t  from, to;                                // [from, to)
+};
+
+// A rollup row costs about four sample rows to decode (min, max, count and
+// sum columns for the channel)
+const double kRollupRowCost = 4;
+
+/**
+ * Tiers up to top worth reading for a device: a rollup tier only if its
+ * rows are well under a quarter as many as the tier below (with readings
+ * every 5 min, 1 min rollups hold as many rows as the raw samples)
+ */
+void usefulTiers(const Stats& st, int top, bool* use) {
+  double below = 0;
+  for (int k = Raw; k < kTiers; k++) {
+    const SeriesStats& s = st.tier[k];
+    const double density = s.rows ? s.rows / (double)(s.tLast - s.tFirst + kTierSeconds[k]) : 0;
+    use[k] = k == Raw || (k <= top && s.rows && density * kRollupRowCost < below);
+    if (use[k]) below = density;
+  }
+}
+
+/**
+ * Split [from, to) between tier k, for whole buckets it has rolled up,
+ * and the tiers below for the rest
+ */
+void plan(const Store& store, uint64_t id, uint32_t device, int64_t from, int64_t to, int k, const bool* use,
+          std::vector<Piece>& out) {
+  if (from >= to) return;
+  while (k > Raw && !use[k]) k--;
+  if (k == Raw) {
+    out.push_back({device, Raw, from, to});
+    return;
+  }
+  const int64_t w = kTierSeconds[k], ready = store.rolledUntil(id, (Tier)k);
+  const int64_t a = ceilTo(from, w), b = ready == INT64_MIN ? INT64_MIN : floorTo(std::min(to, ready), w);
+  if (a >= b) {
+    plan(store, id, device, from, to, k - 1, use, out);
+    return;
+  }
+  plan(store, id, device, from, a, k - 1, use, out);
+  out.push_back({device, (Tier)k, a, b});
+  plan(store, id, device, b, to, k - 1, use, out);
+}
+
+}  // namespace
+
+QueryEngine::QueryEngine(const Store& store, size_t threads) : store_(store), pool_(threads) {}
+
+Tier QueryEngine::plan(const Query& q) {
+  if (!q.percentiles.empty()) return Raw;
+  for (int k = std::min(q.maxTier, (int)kTiers - 1); k > Raw; k--) {
+    const int64_t w = kTierSeconds[k];
+    if (q.step == 0 || (q.step % w == 0 && floorTo(q.t0, w) == q.t0)) return (Tier)k;
+  }
+  return Raw;
+}
+
+QueryResult QueryEngine::run(const Query& q) {
+  QueryResult r;
+  if (q.t1 < q.t0 || q.step < 0) return r;
+  const std::vector<uint64_t> devices = q.devices.empty() ? store_.devices() : q.devices;
+  const bool grouped = q.groups.size() == devices.size();
+  r.groups = grouped && !devices.empty() ? *std::max_element(q.groups.begin(), q.groups.end()) + 1 : 1;
+  r.buckets = q.step ? (size_t)((q.t1 - q.t0) / q.step + 1) : 1;
+  r.tier = plan(q);
+
+  // Pieces per device, cut at segment spans so long ranges spread too
+  std::vector<Piece> pieces, parts;
+  for (uint32_t d = 0; d < devices.size(); d++) {
+    parts.clear();
+    bool use[kTiers];
+    usefulTiers(store_.stats(devices[d]), r.tier, use);
+    ::plan(store_, devices[d], d, q.t0, q.t1 + 1, r.tier, use, parts);
+    for (const Piece& p : parts) {
+      const int64_t span = store_.options().segmentSpan[p.tier];
+      for (int64_t at = p.from; at < p.to;) {
+        const int64_t end = std::min(p.to, floorTo(at, span) + span);
+        pieces.push_back({p.device, p.tier, at, end});
+        at = end;
+      }
+    }
+  }
+
+  const size_t workers = pool_.size(), cells = r.groups * r.buckets;
+  const bool wantPct = !q.percentiles.empty();
+  std::vector<std::vector<Acc>> acc(workers, std::vector<Acc>(cells));
+  std::vector<std::vector<Histogram>> hist(workers, std::vector<Histogram>(wantPct ? cells : 0));
+  std::vector<std::array<uint64_t, kTiers>> rows(workers, std::array<uint64_t, kTiers>{});
+  const int ch = q.channel;
+
+  std::vector<TaskPool::Task> tasks;
+  tasks.reserve(pieces.size());
+  for (const Piece& p : pieces) {
+    tasks.emplace_back([&, p](size_t w) {
+      const uint64_t id = devices[p.device];
+      Acc* const cell = acc[w].data() + (grouped ? q.groups[p.device] : 0) * r.buckets;
+      Histogram* const hcell = wantPct ? hist[w].data() + (cell - acc[w].data()) : nullptr;
+      // First row of the next bucket at or after i
+      auto bucketEnd = [&](const int64_t* t, size_t i, size_t n, size_t& k) {
+        if (!q.step) {
+          k = 0;
+          return n;
+        }
+        k = (size_t)((t[i] - q.t0) / q.step);
+        return (size_t)(std::lower_bound(t + i, t + n, q.t0 + (int64_t)(k + 1) * q.step) - t);
+      };
+      if (p.tier == Raw) {
+        rows[w][Raw] += store_.scan(id, p.from, p.to - 1, 1u << ch, [&](const ColumnView& c) {
+          for (size_t i = 0, j, k; i < c.n; i = j) {
+            j = bucketEnd(c.t, i, c.n, k);
+            aggregate(c.v[ch] + i, j - i, cell[k]);
+            if (hcell) {
+              for (size_t x = i; x < j; x++) {
+                if (c.v[ch][x] != kMissing) hcell[k].add(c.v[ch][x]);
+              }
+            }
+          }
+        });
+      } else {
+        rows[w][p.tier] += store_.scanRollups(id, p.tier, p.from, p.to - 1, 1u << ch, [&](const RollupView& c) {
+          for (size_t i = 0, j, k; i < c.n; i = j) {
+            j = bucketEnd(c.t, i, c.n, k);
+            aggregate(c.min[ch] + i, c.max[ch] + i, c.count[ch] + i, c.sum[ch] + i, j - i, cell[k]);
+          }
+        });
+      }
+    });
+  }
+  r.tasks = tasks.size();
+  r.steals = pool_.run(tasks);
+
+  // Merge the workers' cells
+  r.cells.resize(cells);
+  for (size_t i = 0; i < cells; i++) {
+    Acc a;
+    Histogram h;
+    for (size_t w = 0; w < workers; w++) {
+      const Acc& b = acc[w][i];
+      a.count += b.count;
+      a.sum += b.sum;
+      a.min = std::min(a.min, b.min);
+      a.max = std::max(a.max, b.max);
+      if (wantPct) h.merge(hist[w][i]);
+    }
+    Cell& c = r.cells[i];
+    c.count = a.count;
+    c.sum = a.sum;
+    if (a.count) {
+      c.min = (int16_t)a.min;
+      c.max = (int16_t)a.max;
+    }
+    for (double p : q.percentiles) {
+      const uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(p * a.count));
+      c.percentiles.push_back(a.count ? h.at(std::min(rank, a.count)) : kMissing);
+    }
+  }
+  for (size_t w = 0; w < workers; w++) {
+    for (int k = 0; k < kTiers; k++) r.rows[k] += rows[w][k];
+  }
+  return r;
+}
@@ -0,0 +1,85 @@
+/**
+ * Fleet Store Queries
+ *
+ * Aggregates one channel over many devices, per group of devices (a bench,
+ * a site) and per time bucket: count, min, max, mean and optionally exact
+ * percentiles of the valid samples, e.g. mean soil moisture per bench per
+ * hour over the last 30 days.
+ *
+ * Planning: the coarsest tier whose buckets never straddle a query bucket
+ * (its width divides the step and t0) is used for the bulk of each
+ * device's range. The ragged ends, and the recent part that tier has not
+ * rolled up yet, come from the tiers below, down to raw samples. Rollups
+ * keep sums and counts, so results are the same as from raw samples
+ * whichever tier serves them. A device skips a tier that is not much
+ * sparser than the one below it (5-minute readings make 1 min rollups as
+ * many rows as the samples). Percentiles need the samples themselves and
+ * always read raw.
+ *
+ * Execution: each device's pieces are cut at segment spans
+ * (Options::segmentSpan) into tasks for a work-stealing TaskPool. Each
+ * worker aggregates into its own cells with SSE2 kernels over the decoded
+ * columns, and the cells are merged when the batch is done.
+ */
+
+#pragma once
+#include "FleetStore.h"
+#include "TaskPool.h"
+#include <cmath>
+
+namespace FleetDb {
+
+  struct Query {
+    Channel  channel = Soil;
+    int64_t  t0 = 0;                                // Inclusive range (Unix seconds)
+    int64_t  t1 = 0;
+    int64_t  step = 0;                              // Bucket width in seconds, 0 = one bucket
+    std::vector<uint64_t> devices;                  // Empty = every device in the store
+    std::vector<uint32_t> groups;                   // Group of each device (empty: all in group 0)
+    std::vector<double>   percentiles;              // Fractions, e.g. 0.5 and 0.95
+    int      maxTier = kTiers - 1;                  // Coarsest tier allowed
+  };
+
+  struct Cell {
+    uint64_t count = 0;                             // Valid samples
+    int64_t  sum = 0;
+    int16_t  min = kMissing;                        // kMissing when count is 0
+    int16_t  max = kMissing;
+    std::vector<int16_t> percentiles;               // Nearest rank, as Query::percentiles
+
+    double mean() const { return count ? (double)sum / count : NAN; }
+  };
+
+  struct QueryResult {
+    size_t   groups = 0;
+    size_t   buckets = 0;
+    std::vector<Cell> cells;                        // Group-major
+    Tier     tier = Raw;                            // Coarsest tier the plan allowed
+    uint64_t rows[kTiers] = {};                     // Rows read per tier
+    size_t   tasks = 0;
+    uint64_t steals = 0;
+
+    const Cell& at(size_t group, size_t bucket) const { return cells[group * buckets + bucket]; }
+  };
+
+  class QueryEngine {
+  public:
+    /**
+     * @param threads Pool size (0: one per core)
+     */
+    explicit QueryEngine(const Store& store, size_t threads = 0);
+
+    QueryResult run(const Query& q);
+
+    /**
+     * Coarsest tier whose buckets fit inside the query's buckets
+     */
+    static Tier plan(const Query& q);
+
+    size_t threads() const { return pool_.size(); }
+
+  private:
+    const Store& store_;
+    TaskPool     pool_;
+  };
+}
@@ -0,0 +1,140 @@
+/**
+ * Fleet Store Segment Implementation
+ */
+
+#include "Segment.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace FleetDb;
+
+namespace {
+
+struct Trailer {
+  uint32_t magic;
+  uint32_t count;
+  uint64_t indexOffset;
+};
+
+const uint32_t kTrailerMagic = 0x58444946;  // "FIDX"
+
+bool writeAll(int fd, const void* p, size_t len, uint64_t at) {
+  const uint8_t* b = (const uint8_t*)p;
+  while (len) {
+    const ssize_t w = pwrite(fd, b, len, (off_t)at);
+    if (w <= 0) return false;
+    b += w;
+    at += w;
+    len -= w;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool Segment::mapFile(size_t len) {
+  mapLen_ = len ? len : 1;
+  void* m = mmap(nullptr, mapLen_, PROT_READ, MAP_SHARED, fd_, 0);
+  if (m == MAP_FAILED) return false;
+  map_ = (uint8_t*)m;
+  return true;
+}
+
+std::unique_ptr<Segment> Segment::create(const std::string& path, size_t maxBlocks, size_t maxBlockBytes) {
+  std::unique_ptr<Segment> s(new Segment());
+  s->path_ = path;
+  s->fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (s->fd_ < 0) return nullptr;
+  s->maxBlocks_ = maxBlocks;
+  s->index_.reserve(maxBlocks);
+  // Room for every block plus the index and trailer; pages past the end of
+  // the file are never touched
+  if (!s->mapFile(maxBlocks * (maxBlockBytes + sizeof(BlockRef)) + sizeof(Trailer))) return nullptr;
+  return s;
+}
+
+std::unique_ptr<Segment> Segment::open(const std::string& path) {
+  std::unique_ptr<Segment> s(new Segment());
+  s->path_ = path;
+  s->fd_ = ::open(path.c_str(), O_RDWR);
+  struct stat st;
+  if (s->fd_ < 0 || fstat(s->fd_, &st) < 0) return nullptr;
+  const uint64_t len = (uint64_t)st.st_size;
+  if (!s->mapFile(len)) return nullptr;
+
+  Trailer tr{};
+  if (len >= sizeof tr) memcpy(&tr, s->map_ + len - sizeof tr, sizeof tr);
+  if (tr.magic == kTrailerMagic && tr.indexOffset + (uint64_t)tr.count * sizeof(BlockRef) + sizeof tr == len) {
+    s->index_.resize(tr.count);
+    memcpy(s->index_.data(), s->map_ + tr.indexOffset, tr.count * sizeof(BlockRef));
+    s->count_ = tr.count;
+    s->size_ = len;
+    s->sealed_ = true;
+    close(s->fd_);
+    s->fd_ = -1;
+    return s;
+  }
+
+  // Unsealed: walk the blocks, keep the valid prefix
+  uint64_t off = 0;
+  while (validBlock(s->map_ + off, len - off)) {
+    BlockHeader h;
+    memcpy(&h, s->map_ + off, sizeof h);
+    s->index_.push_back({h.tFirst, h.tLast, off, h.count, 0});
+    off += h.size();
+  }
+  s->count_ = s->index_.size();
+  s->size_ = off;
+  if (ftruncate(s->fd_, (off_t)off) < 0 || !s->seal()) return nullptr;
+  return s;
+}
+
+Segment::~Segment() {
+  if (map_) munmap(map_, mapLen_);
+  if (fd_ >= 0) close(fd_);
+}
+
+bool Segment::append(const uint8_t* block, size_t len) {
+  const size_t n = blockCount();
+  if (sealed_ || n >= maxBlocks_) return false;
+  if (!writeAll(fd_, block, len, size_)) return false;
+  BlockHeader h;
+  memcpy(&h, block, sizeof h);
+  index_.push_back({h.tFirst, h.tLast, size_, h.count, 0});      // Within capacity: no reallocation
+  size_ += len;
+  count_.store(n + 1, std::memory_order_release);
+  return true;
+}
+
+bool Segment::seal() {
+  if (sealed_) return true;
+  const Trailer tr{kTrailerMagic, (uint32_t)index_.size(), size_};
+  if (!writeAll(fd_, index_.data(), index_.size() * sizeof(BlockRef), size_) ||
+      !writeAll(fd_, &tr, sizeof tr, size_ + index_.size() * sizeof(BlockRef)) || fdatasync(fd_) < 0) {
+    return false;
+  }
+  size_ += index_.size() * sizeof(BlockRef) + sizeof tr;
+  sealed_ = true;
+  close(fd_);                                       // The map stays valid
+  fd_ = -1;
+  return true;
+}
+
+size_t Segment::seek(int64_t t) const {
+  size_t lo = 0, hi = blockCount();
+  while (lo < hi) {
+    const size_t mid = (lo + hi) / 2;
+    if (index_[mid].tLast < t) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+uint64_t Segment::samples() const {
+  uint64_t n = 0;
+  for (size_t i = 0, c = blockCount(); i < c; i++) n += index_[i].samples;
+  return n;
+}
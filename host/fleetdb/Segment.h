@@ -0,0 +1,98 @@
+/**
+ * Fleet Store Segment
+ *
+ * Append-only file of encoded blocks (Codec.h) for one device, read through
+ * a shared memory map. While a segment is active, blocks are appended with
+ * write() and published to readers through an atomic block count; the map
+ * covers the largest size the segment may reach, so it never moves. Sealing
+ * appends the sparse time index (one entry per block) and a trailer:
+ *
+ *   block* index[count] {tFirst, tLast, offset, samples} trailer {magic, count, indexOffset}
+ *
+ * Opening a segment without a trailer (the process stopped while it was
+ * active) walks the block headers, drops a torn last block and seals it.
+ * A sealed segment keeps its map but not its file descriptor, so a store
+ * with many devices only holds descriptors for the active segments.
+ */
+
+#pragma once
+#include "Codec.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace FleetDb {
+
+  struct BlockRef {
+    int64_t  tFirst;
+    int64_t  tLast;
+    uint64_t offset;
+    uint32_t samples;
+    uint32_t reserved;
+  };
+
+  class Segment {
+  public:
+    /**
+     * Start an empty segment for up to maxBlocks blocks
+     * @param maxBlockBytes Largest block that will be appended
+     * @return nullptr on an I/O error
+     */
+    static std::unique_ptr<Segment> create(const std::string& path, size_t maxBlocks, size_t maxBlockBytes);
+
+    /**
+     * Open an existing segment (recovering and sealing an unsealed one)
+     */
+    static std::unique_ptr<Segment> open(const std::string& path);
+
+    ~Segment();
+
+    /**
+     * Append one encoded block (single writer)
+     * @return false when the segment is full or sealed, or on an I/O error
+     */
+    bool append(const uint8_t* block, size_t len);
+
+    /**
+     * Write the index and trailer; the segment is read-only afterwards
+     */
+    bool seal();
+
+    /**
+     * Blocks readable now (safe to call while another thread appends)
+     */
+    size_t blockCount() const { return count_.load(std::memory_order_acquire); }
+    const BlockRef& block(size_t i) const { return index_[i]; }
+    const uint8_t* blockData(size_t i) const { return map_ + index_[i].offset; }
+
+    /**
+     * First block that may hold samples at or after t
+     */
+    size_t seek(int64_t t) const;
+
+    bool sealed() const { return sealed_; }
+    bool full() const { return blockCount() >= maxBlocks_; }
+    const std::string& path() const { return path_; }
+    void setPath(const std::string& path) { path_ = path; }
+    uint64_t bytes() const { return size_; }
+    uint64_t samples() const;
+    int64_t tFirst() const { return blockCount() ? index_[0].tFirst : 0; }
+    int64_t tLast() const { return blockCount() ? index_[blockCount() - 1].tLast : 0; }
+
+  private:
+    Segment() = default;
+
+    std::string path_;
+    int         fd_ = -1;
+    uint8_t*    map_ = nullptr;
+    size_t      mapLen_ = 0;
+    uint64_t    size_ = 0;                          // Bytes written
+    bool        sealed_ = false;
+    size_t      maxBlocks_ = 0;
+    std::vector<BlockRef> index_;                   // Capacity fixed at creation: never reallocates
+    std::atomic<size_t>   count_{0};
+
+    bool mapFile(size_t len);
+  };
+}
@@ -0,0 +1,390 @@
+/**
+ * Fleet Store Series Implementation
+ */
+
+#include "Series.h"
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace FleetDb;
+
+namespace {
+
+std::vector<std::string> listDir(const std::string& dir) {
+  std::vector<std::string> names;
+  if (DIR* d = opendir(dir.c_str())) {
+    while (dirent* e = readdir(d)) {
+      if (e->d_name[0] != '.') names.push_back(e->d_name);
+    }
+    closedir(d);
+  }
+  return names;
+}
+
+bool endsWith(const std::string& s, const char* suffix) {
+  const size_t n = strlen(suffix);
+  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+/**
+ * Decode buffers for a scan (up to ~300 KB each for rollups). A thread
+ * reuses its own pair across scans; a scan started from inside another
+ * scan's callback gets fresh ones.
+ */
+template <class C>
+class ScanBuffers {
+public:
+  ScanBuffers() {
+    Slot& s = slot();
+    if (s.busy) {
+      own_.reset(new C);
+      ownHead_.reset(new C);
+      cols = own_.get();
+      head = ownHead_.get();
+      return;
+    }
+    if (!s.cols) {
+      s.cols.reset(new C);
+      s.head.reset(new C);
+    }
+    s.busy = taken_ = true;
+    cols = s.cols.get();
+    head = s.head.get();
+  }
+
+  ~ScanBuffers() {
+    if (taken_) slot().busy = false;
+  }
+
+  C* cols;
+  C* head;
+
+private:
+  struct Slot {
+    std::unique_ptr<C> cols, head;
+    bool busy = false;
+  };
+
+  static Slot& slot() {
+    thread_local Slot s;
+    return s;
+  }
+
+  std::unique_ptr<C> own_, ownHead_;
+  bool taken_ = false;
+};
+
+}  // namespace
+
+size_t SampleRows::maxBlockBytes() {
+  // Widest buckets: 4 prefix bits + 64 (time) or 17 (channel) payload bits
+  return sizeof(BlockHeader) + 4 * (1 + kChannels) + (kMaxBlock * 68 + 7) / 8 +
+         kChannels * ((kMaxBlock * 21 + 7) / 8);
+}
+
+size_t RollupRows::maxBlockBytes() {
+  // min and max as channels, count and sum 4 + 64 bits
+  return sizeof(BlockHeader) + 4 * (1 + 4 * kChannels) + (kMaxBlock * 68 + 7) / 8 +
+         kChannels * (2 * ((kMaxBlock * 21 + 7) / 8) + 2 * ((kMaxBlock * 68 + 7) / 8));
+}
+
+template <class Rows>
+std::string Series<Rows>::path(uint32_t first, uint32_t last) const {
+  char name[40];
+  snprintf(name, sizeof name, "/%08u-%08u.seg", first, last);
+  return dir_ + name;
+}
+
+template <class Rows>
+bool Series<Rows>::open(const std::string& dir, size_t blockRows, size_t segmentBlocks, int64_t maxSpan,
+                        int64_t reorder) {
+  std::lock_guard<std::mutex> lock(m_);
+  dir_ = dir;
+  blockRows_ = std::max<size_t>(1, std::min(blockRows, kMaxBlock));
+  segmentBlocks_ = std::max<size_t>(1, segmentBlocks);
+  maxSpan_ = std::max<int64_t>(1, maxSpan);
+  reorder_ = std::max<int64_t>(0, reorder);
+  if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST) return false;
+
+  std::vector<File> found;
+  for (const std::string& name : listDir(dir)) {
+    unsigned first, last;
+    if (endsWith(name, ".tmp")) {                   // Unfinished merge
+      unlink((dir + "/" + name).c_str());
+    } else if (endsWith(name, ".seg") && sscanf(name.c_str(), "%u-%u", &first, &last) == 2 && first <= last) {
+      found.push_back({nullptr, first, last});
+    }
+  }
+  // Widest range first among equal starts, so merged files win
+  std::sort(found.begin(), found.end(), [](const File& a, const File& b) {
+    return a.first != b.first ? a.first < b.first : a.last > b.last;
+  });
+  for (File& f : found) {
+    if (!files_.empty() && f.last <= files_.back().last) {
+      unlink(path(f.first, f.last).c_str());        // Source of a merge that completed
+      continue;
+    }
+    f.seg = Segment::open(path(f.first, f.last));
+    if (!f.seg) return false;
+    nextNo_ = std::max(nextNo_, f.last + 1);
+    if (f.seg->blockCount() == 0) {
+      unlink(path(f.first, f.last).c_str());
+      continue;
+    }
+    lastT_ = std::max(lastT_, f.seg->tLast());
+    files_.push_back(f);
+  }
+  blockT_ = lastT_;
+  return true;
+}
+
+/**
+ * Rows up to here are out of the reorder window or in a block (caller holds m_)
+ */
+template <class Rows>
+int64_t Series<Rows>::settled() const {
+  if (lastT_ == INT64_MIN) return INT64_MIN;
+  return std::max(blockT_, lastT_ - reorder_);
+}
+
+/**
+ * Encode the first rows of the head buffer into the active segment (caller
+ * holds m_)
+ */
+template <class Rows>
+bool Series<Rows>::writeBlock(size_t rows) {
+  rows = std::min(rows, head_.size());
+  if (rows == 0) return true;
+  std::vector<uint8_t> block;
+  encodeBlock(head_.data(), rows, block);
+  if (files_.empty() || files_.back().seg->sealed() || files_.back().seg->full() ||
+      head_[rows - 1].t - files_.back().seg->tFirst() > maxSpan_) {
+    if (!files_.empty() && !files_.back().seg->seal()) return false;
+    const uint32_t no = nextNo_++;
+    std::shared_ptr<Segment> s = Segment::create(path(no, no), segmentBlocks_, Rows::maxBlockBytes());
+    if (!s) return false;
+    files_.push_back({s, no, no});
+  }
+  if (!files_.back().seg->append(block.data(), block.size())) return false;
+  blockT_ = head_[rows - 1].t;
+  head_.erase(head_.begin(), head_.begin() + rows);
+  return true;
+}
+
+template <class Rows>
+bool Series<Rows>::accepts(int64_t t) const {
+  std::lock_guard<std::mutex> lock(m_);
+  if (t > lastT_) return true;
+  if (t <= settled()) return false;
+  auto it = std::lower_bound(head_.begin(), head_.end(), t, [](const Row& r, int64_t v) { return r.t < v; });
+  return it == head_.end() || it->t != t;
+}
+
+template <class Rows>
+bool Series<Rows>::append(const Row& r) {
+  std::lock_guard<std::mutex> lock(m_);
+  if (head_.capacity() == 0) head_.reserve(blockRows_);
+  if (r.t > lastT_) {
+    lastT_ = r.t;
+    head_.push_back(r);
+  } else {
+    if (r.t <= settled()) return false;
+    auto it = std::lower_bound(head_.begin(), head_.end(), r.t, [](const Row& h, int64_t v) { return h.t < v; });
+    if (it != head_.end() && it->t == r.t) return false;
+    head_.insert(it, r);
+  }
+  // Full blocks once enough rows have left the reorder window
+  if (head_.size() < blockRows_ || head_[blockRows_ - 1].t > settled()) return true;
+  return writeBlock(blockRows_);
+}
+
+template <class Rows>
+bool Series<Rows>::flush() {
+  std::lock_guard<std::mutex> lock(m_);
+  const int64_t until = settled();
+  const size_t rows =
+      std::upper_bound(head_.begin(), head_.end(), until, [](int64_t v, const Row& r) { return v < r.t; }) -
+      head_.begin();
+  for (size_t at = 0; at < rows; at += blockRows_) {
+    if (!writeBlock(std::min(blockRows_, rows - at))) return false;
+  }
+  return true;
+}
+
+template <class Rows>
+bool Series<Rows>::seal() {
+  std::lock_guard<std::mutex> lock(m_);
+  while (!head_.empty()) {
+    if (!writeBlock(blockRows_)) return false;
+  }
+  return files_.empty() || files_.back().seg->seal();
+}
+
+template <class Rows>
+int64_t Series<Rows>::lastT() const {
+  std::lock_guard<std::mutex> lock(m_);
+  return lastT_;
+}
+
+template <class Rows>
+int64_t Series<Rows>::settledT() const {
+  std::lock_guard<std::mutex> lock(m_);
+  return settled();
+}
+
+template <class Rows>
+int64_t Series<Rows>::headSince() const {
+  std::lock_guard<std::mutex> lock(m_);
+  return head_.empty() ? INT64_MAX : head_.front().t;
+}
+
+template <class Rows>
+uint64_t Series<Rows>::scan(int64_t t0, int64_t t1, uint32_t channels, const ScanFn& fn) const {
+  if (t1 < t0) return 0;
+  // Snapshot: segments with their published block counts, and the head
+  // rows in range, taken together so nothing is seen twice
+  std::vector<std::pair<std::shared_ptr<Segment>, size_t>> segs;
+  ScanBuffers<typename Rows::Columns> buffers;
+  typename Rows::Columns* const head = buffers.head;
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    for (const File& f : files_) {
+      if (f.seg->tLast() >= t0 && f.seg->tFirst() <= t1) segs.emplace_back(f.seg, f.seg->blockCount());
+    }
+    auto from = std::lower_bound(head_.begin(), head_.end(), t0, [](const Row& r, int64_t t) { return r.t < t; });
+    auto to = std::upper_bound(head_.begin(), head_.end(), t1, [](int64_t t, const Row& r) { return t < r.t; });
+    if (from < to) head->load(&*from, to - from);
+    else head->n = 0;
+  }
+
+  uint64_t visited = 0;
+  typename Rows::Columns* const cols = buffers.cols;
+  for (const auto& e : segs) {
+    const Segment& s = *e.first;
+    for (size_t b = s.seek(t0); b < e.second && s.block(b).tFirst <= t1; b++) {
+      decodeBlock(s.blockData(b), channels, *cols, t1);
+      const size_t from = std::lower_bound(cols->t, cols->t + cols->n, t0) - cols->t;
+      const size_t to = cols->n;
+      if (from < to) fn(cols->slice(from, to));
+      visited += to - from;
+    }
+  }
+  if (head->n) fn(head->slice(0, head->n));
+  return visited + head->n;
+}
+
+template <class Rows>
+SeriesStats Series<Rows>::stats() const {
+  std::lock_guard<std::mutex> lock(m_);
+  SeriesStats st;
+  if (!files_.empty()) {
+    st.tFirst = files_.front().seg->tFirst();
+    st.tLast = files_.back().seg->tLast();
+  }
+  for (const File& f : files_) {
+    st.segments++;
+    st.blocks += f.seg->blockCount();
+    st.rows += f.seg->samples();
+    st.bytes += f.seg->bytes();
+  }
+  return st;
+}
+
+/**
+ * Rewrite a run of sealed segments as full blocks in one new segment
+ */
+template <class Rows>
+bool Series<Rows>::merge(const std::vector<File>& run, File& out) {
+  std::vector<Row> rows;
+  std::unique_ptr<typename Rows::Columns> cols(new typename Rows::Columns());
+  for (const File& f : run) {
+    for (size_t b = 0; b < f.seg->blockCount(); b++) {
+      decodeBlock(f.seg->blockData(b), kAllChannels, *cols);
+      for (size_t i = 0; i < cols->n; i++) rows.push_back(row(*cols, i));
+    }
+  }
+  out.first = run.front().first;
+  out.last = run.back().last;
+  const std::string final = path(out.first, out.last), tmp = final + ".tmp";
+  const size_t blocks = (rows.size() + blockRows_ - 1) / blockRows_;
+  std::unique_ptr<Segment> s = Segment::create(tmp, blocks, Rows::maxBlockBytes());
+  if (!s) return false;
+  std::vector<uint8_t> block;
+  for (size_t at = 0; at < rows.size(); at += blockRows_) {
+    block.clear();
+    encodeBlock(&rows[at], std::min(blockRows_, rows.size() - at), block);
+    if (!s->append(block.data(), block.size())) return false;
+  }
+  if (!s->seal() || rename(tmp.c_str(), final.c_str()) < 0) {
+    unlink(tmp.c_str());
+    return false;
+  }
+  s->setPath(final);
+  out.seg = std::move(s);
+  return true;
+}
+
+template <class Rows>
+size_t Series<Rows>::compact() {
+  const uint64_t target = (uint64_t)blockRows_ * segmentBlocks_;
+  size_t replaced = 0;
+  for (size_t start = 0;;) {
+    // Next run: consecutive sealed segments within the target size and time
+    // span, at least two, or one whose blocks are mostly short
+    std::vector<File> run;
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      for (; start < files_.size() && run.empty(); start++) {
+        uint64_t rows = 0;
+        for (size_t j = start; j < files_.size() && files_[j].seg->sealed(); j++) {
+          const uint64_t n = files_[j].seg->samples();
+          if (rows + n > target || files_[j].seg->tLast() - files_[start].seg->tFirst() > maxSpan_) break;
+          rows += n;
+          run.push_back(files_[j]);
+        }
+        const bool sparse = run.size() == 1 && run[0].seg->blockCount() > (rows + blockRows_ - 1) / blockRows_ + 1;
+        if (run.size() < 2 && !sparse) run.clear();
+      }
+    }
+    if (run.empty()) return replaced;
+
+    File merged;
+    if (!merge(run, merged)) return replaced;
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      auto it = std::find_if(files_.begin(), files_.end(), [&](const File& f) { return f.seg == run[0].seg; });
+      const size_t at = it - files_.begin();
+      files_.erase(it, it + run.size());
+      files_.insert(files_.begin() + at, merged);
+      start = at + 1;
+    }
+    // Scans still holding the old segments keep their maps; the files go now
+    for (const File& f : run) {
+      if (f.first != merged.first || f.last != merged.last) unlink(f.seg->path().c_str());
+    }
+    replaced += run.size();
+  }
+}
+
+template <class Rows>
+size_t Series<Rows>::dropBefore(int64_t t) {
+  std::vector<File> dropped;
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    size_t n = 0;
+    while (n < files_.size() && files_[n].seg->sealed() && files_[n].seg->tLast() < t) n++;
+    dropped.assign(files_.begin(), files_.begin() + n);
+    files_.erase(files_.begin(), files_.begin() + n);
+  }
+  for (const File& f : dropped) unlink(f.seg->path().c_str());
+  return dropped.size();
+}
+
+template class FleetDb::Series<SampleRows>;
+template class FleetDb::Series<RollupRows>;
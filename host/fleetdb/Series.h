@@ -0,0 +1,165 @@
+/**
+ * Fleet Store Series
+ *
+ * The rows of one device at one resolution (raw samples or one rollup
+ * tier): a directory of segment files (Segment.h) plus a head buffer of rows
+ * not yet in a block. With a reorder window, a row up to that many seconds
+ * older than the newest still goes into the (sorted) head buffer; rows only
+ * leave it for a block once they are out of the window, so blocks never
+ * overlap.
+ *
+ *   <dir>/<first no>-<last no>.seg
+ *
+ * A segment written by append() gets one number (n-n). Compaction merges a
+ * run of small sealed segments, or one with mostly short blocks (from
+ * periodic flushes), into full blocks in a new file named after the range
+ * it replaces. No segment spans more than a set time, so retention, which
+ * deletes whole segments, keeps close to what it is asked for. The merged
+ * file is written as .tmp and renamed once sealed; opening the series
+ * deletes leftover .tmp files and any segment inside another's range, so a
+ * crash at any point neither loses nor duplicates rows.
+ *
+ * append(), flush() and seal() come from one writer thread; compact() and
+ * dropBefore() from one maintenance thread. Both only hold the series lock
+ * for bookkeeping, so neither blocks the other for long. Scans run
+ * concurrently on a snapshot.
+ */
+
+#pragma once
+#include "Segment.h"
+#include <functional>
+#include <mutex>
+
+namespace FleetDb {
+
+  /**
+   * Row kinds
+   */
+  struct SampleRows {
+    using Row = Sample;
+    using Columns = FleetDb::Columns;
+    using View = ColumnView;
+    static size_t maxBlockBytes();
+  };
+
+  struct RollupRows {
+    using Row = Rollup;
+    using Columns = RollupColumns;
+    using View = RollupView;
+    static size_t maxBlockBytes();
+  };
+
+  struct SeriesStats {
+    size_t   segments = 0;
+    size_t   blocks = 0;
+    uint64_t rows = 0;                              // In segments (not the head buffer)
+    uint64_t bytes = 0;
+    int64_t  tFirst = 0;                            // Time the segments cover
+    int64_t  tLast = 0;
+  };
+
+  template <class Rows>
+  class Series {
+  public:
+    using Row = typename Rows::Row;
+    using View = typename Rows::View;
+    using ScanFn = std::function<void(const View&)>;
+
+    /**
+     * Create the directory or load its segments
+     * @param blockRows Rows per block
+     * @param segmentBlocks Blocks per segment written by append()
+     * @param maxSpan Seconds from a segment's first row to its last, at most
+     * @param reorder Seconds a row may be older than the newest one (0: rows
+     *                come in time order)
+     */
+    bool open(const std::string& dir, size_t blockRows, size_t segmentBlocks, int64_t maxSpan,
+              int64_t reorder = 0);
+
+    /**
+     * Whether append() would take a row at time t: after settledT() and not
+     * a time the series has already
+     */
+    bool accepts(int64_t t) const;
+
+    /**
+     * Add a row
+     * @return false if accepts() is not true (the row is dropped) or on an
+     *         I/O error
+     */
+    bool append(const Row& r);
+
+    /**
+     * Encode the head rows out of the reorder window into a (possibly short)
+     * block
+     */
+    bool flush();
+
+    /**
+     * Flush and seal the active segment
+     */
+    bool seal();
+
+    /**
+     * Visit rows with t0 <= t <= t1 in time order, at most a block at a time
+     * @return Rows visited
+     */
+    uint64_t scan(int64_t t0, int64_t t1, uint32_t channels, const ScanFn& fn) const;
+
+    /**
+     * Time of the last row (INT64_MIN when empty)
+     */
+    int64_t lastT() const;
+
+    /**
+     * Rows up to this time are final: no later append() lands at or before
+     * it (INT64_MIN when empty)
+     */
+    int64_t settledT() const;
+
+    /**
+     * Time of the oldest row still in the head buffer (INT64_MAX when empty)
+     */
+    int64_t headSince() const;
+
+    SeriesStats stats() const;
+
+    /**
+     * Merge runs of small or sparsely filled sealed segments into full blocks
+     * @return Segments replaced
+     */
+    size_t compact();
+
+    /**
+     * Delete sealed segments whose rows all lie before t
+     * @return Segments deleted
+     */
+    size_t dropBefore(int64_t t);
+
+  private:
+    struct File {
+      std::shared_ptr<Segment> seg;
+      uint32_t first, last;                         // Segment numbers it covers
+    };
+
+    mutable std::mutex m_;
+    std::string dir_;
+    size_t   blockRows_ = 1024;
+    size_t   segmentBlocks_ = 64;
+    int64_t  maxSpan_ = INT64_MAX;
+    int64_t  reorder_ = 0;
+    std::vector<File> files_;                       // Oldest first; the last may be active
+    std::vector<Row>  head_;                        // Sorted by time
+    int64_t  lastT_ = INT64_MIN;
+    int64_t  blockT_ = INT64_MIN;                   // Last row written to a block
+    uint32_t nextNo_ = 0;
+
+    int64_t settled() const;
+    bool writeBlock(size_t rows);
+    std::string path(uint32_t first, uint32_t last) const;
+    bool merge(const std::vector<File>& run, File& out);
+  };
+
+  extern template class Series<SampleRows>;
+  extern template class Series<RollupRows>;
+}
@@ -0,0 +1,82 @@
+/**
+ * Fleet Store Task Pool Implementation
+ */
+
+#include "TaskPool.h"
+#include <algorithm>
+
+using namespace FleetDb;
+
+TaskPool::TaskPool(size_t threads) {
+  if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+  for (size_t i = 0; i < threads; i++) queues_.emplace_back(new Queue());
+  for (size_t i = 0; i < threads; i++) threads_.emplace_back(&TaskPool::worker, this, i);
+}
+
+TaskPool::~TaskPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& t : threads_) t.join();
+}
+
+uint64_t TaskPool::run(std::vector<Task>& tasks) {
+  if (tasks.empty()) return 0;
+  std::lock_guard<std::mutex> batch(runMutex_);
+  const size_t n = tasks.size(), w = queues_.size();
+  steals_ = 0;
+  remaining_ = n;
+  for (size_t i = 0; i < w; i++) {
+    std::lock_guard<std::mutex> lock(queues_[i]->m);
+    for (size_t k = i * n / w; k < (i + 1) * n / w; k++) queues_[i]->tasks.push_back(&tasks[k]);
+  }
+  std::unique_lock<std::mutex> lock(m_);
+  generation_++;
+  wake_.notify_all();
+  done_.wait(lock, [this] { return remaining_ == 0; });
+  return steals_;
+}
+
+TaskPool::Task* TaskPool::next(size_t i) {
+  {
+    Queue& own = *queues_[i];
+    std::lock_guard<std::mutex> lock(own.m);
+    if (!own.tasks.empty()) {
+      Task* t = own.tasks.front();
+      own.tasks.pop_front();
+      return t;
+    }
+  }
+  for (size_t k = 1; k < queues_.size(); k++) {
+    Queue& other = *queues_[(i + k) % queues_.size()];
+    std::lock_guard<std::mutex> lock(other.m);
+    if (!other.tasks.empty()) {
+      Task* t = other.tasks.back();
+      other.tasks.pop_back();
+      steals_++;
+      return t;
+    }
+  }
+  return nullptr;
+}
+
+void TaskPool::worker(size_t i) {
+  uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(m_);
+      wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) return;
+      seen = generation_;
+    }
+    while (Task* t = next(i)) {
+      (*t)(i);
+      if (--remaining_ == 0) {
+        std::lock_guard<std::mutex> lock(m_);
+        done_.notify_all();
+      }
+    }
+  }
+}
@@ -0,0 +1,63 @@
+/**
+ * Fleet Store Task Pool
+ *
+ * Fixed set of worker threads running batches of small tasks with work
+ * stealing. run() deals a batch out in contiguous runs, one per worker
+ * (neighbouring tasks, e.g. the pieces of one device, tend to stay on one
+ * thread). Each worker takes tasks from the front of its own queue; a
+ * worker whose queue is empty takes from the back of another's, so uneven
+ * tasks (a device with more history, a slow segment) do not leave threads
+ * idle at the end of a batch.
+ */
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FleetDb {
+
+  class TaskPool {
+  public:
+    using Task = std::function<void(size_t worker)>;
+
+    /**
+     * @param threads Workers (0: one per core)
+     */
+    explicit TaskPool(size_t threads = 0);
+    ~TaskPool();
+
+    size_t size() const { return queues_.size(); }
+
+    /**
+     * Run a batch and wait for all of it; batches from several threads run
+     * one after another
+     * @return Tasks that were stolen
+     */
+    uint64_t run(std::vector<Task>& tasks);
+
+  private:
+    struct Queue {
+      std::mutex         m;
+      std::deque<Task*>  tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex runMutex_;                           // One batch at a time
+    std::mutex m_;
+    std::condition_variable wake_, done_;
+    uint64_t generation_ = 0;                       // Batches started
+    bool     stop_ = false;
+    std::atomic<size_t>   remaining_{0};
+    std::atomic<uint64_t> steals_{0};
+
+    void worker(size_t i);
+    Task* next(size_t i);
+  };
+}
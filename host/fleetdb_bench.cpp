@@ -0,0 +1,497 @@
+/**
+ * Fleet Store Benchmark (host)
+ *
+ * Writes synthetic fleet history (1 Hz per device: daily temperature and
+ * light cycles, soil dry-down with watering, sensor dropouts and reporting
+ * gaps) into a FleetDb::Store (host/fleetdb/), reopens it and checks every
+ * sample, then reports:
+ *   - ingest rate and bytes per sample on disk,
+ *   - full-scan rate (all channels and one channel), single- and
+ *     multi-threaded, against a memcpy of the decoded columns,
+ *   - latency of one-hour range queries through the sparse time index.
+ *
+ * With --compaction it instead ingests in simulated time, flushing every
+ * simulated minute as the collector does, once without and once with a
+ * Compactor running alongside (raw kept 2 days, 1 min rollups 5 days). A
+ * query thread asks for the latest hour of a random device throughout.
+ * It checks the retained raw samples and every 1 min, 1 h and 1 day rollup
+ * against the model, then reports ingest rate, query latency while
+ * ingesting, segments and bytes per tier, and the latency of the same
+ * 48 h window at each resolution.
+ *
+ * Build:  g++ -O2 -std=c++17 -pthread -Ihost host/fleetdb_bench.cpp host/fleetdb/Codec.cpp host/fleetdb/Segment.cpp host/fleetdb/Series.cpp host/fleetdb/FleetStore.cpp host/fleetdb/Compactor.cpp -o fleetdb_bench
+ * Usage:  fleetdb_bench [devices] [days] [dir]      (exit code 1 on a mismatch)
+ *         fleetdb_bench --compaction [devices] [days] [dir]
+ */
+
+#include "fleetdb/Compactor.h"
+#include "fleetdb/FleetStore.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace FleetDb;
+
+const int64_t kEpoch = 1767225600;     // 2026-01-01
+
+double seconds(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * Deterministic plant-bench environment for one device
+ */
+class DeviceModel {
+public:
+  explicit DeviceModel(int device) : rng_(device * 7919 + 1), device_(device) {}
+
+  Sample next() {
+    std::uniform_real_distribution<double> u(0, 1);
+    t_ += u(rng_) < 0.001 ? 1 + (int)(u(rng_) * 30) : 1;   // Occasional reporting gap
+    const double day = 2 * M_PI * ((t_ - kEpoch) % 86400) / 86400.0;
+    walk_ += (u(rng_) - 0.5) * 0.02;
+    soil_ -= 0.0004;
+    if (soil_ < 25 || u(rng_) < 1e-5) soil_ = 70 + device_ % 10;           // Watering
+    Sample s;
+    s.t = t_;
+    s.v[Temp] = (int16_t)std::lround((22 + 4 * std::sin(day - 2) + walk_) * 10);
+    s.v[Humidity] = (int16_t)std::lround((55 - 10 * std::sin(day - 2) + walk_ * 2) * 10);
+    s.v[Soil] = (int16_t)std::lround(soil_);
+    s.v[Light] = (int16_t)std::max(0L, std::lround(90 * std::sin(day - M_PI / 2)));
+    if (u(rng_) < 0.0005) s.v[Temp] = s.v[Humidity] = kMissing;           // DHT read error
+    return s;
+  }
+
+private:
+  std::mt19937 rng_;
+  int     device_;
+  int64_t t_ = kEpoch;
+  double  walk_ = 0, soil_ = 60;
+};
+
+uint64_t deviceId(int d) { return 0x24A1600000000000ull + d; }
+
+int64_t floorTo(int64_t t, int64_t width) { return t / width * width; }   // t >= 0 here
+
+/**
+ * Threads meeting at the end of each simulated minute; the last one to
+ * arrive runs the serial step before they all go on
+ */
+class Barrier {
+public:
+  explicit Barrier(int n) : n_(n) {}
+
+  template <class F>
+  void wait(F serial) {
+    std::unique_lock<std::mutex> lock(m_);
+    const uint64_t gen = gen_;
+    if (++arrived_ == n_) {
+      serial();
+      arrived_ = 0;
+      gen_++;
+      cv_.notify_all();
+    } else {
+      cv_.wait(lock, [&] { return gen_ != gen; });
+    }
+  }
+
+private:
+  std::mutex m_;
+  std::condition_variable cv_;
+  int      n_, arrived_ = 0;
+  uint64_t gen_ = 0;
+};
+
+double percentile(std::vector<double>& v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[std::min(v.size() - 1, (size_t)(p * v.size()))];
+}
+
+/**
+ * Expected rollups of one device's model history, built straight from the
+ * samples (not tier by tier as the store does)
+ */
+struct Expected {
+  std::vector<Rollup> tier[kTiers];                 // Minute, Hour, Day (Raw unused)
+  int64_t lastT = 0;
+
+  Expected(int device, int64_t end) {
+    DeviceModel model(device);
+    Rollup open[kTiers];
+    bool   started[kTiers] = {};
+    for (Sample s = model.next(); s.t < end; s = model.next()) {
+      lastT = s.t;
+      for (int k = Minute; k < kTiers; k++) {
+        const int64_t b = floorTo(s.t, kTierSeconds[k]);
+        if (!started[k] || open[k].t != b) {
+          if (started[k]) tier[k].push_back(open[k]);
+          open[k] = Rollup();
+          open[k].t = b;
+          for (int c = 0; c < kChannels; c++) open[k].min[c] = open[k].max[c] = kMissing;
+          started[k] = true;
+        }
+        for (int c = 0; c < kChannels; c++) {
+          const int16_t v = s.v[c];
+          if (v == kMissing) continue;
+          Rollup& r = open[k];
+          if (!r.count[c] || v < r.min[c]) r.min[c] = v;
+          if (!r.count[c] || v > r.max[c]) r.max[c] = v;
+          r.count[c]++;
+          r.sum[c] += v;
+        }
+      }
+    }
+    for (int k = Minute; k < kTiers; k++) {
+      if (started[k]) tier[k].push_back(open[k]);
+    }
+    // Only complete buckets are rolled up: up to the last raw sample for
+    // 1 min, up to the end of the last rollup below for the others
+    int64_t until = floorTo(lastT + 1, kTierSeconds[Minute]);
+    for (int k = Minute; k < kTiers; k++) {
+      while (!tier[k].empty() && tier[k].back().t >= until) tier[k].pop_back();
+      if (k + 1 < kTiers) {
+        until = tier[k].empty() ? 0 : floorTo(tier[k].back().t + kTierSeconds[k], kTierSeconds[k + 1]);
+      }
+    }
+  }
+};
+
+bool sameRollup(const RollupView& c, size_t i, const Rollup& r) {
+  bool ok = c.t[i] == r.t;
+  for (int k = 0; k < kChannels; k++) {
+    ok &= c.count[k][i] == r.count[k] && c.sum[k][i] == r.sum[k];
+    if (r.count[k]) ok &= c.min[k][i] == r.min[k] && c.max[k][i] == r.max[k];
+  }
+  return ok;
+}
+
+/**
+ * Simulated-time ingest with and without background compaction
+ */
+int compactionBench(int devices, double days, const std::string& dir) {
+  const int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+  const int64_t end = kEpoch + (int64_t)(days * 86400);
+  Options opt;
+  opt.retention[Raw] = 2 * 86400;
+  opt.retention[Minute] = 5 * 86400;
+
+  printf("%d devices x %.1f days at 1 Hz, flushed every simulated minute, %d ingest threads, store in %s\n"
+         "Retention: raw 2 days, 1 min rollups 5 days, 1 h and 1 day rollups kept\n\n",
+         devices, days, threads, dir.c_str());
+  printf("%-14s %8s %8s %8s %7s %9s %9s %9s %9s %9s %9s\n", "", "ingest", "1 h", "1 h", "", "48 h raw",
+         "raw", "raw", "1 min", "1 h", "1 day");
+  printf("%-14s %8s %8s %8s %7s %9s %9s %9s %9s %9s %9s\n", "", "M/s", "p50 us", "p99 us", "jobs", "us",
+         "segments", "B/sample", "segments", "segments", "segments");
+  int failures = 0;
+
+  for (int withCompactor = 0; withCompactor < 2; withCompactor++) {
+    if (system(("rm -rf '" + dir + "'").c_str()) != 0) return 1;
+    Store store(dir, opt);
+    if (!store.open()) { perror(dir.c_str()); return 1; }
+    std::atomic<int64_t> now{kEpoch};
+    Compactor::Config cfg;
+    cfg.threads = 2;
+    cfg.intervalMs = 100;
+    cfg.now = [&] { return now.load(); };
+    Compactor compactor(store, cfg);
+    if (withCompactor) compactor.start();
+
+    // Latest-hour queries from a client while ingest runs
+    std::atomic<bool> done{false};
+    std::vector<double> latency;
+    std::thread client([&] {
+      std::mt19937 rng(11);
+      while (!done) {
+        const int64_t t1 = now;
+        const auto t0 = std::chrono::steady_clock::now();
+        store.scan(deviceId((int)(rng() % devices)), t1 - 3600, t1, 1u << Temp, [](const ColumnView&) {});
+        latency.push_back(seconds(t0) * 1e6);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+
+    uint64_t ingested = 0;
+    std::mutex ingestedMutex;
+    Barrier barrier(threads);
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int w = 0; w < threads; w++) {
+      pool.emplace_back([&, w] {
+        std::vector<DeviceModel> models;
+        std::vector<Sample> pending;
+        for (int d = w; d < devices; d += threads) {
+          models.emplace_back(d);
+          pending.push_back(models.back().next());
+        }
+        uint64_t n = 0;
+        for (int64_t minute = kEpoch + 60; minute - 60 < end; minute += 60) {
+          const int64_t until = std::min(minute, end);
+          for (size_t m = 0; m < models.size(); m++) {
+            for (; pending[m].t < until; pending[m] = models[m].next(), n++) {
+              store.append(deviceId(w + (int)m * threads), pending[m]);
+            }
+          }
+          barrier.wait([&] {
+            store.flush();
+            now = until;
+          });
+        }
+        std::lock_guard<std::mutex> lock(ingestedMutex);
+        ingested += n;
+      });
+    }
+    for (auto& t : pool) t.join();
+    const double ingestS = seconds(t0);
+    done = true;
+    client.join();
+
+    // Let compaction catch up, then a final pass over the sealed store
+    if (withCompactor) {
+      store.close();
+      compactor.kick();
+      compactor.drain();
+    }
+    compactor.stop();
+    store.close();
+    const Stats st = store.stats();
+    const Compactor::Totals ct = compactor.totals();
+
+    // The last 48 hours of temperature at one resolution: rows and
+    // microseconds per query
+    auto last48h = [&](int k, double& us) {
+      const int queries = std::max(devices, 100);
+      std::mt19937 rng(5);
+      uint64_t rows = 0;
+      int64_t sum = 0;
+      const auto q0 = std::chrono::steady_clock::now();
+      for (int q = 0; q < queries; q++) {
+        const uint64_t id = deviceId((int)(rng() % devices));
+        if (k == Raw) {
+          rows += store.scan(id, end - 48 * 3600, end, 1u << Temp, [&](const ColumnView& c) {
+            for (size_t i = 0; i < c.n; i++) sum += c.v[Temp][i];
+          });
+        } else {
+          rows += store.scanRollups(id, (Tier)k, end - 48 * 3600, end, 1u << Temp, [&](const RollupView& c) {
+            for (size_t i = 0; i < c.n; i++) sum += c.sum[Temp][i];
+          });
+        }
+      }
+      us = seconds(q0) / queries * 1e6;
+      return (double)rows / queries;
+    };
+    double rawUs;
+    last48h(Raw, rawUs);
+    printf("%-14s %8.2f %8.1f %8.1f %7llu %9.1f %9zu %9.2f %9zu %9zu %9zu\n",
+           withCompactor ? "compaction" : "no compaction", ingested / ingestS / 1e6, percentile(latency, 0.5),
+           percentile(latency, 0.99), (unsigned long long)ct.jobs, rawUs, st.tier[Raw].segments,
+           (double)st.tier[Raw].bytes / std::max<uint64_t>(1, st.tier[Raw].rows), st.tier[Minute].segments,
+           st.tier[Hour].segments, st.tier[Day].segments);
+    if (st.rejected) failures++;
+    if (!withCompactor) continue;
+
+    // Retained raw samples and every rollup match the model
+    uint64_t bad = 0, rawSeen = 0, rollupSeen[kTiers] = {};
+    for (int d = 0; d < devices; d++) {
+      DeviceModel model(d);
+      Sample want = model.next();
+      store.scan(deviceId(d), INT64_MIN, INT64_MAX, kAllChannels, [&](const ColumnView& c) {
+        for (size_t i = 0; i < c.n; i++) {
+          while (want.t < c.t[i]) want = model.next();
+          bool ok = c.t[i] == want.t;
+          for (int k = 0; k < kChannels; k++) ok &= c.v[k][i] == want.v[k];
+          bad += !ok;
+          want = model.next();
+        }
+        rawSeen += c.n;
+      });
+
+      const Expected e(d, end);
+      for (int k = Minute; k < kTiers; k++) {
+        const std::vector<Rollup>& x = e.tier[k];
+        size_t at = 0;
+        bool first = true;
+        store.scanRollups(deviceId(d), (Tier)k, INT64_MIN, INT64_MAX, kAllChannels, [&](const RollupView& c) {
+          for (size_t i = 0; i < c.n; i++) {
+            if (first) {                             // 1 min rows before it were dropped
+              while (at < x.size() && x[at].t < c.t[i]) at++;
+              if (k != Minute && at) bad++;
+              first = false;
+            }
+            bad += at >= x.size() || !sameRollup(c, i, x[at]);
+            at++;
+          }
+          rollupSeen[k] += c.n;
+        });
+        if (at != x.size()) bad++;                   // Missing complete buckets at the end
+      }
+    }
+    // Raw rows older than 2 days and 1 min rows older than 5 days went,
+    // give or take a segment
+    const double rawDays = rawSeen / (86400.0 * devices), minuteDays = rollupSeen[Minute] / (1440.0 * devices);
+    printf("\nVerify      %llu raw samples (%.1f days per device), %llu/%llu/%llu 1 min/1 h/1 day rollups "
+           "(%.1f days of 1 min), %llu mismatched\n", (unsigned long long)rawSeen, rawDays,
+           (unsigned long long)rollupSeen[Minute], (unsigned long long)rollupSeen[Hour],
+           (unsigned long long)rollupSeen[Day], minuteDays, (unsigned long long)bad);
+    printf("Compactor   %llu jobs, %llu rollup rows, %llu segments merged, %llu dropped\n",
+           (unsigned long long)ct.jobs, (unsigned long long)ct.rollups, (unsigned long long)ct.merged,
+           (unsigned long long)ct.dropped);
+    if (bad || (days > 2.5 && rawDays > 2.5) || (days > 5.5 && minuteDays > 5.5)) failures++;
+
+    // The same window at each resolution
+    printf("\n%-8s %10s %12s %10s\n", "48 h", "rows", "latency us", "bytes/row");
+    const char* const names[kTiers] = {"raw", "1 min", "1 h", "1 day"};
+    for (int k = Raw; k < kTiers; k++) {
+      double us;
+      const double rows = last48h(k, us);
+      printf("%-8s %10.0f %12.1f %10.2f\n", names[k], rows, us,
+             (double)st.tier[k].bytes / std::max<uint64_t>(1, st.tier[k].rows));
+    }
+  }
+
+  printf("\n%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc > 1 && !strcmp(argv[1], "--compaction")) {
+    return compactionBench(argc > 2 ? atoi(argv[2]) : 20, argc > 3 ? atof(argv[3]) : 7,
+                           argc > 4 ? argv[4] : "fleetdb_bench.data");
+  }
+  const int devices = argc > 1 ? atoi(argv[1]) : 200;
+  const double days = argc > 2 ? atof(argv[2]) : 1;
+  const std::string dir = argc > 3 ? argv[3] : "fleetdb_bench.data";
+  const uint64_t perDevice = (uint64_t)(days * 86400);
+  const uint64_t total = perDevice * devices;
+  const int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+  if (system(("rm -rf '" + dir + "'").c_str()) != 0) return 1;
+
+  printf("%d devices x %.1f days at 1 Hz = %llu samples, %d threads, store in %s\n\n", devices, days,
+         (unsigned long long)total, threads, dir.c_str());
+  int failures = 0;
+
+  // Ingest: each thread feeds its devices in time order, interleaved as a
+  // collector sink would
+  {
+    Store store(dir);
+    if (!store.open()) { perror(dir.c_str()); return 1; }
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int w = 0; w < threads; w++) {
+      pool.emplace_back([&, w] {
+        std::vector<DeviceModel> models;
+        for (int d = w; d < devices; d += threads) models.emplace_back(d);
+        for (uint64_t i = 0; i < perDevice; i++) {
+          for (size_t m = 0; m < models.size(); m++) store.append(deviceId(w + (int)m * threads), models[m].next());
+        }
+      });
+    }
+    for (auto& t : pool) t.join();
+    store.close();
+    const double s = seconds(t0);
+    const Stats st = store.stats();
+    const SeriesStats& raw = st.tier[Raw];
+    printf("Ingest      %8.2f M samples/s   %llu segments, %.1f MB on disk = %.2f bytes/sample "
+           "(%.1fx smaller than 16-byte samples)\n", total / s / 1e6, (unsigned long long)raw.segments,
+           raw.bytes / 1e6, (double)raw.bytes / total, 16.0 * total / raw.bytes);
+    if (raw.rows != total || st.rejected) failures++;
+  }
+
+  Store store(dir);
+  if (!store.open()) { perror(dir.c_str()); return 1; }
+
+  // Every sample comes back as written
+  {
+    uint64_t bad = 0, seen = 0;
+    for (int d = 0; d < devices; d++) {
+      DeviceModel model(d);
+      store.scan(deviceId(d), INT64_MIN, INT64_MAX, kAllChannels, [&](const ColumnView& c) {
+        for (size_t i = 0; i < c.n; i++) {
+          const Sample want = model.next();
+          bool ok = c.t[i] == want.t;
+          for (int k = 0; k < kChannels; k++) ok &= c.v[k][i] == want.v[k];
+          bad += !ok;
+        }
+        seen += c.n;
+      });
+    }
+    printf("Verify      %llu samples read back, %llu mismatched\n", (unsigned long long)seen, (unsigned long long)bad);
+    if (bad || seen != total) failures++;
+  }
+
+  // Full scans (page cache warm after the verify pass)
+  auto fullScan = [&](uint32_t channels, int nThreads) {
+    std::atomic<int64_t> sum{0};
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int w = 0; w < nThreads; w++) {
+      pool.emplace_back([&, w] {
+        int64_t local = 0;
+        for (int d = w; d < devices; d += nThreads) {
+          store.scan(deviceId(d), INT64_MIN, INT64_MAX, channels, [&](const ColumnView& c) {
+            for (int k = 0; k < kChannels; k++) {
+              if (channels >> k & 1) {
+                for (size_t i = 0; i < c.n; i++) local += c.v[k][i];
+              }
+            }
+          });
+        }
+        sum += local;
+      });
+    }
+    for (auto& t : pool) t.join();
+    return seconds(t0);
+  };
+  const double decodedBytes = 16.0 * total;          // t + four int16 columns
+  {
+    std::vector<uint8_t> a((size_t)decodedBytes), b((size_t)decodedBytes);
+    memset(a.data(), 1, a.size());
+    memset(b.data(), 2, b.size());
+    const auto t0 = std::chrono::steady_clock::now();
+    memcpy(b.data(), a.data(), a.size());
+    const double s = seconds(t0);
+    printf("memcpy      %8.2f GB/s (decoded size %.0f MB)\n", decodedBytes / s / 1e9, decodedBytes / 1e6);
+  }
+  struct ScanCase { const char* name; uint32_t channels; int threads; };
+  const ScanCase scans[] = {
+    {"all channels, 1 thread", kAllChannels, 1},
+    {"soil only, 1 thread", 1u << Soil, 1},
+    {"all channels, all threads", kAllChannels, threads},
+  };
+  for (const ScanCase& k : scans) {
+    const double s = fullScan(k.channels, k.threads);
+    printf("Scan        %8.1f M samples/s  %6.2f GB/s decoded   %s\n", total / s / 1e6, decodedBytes / s / 1e9, k.name);
+  }
+
+  // One-hour windows at random places
+  {
+    std::mt19937 rng(5);
+    const int queries = 2000;
+    uint64_t got = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int q = 0; q < queries; q++) {
+      const int d = (int)(rng() % devices);
+      const int64_t from = kEpoch + (int64_t)(rng() % std::max<uint64_t>(1, perDevice - 3600));
+      got += store.scan(deviceId(d), from, from + 3599, 1u << Temp, [](const ColumnView&) {});
+    }
+    const double s = seconds(t0);
+    printf("Range query %8.1f us per 1 h window (%.0f samples each)\n", s / queries * 1e6, (double)got / queries);
+  }
+
+  printf("\n%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * Flicker Detector Bench (host)
+ *
+ * Runs the firmware's fixed-point Goertzel flicker detector (src/Flicker.*)
+ * on synthetic LDR bursts (steady light, slow ramps, 100/120 Hz flicker at
+ * several modulation depths and noise levels) and checks each
+ * classification, then measures kernel throughput in samples per second.
+ *
+ * Build:  g++ -O2 -std=c++17 -Isrc host/flicker_bench.cpp src/Flicker.cpp -o flicker_bench
+ * Usage:  flicker_bench        (exit code 1 if any synthetic case is misclassified)
+ */
+
+#include "Flicker.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Mirrors the flicker settings in src/Config.h
+const float kRateHz = 1000.0f;
+const int   kSamples = 200;
+const float kMinRatio = 0.2f;
+const float kMinRms = 2.0f;
+const float kDarkMean = 40.0f;
+
+struct Case {
+  const char* name;
+  float mean;        // DC level in ADC codes
+  float depth;       // Flicker modulation depth (fraction of mean)
+  float flickerHz;   // 0 = none
+  float rampPerS;    // Slow drift in codes per second (clouds, dusk)
+  float noise;       // Gaussian noise sigma in codes
+  LightSource expect;
+};
+
+const Case kCases[] = {
+  {"steady sun",          2500, 0.00f,   0,    0, 1.5f, LightSource::Natural},
+  {"sun + clouds ramp",   2000, 0.00f,   0, 2000, 3.0f, LightSource::Natural},
+  {"dark",                  15, 0.00f,   0,    0, 1.0f, LightSource::Dark},
+  {"LED 100 Hz 20%",      2200, 0.20f, 100,    0, 3.0f, LightSource::Artificial},
+  {"LED 120 Hz 20%",      2200, 0.20f, 120,    0, 3.0f, LightSource::Artificial},
+  {"HPS 100 Hz 5%",       1800, 0.05f, 100,    0, 3.0f, LightSource::Artificial},
+  {"weak 120 Hz 1%",      3000, 0.01f, 120,    0, 2.0f, LightSource::Artificial},
+  {"sun + 2% LED 100 Hz", 3000, 0.02f, 100,  500, 4.0f, LightSource::Artificial},
+  {"noisy steady",        2000, 0.00f,   0,    0, 8.0f, LightSource::Natural},
+};
+
+/**
+ * Rectified-sine flicker (|sin| at mains frequency has its fundamental at
+ * twice mains), plus drift and noise, quantized to 12-bit codes.
+ */
+void synthesize(const Case& c, std::vector<int16_t>& out, std::mt19937& rng) {
+  std::normal_distribution<float> noise(0.0f, c.noise);
+  out.resize(kSamples);
+  for (int i = 0; i < kSamples; i++) {
+    const float t = i / kRateHz;
+    float v = c.mean + c.rampPerS * t;
+    if (c.flickerHz > 0) {
+      const float rect = fabsf(sinf((float)M_PI * c.flickerHz * t));   // period 1/flickerHz
+      v += c.mean * c.depth * (rect - 2.0f / (float)M_PI) * 2.0f;
+    }
+    v += noise(rng);
+    out[i] = (int16_t)std::min(4095.0f, std::max(0.0f, roundf(v)));
+  }
+}
+
+}  // namespace
+
+int main() {
+  FlickerDetector det(kRateHz, kSamples, kMinRatio, kMinRms, kDarkMean);
+  std::mt19937 rng(42);
+  std::vector<int16_t> burst;
+  int failures = 0;
+
+  printf("%-22s %8s %8s %8s %6s  %s\n", "case", "mean", "rms", "ratio", "class", "");
+  for (const Case& c : kCases) {
+    // Run several noise realisations per case; all must classify correctly
+    int wrong = 0;
+    FlickerResult last;
+    for (int trial = 0; trial < 50; trial++) {
+      synthesize(c, burst, rng);
+      last = det.analyze(burst.data(), kSamples);
+      if (last.source != c.expect) wrong++;
+    }
+    failures += wrong ? 1 : 0;
+    printf("%-22s %8.0f %8.2f %8.3f %6s  %s\n", c.name, last.mean, last.rms, last.ratio,
+           lightSourceName(last.source), wrong ? "MISCLASSIFIED" : "ok");
+    if (wrong) printf("  %d of 50 trials misclassified (expected %s)\n", wrong, lightSourceName(c.expect));
+  }
+
+  // Throughput: both Goertzel bins plus DC removal, as analyze() runs on device
+  synthesize(kCases[3], burst, rng);
+  std::vector<int16_t> work(kSamples);
+  const int iters = 200000;
+  volatile float sink = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < iters; i++) {
+    work = burst;
+    sink = sink + det.analyze(work.data(), kSamples).ratio;
+  }
+  const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  printf("\nanalyze(): %.1f ns/sample, %.1f Msamples/s, %.2f us per %d-sample burst\n",
+         s * 1e9 / ((double)iters * kSamples), (double)iters * kSamples / s / 1e6,
+         s * 1e6 / iters, kSamples);
+
+  const int64_t p = FlickerDetector::goertzelPower(burst.data(), kSamples,
+                                                   FlickerDetector::coeffQ14(100.0f, kRateHz));
+  printf("goertzelPower(100 Hz) on last burst: %lld\n", (long long)p);
+  return failures ? 1 : 0;
+}
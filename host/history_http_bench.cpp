@@ -0,0 +1,246 @@
+/**
+ * History Streaming Benchmark (host)
+ *
+ * Serves a week of 1 Hz history (604800 samples) through the firmware's
+ * chunked encoder (src/HistoryStream.*) over a loopback TCP connection,
+ * with the same non-blocking send loop as the device: one chunk buffer,
+ * refilled only after send() has taken all of it, and a small send buffer
+ * like lwIP's. A client thread decodes the chunked body and checks every
+ * record.
+ *
+ * Reports throughput for CSV and binary, LZSS-compressed bodies, a
+ * stepped query, and a slow client, where the encoder is throttled by EWOULDBLOCK instead of
+ * buffering.
+ *
+ * Build:  g++ -O2 -std=c++17 -pthread -Isrc host/history_http_bench.cpp src/HistoryStream.cpp src/History.cpp src/Lzss.cpp -o history_http_bench
+ * Usage:  history_http_bench [samples]     (exit code 1 if a check fails)
+ */
+
+#include "HistoryStream.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const size_t kChunkBytes = 1460;       // HTTP_CHUNK_BYTES
+const int    kSendBuffer = 5744;       // lwIP TCP_SND_BUF on the ESP32
+
+double seconds(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * A week of plausible readings at 1 Hz with occasional dropouts
+ */
+void fill(History& h, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    HistorySample s;
+    s.t = i;
+    const float day = sinf(i * 2.0f * (float)M_PI / 86400.0f);
+    s.tempC10 = (i % 5000 < 3) ? HistorySample::kNoValue : HistorySample::encode10(22.0f + 4.0f * day);
+    s.humidity10 = HistorySample::encode10(55.0f - 10.0f * day);
+    s.soilPct = (int8_t)(60 - (i / 3600) % 30);
+    s.lightPct = (int8_t)(day > 0 ? day * 100 : 0);
+    h.add(s);
+  }
+}
+
+struct Result {
+  uint64_t bodyBytes = 0;              // Decoded payload
+  uint64_t wireBytes = 0;              // Including headers and chunk framing
+  uint32_t records = 0;
+  uint32_t wouldBlock = 0;             // Sends refused by a full window
+  uint32_t badRecords = 0;
+  double   seconds = 0;
+};
+
+/**
+ * Client: read the whole response, decode chunks, check records
+ * Each record must be a later sample than the previous one, at least
+ * `step` seconds on, and decode to what fill() stored.
+ */
+void client(int fd, const History& h, const HistoryQuery& q, bool slow, Result& r) {
+  std::string all;
+  std::vector<char> buf(16384);
+  for (;;) {
+    const ssize_t n = recv(fd, buf.data(), slow ? 512 : buf.size(), 0);
+    if (n <= 0) break;
+    all.append(buf.data(), n);
+    if (slow) std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  r.wireBytes = all.size();
+
+  size_t pos = all.find("\r\n\r\n");
+  if (pos == std::string::npos) { r.badRecords++; return; }
+  pos += 4;
+  std::string body;
+  for (;;) {
+    const size_t eol = all.find("\r\n", pos);
+    if (eol == std::string::npos) { r.badRecords++; return; }
+    const size_t len = strtoul(all.c_str() + pos, nullptr, 16);
+    pos = eol + 2;
+    if (len == 0) break;
+    body.append(all, pos, len);
+    pos += len + 2;
+  }
+  if (q.compress) {
+    std::string plain;
+    LzssDecoder dec;
+    dec.feed((const uint8_t*)body.data(), body.size(), [&](uint8_t b) { plain += (char)b; });
+    body.swap(plain);
+  }
+  r.bodyBytes = body.size();
+
+  int64_t lastT = -1;
+  auto check = [&](uint32_t seq, uint32_t t, int16_t temp, int16_t hum, int8_t soil, int8_t light) {
+    HistorySample s;
+    const bool ok = h.bySeq(seq, s) && s.t == t && s.tempC10 == temp && s.humidity10 == hum &&
+                    s.soilPct == soil && s.lightPct == light && (int64_t)t > lastT &&
+                    (lastT < 0 || t - lastT >= q.step) && t >= q.from && t <= q.to;
+    if (!ok) r.badRecords++;
+    lastT = t;
+    r.records++;
+  };
+
+  if (q.format == HistoryQuery::Binary) {
+    const uint8_t* p = (const uint8_t*)body.data();
+    for (size_t i = 0; i + HistoryStream::kBinaryRecord <= body.size(); i += HistoryStream::kBinaryRecord) {
+      uint32_t seq, t;
+      int16_t temp, hum;
+      memcpy(&seq, p + i, 4);
+      memcpy(&t, p + i + 4, 4);
+      memcpy(&temp, p + i + 8, 2);
+      memcpy(&hum, p + i + 10, 2);
+      check(seq, t, temp, hum, (int8_t)p[i + 12], (int8_t)p[i + 13]);
+    }
+  } else {
+    size_t line = body.find("\r\n") + 2;           // Skip the header row
+    while (line < body.size()) {
+      const size_t eol = body.find("\r\n", line);
+      char f[6][16] = {};
+      int col = 0, k = 0;
+      for (size_t i = line; i < eol && col < 6; i++) {
+        if (body[i] == ',') { col++; k = 0; }
+        else if (k < 15) f[col][k++] = body[i];
+      }
+      auto tenths = [](const char* s) { return *s ? (int16_t)lroundf(strtof(s, nullptr) * 10) : HistorySample::kNoValue; };
+      check(strtoul(f[0], nullptr, 10), strtoul(f[1], nullptr, 10), tenths(f[2]), tenths(f[3]),
+            *f[4] ? (int8_t)atoi(f[4]) : -1, *f[5] ? (int8_t)atoi(f[5]) : -1);
+      line = eol + 2;
+    }
+  }
+}
+
+/**
+ * Server: the device's send loop (HistoryServer::sendPending)
+ */
+Result serve(const History& h, const HistoryQuery& q, bool slow) {
+  int lfd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  bind(lfd, (sockaddr*)&addr, sizeof addr);
+  listen(lfd, 1);
+  socklen_t alen = sizeof addr;
+  getsockname(lfd, (sockaddr*)&addr, &alen);
+
+  Result r;
+  int cfd = socket(AF_INET, SOCK_STREAM, 0);
+  connect(cfd, (sockaddr*)&addr, sizeof addr);
+  const int sfd = accept(lfd, nullptr, nullptr);
+  setsockopt(sfd, SOL_SOCKET, SO_SNDBUF, &kSendBuffer, sizeof kSendBuffer);
+  setsockopt(sfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+  std::thread reader(client, cfd, std::cref(h), q, slow, std::ref(r));
+
+  const auto t0 = std::chrono::steady_clock::now();
+  HistoryStream stream(h, q);
+  static LzssEncoder lzss;
+  if (q.compress) stream.compressWith(&lzss);
+  uint8_t buf[kChunkBytes];
+  size_t len = snprintf((char*)buf, sizeof buf,
+                        "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\n"
+                        "Connection: close\r\n\r\n", stream.contentType());
+  size_t off = 0;
+  uint32_t wouldBlock = 0;
+  for (;;) {
+    if (off == len) {
+      len = stream.nextChunk(buf, sizeof buf);
+      off = 0;
+      if (len == 0) break;
+    }
+    const ssize_t n = send(sfd, buf + off, len - off, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n > 0) {
+      off += n;
+    } else if (n < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) {
+      wouldBlock++;
+      std::this_thread::sleep_for(std::chrono::microseconds(50));   // Next loop pass
+    } else {
+      break;
+    }
+  }
+  close(sfd);
+  reader.join();
+  r.seconds = seconds(t0);
+  r.wouldBlock = wouldBlock;
+  close(cfd);
+  close(lfd);
+  return r;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t n = argc > 1 ? (uint32_t)atoi(argv[1]) : 7 * 86400;
+  std::vector<HistorySample> storage(n);
+  History h(storage.data(), n);
+  fill(h, n);
+  int failures = 0;
+
+  struct Case { const char* name; const char* query; bool slow; uint32_t expect; };
+  const Case cases[] = {
+    {"csv, all",         "",                    false, n},
+    {"bin, all",         "fmt=bin",             false, n},
+    {"csv, z=1",         "z=1",                 false, n},
+    {"bin, z=1",         "fmt=bin&z=1",         false, n},
+    {"csv, step=60",     "step=60",             false, (n + 59) / 60},
+    {"bin, 1 day",       "fmt=bin&from=86400&to=172799", false, n >= 172800 ? 86400u : 0u},
+    {"bin, slow client", "fmt=bin&to=86399",    true,  n >= 86400 ? 86400u : n},
+  };
+
+  printf("History: %u samples (%.1f days at 1 Hz), chunk buffer %zu bytes\n\n",
+         n, n / 86400.0, kChunkBytes);
+  printf("%-18s %9s %11s %8s %8s %10s %6s\n", "query", "records", "wire bytes", "ms", "MB/s", "would-blk", "bad");
+  for (const Case& c : cases) {
+    HistoryQuery q;
+    if (!q.parse(c.query)) { printf("%s: query rejected\n", c.name); failures++; continue; }
+    const Result r = serve(h, q, c.slow);
+    printf("%-18s %9u %11llu %8.0f %8.1f %10u %6u\n", c.name, r.records, (unsigned long long)r.wireBytes,
+           r.seconds * 1000, r.wireBytes / r.seconds / 1e6, r.wouldBlock, r.badRecords);
+    if (r.badRecords || r.records != c.expect) failures++;
+  }
+
+  // Query parsing edge cases
+  HistoryQuery q;
+  if (q.parse("from=10&to=5")) failures++;
+  if (HistoryQuery().parse("fmt=xml")) failures++;
+  if (HistoryQuery().parse("step=-1")) failures++;
+  if (!HistoryQuery().parse("foo=bar&step=5")) failures++;
+  if (HistoryQuery().parse("z=2")) failures++;
+
+  printf("\n%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
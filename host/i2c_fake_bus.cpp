@@ -0,0 +1,257 @@
+/**
+ * I2C Fake-Bus Harness (host)
+ *
+ * Runs the firmware's I2C scheduler and SHT3x/BME280 drivers (src/I2CBus.*,
+ * src/I2CSensors.*) against simulated devices on a fake bus with a
+ * simulated clock. Devices NACK reads while converting, exactly like the
+ * real parts, so a driver that reads too early fails here too.
+ *
+ * Checks:
+ *   - decoded values (SHT3x encoding, BME280 datasheet example vectors)
+ *   - a sweep costs the longest conversion, not the sum
+ *   - the loop is never blocked longer than one transaction
+ *   - a device that stops answering is counted as an error and the
+ *     remaining devices keep working
+ *
+ * Build:  g++ -O2 -std=c++17 -Isrc host/i2c_fake_bus.cpp src/I2CBus.cpp src/I2CSensors.cpp -o i2c_fake_bus
+ * Usage:  i2c_fake_bus        (exit code 1 on any failed check)
+ */
+
+#include "I2CBus.h"
+#include "I2CSensors.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <map>
+
+namespace {
+
+uint32_t g_nowUs = 0;        // Simulated time
+int g_failures = 0;
+
+void check(bool ok, const char* what) {
+  printf("  [%s] %s\n", ok ? " ok " : "FAIL", what);
+  if (!ok) g_failures++;
+}
+
+/**
+ * Simulated device: answers transactions addressed to it
+ */
+class FakeDevice {
+public:
+  virtual ~FakeDevice() {}
+  virtual bool onWrite(const uint8_t* d, size_t n) = 0;
+  virtual bool onRead(uint8_t* d, size_t n) = 0;
+  bool attached = true;
+};
+
+/**
+ * Fake bus: routes transactions and charges 9 bit times per byte
+ * (plus start/address) to the simulated clock at 400 kHz.
+ */
+class FakeBus : public I2CTransport {
+public:
+  void attach(uint8_t addr, FakeDevice* d) { devs_[addr] = d; }
+
+  bool write(uint8_t addr, const uint8_t* data, size_t len) override {
+    FakeDevice* d = route(addr, len + 1);
+    return d && d->onWrite(data, len);
+  }
+  bool read(uint8_t addr, uint8_t* data, size_t len) override {
+    FakeDevice* d = route(addr, len + 1);
+    return d && d->onRead(data, len);
+  }
+  bool writeRead(uint8_t addr, const uint8_t* wr, size_t wrLen, uint8_t* rd, size_t rdLen) override {
+    FakeDevice* d = route(addr, wrLen + rdLen + 2);
+    return d && d->onWrite(wr, wrLen) && d->onRead(rd, rdLen);
+  }
+
+  uint32_t transactions = 0;
+  uint32_t longestUs = 0;
+
+private:
+  std::map<uint8_t, FakeDevice*> devs_;
+
+  FakeDevice* route(uint8_t addr, size_t bytes) {
+    const uint32_t us = (uint32_t)(bytes * 9 * 1000000 / 400000) + 5;
+    g_nowUs += us;
+    transactions++;
+    if (us > longestUs) longestUs = us;
+    auto it = devs_.find(addr);
+    return (it != devs_.end() && it->second->attached) ? it->second : nullptr;
+  }
+};
+
+class FakeSht3x : public FakeDevice {
+public:
+  float tempC = 23.45f, humidity = 56.7f;
+  uint32_t convertUs = 12500;            // Typical, below the 15.5 ms maximum
+
+  bool onWrite(const uint8_t* d, size_t n) override {
+    if (n != 2) return false;
+    cmd_ = (uint16_t)(d[0] << 8 | d[1]);
+    if (cmd_ == 0x2400) readyUs_ = g_nowUs + convertUs;
+    return true;
+  }
+  bool onRead(uint8_t* d, size_t n) override {
+    if (cmd_ == 0xF32D && n == 3) {
+      d[0] = 0x80; d[1] = 0x10; d[2] = Sht3x::crc8(d, 2);
+      return true;
+    }
+    if (cmd_ != 0x2400 || n != 6) return false;
+    if ((int32_t)(g_nowUs - readyUs_) < 0) return false;     // NACK while converting
+    const uint16_t t = (uint16_t)lroundf((tempC + 45.0f) * 65535.0f / 175.0f);
+    const uint16_t h = (uint16_t)lroundf(humidity * 65535.0f / 100.0f);
+    d[0] = t >> 8; d[1] = t & 0xFF; d[2] = Sht3x::crc8(d, 2);
+    d[3] = h >> 8; d[4] = h & 0xFF; d[5] = Sht3x::crc8(d + 3, 2);
+    cmd_ = 0;
+    return true;
+  }
+
+private:
+  uint16_t cmd_ = 0;
+  uint32_t readyUs_ = 0;
+};
+
+/**
+ * BME280 register model loaded with the datasheet's example calibration
+ * (section 8.1/8.2): adc_T = 519888 -> 25.08 C, adc_P = 415148 -> 100653 Pa.
+ */
+class FakeBme280 : public FakeDevice {
+public:
+  uint32_t convertUs = 8000;
+
+  FakeBme280() {
+    regs_[0xD0] = 0x60;
+    const uint16_t calib[12] = {27504, 26435, (uint16_t)-1000, 36477, (uint16_t)-10685, 3024,
+                                2855, 140, (uint16_t)-7, 15500, (uint16_t)-14600, 6000};
+    for (int i = 0; i < 12; i++) {
+      regs_[0x88 + 2 * i] = calib[i] & 0xFF;
+      regs_[0x89 + 2 * i] = calib[i] >> 8;
+    }
+    // Humidity coefficients of a typical part
+    regs_[0xA1] = 75;
+    regs_[0xE1] = 0x6A; regs_[0xE2] = 0x01;          // H2 = 362
+    regs_[0xE3] = 0;                                 // H3
+    regs_[0xE4] = 0x13; regs_[0xE5] = 0x25; regs_[0xE6] = 0x03;  // H4 = 309, H5 = 50
+    regs_[0xE7] = 30;                                // H6
+    setAdc(519888, 415148, 0x6A00);
+  }
+
+  void setAdc(int32_t t, int32_t p, int32_t h) {
+    adcT_ = t; adcP_ = p; adcH_ = h;
+  }
+
+  bool onWrite(const uint8_t* d, size_t n) override {
+    if (n < 1) return false;
+    ptr_ = d[0];
+    if (n == 2) {
+      regs_[d[0]] = d[1];
+      if (d[0] == 0xF4 && (d[1] & 0x03) == 0x01) readyUs_ = g_nowUs + convertUs;
+    }
+    return true;
+  }
+  bool onRead(uint8_t* d, size_t n) override {
+    if (ptr_ == 0xF7) {
+      // Data registers read back 0x80000 (skipped) until the conversion is done
+      const bool done = (int32_t)(g_nowUs - readyUs_) >= 0;
+      const int32_t t = done ? adcT_ : 0x80000, p = done ? adcP_ : 0x80000;
+      const uint8_t data[8] = {(uint8_t)(p >> 12), (uint8_t)(p >> 4), (uint8_t)(p << 4),
+                               (uint8_t)(t >> 12), (uint8_t)(t >> 4), (uint8_t)(t << 4),
+                               (uint8_t)(adcH_ >> 8), (uint8_t)adcH_};
+      memcpy(d, data, n < 8 ? n : 8);
+      return true;
+    }
+    for (size_t i = 0; i < n; i++) d[i] = regs_[(uint8_t)(ptr_ + i)];
+    return true;
+  }
+
+private:
+  uint8_t regs_[256] = {0};
+  uint8_t ptr_ = 0;
+  uint32_t readyUs_ = 0;
+  int32_t adcT_, adcP_, adcH_;
+};
+
+/**
+ * Run the loop in 100 us steps until a sweep completes
+ * @return Longest time spent inside one update() call, in us
+ */
+uint32_t runSweep(I2CScheduler& sched) {
+  uint32_t worstCallUs = 0;
+  for (int guard = 0; guard < 100000; guard++) {
+    const uint32_t before = g_nowUs;
+    const bool done = sched.update(g_nowUs / 1000);
+    worstCallUs = std::max(worstCallUs, g_nowUs - before);
+    if (done) return worstCallUs;
+    g_nowUs += 100;
+  }
+  return worstCallUs;
+}
+
+}  // namespace
+
+int main() {
+  FakeBus bus;
+  FakeSht3x fsht;
+  FakeBme280 fbme;
+  bus.attach(0x44, &fsht);
+  bus.attach(0x76, &fbme);
+
+  Sht3x sht;
+  Bme280 bme;
+  I2CScheduler sched(bus, 2000);
+  sched.add(&sht);
+  sched.add(&bme);
+
+  printf("probe\n");
+  check(sched.begin() == 2, "both devices found");
+
+  printf("sweep\n");
+  const uint32_t worstCall = runSweep(sched);
+  check(sht.valid() && fabsf(sht.tempC() - 23.45f) < 0.01f && fabsf(sht.humidity() - 56.7f) < 0.01f,
+        "SHT3x decodes 23.45 C / 56.7 %RH");
+  check(bme.valid() && fabsf(bme.tempC() - 25.08f) < 0.005f, "BME280 temperature 25.08 C (datasheet vector)");
+  check(fabsf(bme.pressureHpa() - 1006.53f) < 0.02f, "BME280 pressure 1006.53 hPa (datasheet vector)");
+  check(bme.humidity() > 0.0f && bme.humidity() < 100.0f, "BME280 humidity in range");
+  printf("  T %.2f C  RH %.2f %%  |  T %.2f C  P %.2f hPa  RH %.2f %%\n",
+         sht.tempC(), sht.humidity(), bme.tempC(), bme.pressureHpa(), bme.humidity());
+
+  printf("timing\n");
+  printf("  overlapped sweep %u ms, sequential %u ms, longest loop stall %u us\n",
+         sched.lastSweepMs(), sched.sequentialMs(), worstCall);
+  check(sched.sequentialMs() == 26, "sequential cost is the sum of conversions (16 + 10 ms)");
+  check(sched.lastSweepMs() <= 17, "sweep costs the longest conversion (16 ms)");
+  check(worstCall < 1000, "no update() call blocks for a conversion");
+
+  printf("sweep period\n");
+  const uint32_t t0 = g_nowUs / 1000;
+  check(!sched.pending(t0 + 1), "idle between sweeps");
+  g_nowUs = (t0 + 2000) * 1000;
+  check(sched.pending(g_nowUs / 1000), "next sweep due after the period");
+
+  printf("device failure\n");
+  fsht.attached = false;
+  fbme.setAdc(519888 + 1000, 415148, 0x6A00);
+  runSweep(sched);
+  check(sched.errors() == 1, "detached SHT3x counted as one error");
+  check(!sht.valid() && bme.valid() && bme.tempC() > 25.08f, "BME280 keeps updating");
+
+  // Throughput of the decode path (host-side reference for the on-device cost)
+  Bme280::Calib c{27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+                  75, 362, 0, 309, 50, 30};
+  float t, p, h, acc = 0;
+  const int n = 2000000;
+  clock_t start = clock();
+  for (int i = 0; i < n; i++) {
+    Bme280::compensate(c, 519888 + (i & 1023), 415148, 0x6A00, t, p, h);
+    acc += t + p + h;
+  }
+  const double s = (double)(clock() - start) / CLOCKS_PER_SEC;
+  printf("\nBME280 compensate: %.1f ns/call (checksum %.0f)\n", s * 1e9 / n, acc);
+
+  printf("\n%s\n", g_failures ? "FAILED" : "all checks passed");
+  return g_failures ? 1 : 0;
+}
@@ -0,0 +1,194 @@
+/**
+ * LZSS Tool (host)
+ *
+ * Decompresses history exports sent with the firmware's LZSS encoder
+ * (src/Lzss.*), and measures it on sensor data.
+ *
+ *   lzss_tool -d <capture> [out]   Decode a serial capture: the framed stream
+ *                                  after the "LZSS" line ('z' command)
+ *   lzss_tool -r <file> [out]      Decode a raw stream (/history?z=1 body)
+ *   lzss_tool -c <file> [out]      Compress a file to a raw stream
+ *   lzss_tool --bench [files...]   Ratio, throughput and transfer times for
+ *                                  the given files (exports, serial logs) or,
+ *                                  without files, a synthetic week of history
+ *
+ * Build:  g++ -O2 -std=c++17 -Isrc host/lzss_tool.cpp src/Lzss.cpp src/HistoryStream.cpp src/History.cpp -o lzss_tool
+ */
+
+#include "Lzss.h"
+#include "HistoryStream.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+double seconds(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+bool readFile(const char* path, Bytes& out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  uint8_t buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof buf, f)) > 0) out.insert(out.end(), buf, buf + n);
+  fclose(f);
+  return true;
+}
+
+bool writeFile(const char* path, const Bytes& data) {
+  FILE* f = path ? fopen(path, "wb") : stdout;
+  if (!f) return false;
+  fwrite(data.data(), 1, data.size(), f);
+  if (path) fclose(f);
+  return true;
+}
+
+/**
+ * Compress in 1460-byte output pieces, as the HTTP path does
+ */
+Bytes compress(const Bytes& in) {
+  static LzssEncoder enc;
+  enc.reset();
+  Bytes out;
+  uint8_t buf[1460];
+  size_t pos = 0;
+  while (!enc.done()) {
+    if (pos < in.size()) pos += enc.sink(in.data() + pos, in.size() - pos);
+    else enc.finish();
+    size_t n;
+    while ((n = enc.poll(buf, sizeof buf)) > 0) out.insert(out.end(), buf, buf + n);
+  }
+  return out;
+}
+
+Bytes decompress(const Bytes& in) {
+  Bytes out;
+  LzssDecoder dec;
+  dec.feed(in.data(), in.size(), [&](uint8_t b) { out.push_back(b); });
+  return out;
+}
+
+/**
+ * Extract the framed stream that follows an "LZSS" line in a capture
+ */
+bool unframe(const Bytes& capture, Bytes& raw) {
+  static const char kMarker[] = "LZSS\r\n";
+  const uint8_t* m = (const uint8_t*)kMarker;
+  auto it = std::search(capture.begin(), capture.end(), m, m + 6);
+  if (it == capture.end()) return false;
+  size_t pos = (it - capture.begin()) + 6;
+  while (pos < capture.size()) {
+    const size_t len = capture[pos++];
+    if (len == 0) return true;
+    if (pos + len > capture.size()) return false;
+    raw.insert(raw.end(), capture.begin() + pos, capture.begin() + pos + len);
+    pos += len;
+  }
+  return false;                                    // Truncated capture
+}
+
+/**
+ * A week of 1 Hz history as the device would export it (CSV and binary)
+ * Sensor-like: slow daily cycles, quantised noise, occasional dropouts.
+ */
+void syntheticExports(uint32_t n, Bytes& csv, Bytes& bin) {
+  std::vector<HistorySample> storage(n);
+  History h(storage.data(), n);
+  std::mt19937 rng(7);
+  std::normal_distribution<float> noise(0.0f, 0.08f);
+  float soil = 62;
+  for (uint32_t i = 0; i < n; i++) {
+    const float day = sinf(i * 2.0f * (float)M_PI / 86400.0f);
+    HistorySample s;
+    s.t = i;
+    s.tempC10 = (i % 20000 < 2) ? HistorySample::kNoValue : HistorySample::encode10(22.0f + 3.5f * day + noise(rng));
+    s.humidity10 = HistorySample::encode10(55.0f - 9.0f * day + 4 * noise(rng));
+    soil = i % 172800 == 0 ? 70 : soil - 0.0001f;                    // Watering every 2 days
+    s.soilPct = (int8_t)lroundf(soil + noise(rng));
+    s.lightPct = (int8_t)(day > 0 ? lroundf(day * 95 + 10 * noise(rng)) : 0);
+    h.add(s);
+  }
+
+  for (int format = 0; format < 2; format++) {
+    HistoryQuery q;
+    q.format = format ? HistoryQuery::Binary : HistoryQuery::Csv;
+    HistoryStream stream(h, q);
+    Bytes& out = format ? bin : csv;
+    uint8_t buf[1460];
+    size_t len;
+    while ((len = stream.nextChunk(buf, sizeof buf)) > 5) {      // Strip the chunk framing
+      const uint8_t* crlf = (const uint8_t*)memchr(buf, '\n', len);
+      out.insert(out.end(), crlf + 1, (const uint8_t*)buf + len - 2);
+    }
+  }
+}
+
+void bench(const char* name, const Bytes& in, int& failures) {
+  const auto t0 = std::chrono::steady_clock::now();
+  const Bytes z = compress(in);
+  const double enc = seconds(t0);
+  const auto t1 = std::chrono::steady_clock::now();
+  const Bytes back = decompress(z);
+  const double dec = seconds(t1);
+  const bool ok = back == in;
+  if (!ok) failures++;
+
+  // Transfer time at serial and Wi-Fi rates (10 bits per byte on a UART)
+  const double serial = 9600 / 10.0, wifi = 1.0e6;               // SERIAL_BAUD
+  printf("%-22s %10zu %9zu %6.2f:1 %7.1f %7.1f %8.1f %8.1f %7.2f %7.2f %s\n", name, in.size(), z.size(),
+         (double)in.size() / z.size(), in.size() / enc / 1e6, in.size() / dec / 1e6,
+         in.size() / serial, z.size() / serial, in.size() / wifi, z.size() / wifi, ok ? "ok" : "MISMATCH");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 3 && (!strcmp(argv[1], "-d") || !strcmp(argv[1], "-r") || !strcmp(argv[1], "-c"))) {
+    Bytes in;
+    if (!readFile(argv[2], in)) { fprintf(stderr, "cannot read %s\n", argv[2]); return 1; }
+    Bytes out;
+    if (!strcmp(argv[1], "-c")) {
+      out = compress(in);
+    } else if (!strcmp(argv[1], "-r")) {
+      out = decompress(in);
+    } else {
+      Bytes raw;
+      if (!unframe(in, raw)) { fprintf(stderr, "no complete LZSS stream in %s\n", argv[2]); return 1; }
+      out = decompress(raw);
+    }
+    return writeFile(argc > 3 ? argv[3] : nullptr, out) ? 0 : 1;
+  }
+
+  if (argc >= 2 && !strcmp(argv[1], "--bench")) {
+    int failures = 0;
+    printf("%-22s %10s %9s %8s %7s %7s %8s %8s %7s %7s\n", "input", "bytes", "lzss", "ratio",
+           "enc MB/s", "dec MB/s", "UART s", "z s", "WiFi s", "z s");
+    if (argc == 2) {
+      Bytes csv, bin;
+      syntheticExports(7 * 86400, csv, bin);
+      bench("week 1 Hz, CSV", csv, failures);
+      bench("week 1 Hz, binary", bin, failures);
+    }
+    for (int i = 2; i < argc; i++) {
+      Bytes in;
+      if (!readFile(argv[i], in)) { fprintf(stderr, "cannot read %s\n", argv[i]); return 1; }
+      const char* base = strrchr(argv[i], '/');
+      bench(base ? base + 1 : argv[i], in, failures);
+    }
+    printf("(Transfer times: UART at 9600 baud (SERIAL_BAUD), Wi-Fi at 1 MB/s; z = compressed)\n");
+    return failures ? 1 : 0;
+  }
+
+  fprintf(stderr, "usage: %s -d <capture> [out] | -r <file> [out] | -c <file> [out] | --bench [files...]\n", argv[0]);
+  return 2;
+}
@@ -0,0 +1,95 @@
+/**
+ * Palette Expansion Benchmark (host)
+ *
+ * Composes a typical UI frame into the firmware's 4-bpp PalFrame
+ * (src/PalFrame.*) and measures how fast it expands to RGB565: one nibble
+ * at a time vs the pixel-pair lookup table used for the DMA stripes.
+ * Also checks that both expansions produce identical output and prints
+ * the frame memory of each pixel format.
+ *
+ * Build:  g++ -O2 -std=c++17 -Isrc host/palette_bench.cpp src/PalFrame.cpp -o palette_bench
+ * Usage:  palette_bench [frames]     (exit code 1 if the expansions differ)
+ */
+
+#include "PalFrame.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const uint16_t kPalette[] = {0x0000, 0xFFFF, 0x7BEF, 0x07E0, 0xF800, 0xFFE0, 0x07FF, 0xFDA0, 0x001F};
+
+double seconds(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * Time one expansion function over whole frames, stripe by stripe
+ * @return Mega-pixels per second
+ */
+template <class F>
+double run(const PalFrame& f, uint16_t* stripe, int frames, F expand) {
+  const int rows = 8;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int n = 0; n < frames; n++) {
+    for (int y = 0; y < PalFrame::kHeight; y += rows) {
+      const int h = y + rows <= PalFrame::kHeight ? rows : PalFrame::kHeight - y;
+      expand(f.row(y), stripe, h * PalFrame::kStride);
+      asm volatile("" : : "r"(stripe) : "memory");   // Keep every stripe store
+    }
+  }
+  return (double)frames * PalFrame::kWidth * PalFrame::kHeight / seconds(t0) / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int frames = argc > 1 ? atoi(argv[1]) : 20000;
+
+  PaletteLut lut;
+  lut.set(kPalette, sizeof kPalette / sizeof kPalette[0]);
+
+  // A frame like the sensor screen: title, six rows of text, a colored bar
+  static PalFrame f;
+  f.clear(0);
+  f.text(6, 4, "SmartArium", 2, 1, 0);
+  const char* rows[] = {"Uptime:  86400 s", "Temp:    23.4 C", "Humid:   56.7 %",
+                        "Soil:    41 %", "Light:   87 % sun", "Root:    19.8 C"};
+  for (int i = 0; i < 6; i++) f.text(6, 26 + 16 * i, rows[i], 1, 1, 0);
+  f.fillRect(200, 30, 33, 90, 3);
+
+  // Both paths must produce the same panel-order pixels
+  std::vector<uint16_t> a(PalFrame::kWidth * PalFrame::kHeight), b(a.size());
+  lut.expandNaive(f.row(0), a.data(), PalFrame::kStride * PalFrame::kHeight);
+  lut.expand(f.row(0), b.data(), PalFrame::kStride * PalFrame::kHeight);
+  const bool same = memcmp(a.data(), b.data(), a.size() * 2) == 0;
+  printf("Expansion outputs %s\n", same ? "identical" : "DIFFER");
+
+  alignas(4) static uint16_t stripe[PalFrame::kWidth * 8];
+  const double naive = run(f, stripe, frames, [&](const uint8_t* s, uint16_t* d, int n) { lut.expandNaive(s, d, n); });
+  const double pair = run(f, stripe, frames, [&](const uint8_t* s, uint16_t* d, int n) { lut.expand(s, d, n); });
+
+  // Composition cost of the same frame
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int n = 0; n < frames / 10; n++) {
+    f.clear(0);
+    f.text(6, 4, "SmartArium", 2, 1, 0);
+    for (int i = 0; i < 6; i++) f.text(6, 26 + 16 * i, rows[i], 1, 1, 0);
+  }
+  const double composeUs = seconds(t0) / (frames / 10) * 1e6;
+
+  const int px = PalFrame::kWidth * PalFrame::kHeight;
+  printf("\nFrame memory (%dx%d):  RGB565 %d B, 8-bpp %d B, 4-bpp %d B\n",
+         PalFrame::kWidth, PalFrame::kHeight, px * 2, px, px / 2);
+  printf("Double buffer + 2 DMA stripes:  RGB565 %d B, 4-bpp %d B\n",
+         px * 4, px + 2 * PalFrame::kWidth * 8 * 2);
+  printf("\nExpansion (%d frames):\n", frames);
+  printf("  naive      %8.1f Mpx/s  %7.1f us/frame\n", naive, px / naive);
+  printf("  pair table %8.1f Mpx/s  %7.1f us/frame\n", pair, px / pair);
+  printf("  SPI @40MHz %8.1f Mpx/s  %7.1f us/frame (wire limit)\n", 2.5, px / 2.5);
+  printf("Compose (clear + 7 text lines): %.1f us/frame\n", composeUs);
+  return same ? 0 : 1;
+}
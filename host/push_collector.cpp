@@ -0,0 +1,346 @@
+/**
+ * UDP Push Collector (host)
+ *
+ * Collector side of the push protocol (src/PushProtocol.*). Receives Data
+ * datagrams from any number of devices on one UDP port, drops duplicates,
+ * acknowledges as the protocol asks and appends the readings to
+ * <out>/<device id>.csv (arrival order; seq is the datagram's).
+ *
+ *   push_collector [options]               Collect on PUSH_PORT
+ *     --port <n>         UDP port (default 4211)
+ *     --out <dir>        Output directory (default .)
+ *
+ *   push_collector --simulate [days]       Run simulated devices (the firmware's
+ *                                          Sender) against a Collector over a
+ *                                          simulated link with random and bursty
+ *                                          loss, outages, Wi-Fi down at the device
+ *                                          and reboots; checks that every reading is
+ *                                          delivered once or accounted as evicted
+ *
+ * Build:  g++ -O2 -std=c++17 -Isrc host/push_collector.cpp src/PushProtocol.cpp src/HistoryStream.cpp src/History.cpp src/Lzss.cpp -o push_collector
+ */
+
+#include "PushProtocol.h"
+#include "HistoryStream.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <netinet/in.h>
+#include <queue>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const uint16_t kDefaultPort = 4211;    // PUSH_PORT
+const size_t   kIpUdpHeader = 28;      // IPv4 + UDP, counted in the wire bytes
+
+/**
+ * Per-device receive state; hands new readings to `deliver` and Acks to `reply`
+ */
+class Collector {
+public:
+  using Deliver = std::function<void(uint64_t id, uint32_t seq, const HistorySample& s)>;
+  using Reply = std::function<void(const uint8_t* p, size_t len)>;
+
+  explicit Collector(Deliver deliver) : deliver_(deliver) {}
+
+  std::map<uint64_t, Push::Peer> peers;
+  uint32_t acks = 0;
+  uint32_t malformed = 0;
+
+  void onDatagram(const uint8_t* p, size_t len, const Reply& reply) {
+    Push::Header h;
+    if (!Push::parse(p, len, h) || h.type != Push::Data) { malformed++; return; }
+    Push::Peer& peer = peers[h.id];
+    bool ackNow = false;
+    if (peer.accept(h, ackNow)) {
+      for (int i = 0; i < h.count; i++) deliver_(h.id, h.seq, Push::record(p, i));
+    }
+    if (ackNow) {
+      uint8_t ack[Push::kAckSize];
+      reply(ack, peer.ack(h.id, ack));
+      acks++;
+    }
+  }
+
+private:
+  Deliver deliver_;
+};
+
+// =============================================================================
+// Collector
+// =============================================================================
+
+int runCollector(int argc, char** argv) {
+  uint16_t port = kDefaultPort;
+  std::string outDir = ".";
+  for (int i = 0; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--port")) port = (uint16_t)atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--out")) outDir = argv[i + 1];
+    else { fprintf(stderr, "unknown option %s\n", argv[i]); return 2; }
+  }
+
+  const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (fd < 0 || bind(fd, (sockaddr*)&addr, sizeof addr) < 0) { perror("bind"); return 1; }
+  printf("Collecting on UDP %u into %s\n", port, outDir.c_str());
+
+  std::map<uint64_t, FILE*> files;
+  Collector c([&](uint64_t id, uint32_t seq, const HistorySample& s) {
+    FILE*& f = files[id];
+    if (!f) {
+      char path[512];
+      snprintf(path, sizeof path, "%s/%016llx.csv", outDir.c_str(), (unsigned long long)id);
+      const bool fresh = access(path, F_OK) != 0;
+      f = fopen(path, "a");
+      if (!f) { perror(path); exit(1); }
+      if (fresh) fprintf(f, "%s\n", HistoryStream::csvHeader());
+      printf("device %016llx\n", (unsigned long long)id);
+    }
+    char row[HistoryStream::kMaxRow];
+    HistoryStream::csvRow(row, sizeof row, seq, s);
+    fprintf(f, "%s\n", row);
+  });
+
+  for (;;) {
+    uint8_t buf[2048];
+    sockaddr_in from{};
+    socklen_t fromLen = sizeof from;
+    const ssize_t n = recvfrom(fd, buf, sizeof buf, 0, (sockaddr*)&from, &fromLen);
+    if (n < 0) { perror("recvfrom"); return 1; }
+    c.onDatagram(buf, (size_t)n, [&](const uint8_t* p, size_t len) {
+      for (auto& e : files) fflush(e.second);      // Readings on disk before the device frees them
+      sendto(fd, p, len, 0, (sockaddr*)&from, fromLen);
+    });
+  }
+}
+
+// =============================================================================
+// Simulation
+// =============================================================================
+
+/**
+ * Datagram loss for one direction: independent (Bernoulli) or bursty
+ * (Gilbert-Elliott: a good and a bad state with their own loss rates)
+ */
+struct LossModel {
+  double lossGood = 0, lossBad = 0;
+  double toBad = 0, toGood = 1;        // State change probabilities per datagram
+  uint64_t outageFromMs = 0, outageToMs = 0;   // Link down entirely
+
+  bool bad = false;
+
+  bool drop(std::mt19937& rng, uint64_t nowMs) {
+    std::uniform_real_distribution<double> coin(0, 1);
+    bad = bad ? coin(rng) >= toGood : coin(rng) < toBad;
+    if (nowMs >= outageFromMs && nowMs < outageToMs) return true;
+    return coin(rng) < (bad ? lossBad : lossGood);
+  }
+};
+
+struct Case {
+  const char* name;
+  LossModel   loss;
+  int         batch;
+  uint32_t    offlineMs = 0;                   // Wi-Fi down for this long after 1 h: nothing sent or read
+  uint32_t    rebootMs = 0;                    // Devices restart this often (unacknowledged readings lost)
+};
+
+struct SimResult {
+  uint64_t offered = 0, delivered = 0, evicted = 0, rebootLost = 0, duplicates = 0, mismatched = 0, undrained = 0;
+  uint64_t datagrams = 0, retransmits = 0, acks = 0;
+  uint64_t upBytes = 0, downBytes = 0;
+  uint32_t p50Ms = 0, p99Ms = 0;
+};
+
+struct InFlight {
+  uint64_t at;
+  int      device;                     // -1: to the collector
+  std::vector<uint8_t> bytes;
+  bool operator>(const InFlight& o) const { return at > o.at; }
+};
+
+HistorySample sampleFor(int device, uint32_t i) {
+  HistorySample s;
+  s.t = i * 10;
+  s.tempC10 = (int16_t)(200 + device + i % 50);
+  s.humidity10 = (int16_t)(500 + i % 300);
+  s.soilPct = (int8_t)(i % 101);
+  s.lightPct = (int8_t)((i + device) % 101);
+  return s;
+}
+
+/**
+ * Devices report every 10 s and run their send loop every 100 ms; datagrams
+ * take 20-80 ms each way. Everything runs on a virtual clock.
+ */
+SimResult simulate(const Case& k, int devices, double days, uint32_t seed) {
+  const uint32_t kReportMs = 10000, kPollMs = 100;
+  const uint64_t kOfflineFromMs = 3600000;
+  const uint32_t perDevice = (uint32_t)(days * 86400000 / kReportMs);
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> delay(20, 80);
+  LossModel up = k.loss, down = k.loss;
+
+  auto boot = [&](int d) { return Push::Sender(0x24A160000000ull + d, (uint32_t)rng(), k.batch, 8, 3000, 60000); };
+  std::vector<Push::Sender> senders;
+  std::vector<uint32_t> added(devices, 0);         // Readings given to the current Sender
+  for (int d = 0; d < devices; d++) senders.push_back(boot(d));
+  std::vector<std::vector<uint32_t>> deliveredAt(devices, std::vector<uint32_t>(perDevice, 0));
+  std::vector<uint32_t> latencies;
+  SimResult r;
+  uint64_t now = 0;
+
+  Collector c([&](uint64_t id, uint32_t, const HistorySample& s) {
+    const int d = (int)(id - 0x24A160000000ull);
+    const uint32_t i = s.t / 10;
+    const HistorySample want = sampleFor(d, i);
+    if (d < 0 || d >= devices || i >= perDevice || s.tempC10 != want.tempC10 || s.humidity10 != want.humidity10 ||
+        s.soilPct != want.soilPct || s.lightPct != want.lightPct) {
+      r.mismatched++;
+      return;
+    }
+    if (deliveredAt[d][i]) { r.duplicates++; return; }
+    deliveredAt[d][i] = (uint32_t)(now + 1);
+    latencies.push_back((uint32_t)(now - (uint64_t)i * kReportMs));
+    r.delivered++;
+  });
+
+  std::priority_queue<InFlight, std::vector<InFlight>, std::greater<InFlight>> wire;
+  const uint64_t endMs = (uint64_t)perDevice * kReportMs;
+  const uint64_t drainMs = endMs + 30 * 60000;     // Let retransmissions finish
+  uint8_t buf[Push::kMaxDatagram];
+
+  for (now = 0; now < drainMs; now += kPollMs) {
+    const bool online = !(now >= kOfflineFromMs && now < kOfflineFromMs + k.offlineMs);
+    while (!wire.empty() && wire.top().at <= now) {
+      const InFlight f = wire.top();
+      wire.pop();
+      if (f.device < 0) {
+        c.onDatagram(f.bytes.data(), f.bytes.size(), [&](const uint8_t* p, size_t len) {
+          Push::Header h;
+          Push::parse(p, len, h);
+          r.downBytes += len + kIpUdpHeader;
+          if (!down.drop(rng, now)) wire.push({now + delay(rng), (int)(h.id - 0x24A160000000ull), {p, p + len}});
+        });
+      } else if (online) {
+        senders[f.device].onDatagram(f.bytes.data(), f.bytes.size(), (uint32_t)now);
+      }
+    }
+    for (int d = 0; d < devices; d++) {
+      // Devices do not report in lockstep
+      const uint64_t phase = (uint64_t)d * kReportMs / devices / kPollMs * kPollMs;
+      if (k.rebootMs && now > phase && now < endMs && (now - phase) % k.rebootMs == 0) {
+        const Push::Sender& old = senders[d];
+        r.rebootLost += added[d] - old.acked();
+        r.datagrams += old.sent();
+        r.retransmits += old.retransmits();
+        r.evicted += old.evicted();
+        senders[d] = boot(d);
+        added[d] = 0;
+      }
+      if (now >= phase && now < endMs + phase && (now - phase) % kReportMs == 0) {
+        const uint32_t i = (uint32_t)((now - phase) / kReportMs);
+        if (i < perDevice) {
+          senders[d].add(sampleFor(d, i), (uint32_t)now);
+          added[d]++;
+          r.offered++;
+        }
+      }
+      size_t len;
+      while (online && (len = senders[d].nextDatagram(buf, (uint32_t)now)) > 0) {
+        r.upBytes += len + kIpUdpHeader;
+        if (!up.drop(rng, now)) wire.push({now + delay(rng), -1, {buf, buf + len}});
+      }
+    }
+  }
+
+  for (auto& s : senders) {
+    r.datagrams += s.sent();
+    r.retransmits += s.retransmits();
+    r.evicted += s.evicted();
+    r.undrained += s.inFlight();
+  }
+  r.acks = c.acks;
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    r.p50Ms = latencies[latencies.size() / 2];
+    r.p99Ms = latencies[latencies.size() * 99 / 100];
+  }
+  return r;
+}
+
+int runSimulation(double days) {
+  const int devices = 20;
+  const LossModel none;
+  auto bernoulli = [](double p) { LossModel m; m.lossGood = p; return m; };
+  LossModel bursty;                    // ~6% average, in bursts of ~5 datagrams
+  bursty.lossGood = 0.01;
+  bursty.lossBad = 0.6;
+  bursty.toBad = 0.02;
+  bursty.toGood = 0.2;
+  LossModel outage = bernoulli(0.01);  // 20 min without a link: the window overflows
+  outage.outageFromMs = 3600000;
+  outage.outageToMs = outage.outageFromMs + 20 * 60000;
+
+  const Case cases[] = {
+    {"no loss",            none,             8},
+    {"1% loss",            bernoulli(0.01),  8},
+    {"5% loss",            bernoulli(0.05),  8},
+    {"10% loss",           bernoulli(0.10),  8},
+    {"20% loss",           bernoulli(0.20),  8},
+    {"30% loss",           bernoulli(0.30),  8},
+    {"bursty (G-E)",       bursty,           8},
+    {"1% loss, 20 min out", outage,          8},
+    {"Wi-Fi down 10 min",  bernoulli(0.01),  8, 10 * 60000},
+    {"Wi-Fi down 20 min",  bernoulli(0.01),  8, 20 * 60000},
+    {"1% loss, batch 1",   bernoulli(0.01),  1},
+    {"reboot every 10 min", bernoulli(0.01), 8, 0, 10 * 60000},
+  };
+
+  printf("Simulated fleet: %d devices, one reading per 10 s for %.1f days, window 8, RTO 3 s\n"
+         "Loss applies to both directions; wire bytes include IPv4/UDP headers\n\n", devices, days);
+  printf("%-20s %9s %7s %6s %7s %7s %6s %8s %8s %8s\n", "link", "readings", "deliv%", "dups", "retx%",
+         "evicted", "B/rdg", "acks/dg", "p50 s", "p99 s");
+  int failures = 0;
+  for (size_t i = 0; i < sizeof cases / sizeof cases[0]; i++) {
+    const Case& k = cases[i];
+    const SimResult r = simulate(k, devices, days, 1 + i);
+    printf("%-20s %9llu %7.3f %6llu %7.2f %7llu %6.1f %8.2f %8.1f %8.1f\n", k.name,
+           (unsigned long long)r.offered, 100.0 * r.delivered / r.offered, (unsigned long long)r.duplicates,
+           100.0 * r.retransmits / r.datagrams, (unsigned long long)r.evicted,
+           (double)(r.upBytes + r.downBytes) / r.delivered, (double)r.acks / r.datagrams,
+           r.p50Ms / 1000.0, r.p99Ms / 1000.0);
+    // Every reading arrives exactly once, or the device says it gave it up or
+    // rebooted before it was acknowledged (it may still have arrived, only its
+    // Ack was lost)
+    if (r.duplicates || r.mismatched || r.undrained || r.offered - r.delivered > r.evicted + r.rebootLost) failures++;
+    // Offline, the window holds 8 datagrams of readings (one per 10 s)
+    const bool overflows = k.loss.outageToMs != 0 || k.offlineMs > 8u * k.batch * 10000;
+    if (!overflows && r.evicted) failures++;
+  }
+
+  printf("\n%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 2 && !strcmp(argv[1], "--simulate")) return runSimulation(argc > 2 ? atof(argv[2]) : 1);
+  if (argc == 1 || argv[1][0] == '-') return runCollector(argc - 1, argv + 1);
+  fprintf(stderr, "usage: %s [--port n] [--out dir]\n"
+                  "       %s --simulate [days]\n", argv[0], argv[0]);
+  return 2;
+}
@@ -0,0 +1,379 @@
+/**
+ * Batch Recalibration Implementation
+ */
+
+#include "Recal.h"
+
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+int16_t sat16(int v) {
+  return (int16_t)(v < INT16_MIN ? INT16_MIN : v > INT16_MAX ? INT16_MAX : v);
+}
+
+}  // namespace
+
+namespace Recal {
+
+Isa best() {
+#ifdef __SSE2__
+  static const Isa isa = __builtin_cpu_supports("avx2") ? Isa::Avx2 : Isa::Sse2;
+  return isa;
+#else
+  return Isa::Scalar;
+#endif
+}
+
+const char* isaName(Isa isa) {
+  switch (isa) {
+    case Isa::Sse2: return "SSE2";
+    case Isa::Avx2: return "AVX2";
+    default:        return "scalar";
+  }
+}
+
+// =============================================================================
+// Map
+// =============================================================================
+
+/**
+ * The two orientations of mapConstrainBi() become one segment starting at
+ * the lower input
+ */
+Map::Map(int inA, int inB, int outMin, int outMax) {
+  n_ = 1;
+  if (inA == inB) {                                 // Degenerate: always outMin
+    x0_[0] = xMin_ = xMax_ = inA;
+    y0_[0] = outMin;
+    span_[0] = 1;
+    rise_[0] = 0;
+  } else if (inA < inB) {
+    x0_[0] = xMin_ = inA;
+    xMax_ = inB;
+    y0_[0] = outMin;
+    span_[0] = inB - inA;
+    rise_[0] = outMax - outMin;
+  } else {
+    x0_[0] = xMin_ = inB;
+    xMax_ = inA;
+    y0_[0] = outMax;
+    span_[0] = inA - inB;
+    rise_[0] = outMin - outMax;
+  }
+  prepare();
+}
+
+/**
+ * Each segment runs from one point to the next; an input on a point
+ * belongs to the segment starting there, as in batteryPercentFromMv()
+ */
+bool Map::setCurve(const Point* points, int n) {
+  if (n < 2 || n > kMaxPoints) return false;
+  for (int i = 1; i < n; i++) {
+    if (points[i].x <= points[i - 1].x) return false;
+  }
+  n_ = n - 1;
+  xMin_ = points[0].x;
+  xMax_ = points[n - 1].x;
+  for (int i = 0; i < n_; i++) {
+    x0_[i] = points[i].x;
+    y0_[i] = points[i].y;
+    span_[i] = points[i + 1].x - points[i].x;
+    rise_[i] = points[i + 1].y - points[i].y;
+  }
+  prepare();
+  return true;
+}
+
+/**
+ * Reciprocals for the kernels
+ * A segment divides d * |rise| (0 <= d <= span) by its span. With every
+ * such dividend below 2^bits and 2^l >= every span, multiplying by
+ * ceil(2^(bits + l) / span) and shifting right by bits + l gives the exact
+ * quotient (Granlund and Montgomery). One shift serves all segments; each
+ * reciprocal must fit 32 bits for the 32x32 multiplies.
+ */
+void Map::prepare() {
+  uint64_t top = 0;
+  int l = 0;
+  for (int i = 0; i < n_; i++) {
+    const uint64_t rise = (uint64_t)(rise_[i] < 0 ? -(int64_t)rise_[i] : rise_[i]);
+    if ((uint64_t)span_[i] * rise > top) top = (uint64_t)span_[i] * rise;
+    while ((1ull << l) < (uint64_t)span_[i]) l++;
+  }
+  int bits = 0;
+  while (bits < 64 && (top >> bits) != 0) bits++;
+  shift_ = bits + l;
+  vector_ = top < (1ull << 31) && shift_ < 63;
+  for (int i = 0; vector_ && i < n_; i++) {
+    const uint64_t m = ((1ull << shift_) + span_[i] - 1) / span_[i];
+    if (m > UINT32_MAX) vector_ = false;
+    magic_[i] = (uint32_t)m;
+  }
+}
+
+int Map::segment(int32_t x) const {
+  for (int i = n_ - 1; i > 0; i--) {
+    if (x >= x0_[i]) return i;
+  }
+  return 0;
+}
+
+/**
+ * Firmware arithmetic: (x - x0) * rise / span + y0, truncating division
+ */
+int Map::map(int x) const {
+  if (x < 0) return x;
+  x = x < xMin_ ? xMin_ : x > xMax_ ? xMax_ : x;
+  const int i = segment(x);
+  return y0_[i] + (int)((int64_t)(x - x0_[i]) * rise_[i] / span_[i]);
+}
+
+// =============================================================================
+// Kernels
+// =============================================================================
+
+#ifdef __SSE2__
+
+struct Kernels {
+  static const int kSeg = Map::kMaxPoints - 1;
+
+  /**
+   * Segment parameters in the form the kernels use
+   */
+  struct Table {
+    int n;
+    alignas(32) int32_t  x0[kSeg];
+    alignas(32) int32_t  y0[kSeg];
+    alignas(32) int32_t  rise[kSeg];                // |rise|
+    alignas(32) int32_t  neg[kSeg];                 // -1 where rise < 0
+    alignas(32) uint32_t magic[kSeg];
+
+    explicit Table(const Map& m) : n(m.n_), x0(), y0(), rise(), neg(), magic() {
+      for (int i = 0; i < n; i++) {
+        x0[i] = m.x0_[i];
+        y0[i] = m.y0_[i];
+        rise[i] = m.rise_[i] < 0 ? -m.rise_[i] : m.rise_[i];
+        neg[i] = m.rise_[i] < 0 ? -1 : 0;
+        magic[i] = m.magic_[i];
+      }
+    }
+  };
+
+  // ---------------------------------------------------------------------------
+  // SSE2: 4 lanes; no 32-bit min/max or multiply, so these are built
+  // from compares and 32x32->64 multiplies
+  // ---------------------------------------------------------------------------
+
+  struct Sse2 {
+    __m128i lo, hi, shift;
+    __m128i x0, y0, rise, neg, magic;               // Segment 0, broadcast
+    __m128i bound[kSeg];                            // Segment starts, broadcast
+    const Table* table;
+    int     n;
+  };
+
+  static __m128i select(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+  }
+
+  /**
+   * Low 32 bits of a * b for non-negative lanes
+   */
+  static __m128i mullo(__m128i a, __m128i b) {
+    const __m128i e = _mm_mul_epu32(a, b);
+    const __m128i o = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(e, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(o, _MM_SHUFFLE(0, 0, 2, 0)));
+  }
+
+  static __m128i lanes(const Sse2& k, __m128i x) {
+    const __m128i invalid = _mm_cmplt_epi32(x, _mm_setzero_si128());
+    __m128i c = select(_mm_cmpgt_epi32(x, k.lo), x, k.lo);
+    c = select(_mm_cmpgt_epi32(c, k.hi), k.hi, c);
+
+    __m128i x0 = k.x0, y0 = k.y0, rise = k.rise, neg = k.neg, magic = k.magic;
+    if (k.n > 1) {                                  // No lane permute: index the table per lane
+      __m128i idx = _mm_set1_epi32(k.n - 1);
+      for (int j = 1; j < k.n; j++) idx = _mm_add_epi32(idx, _mm_cmpgt_epi32(k.bound[j], c));
+      alignas(16) int32_t s[4];
+      _mm_store_si128((__m128i*)s, idx);
+      const Table& t = *k.table;
+      x0 = _mm_set_epi32(t.x0[s[3]], t.x0[s[2]], t.x0[s[1]], t.x0[s[0]]);
+      y0 = _mm_set_epi32(t.y0[s[3]], t.y0[s[2]], t.y0[s[1]], t.y0[s[0]]);
+      rise = _mm_set_epi32(t.rise[s[3]], t.rise[s[2]], t.rise[s[1]], t.rise[s[0]]);
+      neg = _mm_set_epi32(t.neg[s[3]], t.neg[s[2]], t.neg[s[1]], t.neg[s[0]]);
+      magic = _mm_set_epi32((int32_t)t.magic[s[3]], (int32_t)t.magic[s[2]], (int32_t)t.magic[s[1]], (int32_t)t.magic[s[0]]);
+    }
+
+    const __m128i u = mullo(_mm_sub_epi32(c, x0), rise);
+    const __m128i e = _mm_srl_epi64(_mm_mul_epu32(u, magic), k.shift);
+    const __m128i o = _mm_srl_epi64(_mm_mul_epu32(_mm_srli_epi64(u, 32), _mm_srli_epi64(magic, 32)), k.shift);
+    const __m128i q = _mm_or_si128(_mm_and_si128(e, _mm_set_epi32(0, -1, 0, -1)), _mm_slli_epi64(o, 32));
+    const __m128i y = _mm_add_epi32(y0, _mm_sub_epi32(_mm_xor_si128(q, neg), neg));
+    return select(invalid, x, y);
+  }
+
+  static void mapSse2(const Map& m, const int16_t* in, int16_t* out, size_t n) {
+    const Table t(m);
+    Sse2 k;
+    k.table = &t;
+    k.n = t.n;
+    k.lo = _mm_set1_epi32(m.xMin_);
+    k.hi = _mm_set1_epi32(m.xMax_);
+    k.shift = _mm_cvtsi32_si128(m.shift_);
+    k.x0 = _mm_set1_epi32(t.x0[0]);
+    k.y0 = _mm_set1_epi32(t.y0[0]);
+    k.rise = _mm_set1_epi32(t.rise[0]);
+    k.neg = _mm_set1_epi32(t.neg[0]);
+    k.magic = _mm_set1_epi32((int32_t)t.magic[0]);
+    for (int j = 0; j < t.n; j++) k.bound[j] = _mm_set1_epi32(t.x0[j]);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      const __m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+      const __m128i a = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+      const __m128i b = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+      _mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(lanes(k, a), lanes(k, b)));
+    }
+    for (; i < n; i++) out[i] = sat16(m.map(in[i]));
+  }
+
+  // ---------------------------------------------------------------------------
+  // AVX2: 8 lanes; segment parameters come from two registers per field
+  // through a lane permute
+  // ---------------------------------------------------------------------------
+
+  struct Avx2 {
+    __m256i lo, hi;
+    __m128i shift;
+    __m256i x0[2], y0[2], rise[2], neg[2], magic[2];
+    __m256i bound[kSeg];                            // Segment starts, broadcast
+    int     n;
+  };
+
+  __attribute__((target("avx2")))
+  static __m256i pick(const __m256i* t, __m256i idx, __m256i upper) {
+    return _mm256_blendv_epi8(_mm256_permutevar8x32_epi32(t[0], idx), _mm256_permutevar8x32_epi32(t[1], idx), upper);
+  }
+
+  template <bool kMulti>
+  __attribute__((target("avx2")))
+  static __m256i lanes(const Avx2& k, __m256i x) {
+    const __m256i invalid = _mm256_cmpgt_epi32(_mm256_setzero_si256(), x);
+    const __m256i c = _mm256_min_epi32(_mm256_max_epi32(x, k.lo), k.hi);
+
+    __m256i x0 = k.x0[0], y0 = k.y0[0], rise = k.rise[0], neg = k.neg[0], magic = k.magic[0];
+    if (kMulti) {
+      __m256i idx = _mm256_set1_epi32(k.n - 1);     // Count the segment starts at or below c
+      for (int j = 1; j < k.n; j++) idx = _mm256_add_epi32(idx, _mm256_cmpgt_epi32(k.bound[j], c));
+      const __m256i upper = _mm256_cmpgt_epi32(idx, _mm256_set1_epi32(7));
+      x0 = pick(k.x0, idx, upper);
+      y0 = pick(k.y0, idx, upper);
+      rise = pick(k.rise, idx, upper);
+      neg = pick(k.neg, idx, upper);
+      magic = pick(k.magic, idx, upper);
+    }
+
+    const __m256i u = _mm256_mullo_epi32(_mm256_sub_epi32(c, x0), rise);
+    const __m256i e = _mm256_srl_epi64(_mm256_mul_epu32(u, magic), k.shift);
+    const __m256i o = _mm256_srl_epi64(_mm256_mul_epu32(_mm256_srli_epi64(u, 32), _mm256_srli_epi64(magic, 32)), k.shift);
+    const __m256i q = _mm256_blend_epi32(e, _mm256_slli_epi64(o, 32), 0xAA);
+    const __m256i y = _mm256_add_epi32(y0, _mm256_sub_epi32(_mm256_xor_si256(q, neg), neg));
+    return _mm256_blendv_epi8(y, x, invalid);
+  }
+
+  template <bool kMulti>
+  __attribute__((target("avx2")))
+  static void runAvx2(const Map& m, const Avx2& k, const int16_t* in, int16_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+      const __m256i a = lanes<kMulti>(k, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i))));
+      const __m256i b = lanes<kMulti>(k, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i + 8))));
+      _mm256_storeu_si256((__m256i*)(out + i), _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8));
+    }
+    for (; i < n; i++) out[i] = sat16(m.map(in[i]));
+  }
+
+  __attribute__((target("avx2")))
+  static void mapAvx2(const Map& m, const int16_t* in, int16_t* out, size_t n) {
+    const Table t(m);
+    Avx2 k;
+    k.n = t.n;
+    k.lo = _mm256_set1_epi32(m.xMin_);
+    k.hi = _mm256_set1_epi32(m.xMax_);
+    k.shift = _mm_cvtsi32_si128(m.shift_);
+    if (t.n == 1) {
+      k.x0[0] = _mm256_set1_epi32(t.x0[0]);
+      k.y0[0] = _mm256_set1_epi32(t.y0[0]);
+      k.rise[0] = _mm256_set1_epi32(t.rise[0]);
+      k.neg[0] = _mm256_set1_epi32(t.neg[0]);
+      k.magic[0] = _mm256_set1_epi32((int32_t)t.magic[0]);
+      runAvx2<false>(m, k, in, out, n);
+      return;
+    }
+    for (int h = 0; h < 2; h++) {
+      k.x0[h] = _mm256_load_si256((const __m256i*)(t.x0 + 8 * h));
+      k.y0[h] = _mm256_load_si256((const __m256i*)(t.y0 + 8 * h));
+      k.rise[h] = _mm256_load_si256((const __m256i*)(t.rise + 8 * h));
+      k.neg[h] = _mm256_load_si256((const __m256i*)(t.neg + 8 * h));
+      k.magic[h] = _mm256_load_si256((const __m256i*)(t.magic + 8 * h));
+    }
+    for (int j = 0; j < t.n; j++) k.bound[j] = _mm256_set1_epi32(t.x0[j]);
+    runAvx2<true>(m, k, in, out, n);
+  }
+
+  __attribute__((target("avx2")))
+  static void channelAvx2(const int32_t* table, const int16_t* raw, int16_t* out, size_t n) {
+    const __m256i zero = _mm256_setzero_si256(), top = _mm256_set1_epi32(Channel::kCodes - 1);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+      __m256i y[2];
+      for (int h = 0; h < 2; h++) {
+        const __m256i x = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(raw + i + 8 * h)));
+        const __m256i c = _mm256_min_epi32(_mm256_max_epi32(x, zero), top);
+        y[h] = _mm256_blendv_epi8(_mm256_i32gather_epi32((const int*)table, c, 4), x, _mm256_cmpgt_epi32(zero, x));
+      }
+      _mm256_storeu_si256((__m256i*)(out + i), _mm256_permute4x64_epi64(_mm256_packs_epi32(y[0], y[1]), 0xD8));
+    }
+    for (; i < n; i++) {
+      const int x = raw[i];
+      out[i] = sat16(x < 0 ? x : table[x < Channel::kCodes ? x : Channel::kCodes - 1]);
+    }
+  }
+};
+
+#endif
+
+void Map::apply(const int16_t* in, int16_t* out, size_t n, Isa isa) const {
+#ifdef __SSE2__
+  if (vector_ && isa == Isa::Avx2) return Kernels::mapAvx2(*this, in, out, n);
+  if (vector_ && isa == Isa::Sse2) return Kernels::mapSse2(*this, in, out, n);
+#endif
+  for (size_t i = 0; i < n; i++) out[i] = sat16(map(in[i]));
+}
+
+// =============================================================================
+// Channel
+// =============================================================================
+
+Channel::Channel(const uint16_t* mvTable, const Map& map) {
+  for (int raw = 0; raw < kCodes; raw++) table_[raw] = sat16(map.map(mvTable[raw]));
+}
+
+int Channel::map(int raw) const {
+  if (raw < 0) return raw;
+  return table_[raw < kCodes ? raw : kCodes - 1];
+}
+
+void Channel::apply(const int16_t* raw, int16_t* out, size_t n, Isa isa) const {
+#ifdef __SSE2__
+  if (isa == Isa::Avx2) return Kernels::channelAvx2(table_, raw, out, n);
+#endif
+  (void)isa;
+  for (size_t i = 0; i < n; i++) out[i] = sat16(map(raw[i]));
+}
+
+}  // namespace Recal
@@ -0,0 +1,121 @@
+/**
+ * Batch Recalibration (host)
+ *
+ * Recomputes percentages from raw history after a probe is re-calibrated:
+ * the firmware's mappings applied to large arrays, with results identical
+ * to what the firmware computes for the same input.
+ *   - Map: a voltage to a percentage, either Utils::mapConstrainBi() (soil,
+ *     LDR) or a multi-point curve interpolated as batteryPercentFromMv()
+ *     does. Integer arithmetic with truncating division, inputs clamped to
+ *     the curve's ends.
+ *   - Channel: raw 12-bit codes through a chip's millivolt table (as
+ *     AdcCal::toMv()) and then a Map, composed into one 4096-entry table
+ *     the way AdcCal expands its curve at boot.
+ * Negative inputs are invalid readings (-1 in Readings, kMissing in the
+ * fleet store) and are passed through unchanged.
+ *
+ * Kernels: AVX2 (8 lanes) and SSE2 (4 lanes), picked at run time, and a
+ * scalar path. The division by each segment's span is a multiply by a
+ * precomputed reciprocal and a shift, exact for every dividend the
+ * segment can produce; a map whose span products reach 2^31 (none from a
+ * 12-bit ADC) runs the scalar path.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Recal {
+
+  enum class Isa : uint8_t { Scalar, Sse2, Avx2 };
+
+  /**
+   * Widest kernel set this CPU runs
+   */
+  Isa best();
+
+  const char* isaName(Isa isa);
+
+  /**
+   * Curve point: input (e.g. millivolts) and output (e.g. percent)
+   */
+  struct Point {
+    int x;
+    int y;
+  };
+
+  class Map {
+  public:
+    static const int kMaxPoints = 17;               // 16 segments
+
+    /**
+     * Linear map with the semantics of Utils::mapConstrainBi()
+     * (inA > inB for inverted sensors, inA == inB maps to outMin)
+     */
+    Map(int inA, int inB, int outMin, int outMax);
+
+    /**
+     * Replace the map with a piecewise-linear curve
+     * @param points Ascending, strictly increasing x
+     * @return false (map unchanged) for fewer than 2 or more than
+     *         kMaxPoints points, or x not strictly increasing
+     */
+    bool setCurve(const Point* points, int n);
+
+    /**
+     * One value (scalar reference)
+     */
+    int map(int x) const;
+
+    /**
+     * Map an array; outputs saturate to int16_t
+     */
+    void apply(const int16_t* in, int16_t* out, size_t n, Isa isa = best()) const;
+
+    bool vectorized() const { return vector_; }     // Kernels usable (else scalar)
+    int  segments() const { return n_; }
+
+  private:
+    friend struct Kernels;
+
+    int      n_ = 0;
+    int32_t  xMin_ = 0, xMax_ = 0;                  // Inputs are clamped to this
+    int32_t  x0_[kMaxPoints - 1];                   // Segment start
+    int32_t  y0_[kMaxPoints - 1];                   // Output at the start
+    int32_t  span_[kMaxPoints - 1];                 // Input width (> 0)
+    int32_t  rise_[kMaxPoints - 1];                 // Output change over the span
+    uint32_t magic_[kMaxPoints - 1];                // ceil(2^shift / span)
+    int      shift_ = 0;
+    bool     vector_ = false;
+
+    int segment(int32_t x) const;
+    void prepare();
+  };
+
+  /**
+   * Raw ADC codes to output: mvTable then Map, as one table
+   */
+  class Channel {
+  public:
+    static const int kCodes = 4096;
+
+    /**
+     * @param mvTable Millivolts per code (kCodes entries, as AdcCal builds)
+     */
+    Channel(const uint16_t* mvTable, const Map& map);
+
+    /**
+     * One code (codes above 4095 clamp as in AdcCal::toMv())
+     */
+    int map(int raw) const;
+
+    /**
+     * Map an array of codes (AVX2 gathers from the table; SSE2 has no
+     * gather and runs the scalar path)
+     */
+    void apply(const int16_t* raw, int16_t* out, size_t n, Isa isa = best()) const;
+
+  private:
+    int32_t table_[kCodes];
+  };
+}
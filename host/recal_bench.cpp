@@ -0,0 +1,227 @@
+/**
+ * Batch Recalibration Bench (host)
+ *
+ * Checks the recalibration kernels (host/recal/) against the firmware's own
+ * functions, built unmodified from src/ against the Arduino shim:
+ *   - Utils::mapConstrainBi() for the soil map, 2,000 LDR calibration
+ *     windows and 2,000 random linear maps,
+ *   - batteryPercentFromMv() for the 15-point discharge curve,
+ *   - Utils::mapConstrainBi(AdcCal::toMv(raw)) for raw codes,
+ * plus 500 random curves against the scalar path. Every int16 input,
+ * invalid readings included, goes through each kernel set. Then measures
+ * single-core throughput in samples per second on a history-sized array,
+ * with the firmware function called per sample as the baseline.
+ *
+ * Build:  g++ -O2 -std=c++17 -Isrc -Ihost -Ihost/sim host/recal_bench.cpp host/recal/Recal.cpp host/sim/Arduino.cpp src/Utils.cpp src/AdcCal.cpp src/Power.cpp src/Pm.cpp -o recal_bench
+ * Usage:  recal_bench [msamples]     (exit code 1 on any mismatch)
+ */
+
+#include "AdcCal.h"
+#include "Power.h"
+#include "Utils.h"
+#include "recal/Recal.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Discharge curve of src/Power.cpp, ascending
+const Recal::Point kBatteryCurve[] = {
+  {3300, 0},  {3600, 2},  {3750, 5},  {3800, 10}, {3840, 20}, {3850, 30}, {3870, 40}, {3910, 50},
+  {3950, 60}, {3980, 70}, {4020, 80}, {4080, 85}, {4110, 90}, {4150, 95}, {4200, 100},
+};
+
+std::vector<Recal::Isa> isas() {
+  std::vector<Recal::Isa> v{Recal::Isa::Scalar};
+#ifdef __SSE2__
+  v.push_back(Recal::Isa::Sse2);
+  if (Recal::best() == Recal::Isa::Avx2) v.push_back(Recal::Isa::Avx2);
+#endif
+  return v;
+}
+
+int16_t sat16(int v) {
+  return (int16_t)(v < INT16_MIN ? INT16_MIN : v > INT16_MAX ? INT16_MAX : v);
+}
+
+/**
+ * Exhaustive comparison over every int16 input
+ */
+struct Checker {
+  std::vector<int16_t> in, want, got;
+  uint64_t samples = 0, mismatches = 0;
+
+  Checker() : in(65536), want(65536), got(65536) {
+    for (int i = 0; i < 65536; i++) in[i] = (int16_t)(i - 32768);
+  }
+
+  /**
+   * @param ref Firmware result for a valid input; invalid inputs pass through
+   */
+  template <class Mapper, class Ref>
+  void run(const char* what, const Mapper& m, Ref&& ref) {
+    for (size_t i = 0; i < in.size(); i++) want[i] = in[i] < 0 ? in[i] : sat16(ref(in[i]));
+    for (Recal::Isa isa : isas()) {
+      m.apply(in.data(), got.data(), in.size(), isa);
+      for (size_t i = 0; i < in.size(); i++) {
+        if (got[i] == want[i]) continue;
+        if (mismatches++ < 10) {
+          printf("  MISMATCH %s (%s): in %d, firmware %d, got %d\n", what, Recal::isaName(isa), in[i], want[i], got[i]);
+        }
+      }
+      samples += in.size();
+    }
+  }
+};
+
+template <class F>
+double rate(size_t n, F&& f) {
+  double best = 1e9;
+  for (int r = 0; r < 3; r++) {
+    const auto t0 = std::chrono::steady_clock::now();
+    f();
+    best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+  }
+  return n / best / 1e6;
+}
+
+/**
+ * Readings stepped by a random walk within [lo, hi], 0.5 % invalid
+ */
+std::vector<int16_t> walk(size_t n, int lo, int hi, int step, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<int16_t> v(n);
+  int x = (lo + hi) / 2;
+  for (size_t i = 0; i < n; i++) {
+    x = std::min(hi, std::max(lo, x + (int)(rng() % (2 * step + 1)) - step));
+    v[i] = rng() % 200 == 0 ? -1 : (int16_t)x;
+  }
+  return v;
+}
+
+volatile int g_sink;
+
+void printRow(const char* name, double firmware, const std::vector<double>& kernels) {
+  printf("%-34s %10.0f", name, firmware);
+  for (double k : kernels) {
+    if (k > 0) printf(" %10.0f", k);
+    else printf(" %10s", "-");
+  }
+  printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t n = (size_t)((argc > 1 ? atof(argv[1]) : 16) * 1e6);
+  AdcCal::begin();
+  uint16_t mvTable[Recal::Channel::kCodes];
+  for (int raw = 0; raw < Recal::Channel::kCodes; raw++) mvTable[raw] = AdcCal::toMv(raw);
+  printf("Kernels: %s (best %s)\n\n", Recal::isaName(isas().back()), Recal::isaName(Recal::best()));
+
+  // ---------------------------------------------------------------------------
+  // Exactness
+  // ---------------------------------------------------------------------------
+
+  Checker check;
+  std::mt19937 rng(7);
+  const Recal::Map soil(SOIL_MV_WATER, SOIL_MV_AIR, 100, 0);
+  check.run("soil", soil, [](int x) { return Utils::mapConstrainBi(x, SOIL_MV_WATER, SOIL_MV_AIR, 100, 0); });
+
+  for (int i = 0; i < 2000; i++) {
+    const int a = (int)(rng() % (ADC_MAX_MV + 1)), b = i % 10 == 0 ? a : (int)(rng() % (ADC_MAX_MV + 1));
+    const Recal::Map ldr(a, b, 0, 100);
+    check.run("LDR", ldr, [&](int x) { return Utils::mapConstrainBi(x, a, b, 0, 100); });
+  }
+
+  int scalarOnly = 0;
+  for (int i = 0; i < 2000; i++) {
+    const int a = (int)(rng() % 32768), b = (int)(rng() % 32768);
+    const int lo = (int)(rng() % 65536) - 32768, hi = i % 2 ? (int)(rng() % 65536) - 32768 : lo + (int)(rng() % 201) - 100;
+    const Recal::Map m(a, b, lo, hi);
+    scalarOnly += !m.vectorized();
+    check.run("linear", m, [&](int x) { return Utils::mapConstrainBi(x, a, b, lo, hi); });
+  }
+
+  Recal::Map battery(0, 0, 0, 0);
+  if (!battery.setCurve(kBatteryCurve, sizeof kBatteryCurve / sizeof kBatteryCurve[0])) {
+    printf("battery curve rejected\n");
+    return 1;
+  }
+  check.run("battery", battery, [](int x) { return batteryPercentFromMv(x); });
+
+  for (int i = 0; i < 500; i++) {
+    Recal::Point p[Recal::Map::kMaxPoints];
+    const int points = 2 + (int)(rng() % (Recal::Map::kMaxPoints - 1));
+    int x = (int)(rng() % 4000);
+    for (int j = 0; j < points; j++) {
+      p[j] = {x, (int)(rng() % 2001) - 1000};
+      x += 1 + (int)(rng() % 2000);
+    }
+    Recal::Map curve(0, 0, 0, 0);
+    curve.setCurve(p, points);
+    scalarOnly += !curve.vectorized();
+    check.run("curve", curve, [&](int v) { return curve.map(v); });
+  }
+
+  const Recal::Channel soilRaw(mvTable, soil);
+  check.run("soil raw", soilRaw, [](int raw) {
+    return Utils::mapConstrainBi(AdcCal::toMv(raw), SOIL_MV_WATER, SOIL_MV_AIR, 100, 0);
+  });
+  const Recal::Channel ldrRaw(mvTable, Recal::Map(412, 2890, 0, 100));
+  check.run("LDR raw", ldrRaw, [](int raw) { return Utils::mapConstrainBi(AdcCal::toMv(raw), 412, 2890, 0, 100); });
+
+  printf("Exactness: 4,501 maps and 2 raw channels, %.0f M samples through %zu kernel sets, %llu mismatches "
+         "(%d maps on the scalar path)\n\n",
+         check.samples / 1e6, isas().size(), (unsigned long long)check.mismatches, scalarOnly);
+
+  // ---------------------------------------------------------------------------
+  // Throughput
+  // ---------------------------------------------------------------------------
+
+  const std::vector<int16_t> soilMv = walk(n, 900, 2700, 6, 1);
+  const std::vector<int16_t> batteryMv = walk(n, 3200, 4250, 2, 2);
+  const std::vector<int16_t> raw = walk(n, 0, 4095, 12, 3);
+  std::vector<int16_t> out(n);
+  const std::vector<Recal::Isa> sets = isas();
+
+  printf("%.0f M samples, M samples/s on one core\n", n / 1e6);
+  printf("%-34s %10s", "", "firmware");
+  for (const char* name : {"scalar", "SSE2", "AVX2"}) printf(" %10s", name);
+  printf("\n");
+
+  auto kernels = [&](auto&& mapper, const std::vector<int16_t>& in, bool sse2) {
+    std::vector<double> r;
+    for (Recal::Isa isa : {Recal::Isa::Scalar, Recal::Isa::Sse2, Recal::Isa::Avx2}) {
+      const bool have = std::find(sets.begin(), sets.end(), isa) != sets.end();
+      if (!have || (isa == Recal::Isa::Sse2 && !sse2)) { r.push_back(0); continue; }
+      r.push_back(rate(n, [&] { mapper.apply(in.data(), out.data(), n, isa); }));
+    }
+    return r;
+  };
+
+  printRow("soil % from mV (linear)", rate(n, [&] {
+    int s = 0;
+    for (size_t i = 0; i < n; i++) s += Utils::mapConstrainBi(soilMv[i], SOIL_MV_WATER, SOIL_MV_AIR, 100, 0);
+    g_sink = s;
+  }), kernels(soil, soilMv, true));
+
+  printRow("battery % from mV (15 points)", rate(n, [&] {
+    int s = 0;
+    for (size_t i = 0; i < n; i++) s += batteryPercentFromMv(batteryMv[i]);
+    g_sink = s;
+  }), kernels(battery, batteryMv, true));
+
+  printRow("soil % from raw codes (table)", rate(n, [&] {
+    int s = 0;
+    for (size_t i = 0; i < n; i++) s += Utils::mapConstrainBi(AdcCal::toMv(raw[i]), SOIL_MV_WATER, SOIL_MV_AIR, 100, 0);
+    g_sink = s;
+  }), kernels(soilRaw, raw, false));
+
+  printf("\n%s\n", check.mismatches ? "FAILED" : "OK");
+  return check.mismatches ? 1 : 0;
+}
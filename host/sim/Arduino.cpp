@@ -0,0 +1,152 @@
+/**
+ * Arduino Core Shim Implementation
+ */
+
+#include "Arduino.h"
+#include "DHT.h"
+#include "esp_adc_cal.h"
+#include <stdio.h>
+
+namespace {
+  thread_local Sim::Board* t_board = nullptr;
+}
+
+void Sim::setBoard(Board* board) {
+  t_board = board;
+}
+
+Sim::Board* Sim::board() {
+  return t_board;
+}
+
+// =============================================================================
+// Clock and Pins
+// =============================================================================
+
+uint32_t millis() {
+  return (uint32_t)(t_board->us / 1000);
+}
+
+/**
+ * A poll costs a little time, so `while (micros() - t0 < d) {}` ends
+ */
+uint32_t micros() {
+  const uint32_t now = (uint32_t)t_board->us;
+  t_board->us += Sim::kPollUs;
+  return now;
+}
+
+void delay(uint32_t ms) {
+  t_board->us += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us) {
+  t_board->us += us;
+}
+
+int analogRead(uint8_t pin) {
+  const int code = t_board->analogRead(pin);
+  t_board->us += Sim::kConversionUs;
+  return code;
+}
+
+void analogReadResolution(uint8_t) {}
+void analogSetPinAttenuation(uint8_t, adc_attenuation_t) {}
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  t_board->digitalWrite(pin, level);
+}
+
+bool setCpuFrequencyMhz(uint32_t) {
+  return true;
+}
+
+// =============================================================================
+// Print
+// =============================================================================
+
+size_t Print::write(const uint8_t* p, size_t n) {
+  for (size_t i = 0; i < n; i++) write(p[i]);
+  return n;
+}
+
+size_t Print::print(long v, int base) {
+  if (base == 10 && v < 0) return print('-') + print((unsigned long)-v, 10);
+  return print((unsigned long)v, base);
+}
+
+size_t Print::print(unsigned long v, int base) {
+  char buf[8 * sizeof v + 1];
+  char* p = buf + sizeof buf;
+  *--p = 0;
+  if (base < 2) base = 10;
+  do {
+    const int d = (int)(v % base);
+    *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+    v /= base;
+  } while (v);
+  return print(p);
+}
+
+size_t Print::print(double v, int digits) {
+  char buf[48];
+  if (isnan(v)) return print("nan");
+  if (isinf(v)) return print("inf");
+  snprintf(buf, sizeof buf, "%.*f", digits, v);
+  return print(buf);
+}
+
+// =============================================================================
+// DHT22
+// =============================================================================
+
+/**
+ * As the Adafruit library: one transfer per 2 s, values cached in between
+ */
+bool DHT::read() {
+  Sim::Board* b = Sim::board();
+  const uint32_t now = millis();
+  if (b->dht.read && now - b->dht.lastMs < kMinIntervalMs) return b->dht.ok;
+  b->dht.read = true;
+  b->dht.lastMs = now;
+  b->readDht(b->dht.tempC, b->dht.humidity);
+  b->us += Sim::kDhtReadUs;
+  b->dht.ok = !isnan(b->dht.tempC) && !isnan(b->dht.humidity);
+  return b->dht.ok;
+}
+
+void DHT::begin() {
+  Sim::board()->dht.read = false;
+}
+
+float DHT::readTemperature() {
+  return read() ? Sim::board()->dht.tempC : NAN;
+}
+
+float DHT::readHumidity() {
+  return read() ? Sim::board()->dht.humidity : NAN;
+}
+
+// =============================================================================
+// ADC Characterization
+// =============================================================================
+
+/**
+ * Linear fit of ESP-IDF's esp_adc_cal for ADC1 without eFuse data
+ * (default Vref); the IDF's extra correction table near full scale at
+ * 11 dB is left out
+ */
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t, adc_atten_t atten, adc_bits_width_t, uint32_t vref,
+                                              esp_adc_cal_characteristics_t* chars) {
+  static const uint32_t kScale[] = {57431, 76236, 105481, 196602};   // Per attenuation (IDF)
+  static const uint32_t kOffset[] = {75, 78, 107, 142};
+  chars->vref = vref;
+  chars->coeff_a = vref * kScale[atten] / 4096;
+  chars->coeff_b = kOffset[atten];
+  return ESP_ADC_CAL_VAL_DEFAULT_VREF;
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t* chars) {
+  return (chars->coeff_a * raw + 32768) / 65536 + chars->coeff_b;
+}
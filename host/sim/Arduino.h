@@ -0,0 +1,124 @@
+/**
+ * Arduino Core Shim (host)
+ *
+ * Just enough of the ESP32 Arduino core for the firmware's acquisition
+ * modules (src/Sensors.*, src/Utils.*, src/AdcCal.*, src/Pm.*,
+ * src/Radio.*, src/Power.*) to build and run unmodified on a host, against
+ * a simulated board instead of real pins.
+ *
+ * Every pin and clock call goes to the Sim::Board set for the calling
+ * thread. Time is virtual: millis() and micros() read the board's clock,
+ * which only moves when the firmware spends time (delay(), a conversion in
+ * analogRead(), a DHT22 transfer, a micros() poll), so busy-wait loops
+ * terminate and a simulated day takes as long as its work, not 24 hours.
+ *
+ * The firmware keeps some state in globals (radio windows, PM lock
+ * depth, the ADC table, the flicker burst buffer), so one process runs
+ * its devices one at a time; host/fleet_sim.cpp scales across cores with
+ * one process per core.
+ */
+
+#pragma once
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+namespace Sim {
+
+  /**
+   * Hardware seen by one virtual device
+   */
+  class Board {
+  public:
+    virtual ~Board() {}
+
+    /**
+     * 12-bit conversion of an analog pin at the current time
+     */
+    virtual int analogRead(int pin) = 0;
+
+    /**
+     * One DHT22 transfer at the current time (NAN on a failed read)
+     */
+    virtual void readDht(float& tempC, float& humidity) = 0;
+
+    virtual void digitalWrite(int pin, int level) { (void)pin; (void)level; }
+
+    uint64_t us = 0;                                // Virtual time since boot
+
+    struct {                                        // DHT library state (DHT.h)
+      bool     read = false;
+      bool     ok = false;
+      uint32_t lastMs = 0;
+      float    tempC = NAN;
+      float    humidity = NAN;
+    } dht;
+  };
+
+  /**
+   * Board the firmware talks to on this thread
+   */
+  void setBoard(Board* board);
+  Board* board();
+
+  static const uint32_t kConversionUs = 10;         // One analogRead() (ESP32 Arduino core)
+  static const uint32_t kPollUs = 1;                // One micros() call in a busy-wait loop
+  static const uint32_t kDhtReadUs = 5000;          // Start signal and 40-bit transfer
+}
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+static const int LOW = 0;
+static const int HIGH = 1;
+static const int INPUT = 0x01;
+static const int OUTPUT = 0x03;
+static const int INPUT_PULLUP = 0x05;
+
+enum adc_attenuation_t { ADC_0db, ADC_2_5db, ADC_6db, ADC_11db };
+
+using std::max;
+using std::min;
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+int analogRead(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+void analogSetPinAttenuation(uint8_t pin, adc_attenuation_t attenuation);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+bool setCpuFrequencyMhz(uint32_t mhz);
+
+/**
+ * Flash strings are ordinary strings on the host
+ */
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+/**
+ * Text output as in the Arduino core; write() is the only sink
+ */
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* p, size_t n);
+
+  size_t print(const __FlashStringHelper* s) { return print(reinterpret_cast<const char*>(s)); }
+  size_t print(const char* s) { return write(reinterpret_cast<const uint8_t*>(s), strlen(s)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v, int base = 10) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = 10) { return print((unsigned long)v, base); }
+  size_t print(long v, int base = 10);
+  size_t print(unsigned long v, int base = 10);
+  size_t print(double v, int digits = 2);
+
+  size_t println() { return print("\r\n"); }
+  template <class T> size_t println(T v) { return print(v) + println(); }
+  template <class T> size_t println(T v, int arg) { return print(v, arg) + println(); }
+};
@@ -0,0 +1,24 @@
+/**
+ * DHT Sensor Library Shim (host)
+ *
+ * The subset of the Adafruit DHT class the firmware uses, reading from the
+ * calling thread's Sim::Board (see Arduino.h). The firmware has one global
+ * instance, so the library's 2 s reading cache is kept per board instead.
+ */
+
+#pragma once
+#include "Arduino.h"
+
+class DHT {
+public:
+  DHT(uint8_t pin, uint8_t type) { (void)pin; (void)type; }
+
+  void begin();
+  float readTemperature();
+  float readHumidity();
+
+private:
+  static const uint32_t kMinIntervalMs = 2000;
+
+  bool read();
+};
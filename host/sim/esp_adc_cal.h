@@ -0,0 +1,26 @@
+/**
+ * ESP-IDF ADC Calibration Shim (host)
+ *
+ * The esp_adc_cal calls src/AdcCal.cpp makes, characterizing a chip
+ * without eFuse calibration (default Vref). Sim boards convert their
+ * voltages to codes with the inverse of the same curve.
+ */
+
+#pragma once
+#include <stdint.h>
+
+enum adc_unit_t { ADC_UNIT_1 = 1, ADC_UNIT_2 = 2 };
+enum adc_atten_t { ADC_ATTEN_DB_0, ADC_ATTEN_DB_2_5, ADC_ATTEN_DB_6, ADC_ATTEN_DB_11 };
+enum adc_bits_width_t { ADC_WIDTH_BIT_9, ADC_WIDTH_BIT_10, ADC_WIDTH_BIT_11, ADC_WIDTH_BIT_12 };
+enum esp_adc_cal_value_t { ESP_ADC_CAL_VAL_EFUSE_VREF, ESP_ADC_CAL_VAL_EFUSE_TP, ESP_ADC_CAL_VAL_DEFAULT_VREF };
+
+struct esp_adc_cal_characteristics_t {
+  uint32_t vref;
+  uint32_t coeff_a;                                 // Gain, 1/65536 mV per code
+  uint32_t coeff_b;                                 // Offset in mV
+};
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width,
+                                              uint32_t defaultVref, esp_adc_cal_characteristics_t* chars);
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t* chars);
@@ -0,0 +1,570 @@
+/**
+ * History Sync Tool (host)
+ *
+ * Host side of the sync protocol (src/SyncProtocol.*). Keeps the last
+ * acknowledged sequence number per device in a state file and appends new
+ * records to <out>/<device id>.csv, so repeated syncs only move what is new
+ * and an interrupted sync carries on where it stopped.
+ *
+ *   sync_tool <host[:port]> [options]      Sync over TCP (SYNC_PORT)
+ *   sync_tool <tty> [options]              Sync over the serial port (SERIAL_BAUD)
+ *     --state <file>     State file (default sync_state.txt)
+ *     --out <dir>        Output directory (default .)
+ *     --window <n>       Chunks in flight (default 8 TCP, 2 serial)
+ *     --chunk <n>        Records per chunk (default max TCP, 32 serial)
+ *
+ *   sync_tool --simulate [days]            Benchmark against a simulated device
+ *                                          running the firmware's Sender over a
+ *                                          socket pair, with corrupted frames and
+ *                                          dropped connections; checks that every
+ *                                          record arrives exactly once, in order
+ *
+ * Build:  g++ -O2 -std=c++17 -Isrc host/sync_tool.cpp src/SyncProtocol.cpp src/HistoryStream.cpp src/History.cpp src/Lzss.cpp -o sync_tool
+ */
+
+#include "SyncProtocol.h"
+#include "HistoryStream.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <netdb.h>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const uint16_t kDefaultPort = 4210;    // SYNC_PORT
+
+uint32_t nowMs() {
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+double seconds(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+uint32_t getLe(const uint8_t* p, int bytes) {
+  uint32_t v = 0;
+  for (int i = bytes - 1; i >= 0; i--) v = v << 8 | p[i];
+  return v;
+}
+
+void putLe(uint8_t* p, uint32_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+HistorySample decodeRecord(const uint8_t* p) {
+  HistorySample s;
+  s.t = getLe(p + 4, 4);
+  s.tempC10 = (int16_t)getLe(p + 8, 2);
+  s.humidity10 = (int16_t)getLe(p + 10, 2);
+  s.soilPct = (int8_t)p[12];
+  s.lightPct = (int8_t)p[13];
+  return s;
+}
+
+/**
+ * Last acknowledged sequence number per device ("<id hex> <next seq>" lines)
+ */
+struct StateFile {
+  std::string path;
+  std::map<uint64_t, uint32_t> next;
+
+  void load() {
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) return;
+    unsigned long long id;
+    unsigned seq;
+    while (fscanf(f, "%llx %u", &id, &seq) == 2) next[id] = seq;
+    fclose(f);
+  }
+
+  /**
+   * Rewrite via a temporary file so a crash never leaves it half-written
+   */
+  void save() const {
+    const std::string tmp = path + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f) return;
+    for (const auto& e : next) fprintf(f, "%016llx %u\n", (unsigned long long)e.first, e.second);
+    fclose(f);
+    rename(tmp.c_str(), path.c_str());
+  }
+};
+
+/**
+ * Host side of one device's sync
+ *
+ * Bytes from the device go to onByte(); frames to send collect in `out`.
+ * Chunks are accepted only in order: a chunk past the expected sequence
+ * gets one Nak (go-back-N) unless it carries kDataGap, in which case the
+ * records in between were overwritten on the device and are counted as
+ * lost. Every accepted chunk is acknowledged after its records have been
+ * handed to the sink, so the acknowledged position is always durable.
+ */
+class Collector {
+public:
+  typedef std::function<void(uint64_t id, uint32_t seq, const HistorySample&)> Sink;
+  typedef std::function<void(uint64_t id, uint32_t next)> Commit;
+
+  Collector(const std::map<uint64_t, uint32_t>& known, uint8_t window, uint16_t perChunk, Sink sink, Commit commit)
+    : known_(known), window_(window), perChunk_(perChunk), sink_(sink), commit_(commit) {}
+
+  /**
+   * Start or resume a session (after connecting or reconnecting)
+   */
+  void hello() {
+    parser_.reset(new Sync::Parser());
+    nakFor_ = 0xFFFFFFFF;
+    started = false;
+    send(Sync::Hello, nullptr, 0);
+  }
+
+  void onByte(uint8_t b) {
+    if (parser_->feed(b)) onFrame(parser_->type(), parser_->payload(), parser_->length());
+  }
+
+  std::vector<uint8_t> out;            // Frames to send
+  bool     done = false;
+  bool     started = false;             // Info answered in this session
+  uint64_t id = 0;
+  uint32_t expected = 0;               // Next sequence number wanted
+  uint32_t devNext = 0;                // Device's next sequence number at Info
+  uint32_t records = 0;
+  uint32_t lost = 0;                   // Overwritten on the device before sync
+  uint32_t duplicates = 0;
+  uint32_t naks = 0;
+  uint32_t crcErrors = 0;
+  bool     reset = false;              // Device sequence restarted (reboot)
+
+  void countCrc() { crcErrors += parser_ ? parser_->crcErrors() : 0; }
+
+private:
+  const std::map<uint64_t, uint32_t>& known_;
+  uint8_t  window_;
+  uint16_t perChunk_;
+  Sink     sink_;
+  Commit   commit_;
+  std::unique_ptr<Sync::Parser> parser_;
+  uint32_t nakFor_ = 0xFFFFFFFF;       // Expected sequence already Nak'd
+
+  void send(Sync::Type type, const uint8_t* payload, size_t len) {
+    uint8_t buf[32];
+    const size_t n = Sync::frame(buf, type, payload, len);
+    out.insert(out.end(), buf, buf + n);
+  }
+
+  void reply(Sync::Type type, uint32_t seq) {
+    uint8_t p[4];
+    putLe(p, seq, 4);
+    send(type, p, 4);
+  }
+
+  void onFrame(Sync::Type type, const uint8_t* p, size_t len) {
+    switch (type) {
+      case Sync::Info: {
+        if (len < 17 || p[16] != HistoryStream::kBinaryRecord) return;
+        id = (uint64_t)getLe(p + 4, 4) << 32 | getLe(p, 4);
+        const uint32_t first = getLe(p + 8, 4);
+        devNext = getLe(p + 12, 4);
+        const auto it = known_.find(id);
+        expected = it != known_.end() ? it->second : first;
+        if ((int32_t)(expected - devNext) > 0) {   // Device rebooted: start over
+          expected = first;
+          reset = true;
+        }
+        uint8_t s[7];
+        putLe(s, expected, 4);
+        s[4] = window_;
+        putLe(s + 5, perChunk_, 2);
+        send(Sync::Start, s, sizeof s);
+        started = true;
+        break;
+      }
+
+      case Sync::Data: {
+        if (!started || len < Sync::kDataHeader) return;   // Left over from before the Hello
+        const uint32_t seq = getLe(p, 4);
+        const uint16_t count = (uint16_t)getLe(p + 4, 2);
+        const bool gap = p[6] & Sync::kDataGap;
+        if (len != Sync::kDataHeader + count * HistoryStream::kBinaryRecord) return;
+
+        const int32_t ahead = (int32_t)(seq - expected);
+        if (ahead > 0 && !gap) {                   // A chunk went missing
+          if (nakFor_ != expected) {
+            nakFor_ = expected;
+            naks++;
+            reply(Sync::Nak, expected);
+          }
+          return;
+        }
+        if (ahead > 0) lost += ahead;
+        uint32_t skip = ahead < 0 ? (uint32_t)-ahead : 0;   // Overlap with a resend
+        if (skip >= count) {
+          duplicates += count;
+          reply(Sync::Ack, expected);              // Our Ack was lost: repeat it
+          return;
+        }
+        duplicates += skip;
+        for (uint32_t i = skip; i < count; i++) {
+          const uint8_t* r = p + Sync::kDataHeader + i * HistoryStream::kBinaryRecord;
+          sink_(id, getLe(r, 4), decodeRecord(r));
+        }
+        records += count - skip;
+        expected = seq + count;
+        nakFor_ = 0xFFFFFFFF;
+        commit_(id, expected);
+        reply(Sync::Ack, expected);
+        break;
+      }
+
+      case Sync::Done:
+        done = true;
+        break;
+
+      default:
+        break;
+    }
+  }
+};
+
+// =============================================================================
+// Real devices
+// =============================================================================
+
+int openSerial(const char* path) {
+  const int fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0) return -1;
+  termios tio{};
+  tcgetattr(fd, &tio);
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, B9600);                        // SERIAL_BAUD
+  cfsetospeed(&tio, B9600);
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &tio);
+  return fd;
+}
+
+int openTcp(const std::string& target) {
+  std::string host = target, port = std::to_string(kDefaultPort);
+  const size_t colon = target.rfind(':');
+  if (colon != std::string::npos) { host = target.substr(0, colon); port = target.substr(colon + 1); }
+  addrinfo hints{}, *res = nullptr;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) return -1;
+  int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) != 0) { close(fd); fd = -1; }
+  freeaddrinfo(res);
+  return fd;
+}
+
+int runSync(const char* target, int argc, char** argv) {
+  const bool serial = !strncmp(target, "/dev/", 5);
+  StateFile state{"sync_state.txt", {}};
+  std::string outDir = ".";
+  int window = serial ? 2 : 8;
+  int perChunk = serial ? 32 : Sync::kMaxRecords;
+  for (int i = 0; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--state")) state.path = argv[i + 1];
+    else if (!strcmp(argv[i], "--out")) outDir = argv[i + 1];
+    else if (!strcmp(argv[i], "--window")) window = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--chunk")) perChunk = atoi(argv[i + 1]);
+    else { fprintf(stderr, "unknown option %s\n", argv[i]); return 2; }
+  }
+  state.load();
+
+  FILE* csv = nullptr;
+  Collector c(state.next, (uint8_t)window, (uint16_t)perChunk,
+              [&](uint64_t id, uint32_t seq, const HistorySample& s) {
+                if (!csv) {
+                  char path[512];
+                  snprintf(path, sizeof path, "%s/%016llx.csv", outDir.c_str(), (unsigned long long)id);
+                  const bool fresh = access(path, F_OK) != 0;
+                  csv = fopen(path, "a");
+                  if (!csv) { perror(path); exit(1); }
+                  if (fresh) fprintf(csv, "%s\n", HistoryStream::csvHeader());
+                }
+                char row[HistoryStream::kMaxRow];
+                HistoryStream::csvRow(row, sizeof row, seq, s);
+                fprintf(csv, "%s\n", row);
+              },
+              [&](uint64_t id, uint32_t next) {
+                fflush(csv);                       // Records first, then the position
+                state.next[id] = next;
+                state.save();
+              });
+
+  const auto t0 = std::chrono::steady_clock::now();
+  uint64_t bytesIn = 0;
+  int reconnects = 0;
+  while (!c.done) {
+    const int fd = serial ? openSerial(target) : openTcp(target);
+    if (fd < 0) {
+      if (++reconnects > 5) { fprintf(stderr, "cannot open %s\n", target); return 1; }
+      sleep(1);
+      continue;
+    }
+    c.hello();
+    uint32_t lastRx = nowMs();
+    for (;;) {
+      pollfd pfd{fd, (short)(POLLIN | (c.out.empty() ? 0 : POLLOUT)), 0};
+      poll(&pfd, 1, 200);
+      if (pfd.revents & POLLOUT) {
+        const ssize_t n = write(fd, c.out.data(), c.out.size());
+        if (n > 0) c.out.erase(c.out.begin(), c.out.begin() + n);
+      }
+      uint8_t buf[4096];
+      const ssize_t n = (pfd.revents & (POLLIN | POLLHUP)) ? read(fd, buf, sizeof buf) : -1;
+      if (n == 0 && !serial) break;                // Connection dropped: resume
+      if (n > 0) {
+        lastRx = nowMs();
+        bytesIn += n;
+        for (ssize_t i = 0; i < n; i++) c.onByte(buf[i]);
+      }
+      if (c.done) break;
+      if (nowMs() - lastRx > 10000) {              // Stalled: resume with a new Hello
+        c.hello();
+        lastRx = nowMs();
+      }
+    }
+    c.countCrc();
+    close(fd);
+    if (!c.done && ++reconnects > 5) { fprintf(stderr, "giving up after %d reconnects\n", reconnects - 1); break; }
+  }
+  if (csv) fclose(csv);
+
+  const double s = seconds(t0);
+  printf("Device %016llx: %u new records up to seq %u, %llu bytes in %.1f s (%.1f KB/s)\n",
+         (unsigned long long)c.id, c.records, c.expected, (unsigned long long)bytesIn, s, bytesIn / s / 1e3);
+  printf("  lost (overwritten) %u, naks %u, crc errors %u, reconnects %d%s\n",
+         c.lost, c.naks, c.crcErrors, reconnects, c.reset ? ", device restarted its sequence" : "");
+  return c.done ? 0 : 1;
+}
+
+// =============================================================================
+// Simulated device
+// =============================================================================
+
+/**
+ * Reading for a sequence number (deterministic, so the host can check it)
+ */
+HistorySample sampleFor(uint32_t seq) {
+  const float day = sinf(seq * 2.0f * (float)M_PI / 86400.0f);
+  HistorySample s;
+  s.t = seq;
+  s.tempC10 = seq % 20000 < 2 ? HistorySample::kNoValue : HistorySample::encode10(22.0f + 3.5f * day);
+  s.humidity10 = HistorySample::encode10(55.0f - 9.0f * day);
+  s.soilPct = (int8_t)(60 - (seq / 3600) % 30);
+  s.lightPct = (int8_t)(day > 0 ? lroundf(day * 95) : 0);
+  return s;
+}
+
+/**
+ * Device end of a link: the firmware's Sender and parser, a pending frame
+ * and the device's non-blocking send loop (SyncServer::update)
+ */
+struct SimDevice {
+  SimDevice(const History& h) : sender(h, 0x24A160C0FFEEull, 200) {}
+
+  Sync::Sender  sender;
+  std::unique_ptr<Sync::Parser> in;
+  std::vector<uint8_t> frame = std::vector<uint8_t>(Sync::kMaxPayload + Sync::kOverhead);
+  size_t        len = 0, off = 0;
+
+  void connect() {
+    sender.stop();
+    in.reset(new Sync::Parser());
+    len = off = 0;
+  }
+};
+
+struct Link {
+  double   corrupt = 0;                // Probability that a frame gets a flipped byte
+  uint64_t dropEvery = 0;              // Drop the connection after this many device bytes
+};
+
+struct SimResult {
+  uint32_t records = 0, lost = 0, duplicates = 0, naks = 0, crcErrors = 0, reconnects = 0;
+  uint32_t resends = 0, bad = 0;
+  uint64_t wireBytes = 0;
+  double   seconds = 0;
+};
+
+/**
+ * Run one sync between a simulated device and a Collector over a socket
+ * pair, both driven from this thread with non-blocking I/O
+ */
+SimResult simulate(const History& h, SimDevice& dev, std::map<uint64_t, uint32_t>& known,
+                   const Link& link, uint8_t window, uint16_t perChunk, uint32_t seed) {
+  SimResult r;
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> coin(0, 1);
+  int64_t lastSeq = -1;
+  const uint32_t firstExpected = known.count(0x24A160C0FFEEull) ? known[0x24A160C0FFEEull] : h.firstSeq();
+
+  Collector c(known, window, perChunk,
+              [&](uint64_t, uint32_t seq, const HistorySample& s) {
+                const HistorySample want = sampleFor(seq);
+                const bool inOrder = lastSeq < 0 ? seq >= firstExpected : seq == lastSeq + 1;
+                const bool same = s.t == want.t && s.tempC10 == want.tempC10 && s.humidity10 == want.humidity10 &&
+                                  s.soilPct == want.soilPct && s.lightPct == want.lightPct;
+                if (!inOrder || !same) r.bad++;
+                lastSeq = seq;
+              },
+              [&](uint64_t id, uint32_t next) { known[id] = next; });
+
+  const uint32_t resends0 = dev.sender.resends();
+  const auto t0 = std::chrono::steady_clock::now();
+  while (!c.done) {
+    int fds[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    const int sndbuf = 5744;                       // lwIP TCP_SND_BUF
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof sndbuf);
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    dev.connect();
+    c.hello();
+    uint64_t devBytes = 0;
+    uint32_t lastProgress = nowMs();
+    uint32_t lastExpected = c.expected;
+
+    while (!c.done) {
+      uint8_t buf[8192];
+      // Device: receive, then send until the socket would block
+      ssize_t n = recv(fds[0], buf, sizeof buf, 0);
+      for (ssize_t i = 0; i < n; i++) {
+        if (dev.in->feed(buf[i])) dev.sender.onFrame(dev.in->type(), dev.in->payload(), dev.in->length(), nowMs());
+      }
+      for (;;) {
+        if (dev.off == dev.len) {
+          dev.len = dev.sender.nextFrame(dev.frame.data(), nowMs());
+          dev.off = 0;
+          if (dev.len == 0) break;
+          if (coin(rng) < link.corrupt) dev.frame[rng() % dev.len] ^= 0x10;
+        }
+        const ssize_t s = send(fds[0], dev.frame.data() + dev.off, dev.len - dev.off, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (s <= 0) break;
+        dev.off += s;
+        devBytes += s;
+        r.wireBytes += s;
+      }
+
+      // Host: receive, then send its replies (occasionally corrupted too)
+      n = recv(fds[1], buf, sizeof buf, 0);
+      for (ssize_t i = 0; i < n; i++) c.onByte(buf[i]);
+      if (!c.out.empty()) {
+        if (coin(rng) < link.corrupt) c.out[rng() % c.out.size()] ^= 0x10;
+        const ssize_t s = send(fds[1], c.out.data(), c.out.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (s > 0) c.out.erase(c.out.begin(), c.out.begin() + s);
+      }
+
+      if (c.expected != lastExpected) { lastExpected = c.expected; lastProgress = nowMs(); }
+      if (nowMs() - lastProgress > 1000) { c.hello(); lastProgress = nowMs(); }   // Host stall timeout
+      if (link.dropEvery && devBytes >= link.dropEvery) break;                   // Cable pulled
+      if (n <= 0) std::this_thread::yield();
+    }
+    c.countCrc();
+    close(fds[0]);
+    close(fds[1]);
+    if (!c.done) r.reconnects++;
+  }
+  r.seconds = seconds(t0);
+  r.records = c.records;
+  r.lost = c.lost;
+  r.duplicates = c.duplicates;
+  r.naks = c.naks;
+  r.crcErrors = c.crcErrors;
+  r.resends = dev.sender.resends() - resends0;
+  if (lastSeq + 1 != (int64_t)h.nextSeq() && h.size()) r.bad++;   // Ended at the newest record
+  return r;
+}
+
+int runSimulation(double days) {
+  const uint32_t n = (uint32_t)(days * 86400);
+  std::vector<HistorySample> storage(n);
+  History h(storage.data(), n);
+  for (uint32_t i = 0; i < n; i++) h.add(sampleFor(i));
+  int failures = 0;
+
+  struct Case { const char* name; Link link; uint8_t window; uint16_t perChunk; };
+  const Case cases[] = {
+    {"clean",                 {0,     0},       8, Sync::kMaxRecords},
+    {"clean, serial chunks",  {0,     0},       2, 32},
+    {"1% corrupt frames",     {0.01,  0},       8, Sync::kMaxRecords},
+    {"drop every 1 MB",       {0,     1 << 20}, 8, Sync::kMaxRecords},
+    {"1% corrupt + drops",    {0.01,  1 << 20}, 8, Sync::kMaxRecords},
+  };
+
+  printf("Simulated device: %u records (%.1f days at 1 Hz), %u records per full chunk\n\n",
+         n, days, (unsigned)Sync::kMaxRecords);
+  printf("%-22s %8s %10s %7s %7s %7s %6s %6s %6s %5s\n", "link", "records", "wire bytes", "ms", "MB/s",
+         "resends", "naks", "crc", "drops", "bad");
+  for (size_t i = 0; i < sizeof cases / sizeof cases[0]; i++) {
+    const Case& k = cases[i];
+    SimDevice dev(h);
+    std::map<uint64_t, uint32_t> known;
+    const SimResult r = simulate(h, dev, known, k.link, k.window, k.perChunk, 1 + i);
+    printf("%-22s %8u %10llu %7.0f %7.1f %7u %6u %6u %6u %5u\n", k.name, r.records,
+           (unsigned long long)r.wireBytes, r.seconds * 1000, r.wireBytes / r.seconds / 1e6,
+           r.resends, r.naks, r.crcErrors, r.reconnects, r.bad);
+    if (r.bad || r.records != n) failures++;
+  }
+
+  // Incremental: after a full sync, only new records move
+  {
+    std::vector<HistorySample> ring(n + 3600);
+    History h2(ring.data(), n + 3600);
+    for (uint32_t i = 0; i < n; i++) h2.add(sampleFor(i));
+    SimDevice dev(h2);
+    std::map<uint64_t, uint32_t> known;
+    simulate(h2, dev, known, Link(), 8, Sync::kMaxRecords, 10);
+    for (uint32_t i = n; i < n + 3600; i++) h2.add(sampleFor(i));
+    const SimResult r = simulate(h2, dev, known, Link(), 8, Sync::kMaxRecords, 11);
+    printf("\nIncremental: 1 h of new samples -> %u records, %llu bytes (full sync %llu bytes)\n", r.records,
+           (unsigned long long)r.wireBytes,
+           (unsigned long long)((uint64_t)(n + 3600) * HistoryStream::kBinaryRecord));
+    if (r.bad || r.records != 3600) failures++;
+  }
+
+  // Overwritten history: the host was last here long ago
+  {
+    std::vector<HistorySample> ring(720);
+    History h3(ring.data(), 720);
+    for (uint32_t i = 0; i < 5000; i++) h3.add(sampleFor(i));
+    SimDevice dev(h3);
+    std::map<uint64_t, uint32_t> known{{0x24A160C0FFEEull, 1000}};
+    const SimResult r = simulate(h3, dev, known, Link(), 8, 64, 12);
+    printf("Overwritten: resumed from 1000, device keeps %u..%u -> %u records, %u lost\n",
+           h3.firstSeq(), h3.nextSeq() - 1, r.records, r.lost);
+    if (r.records != 720 || r.lost != 5000 - 720 - 1000) failures++;
+  }
+
+  printf("\n%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 2 && !strcmp(argv[1], "--simulate")) return runSimulation(argc > 2 ? atof(argv[2]) : 7);
+  if (argc >= 2 && argv[1][0] != '-') return runSync(argv[1], argc - 2, argv + 2);
+  fprintf(stderr, "usage: %s <host[:port] | /dev/tty...> [--state f] [--out dir] [--window n] [--chunk n]\n"
+                  "       %s --simulate [days]\n", argv[0], argv[0]);
+  return 2;
+}
@@ -0,0 +1,210 @@
+/**
+ * Trace Replay Tool (host)
+ *
+ * Replays a recorded sensor trace through the firmware's adaptive sampling
+ * policy (src/AdaptiveSampler.*) and send-on-delta report filter
+ * (src/SendOnDelta.*). For each it reports the data reduction and the error
+ * of a zero-order-hold reconstruction (last sampled/sent value held until
+ * the next one) against the full-rate trace.
+ *
+ * Accepted input (one record per line, other lines are ignored):
+ *   - Serial monitor logs:  "Temp: 23.4 C, Humidity: 45.0 %, Soil: 40 %, Light: 70 %"
+ *                           (assumed to be 1 s apart, the serial logging period;
+ *                           record them with REPORT_DEADBAND 0 so none are dropped)
+ *   - CSV:                  "ms,tempC,humidity,soilPct,lightPct"
+ *
+ * Build:  g++ -O2 -std=c++17 -Isrc host/trace_replay.cpp src/AdaptiveSampler.cpp src/SendOnDelta.cpp -o trace_replay
+ * Usage:  trace_replay <trace.log|trace.csv>
+ *         trace_replay --synthetic [hours]
+ */
+
+#include "AdaptiveSampler.h"
+#include "SendOnDelta.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Mirrors the defaults in src/Config.h (which depends on Arduino.h)
+struct ChannelSpec {
+  const char* name;
+  uint32_t minMs;
+  uint32_t maxMs;
+  float threshold;
+};
+
+const ChannelSpec kChannels[4] = {
+  {"Temp",  2000, 60000, 0.2f},
+  {"Humid", 2000, 60000, 1.0f},
+  {"Soil",   250, 60000, 1.0f},
+  {"Light",  500, 30000, 2.0f},
+};
+
+// Mirrors the report deadbands and timing in src/Config.h
+const Deadband kBands[4] = {{0.2f, 0.0f}, {1.0f, 0.0f}, {1.0f, 0.0f}, {2.0f, 0.05f}};
+const uint32_t kMaxSilenceMs = 300000;
+const uint32_t kSettleMs = 10000;
+
+struct Record {
+  uint32_t ms;
+  float v[4];   // tempC, humidity, soilPct, lightPct
+};
+
+bool parseLine(const char* line, uint32_t seqMs, Record& r) {
+  float t, h, s, l;
+  unsigned long ms;
+  if (sscanf(line, "Temp: %f C, Humidity: %f %%, Soil: %f %%, Light: %f", &t, &h, &s, &l) == 4) {
+    r = {seqMs, {t, h, s, l}};
+    return true;
+  }
+  if (sscanf(line, "%lu,%f,%f,%f,%f", &ms, &t, &h, &s, &l) == 5) {
+    r = {(uint32_t)ms, {t, h, s, l}};
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Synthetic 1 Hz plant trace: diurnal light and temperature, slow soil
+ * dry-down with a watering event every 12 hours, and small sensor noise.
+ */
+std::vector<Record> synthesize(double hours) {
+  std::vector<Record> out;
+  const uint32_t n = (uint32_t)(hours * 3600.0);
+  srand(1);
+  auto noise = [](float a) { return a * ((float)rand() / RAND_MAX - 0.5f); };
+  float soil = 70.0f;
+  for (uint32_t i = 0; i < n; i++) {
+    const double day = fmod(i / 86400.0, 1.0);
+    const float sun = (float)std::max(0.0, sin((day - 0.25) * 2.0 * M_PI));
+    if (i % 43200 >= 100 && i % 43200 < 130) soil = std::min(80.0f, soil + 1.0f);  // watering
+    else soil = std::max(10.0f, soil - 0.0004f);
+    Record r;
+    r.ms = i * 1000;
+    r.v[0] = 20.0f + 6.0f * sun + noise(0.1f);
+    r.v[1] = 60.0f - 15.0f * sun + noise(0.4f);
+    r.v[2] = roundf(soil + noise(0.8f));
+    r.v[3] = roundf(100.0f * sun + noise(1.0f));
+    out.push_back(r);
+  }
+  return out;
+}
+
+/**
+ * Replay one sampler over the trace. Temperature and humidity share the
+ * DHT sampler on the device, so channels 0 and 1 are replayed together.
+ */
+void replay(const std::vector<Record>& trace, int first, int count, uint32_t minMs, uint32_t maxMs) {
+  AdaptiveSampler sampler(minMs, maxMs);
+  std::vector<ChangeEstimator> est;
+  for (int c = first; c < first + count; c++) est.emplace_back(kChannels[c].threshold);
+
+  float held[4] = {NAN, NAN, NAN, NAN};
+  double sq[4] = {0}, worst[4] = {0};
+  size_t scored = 0;
+
+  for (const Record& r : trace) {
+    if (sampler.due(r.ms)) {
+      bool active = false;
+      for (int k = 0; k < count; k++) {
+        const int c = first + k;
+        held[c] = r.v[c];
+        active |= est[k].update(r.ms, r.v[c], sampler.intervalMs() * 2);
+      }
+      sampler.reschedule(r.ms, active);
+    }
+    for (int k = 0; k < count; k++) {
+      const int c = first + k;
+      const double e = fabs((double)r.v[c] - held[c]);
+      sq[c] += e * e;
+      if (e > worst[c]) worst[c] = e;
+    }
+    scored++;
+  }
+
+  const uint32_t spanMs = trace.back().ms - trace.front().ms;
+  const double fixedPerHour = scored * 3600000.0 / (spanMs ? spanMs : 1);
+  for (int k = 0; k < count; k++) {
+    const int c = first + k;
+    printf("%-6s %10.0f %10.0f %9.1fx %10.3f %10.3f\n", kChannels[c].name,
+           fixedPerHour, sampler.samplesPerHour(trace.back().ms),
+           fixedPerHour / std::max(1.0f, sampler.samplesPerHour(trace.back().ms)),
+           sqrt(sq[c] / scored), worst[c]);
+  }
+}
+
+/**
+ * Feed every record through the send-on-delta filter, as the serial logger
+ * does, and measure what a receiver holding the last sent record would see.
+ */
+void reportBench(const std::vector<Record>& trace) {
+  SendOnDelta filter(kBands, 4, kMaxSilenceMs, kSettleMs);
+  float held[4] = {NAN, NAN, NAN, NAN};
+  double sq[4] = {0}, worst[4] = {0};
+  uint32_t lastSentMs = trace.front().ms, longestGap = 0;
+  uint32_t reasons[5] = {0};
+
+  for (const Record& r : trace) {
+    const SendOnDelta::Reason why = filter.offer(r.ms, r.v);
+    reasons[why]++;
+    if (why != SendOnDelta::None) {
+      for (int c = 0; c < 4; c++) held[c] = r.v[c];
+      longestGap = std::max(longestGap, r.ms - lastSentMs);
+      lastSentMs = r.ms;
+    }
+    for (int c = 0; c < 4; c++) {
+      const double e = fabs((double)r.v[c] - held[c]);
+      sq[c] += e * e;
+      if (e > worst[c]) worst[c] = e;
+    }
+  }
+
+  printf("\nSend-on-delta: %u of %u records sent, compression %.1fx, longest silence %.0f s\n",
+         filter.sent(), filter.offered(), (double)filter.offered() / std::max(1u, filter.sent()),
+         longestGap / 1000.0);
+  printf("  reasons: delta %u, settle %u, heartbeat %u\n",
+         reasons[SendOnDelta::Delta], reasons[SendOnDelta::Settled], reasons[SendOnDelta::Heartbeat]);
+  printf("%-6s %10s %10s\n", "chan", "rms_err", "max_err");
+  for (int c = 0; c < 4; c++) {
+    printf("%-6s %10.3f %10.3f\n", kChannels[c].name, sqrt(sq[c] / trace.size()), worst[c]);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <trace.log|trace.csv> | --synthetic [hours]\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<Record> trace;
+  if (strcmp(argv[1], "--synthetic") == 0) {
+    trace = synthesize(argc > 2 ? atof(argv[2]) : 24.0);
+  } else {
+    FILE* f = fopen(argv[1], "r");
+    if (!f) { perror(argv[1]); return 1; }
+    char line[256];
+    uint32_t seqMs = 0;
+    Record r;
+    while (fgets(line, sizeof line, f)) {
+      if (parseLine(line, seqMs, r)) { trace.push_back(r); seqMs += 1000; }
+    }
+    fclose(f);
+  }
+  if (trace.size() < 2) {
+    fprintf(stderr, "no records found\n");
+    return 1;
+  }
+
+  printf("%zu records, %.2f h\n", trace.size(), (trace.back().ms - trace.front().ms) / 3600000.0);
+  printf("%-6s %10s %10s %10s %10s %10s\n", "chan", "trace/h", "adaptive/h", "saving", "rms_err", "max_err");
+  replay(trace, 0, 2, kChannels[0].minMs, kChannels[0].maxMs);
+  replay(trace, 2, 1, kChannels[2].minMs, kChannels[2].maxMs);
+  replay(trace, 3, 1, kChannels[3].minMs, kChannels[3].maxMs);
+  reportBench(trace);
+  return 0;
+}
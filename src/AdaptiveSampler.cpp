@@ -0,0 +1,82 @@
+/**
+ * Adaptive Sampling Implementation
+ *
+ * EWMA-based change estimation and exponential back-off scheduling.
+ */
+
+#include "AdaptiveSampler.h"
+#include <math.h>
+
+/**
+ * Update estimates with a new sample
+ *
+ * The variance uses the incremental EWM form var = (1-a) * (var + a*d^2),
+ * which needs no history buffer. The projected change is rate * horizon, so
+ * a slow but steady drift still counts as movement once it would exceed the
+ * threshold before the next sample.
+ */
+bool ChangeEstimator::update(uint32_t nowMs, float v, uint32_t horizonMs) {
+  if (!primed_) {
+    primed_ = true;
+    lastMs_ = nowMs;
+    last_ = mean_ = v;
+    return true;                                  // No history yet: stay fast
+  }
+
+  const uint32_t dtMs = nowMs - lastMs_;
+  const float step = fabsf(v - last_);
+  if (dtMs > 0) {
+    const float r = step * 1000.0f / (float)dtMs;
+    rate_ += alpha_ * (r - rate_);
+  }
+
+  const float d = v - mean_;
+  mean_ += alpha_ * d;
+  var_ = (1.0f - alpha_) * (var_ + alpha_ * d * d);
+
+  lastMs_ = nowMs;
+  last_ = v;
+
+  const float projected = rate_ * (float)horizonMs / 1000.0f;
+  return step >= threshold_ || projected >= threshold_ || stddev() >= threshold_;
+}
+
+float ChangeEstimator::stddev() const {
+  return sqrtf(var_);
+}
+
+/**
+ * Schedule the next sample
+ *
+ * Active channels drop straight to the minimum interval so fast events are
+ * caught within one period; stable channels double their interval each time.
+ */
+void AdaptiveSampler::reschedule(uint32_t nowMs, bool active) {
+  if (!started_) {
+    started_ = true;
+    firstMs_ = nowMs;
+  }
+  samples_++;
+
+  if (active) {
+    intervalMs_ = minMs_;
+  } else {
+    const uint32_t doubled = intervalMs_ * 2;
+    intervalMs_ = (doubled > maxMs_ || doubled < intervalMs_) ? maxMs_ : doubled;
+  }
+  nextMs_ = nowMs + intervalMs_;
+}
+
+void AdaptiveSampler::setBounds(uint32_t minMs, uint32_t maxMs) {
+  if (maxMs < minMs) maxMs = minMs;
+  minMs_ = minMs;
+  maxMs_ = maxMs;
+  if (intervalMs_ < minMs_) intervalMs_ = minMs_;
+  if (intervalMs_ > maxMs_) intervalMs_ = maxMs_;
+}
+
+float AdaptiveSampler::samplesPerHour(uint32_t nowMs) const {
+  const uint32_t elapsed = nowMs - firstMs_;
+  if (!started_ || elapsed < 1000) return 0.0f;
+  return (float)samples_ * 3600000.0f / (float)elapsed;
+}
@@ -0,0 +1,118 @@
+/**
+ * Adaptive Sampling Policy
+ *
+ * Per-channel change estimation and sample scheduling. A channel that is
+ * moving (watering, lights switching) is sampled at its minimum interval;
+ * a channel that is stable backs off exponentially towards its maximum
+ * interval, which saves ADC/DHT work and energy overnight.
+ *
+ * This module is plain C++ (no Arduino dependencies) so the same policy can
+ * be replayed against recorded traces on the host (see host/trace_replay.cpp).
+ */
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * Rate-of-change and variance estimator for one signal channel
+ *
+ * Keeps exponentially weighted estimates of the absolute rate of change
+ * (units per second) and of the variance around a running mean. A channel
+ * is considered "active" when the last step, the projected change over the
+ * current interval, or the standard deviation exceeds its threshold.
+ */
+class ChangeEstimator {
+public:
+  /**
+   * Constructor
+   * @param threshold Change (in channel units) that counts as movement
+   * @param alpha EWMA smoothing factor (0..1, higher = faster response)
+   */
+  explicit ChangeEstimator(float threshold = 1.0f, float alpha = 0.3f)
+    : threshold_(threshold), alpha_(alpha) {}
+
+  /**
+   * Feed a new sample and classify the channel
+   *
+   * @param nowMs Sample time in milliseconds
+   * @param v Sample value (channel units)
+   * @param horizonMs Interval over which projected change is evaluated
+   * @return true if the channel is changing, false if stable
+   */
+  bool update(uint32_t nowMs, float v, uint32_t horizonMs);
+
+  float rate() const { return rate_; }          // Smoothed |dv/dt| in units per second
+  float stddev() const;                         // Smoothed standard deviation
+  float threshold() const { return threshold_; }
+
+private:
+  float threshold_;
+  float alpha_;
+  bool  primed_{false};   // false until the first sample arrives
+  uint32_t lastMs_{0};    // Time of previous sample
+  float last_{0};         // Previous sample value
+  float mean_{0};         // EWMA mean
+  float var_{0};          // EWMA variance around mean_
+  float rate_{0};         // EWMA absolute rate of change
+};
+
+/**
+ * Sample scheduler with exponential back-off
+ *
+ * Jumps to the minimum interval whenever the channel is reported active
+ * and doubles the interval (up to the maximum) after each stable sample.
+ * Also counts samples so the effective rate can be reported.
+ */
+class AdaptiveSampler {
+public:
+  /**
+   * Constructor
+   * @param minMs Fastest allowed sample interval
+   * @param maxMs Slowest allowed sample interval
+   */
+  AdaptiveSampler(uint32_t minMs, uint32_t maxMs)
+    : minMs_(minMs), maxMs_(maxMs), intervalMs_(minMs) {}
+
+  /**
+   * Check whether the next sample is due (wrap-safe)
+   * @param nowMs Current time in milliseconds
+   */
+  bool due(uint32_t nowMs) const {
+    return !started_ || (int32_t)(nowMs - nextMs_) >= 0;
+  }
+
+  /**
+   * Record that a sample was taken and schedule the next one
+   *
+   * @param nowMs Time the sample was taken
+   * @param active true if the channel is changing (resets to min interval)
+   */
+  void reschedule(uint32_t nowMs, bool active);
+
+  /**
+   * Change the interval bounds (e.g. from an energy governor)
+   * The current interval is clamped into the new range.
+   */
+  void setBounds(uint32_t minMs, uint32_t maxMs);
+
+  uint32_t intervalMs() const { return intervalMs_; }
+  uint32_t minMs() const { return minMs_; }
+  uint32_t maxMs() const { return maxMs_; }
+  uint32_t samples() const { return samples_; }
+
+  /**
+   * Effective sampling rate since the first sample
+   * @param nowMs Current time in milliseconds
+   * @return Samples per hour (0 until at least one second has elapsed)
+   */
+  float samplesPerHour(uint32_t nowMs) const;
+
+private:
+  uint32_t minMs_;
+  uint32_t maxMs_;
+  uint32_t intervalMs_;
+  uint32_t nextMs_{0};     // Time of next due sample
+  uint32_t firstMs_{0};    // Time of first sample (for rate reporting)
+  uint32_t samples_{0};    // Samples taken so far
+  bool     started_{false};
+};
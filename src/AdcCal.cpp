@@ -0,0 +1,80 @@
+/**
+ * ADC Calibration Lookup Implementation
+ */
+
+#include "AdcCal.h"
+#include <esp_adc_cal.h>
+
+namespace {
+  uint16_t g_mv[4096];                        // Millivolts per raw code (8 KB)
+  esp_adc_cal_characteristics_t g_chars;      // Kept for the benchmark
+  AdcCal::Source g_source = AdcCal::Default;
+
+  const char* const kSourceNames[] = {"default Vref", "eFuse Vref", "eFuse two-point"};
+}
+
+/**
+ * Build the table
+ * esp_adc_cal_raw_to_voltage() evaluates the chip's calibration curve
+ * (including the non-linear correction near full scale); running it once per
+ * code moves that cost out of the sampling path.
+ */
+void AdcCal::begin() {
+  const esp_adc_cal_value_t v = esp_adc_cal_characterize(
+      ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, ADC_DEFAULT_VREF_MV, &g_chars);
+  g_source = (v == ESP_ADC_CAL_VAL_EFUSE_TP)   ? EfuseTwoPoint
+           : (v == ESP_ADC_CAL_VAL_EFUSE_VREF) ? EfuseVref
+           : Default;
+
+  for (uint32_t raw = 0; raw < 4096; raw++) {
+    g_mv[raw] = (uint16_t)esp_adc_cal_raw_to_voltage(raw, &g_chars);
+  }
+}
+
+AdcCal::Source AdcCal::source() {
+  return g_source;
+}
+
+uint16_t AdcCal::toMv(int raw) {
+  if (raw < 0) raw = 0;
+  if (raw > 4095) raw = 4095;
+  return g_mv[raw];
+}
+
+/**
+ * Compare the two conversion paths over all codes, e.g.
+ *   ADC cal bench: table 0.03 us/conv, esp_adc_cal 1.41 us/conv (47x)
+ * The sum is printed so neither loop can be optimized away.
+ */
+void AdcCal::benchmark(Print& out) {
+  const int rounds = 16;
+  uint32_t sumLut = 0, sumCal = 0;
+
+  uint32_t t0 = micros();
+  for (int r = 0; r < rounds; r++)
+    for (int raw = 0; raw < 4096; raw++) sumLut += toMv(raw);
+  const uint32_t lutUs = micros() - t0;
+
+  t0 = micros();
+  for (int r = 0; r < rounds; r++)
+    for (int raw = 0; raw < 4096; raw++) sumCal += esp_adc_cal_raw_to_voltage(raw, &g_chars);
+  const uint32_t calUs = micros() - t0;
+
+  const float n = (float)rounds * 4096.0f;
+  out.print(F("ADC cal bench: table "));
+  out.print(lutUs / n, 3);
+  out.print(F(" us/conv, esp_adc_cal "));
+  out.print(calUs / n, 3);
+  out.print(F(" us/conv ("));
+  out.print(lutUs ? (float)calUs / (float)lutUs : 0.0f, 1);
+  out.print(F("x), checksum "));
+  out.println(sumLut == sumCal ? F("match") : F("MISMATCH"));
+}
+
+void AdcCal::print(Print& out) {
+  out.print(F("ADC cal: ")); out.print(kSourceNames[g_source]);
+  out.print(F(" | 0->")); out.print(g_mv[0]);
+  out.print(F(" 2048->")); out.print(g_mv[2048]);
+  out.print(F(" 4095->")); out.print(g_mv[4095]);
+  out.println(F(" mV"));
+}
@@ -0,0 +1,58 @@
+/**
+ * ADC Calibration Lookup
+ *
+ * The ESP32 ADC is non-linear near the rails at 11 dB attenuation and its
+ * reference voltage differs from chip to chip. At boot the chip's eFuse
+ * calibration (two-point or Vref, falling back to the nominal 1100 mV) is
+ * characterized once with esp_adc_cal and expanded into a 4096-entry
+ * millivolt table, so every conversion afterwards is a single array load.
+ *
+ * All analog inputs (soil, LDR, battery) are on ADC1 at 11 dB, so one table
+ * serves them all.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "Config.h"
+
+namespace AdcCal {
+
+  /**
+   * Calibration source reported by the characterization
+   */
+  enum Source : uint8_t {
+    Default = 0,    // Nominal 1100 mV reference (no eFuse data)
+    EfuseVref,      // Per-chip reference voltage burned in eFuse
+    EfuseTwoPoint   // Per-chip two-point calibration burned in eFuse
+  };
+
+  /**
+   * Characterize ADC1 at 11 dB / 12 bit and build the millivolt table
+   * Must be called once before any toMv() (done in Sensors::begin())
+   */
+  void begin();
+
+  /**
+   * Calibration source in use
+   */
+  Source source();
+
+  /**
+   * Convert a raw 12-bit code to millivolts
+   * @param raw ADC code 0-4095 (out of range values are clamped)
+   * @return Calibrated input voltage in millivolts
+   */
+  uint16_t toMv(int raw);
+
+  /**
+   * Time table lookups against esp_adc_cal_raw_to_voltage() per sample
+   * @param out Destination stream for the result line
+   */
+  void benchmark(Print& out);
+
+  /**
+   * Print the calibration source and a few table points
+   * @param out Destination stream
+   */
+  void print(Print& out);
+}
@@ -0,0 +1,17 @@
+/**
+ * Analog Sample Filtering Implementation
+ */
+
+#include "AnalogFilter.h"
+
+float WeightedEwma::update(float x, float w) {
+  if (!primed_) {
+    primed_ = true;
+    y_ = x;
+    return y_;
+  }
+  if (w < 0) w = 0;
+  if (w > 1) w = 1;
+  y_ += alpha_ * w * (x - y_);
+  return y_;
+}
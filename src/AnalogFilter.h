@@ -0,0 +1,66 @@
+/**
+ * Analog Sample Filtering
+ *
+ * Small building blocks for the analog acquisition path: a weighted EWMA
+ * that lets suspect samples (taken during radio activity) move the output
+ * less, and a noise meter that keeps the mean in-burst variance separately
+ * for clean and RF-tagged samples.
+ *
+ * Plain C++ (no Arduino dependencies).
+ */
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * Exponentially weighted moving average with per-sample weight
+ *
+ * y += alpha * w * (x - y). A weight of 1 is a normal EWMA step, a weight
+ * of 0 ignores the sample. The first sample initializes the output.
+ */
+class WeightedEwma {
+public:
+  explicit WeightedEwma(float alpha) : alpha_(alpha) {}
+
+  /**
+   * Add a sample
+   * @param x Sample value
+   * @param w Sample weight (0..1)
+   * @return Filtered value
+   */
+  float update(float x, float w);
+
+  float value() const { return y_; }
+
+private:
+  float alpha_;
+  float y_{0};
+  bool  primed_{false};
+};
+
+/**
+ * ADC noise meter
+ *
+ * Accumulates the in-burst sample variance (pure noise, since the signal
+ * cannot change within a burst of a few conversions), split by whether the
+ * burst was taken while the radio was active.
+ */
+class NoiseMeter {
+public:
+  /**
+   * Add the variance of one burst
+   * @param var Sample variance of the burst
+   * @param tagged true if taken during radio activity
+   */
+  void add(float var, bool tagged) {
+    sum_[tagged] += var;
+    n_[tagged]++;
+  }
+
+  float variance(bool tagged) const { return n_[tagged] ? sum_[tagged] / (float)n_[tagged] : 0.0f; }
+  uint32_t count(bool tagged) const { return n_[tagged]; }
+
+private:
+  float    sum_[2] = {0, 0};
+  uint32_t n_[2] = {0, 0};
+};
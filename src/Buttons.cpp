@@ -0,0 +1,101 @@
+/**
+ * Interrupt-Driven Buttons Implementation
+ */
+
+#include "Buttons.h"
+#include <Arduino.h>
+#include "Config.h"
+#include "Pm.h"
+
+namespace {
+  const uint8_t kPins[2] = {BUTTON_LEFT_PIN, BUTTON_RIGHT_PIN};
+  const int     kQueueLen = 8;
+
+  portMUX_TYPE      g_mux = portMUX_INITIALIZER_UNLOCKED;
+  Buttons::Event    g_queue[kQueueLen];
+  volatile uint8_t  g_head = 0;           // Written by the ISR
+  volatile uint8_t  g_tail = 0;           // Written by poll()
+  volatile uint32_t g_lastEdgeUs[2] = {0, 0};
+  volatile uint32_t g_edges[2] = {0, 0};
+  volatile uint32_t g_bounces = 0;
+  int               g_level[2] = {HIGH, HIGH};   // Last level seen by poll() (light-sleep fallback)
+  uint32_t          g_seenEdges[2] = {0, 0};     // Edge count at the last poll()
+
+  void push(Buttons::Id id, uint32_t us) {
+    const uint8_t next = (uint8_t)((g_head + 1) % kQueueLen);
+    if (next == g_tail) return;           // Full: drop, the UI is far behind anyway
+    g_queue[g_head].id = id;
+    g_queue[g_head].us = us;
+    g_head = next;
+  }
+
+  /**
+   * Edge handler
+   *
+   * An edge is accepted only after BUTTON_DEBOUNCE_MS without any edge;
+   * every edge restarts that quiet time, so a whole bounce train counts
+   * once. An accepted edge with the pin low is a press. No press/release
+   * state is kept: a release lost in bounce cannot block the next press.
+   */
+  void IRAM_ATTR onEdge(int i) {
+    const uint32_t now = micros();
+    portENTER_CRITICAL_ISR(&g_mux);
+    const bool quiet = now - g_lastEdgeUs[i] >= BUTTON_DEBOUNCE_MS * 1000;
+    g_lastEdgeUs[i] = now;
+    g_edges[i]++;
+    if (!quiet) {
+      g_bounces++;
+    } else if (digitalRead(kPins[i]) == LOW) {
+      push((Buttons::Id)i, now);
+    }
+    portEXIT_CRITICAL_ISR(&g_mux);
+  }
+
+  void IRAM_ATTR onLeft()  { onEdge(0); }
+  void IRAM_ATTR onRight() { onEdge(1); }
+}
+
+void Buttons::begin() {
+  pinMode(BUTTON_LEFT_PIN, INPUT_PULLUP);
+  pinMode(BUTTON_RIGHT_PIN, INPUT);                 // GPIO35 is input-only; pull-up is on the board
+  attachInterrupt(digitalPinToInterrupt(BUTTON_LEFT_PIN), onLeft, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(BUTTON_RIGHT_PIN), onRight, CHANGE);
+}
+
+/**
+ * Dequeue a press
+ *
+ * Under automatic light sleep the GPIO edge logic is not clocked, so a press
+ * that starts while the CPU sleeps raises no interrupt. The loop wakes every
+ * PM_IDLE_SLICE_MS; a pin that went low without any edge interrupt since
+ * the last poll is taken as a press at that moment (the latency report then
+ * includes the sleep slice).
+ */
+bool Buttons::poll(Event& e) {
+  if (Pm::policy() == Pm::DfsLightSleep) {
+    for (int i = 0; i < 2; i++) {
+      const int level = digitalRead(kPins[i]);
+      portENTER_CRITICAL(&g_mux);
+      if (level == LOW && g_level[i] == HIGH && g_edges[i] == g_seenEdges[i]) {
+        g_lastEdgeUs[i] = micros();
+        push((Id)i, g_lastEdgeUs[i]);
+      }
+      g_seenEdges[i] = g_edges[i];
+      portEXIT_CRITICAL(&g_mux);
+      g_level[i] = level;
+    }
+  }
+
+  portENTER_CRITICAL(&g_mux);
+  const bool any = g_tail != g_head;
+  if (any) {
+    e = g_queue[g_tail];
+    g_tail = (uint8_t)((g_tail + 1) % kQueueLen);
+  }
+  portEXIT_CRITICAL(&g_mux);
+  return any;
+}
+
+uint32_t Buttons::bounces() {
+  return g_bounces;
+}
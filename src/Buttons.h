@@ -0,0 +1,42 @@
+/**
+ * Interrupt-Driven Buttons
+ *
+ * The two TTGO T-Display buttons (GPIO0 left, GPIO35 right, both active
+ * low with pull-ups) raise GPIO interrupts on every edge. The ISR debounces
+ * and queues press events with the time of the first clean edge, so the
+ * loop never polls the pins and the UI can measure input-to-photon latency
+ * from the moment the contact closed.
+ */
+
+#pragma once
+#include <stdint.h>
+
+namespace Buttons {
+
+  enum class Id : uint8_t { Left, Right };
+
+  /**
+   * A debounced press
+   */
+  struct Event {
+    Id       id;
+    uint32_t us;       // micros() at the accepted falling edge
+  };
+
+  /**
+   * Configure the pins and attach the edge interrupts
+   */
+  void begin();
+
+  /**
+   * Take the next queued press
+   * @param e Receives the event
+   * @return false if the queue is empty
+   */
+  bool poll(Event& e);
+
+  /**
+   * Edges rejected as contact bounce (debounce diagnostics)
+   */
+  uint32_t bounces();
+}
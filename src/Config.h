@@ -21,16 +21,36 @@ static const int DHT_PIN       = 15;   // DHT22 temperature/humidity sensor data
 static const int DHT_TYPE      = 22;   // DHT sensor type (DHT22 = AM2302)
 static const int SOIL_ADC_PIN  = 36;   // Soil moisture sensor (ADC1_CH0, input-only pin)
 static const int LDR_ADC_PIN   = 33;   // Light-dependent resistor (ADC1_CH5)
+static const int I2C_SDA_PIN   = 21;   // I2C bus for digital climate sensors
+static const int I2C_SCL_PIN   = 22;
+static const int ONEWIRE_PIN   = 25;   // DS18B20 root-zone probes (4k7 pull-up to 3V3)
+static const int SOIL_PWR_PIN  = -1;   // GPIO powering the soil probe (-1 = wired to 3V3, e.g. 26)
+static const int LDR_PWR_PIN   = -1;   // GPIO powering the LDR divider (-1 = wired to 3V3, e.g. 27)
+static const int BUTTON_LEFT_PIN  = 0;    // On-board buttons (active low)
+static const int BUTTON_RIGHT_PIN = 35;   // Input-only, pull-up on the board
+static const int BAT_ADC_PIN   = 34;   // Battery voltage via on-board 100k/100k divider (ADC1_CH6)
+static const int BAT_ADC_EN    = 14;   // Drives the divider enable (HIGH = divider connected)
+
+/* =============================================================================
+ * ADC Calibration
+ * =============================================================================
+ * Raw codes are converted to millivolts through a per-chip table built at boot
+ * from the eFuse calibration (see AdcCal.h), so calibration values below are in
+ * millivolts and hold across boards.
+ */
+static const uint32_t ADC_DEFAULT_VREF_MV = 1100;  // Used when the chip has no eFuse calibration
+static const int      ADC_MAX_MV          = 3300;  // Upper end of the 11 dB input range
+#define ADC_CAL_BENCH 0                            // 1 = time table vs esp_adc_cal at boot
 
 /* =============================================================================
  * Soil Moisture Sensor Calibration Values
  * =============================================================================
- * These values map the raw ADC readings to meaningful moisture percentages.
+ * These values map the calibrated sensor voltage to meaningful moisture percentages.
  * Calibrate by taking readings in completely dry air vs. submerged in water.
- * Higher raw values = drier soil (less conductivity)
+ * Higher voltage = drier soil (less conductivity)
  */
-static const int SOIL_RAW_AIR   = 3000;  // Raw ADC value when sensor is in dry air
-static const int SOIL_RAW_WATER = 1200;  // Raw ADC value when sensor is in water
+static const int SOIL_MV_AIR   = 2550;  // Sensor output (mV) in dry air (was raw 3000)
+static const int SOIL_MV_WATER = 1080;  // Sensor output (mV) in water (was raw 1200)
 
 /* =============================================================================
  * Light Sensor Auto-Calibration
@@ -45,7 +65,168 @@ static const uint32_t LDR_CALIBRATION_MS = 10000;  // 10 seconds calibration win
  * =============================================================================
  * Controls how frequently sensors are read and data is displayed/transmitted.
  */
-static const uint32_t SENSOR_SAMPLE_MS = 1000;  // Read sensors every 1 second
+static const uint32_t SENSOR_SAMPLE_MS = 1000;  // Read sensors every 1 second (fixed mode)
+
+/* =============================================================================
+ * Adaptive Sampling
+ * =============================================================================
+ * When enabled, each channel is sampled at its minimum interval while its value
+ * is moving and backs off exponentially (doubling) towards the maximum interval
+ * while stable. When disabled, every channel uses SENSOR_SAMPLE_MS.
+ * Thresholds are in channel units: the change that counts as "moving".
+ */
+#define ADAPTIVE_SAMPLING 1                       // 1=adaptive, 0=fixed SENSOR_SAMPLE_MS
+
+static const uint32_t DHT_SAMPLE_MIN_MS  = 2000;  // DHT22 cannot be read faster than 0.5 Hz
+static const uint32_t DHT_SAMPLE_MAX_MS  = 60000;
+static const uint32_t SOIL_SAMPLE_MIN_MS = 250;   // Fast enough to follow a watering event
+static const uint32_t SOIL_SAMPLE_MAX_MS = 60000;
+static const uint32_t LDR_SAMPLE_MIN_MS  = 500;
+static const uint32_t LDR_SAMPLE_MAX_MS  = 30000;
+
+static const float TEMP_CHANGE_C     = 0.2f;      // Temperature movement threshold (C)
+static const float HUMIDITY_CHANGE   = 1.0f;      // Humidity movement threshold (%RH)
+static const float SOIL_CHANGE_PCT   = 1.0f;      // Soil moisture movement threshold (%)
+static const float LIGHT_CHANGE_PCT  = 2.0f;      // Light level movement threshold (%)
+
+static const uint32_t SAMPLING_STATS_MS = 60000;  // Print sampling statistics every minute
+
+/* =============================================================================
+ * I2C Climate Sensors
+ * =============================================================================
+ * SHT3x (0x44) and BME280 (0x76) on the I2C bus are probed at boot. When one
+ * is present it replaces the DHT22 for temperature/humidity. Conversions of
+ * all devices run in parallel: a sweep costs the longest conversion time.
+ */
+#define I2C_ENABLE 0                               // 1 = probe and poll I2C sensors
+
+static const uint32_t I2C_FREQ_HZ   = 400000;      // Bus clock
+static const uint32_t I2C_SWEEP_MS  = 2000;        // Time between measurement sweeps
+
+/* =============================================================================
+ * DS18B20 Root-Zone Temperature Probes
+ * =============================================================================
+ * All probes on the 1-Wire bus convert at once (Skip ROM + Convert T), so N
+ * probes cost one conversion window. Scratchpads are then read by ROM ID, one
+ * probe per loop pass. ROM IDs are discovered at boot and kept in NVS so the
+ * probe numbering stays stable when probes are added or drop out.
+ */
+#define DS18B20_ENABLE 0                           // 1 = poll DS18B20 probes on ONEWIRE_PIN
+#define DS18B20_RESET_ROMS 0                       // 1 = forget the stored probe list at boot
+
+static const int      DS18B20_MAX_PROBES = 8;      // Probe slots (stored ROM IDs)
+static const uint8_t  DS18B20_RESOLUTION = 12;     // 9-12 bits (94-750 ms conversion)
+static const uint32_t DS18B20_PERIOD_MS  = 30000;  // Time between conversions
+
+/* =============================================================================
+ * Sensor Excitation Power Gating
+ * =============================================================================
+ * When a sensor is powered from a GPIO (*_PWR_PIN >= 0) it is switched on one
+ * settle time before its next sample and off right after the read. The settle
+ * time overlaps with other loop work (DHT read, rendering) instead of a delay.
+ */
+static const uint32_t SOIL_SETTLE_MS = 50;   // Capacitive probe oscillator start-up
+static const uint32_t LDR_SETTLE_MS  = 5;    // LDR divider + module comparator
+
+/* =============================================================================
+ * Wi-Fi & Radio-Aware Analog Sampling
+ * =============================================================================
+ * Wi-Fi TX bursts couple into ADC1. With RF_AWARE_SAMPLING analog reads wait
+ * (up to RF_MAX_DEFER_MS) for a quiet radio window; reads that still overlap
+ * radio activity are tagged and weighted by RF_NOISY_WEIGHT in the filter.
+ * Each analog read is a burst of ADC_BURST_SAMPLES conversions whose variance
+ * feeds the noise statistics.
+ */
+#define WIFI_ENABLE 0                                 // 1 = connect to the network in Secrets.h
+#define RF_AWARE_SAMPLING 1                           // 1 = schedule analog reads in quiet windows
+
+static const uint32_t WIFI_CONNECT_TIMEOUT_MS = 15000;  // Give up an association attempt after
+static const uint32_t WIFI_RETRY_MS           = 60000;  // Wait before reconnecting
+static const uint32_t RF_GUARD_MS             = 20;     // Radio considered busy after activity ends
+static const uint32_t RF_MAX_DEFER_MS         = 500;    // Longest wait for a quiet window
+static const float    RF_NOISY_WEIGHT         = 0.25f;  // Filter weight of RF-tagged samples
+static const int      ADC_BURST_SAMPLES       = 8;      // Conversions per analog read
+static const float    ANALOG_FILTER_ALPHA     = 0.6f;   // EWMA factor for soil/LDR voltage
+
+/* =============================================================================
+ * Grow-Light (Mains Flicker) Detection
+ * =============================================================================
+ * Every FLICKER_PERIOD_MS the LDR is captured in a short burst at
+ * FLICKER_RATE_HZ and checked for 100/120 Hz flicker (twice the mains
+ * frequency), which separates LED/HPS grow lights from sunlight.
+ * The burst blocks the loop for FLICKER_SAMPLES / FLICKER_RATE_HZ seconds.
+ */
+#define FLICKER_DETECT 1                            // 1=enabled, 0=disabled
+
+static const uint32_t FLICKER_PERIOD_MS  = 30000;   // Burst period
+static const uint32_t FLICKER_RATE_HZ    = 1000;    // Burst sample rate
+static const int      FLICKER_SAMPLES    = 200;     // 200 ms: 100 and 120 Hz fall on exact bins
+static const float    FLICKER_MIN_RATIO  = 0.2f;    // AC energy share at 100/120 Hz for "grow light"
+static const float    FLICKER_MIN_RMS    = 2.0f;    // AC RMS (ADC codes) below this is noise
+static const float    FLICKER_DARK_MEAN  = 40.0f;   // Mean code below this is "dark"
+
+/* =============================================================================
+ * Send-on-Delta Reporting
+ * =============================================================================
+ * Telemetry records (serial log, network exports) are only emitted when a
+ * channel leaves its deadband, when values settle at an unsent value, or as a
+ * heartbeat after REPORT_MAX_SILENCE_MS. Deadband = max(abs, rel * |last sent|).
+ */
+#define REPORT_DEADBAND 1                          // 1=send-on-delta, 0=report every period
+
+static const float TEMP_DEADBAND_ABS      = 0.2f;  // C
+static const float TEMP_DEADBAND_REL      = 0.0f;
+static const float HUMIDITY_DEADBAND_ABS  = 1.0f;  // %RH
+static const float HUMIDITY_DEADBAND_REL  = 0.0f;
+static const float SOIL_DEADBAND_ABS      = 1.0f;  // %
+static const float SOIL_DEADBAND_REL      = 0.0f;
+static const float LIGHT_DEADBAND_ABS     = 2.0f;  // %
+static const float LIGHT_DEADBAND_REL     = 0.05f;
+
+static const uint32_t REPORT_MAX_SILENCE_MS = 300000;  // Heartbeat at least every 5 minutes
+static const uint32_t REPORT_SETTLE_MS      = 10000;   // Flush an unsent final value after 10 s quiet
+
+/* =============================================================================
+ * Battery Monitoring & Energy Budget
+ * =============================================================================
+ * The battery is read through the on-board divider every BATTERY_SAMPLE_MS and
+ * converted to state of charge with a LiPo discharge curve. The governor
+ * compares the estimated average current against the budget needed to reach
+ * TARGET_RUNTIME_H on battery and steps through power profiles (sample rate,
+ * render rate, backlight, radio duty). Currents are estimates for accounting.
+ */
+static const uint32_t BATTERY_SAMPLE_MS   = 10000;   // Battery voltage read period
+static const float    BATTERY_DIVIDER     = 2.0f;    // Vbat = Vadc * divider
+static const int      BATTERY_USB_MV      = 4400;    // Above this we are on USB/charger
+static const uint32_t BATTERY_CAPACITY_MAH = 1000;   // Fitted cell capacity
+static const uint32_t TARGET_RUNTIME_H    = 72;      // Desired runtime on battery
+static const uint32_t GOVERNOR_PERIOD_MS  = 60000;   // Governor re-evaluation period
+static const uint32_t ENERGY_REPORT_MS    = 300000;  // Energy report period on serial
+
+static const float CPU_ACTIVE_MA       = 45.0f;  // ESP32 at 240 MHz, radio off
+static const float BACKLIGHT_FULL_MA   = 22.0f;  // TFT backlight at 100 %
+static const float RENDER_MA           = 15.0f;  // Extra while pushing pixels over SPI
+static const float SOIL_SUPPLY_MA      = 5.0f;   // Soil probe supply current while powered
+static const float LDR_SUPPLY_MA       = 1.0f;   // LDR module supply current while powered
+static const float DHT_READ_MAMS       = 7.5f;   // Charge per DHT22 read (mA*ms)
+static const float ADC_READ_MAMS       = 0.1f;   // Charge per analog read (mA*ms)
+static const float RADIO_ACTIVE_MA     = 110.0f; // Wi-Fi while transmitting/listening
+static const float RADIO_IDLE_MA       = 15.0f;  // Wi-Fi associated in modem sleep (average)
+
+/* =============================================================================
+ * CPU Power Management
+ * =============================================================================
+ * 0 = fixed 240 MHz, 1 = dynamic frequency scaling (80 MHz idle, 240 MHz while
+ * rendering / reading sensors / networking), 2 = DFS plus automatic light sleep
+ * (requires a core built with CONFIG_PM_ENABLE and tickless idle).
+ */
+#define PM_POLICY 1
+
+static const uint32_t PM_MAX_FREQ_MHZ   = 240;
+static const uint32_t PM_MIN_FREQ_MHZ   = 80;     // Lowest clock that keeps APB at 80 MHz
+static const uint32_t PM_IDLE_SLICE_MS  = 10;     // Loop yield per iteration under DFS
+static const float    CPU_IDLE_80MHZ_MA = 20.0f;  // Estimated idle current at 80 MHz
+static const float    CPU_LIGHT_SLEEP_MA = 2.0f;  // Estimated average with auto light sleep
 
 /* =============================================================================
  * Serial Communication & Display Settings
@@ -53,3 +234,85 @@ static const uint32_t SENSOR_SAMPLE_MS = 1000;  // Read sensors every 1 second
  */
 #define SERIAL_BAUD 9600              // Serial monitor baud rate
 #define SHOW_UPTIME_ON_TFT 1          // Show system uptime on display (1=enabled, 0=disabled)
+#define BACKLIGHT_PWM_CHANNEL 0       // LEDC channel driving TFT_BL
+#define DISPLAY_BENCH 0               // 1 = time text paths and frame expansion at boot
+
+/* =============================================================================
+ * UI Pages & History
+ * =============================================================================
+ * The right button steps forward through the pages (live, trends, stats,
+ * diagnostics), the left button back. Readings are kept in a RAM ring every
+ * HISTORY_PERIOD_MS for the trend charts (720 x 2 min = 24 h, ~8.6 KB).
+ * Charts and downsampled exports reduce the history with LTTB; sending 'h',
+ * 'd' or 'm' on Serial dumps it raw, LTTB- or min/max-downsampled as CSV,
+ * and 'z' sends the raw CSV LZSS-compressed.
+ */
+static const uint32_t BUTTON_DEBOUNCE_MS = 30;      // Quiet time before an edge counts
+static const uint32_t HISTORY_PERIOD_MS  = 120000;  // History sample interval
+static const int      HISTORY_CAPACITY   = 720;     // History samples kept in RAM
+static const uint32_t HISTORY_EXPORT_POINTS = 240;  // Points in a downsampled export
+
+/* =============================================================================
+ * History HTTP Endpoint
+ * =============================================================================
+ * With Wi-Fi up, GET /history?from=&to=&step=&fmt=csv|bin streams the history
+ * as a chunked response. One HTTP_CHUNK_BYTES buffer is refilled only after
+ * the previous chunk has been accepted by the TCP stack, so memory does not
+ * depend on the range and a slow client throttles the encoder.
+ */
+#define HTTP_ENABLE 1                                 // 1 = serve /history when Wi-Fi is up
+
+static const uint16_t HTTP_PORT               = 80;
+static const size_t   HTTP_CHUNK_BYTES        = 1460;   // One TCP segment per chunk
+static const uint32_t HTTP_REQUEST_TIMEOUT_MS = 3000;   // Drop clients that do not send a request
+static const uint32_t HTTP_SLICE_MS           = 20;     // Longest send burst per loop pass
+
+/* =============================================================================
+ * History Sync
+ * =============================================================================
+ * Incremental sync with host/sync_tool (see SyncProtocol.h). The host keeps
+ * the last acknowledged sequence number per device, so each sync sends only
+ * new records and an interrupted one resumes. Runs over the serial port and,
+ * with Wi-Fi up, on SYNC_PORT.
+ */
+#define SYNC_ENABLE 1                                 // 1 = answer sync sessions
+
+static const uint16_t SYNC_PORT           = 4210;
+static const uint32_t SYNC_ACK_TIMEOUT_MS = 5000;     // Resend unacknowledged chunks after this
+static const uint32_t SYNC_SLICE_MS       = 20;       // Longest send burst per loop pass
+static const uint32_t SYNC_SERIAL_IDLE_MS = 30000;    // End a serial session (log resumes) when the host goes quiet
+
+/* =============================================================================
+ * Secure Uplink
+ * =============================================================================
+ * Reports are POSTed as JSON to UPLINK_HOST/UPLINK_PATH (Secrets.h) over
+ * HTTPS. The connection is kept open for UPLINK_IDLE_MS after each report,
+ * and the TLS session is saved in RTC memory (and NVS) so reconnects resume
+ * it instead of running a full handshake. The server must present a
+ * certificate signed by UPLINK_CA_CERT; without a valid CA the uplink stays
+ * off unless UPLINK_INSECURE is set.
+ */
+#define UPLINK_ENABLE 0                               // 1 = send reports over HTTPS (needs WIFI_ENABLE)
+#define UPLINK_SESSION_NVS 1                          // 1 = keep the TLS session across power loss
+#define UPLINK_INSECURE 0                             // 1 = connect without a CA, server NOT authenticated (testing only)
+
+static const uint16_t UPLINK_PORT       = 443;
+static const uint32_t UPLINK_IDLE_MS    = 30000;      // Keep-alive after a report
+static const uint32_t UPLINK_TIMEOUT_MS = 10000;      // Give up a connect, handshake or response
+static const uint32_t UPLINK_RETRY_MS   = 30000;      // Resend after a server error or a failed new connection
+static const uint32_t UPLINK_GAP_MS     = 10000;      // Below full radio duty: least time between reports, x 100 / duty
+
+/* =============================================================================
+ * UDP Push Uplink
+ * =============================================================================
+ * Reports are batched into UDP datagrams for the collector at PUSH_HOST
+ * (Secrets.h; host/push_collector). Unacknowledged datagrams are resent from
+ * a small window; acknowledgements are sparse and selective.
+ */
+#define PUSH_ENABLE 0                                 // 1 = push reports over UDP (needs WIFI_ENABLE)
+
+static const uint16_t PUSH_PORT         = 4211;
+static const int      PUSH_BATCH        = 8;          // Readings per datagram
+static const int      PUSH_WINDOW       = 8;          // Datagrams kept until acknowledged
+static const uint32_t PUSH_RTO_MS       = 3000;       // Resend an unacknowledged datagram after this
+static const uint32_t PUSH_MAX_DELAY_MS = 60000;      // Send a partial batch after this
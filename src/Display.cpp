@@ -7,6 +7,12 @@
  */
 
 #include "Display.h"
+#include "Downsample.h"
+
+// RGB565 values of the Display::Color palette indices
+static const uint16_t kPalette[Display::ColorCount] = {
+  TFT_BLACK, TFT_WHITE, TFT_DARKGREY, TFT_GREEN, TFT_RED, TFT_YELLOW, TFT_CYAN, TFT_ORANGE, TFT_BLUE
+};
 
 /**
  * Initialize the TFT display hardware
@@ -18,13 +24,19 @@ void Display::begin() {
   tft.init();                          // Initialize the ST7789 display controller
   tft.setRotation(1);                  // Landscape orientation (135x240 becomes 240x135)
   
-  // Configure backlight control (pin 4 controls TFT_BL)
-  pinMode(4, OUTPUT);
-  digitalWrite(4, 1);                  // Turn on backlight (active high)
+  // Configure backlight control (pin 4 controls TFT_BL) as 8-bit PWM
+  ledcSetup(BACKLIGHT_PWM_CHANNEL, 5000, 8);
+  ledcAttachPin(TFT_BL, BACKLIGHT_PWM_CHANNEL);
+  setBacklight(backlightPct_);         // Turn on backlight (active high)
   
   // Set up initial display state
   tft.fillScreen(TFT_BLACK);           // Clear screen to black
   tft.setTextColor(TFT_WHITE, TFT_BLACK); // White text on black background
+
+  // Frame buffers: pixels are expanded through the palette during the push
+  tft.initDMA();
+  tft.setSwapBytes(false);             // Stripes are already in panel byte order
+  lut_.set(kPalette, ColorCount);
 }
 
 /**
@@ -34,90 +46,436 @@ void Display::begin() {
  * Uses larger text for the main title to make it prominent.
  */
 void Display::showSplash(const char* subtitle) {
-  tft.fillScreen(TFT_BLACK);           // Clear the entire screen
+  back().clear(Black);                 // Clear the entire frame
   
-  // Draw main title in large text
-  tft.setTextSize(2);                  // Double-size text for prominence
-  tft.setCursor(8, 10);                // Position near top-left with margin
-  tft.println("SmartArium");
+  // Draw main title in large text, near top-left with margin
+  back().text(8, 10, "SmartArium", 2, White, Black);
   
-  // Draw subtitle in normal text if provided
-  tft.setTextSize(1);                  // Standard text size
-  tft.setCursor(8, 34);                // Position below main title
-  tft.println(subtitle ? subtitle : ""); // Handle null subtitle gracefully
+  // Draw subtitle in normal text if provided (null handled gracefully)
+  if (subtitle) back().text(8, 34, subtitle, 1, White, Black);
+  present();
+}
+
+// Page names for the header indicator
+static const char* const kPageNames[(int)Page::Count] = { "Live", "Trends", "Stats", "Diagnostics" };
+
+// CPU policy names (Pm::Policy order)
+static const char* const kPolicyNames[] = { "240 MHz fixed", "DFS", "DFS + light sleep" };
+
+// Layout: rows of size-1 text at a 16 px pitch below the header
+static const int kRowTop   = 26;
+static const int kRowPitch = 16;
+static const int kFieldX   = 6 + 9 * 6;                  // After an 8-character label and a space
+
+// Trend charts: two boxes right of a label column
+static const int kChartX   = 36;
+static const int kChartW   = 200;
+static const int kChartH   = 48;
+static const int kChartY[2] = { 28, 84 };
+
+/**
+ * Rows of the live page
+ * Optional rows are skipped so the visible ones stay packed.
+ */
+enum LiveRow { RowUptime, RowTemp, RowHumid, RowSoil, RowLight, RowRoot, RowPressure, RowCount };
+
+static bool liveRowShown(int row) {
+  switch (row) {
+    case RowUptime:   return SHOW_UPTIME_ON_TFT;
+    case RowRoot:     return DS18B20_ENABLE;
+    case RowPressure: return I2C_ENABLE;
+    default:          return true;
+  }
+}
+
+static int liveRowY(int row) {
+  int y = kRowTop;
+  for (int i = 0; i < row; i++) if (liveRowShown(i)) y += kRowPitch;
+  return y;
 }
 
 /**
- * Draw the standard display header
+ * Draw the display header
  * 
- * Clears the screen and draws the SmartArium title at the top.
- * This is called before rendering the main sensor data display.
+ * Title in large text, with the page number and name to its right.
  */
-void Display::header() {
-  tft.fillScreen(TFT_BLACK);           // Clear previous content
-  
-  // Draw title
-  tft.setTextSize(2);                  // Large text for header
-  tft.setCursor(6, 4);                 // Top margin
-  tft.println("SmartArium");
-  
-  tft.setTextSize(1);                  // Reset to normal text size for data rows
+void Display::header(PalFrame& f, Page p) {
+  f.text(6, 4, "SmartArium", 2, White, Black);
+
+  char line[24];
+  snprintf(line, sizeof line, "%d/%d %s", (int)p + 1, (int)Page::Count, kPageNames[(int)p]);
+  f.text(132, 4, line, 1, Grey, Black);
+}
+
+/**
+ * Draw a value in the field column
+ */
+void Display::field(int y, const String& val) {
+  back().text(kFieldX, y, val.c_str(), 1, White, Black);
 }
 
 /**
- * Display a single data row with consistent formatting
+ * Compose the static layer of a page
  * 
- * Helper function that maintains consistent spacing and alignment across
- * all sensor data rows. Uses printf-style formatting for clean columns.
+ * Everything that does not change between renders goes here: the header,
+ * row labels and chart frames. It is drawn once per page switch.
  */
-void Display::row(int& y, const char* key, const String& val) {
-  tft.setCursor(6, y);                 // Left margin for alignment
-  
-  // Use printf for consistent column formatting
-  // %-8s creates an 8-character left-aligned field for the key
-  tft.printf("%-8s %s\n", key, val.c_str());
-  
-  y += 16;                             // Move to next row (16 pixels down)
+void Display::drawChrome(Page p) {
+  PalFrame& f = chrome_;
+  f.clear(Black);
+  header(f, p);
+
+  static const char* const kLiveLabels[RowCount] = {
+    "Uptime:", "Temp:", "Humid:", "Soil:", "Light:", "Root:", "Press:"
+  };
+  static const char* const kStatsLabels[] = {
+    "DHT:", "Soil:", "LDR:", "Reports:", "Current:", "Governor:", "Battery:"
+  };
+  static const char* const kDiagLabels[] = {
+    "Heap:", "Wi-Fi:", "CPU:", "Frame:", "Input:", "Buttons:", "History:"
+  };
+
+  switch (p) {
+    case Page::Live:
+      for (int i = 0; i < RowCount; i++) {
+        if (liveRowShown(i)) f.text(6, liveRowY(i), kLiveLabels[i], 1, White, Black);
+      }
+      break;
+
+    case Page::Trends:
+      for (int c = 0; c < 2; c++) {
+        const int y = kChartY[c];
+        f.fillRect(kChartX - 1, y, kChartW + 2, 1, Grey);            // Frame
+        f.fillRect(kChartX - 1, y + kChartH - 1, kChartW + 2, 1, Grey);
+        f.fillRect(kChartX - 1, y, 1, kChartH, Grey);
+        f.fillRect(kChartX + kChartW, y, 1, kChartH, Grey);
+        f.text(6, y + kChartH / 2 - 4, c == 0 ? "Temp" : "Soil", 1, Grey, Black);
+      }
+      break;
+
+    case Page::Stats:
+      for (int i = 0; i < 7; i++) f.text(6, kRowTop + i * kRowPitch, kStatsLabels[i], 1, White, Black);
+      break;
+
+    case Page::Diagnostics:
+      for (int i = 0; i < 7; i++) f.text(6, kRowTop + i * kRowPitch, kDiagLabels[i], 1, White, Black);
+      break;
+
+    default:
+      break;
+  }
+  chromePage_ = (int8_t)p;
 }
 
 /**
- * Render the complete sensor data display
+ * Live page: current sensor readings
  * 
  * Shows all current sensor readings with appropriate error handling.
  * Displays "calibrating" status for light sensor during startup period.
- * Uses consistent formatting and handles sensor failure gracefully.
  */
-void Display::render(const Readings& r, bool ldrCalibrating) {
-  header();                            // Draw title and clear screen
-
+void Display::drawLive(const Readings& r, bool ldrCalibrating) {
 #if SHOW_UPTIME_ON_TFT
   // Calculate and display system uptime if enabled in config
   static uint32_t t0 = millis();       // Remember first call time
-  uint32_t up = (millis() - t0) / 1000; // Convert to seconds
+  field(liveRowY(RowUptime), String((millis() - t0) / 1000) + " s");
 #endif
 
-  int y = 26;                          // Starting Y position (below header)
+  // Show calibration status for light sensor under the page indicator
+  if (ldrCalibrating) back().text(132, 14, "Calibrating LDR", 1, Yellow, Black);
 
-#if SHOW_UPTIME_ON_TFT
-  // Show system uptime for debugging/monitoring
-  row(y, "Uptime:", String(up) + " s");
+  // DHT22 returns NAN when communication fails
+  field(liveRowY(RowTemp),  isnan(r.tempC) ? "--.- C" : String(r.tempC, 1) + " C");
+  field(liveRowY(RowHumid), isnan(r.humidity) ? "-- %" : String(r.humidity, 1) + " %");
+
+  // Negative values indicate sensor errors (or calibration for the LDR)
+  field(liveRowY(RowSoil),  (r.soilPct < 0) ? "-- %" : String(r.soilPct) + " %");
+
+  // Append the light source once flicker detection has classified it
+  String light = (r.lightPct < 0) ? "-- %" : String(r.lightPct) + " %";
+  if (r.lightSource != LightSource::Unknown) light = light + " " + lightSourceName(r.lightSource);
+  field(liveRowY(RowLight), light);
+
+#if DS18B20_ENABLE
+  field(liveRowY(RowRoot), isnan(r.rootTempC) ? "--.- C" : String(r.rootTempC, 1) + " C");
+#endif
+#if I2C_ENABLE
+  field(liveRowY(RowPressure), isnan(r.pressureHpa) ? "---- hPa" : String(r.pressureHpa, 1) + " hPa");
 #endif
+}
+
+// Chart points of the last LTTB pass (one per column at most)
+static Downsample::Point chartPts[kChartW];
 
-  // Show calibration status for light sensor
-  if (ldrCalibrating) {
-    row(y, "Status:", "Calibrating LDR...");
+/**
+ * Trend chart
+ * 
+ * The whole history is reduced to kChartW points with LTTB, so a day of
+ * samples fits the box without dropping the peaks that plain decimation
+ * would skip. Points are placed by time, scaled between their own minimum
+ * and maximum and joined with lines; invalid samples leave a gap.
+ */
+void Display::chart(const History& hist, int channel, int y, uint8_t color) {
+  const uint32_t n = hist.size();
+  if (n == 0) {
+    back().text(kChartX + 4, y + kChartH / 2 - 4, "No data", 1, Grey, Black);
+    return;
   }
+  const uint32_t t0 = hist.at(0).t;
 
-  // Display temperature with error handling
-  // DHT22 returns NAN when communication fails
-  row(y, "Temp:",  isnan(r.tempC) ? "--.- C" : String(r.tempC, 1) + " C");
-  
-  // Display humidity with error handling
-  row(y, "Humid:", isnan(r.humidity) ? "-- %" : String(r.humidity, 1) + " %");
-  
-  // Display soil moisture (negative values indicate sensor errors)
-  row(y, "Soil:",  (r.soilPct < 0) ? "-- %" : String(r.soilPct) + " %");
-  
-  // Display light level (negative values indicate calibration/errors)
-  row(y, "Light:", (r.lightPct < 0) ? "-- %" : String(r.lightPct) + " %");
+  int count = 0;
+  Downsample::lttb(
+    [&](uint32_t i, Downsample::Point& p) {
+      const HistorySample& s = hist.at(i);
+      p.x = (float)(s.t - t0);
+      if (channel == 0) { p.y = HistorySample::decode10(s.tempC10); return !isnan(p.y); }
+      p.y = s.soilPct;
+      return s.soilPct >= 0;
+    },
+    n, kChartW,
+    [&](uint32_t, const Downsample::Point& p) { if (count < kChartW) chartPts[count++] = p; });
+
+  float lo = INFINITY, hi = -INFINITY;
+  for (int i = 0; i < count; i++) {
+    if (isnan(chartPts[i].y)) continue;
+    if (chartPts[i].y < lo) lo = chartPts[i].y;
+    if (chartPts[i].y > hi) hi = chartPts[i].y;
+  }
+  if (lo > hi) {
+    back().text(kChartX + 4, y + kChartH / 2 - 4, "No data", 1, Grey, Black);
+    return;
+  }
+
+  const int decimals = channel == 0 ? 1 : 0;
+  back().text(6, y + 1, String(hi, decimals).c_str(), 1, White, Black);
+  back().text(6, y + kChartH - 9, String(lo, decimals).c_str(), 1, White, Black);
+
+  const float span = hi - lo < 0.1f ? 0.1f : hi - lo;
+  const float tSpan = chartPts[count - 1].x > 0 ? chartPts[count - 1].x : 1;
+  const int top = y + 2, h = kChartH - 4;
+  int px = -1, py = -1;
+  for (int i = 0; i < count; i++) {
+    if (isnan(chartPts[i].y)) { px = -1; continue; }
+    const int x = kChartX + (int)(chartPts[i].x * (kChartW - 1) / tSpan + 0.5f);
+    const int v = top + h - 1 - (int)((chartPts[i].y - lo) * (h - 1) / span + 0.5f);
+    if (px < 0) back().line(x, v, x, v, color);
+    else        back().line(px, py, x, v, color);
+    px = x;
+    py = v;
+  }
+}
+
+/**
+ * Trends page: temperature and soil moisture over the history window
+ */
+void Display::drawTrends(const History& hist) {
+  chart(hist, 0, kChartY[0], Yellow);
+  chart(hist, 1, kChartY[1], Cyan);
+
+  // Time covered by the history
+  if (hist.size() > 1) {
+    const uint32_t span = hist.at(hist.size() - 1).t - hist.at(0).t;
+    char line[16];
+    snprintf(line, sizeof line, "%.1f h", span / 3600.0f);
+    back().text(132, 14, line, 1, Grey, Black);
+  }
+}
+
+/**
+ * Stats page: sampling rates, reporting and power
+ */
+void Display::drawStats(const UiStatus& st) {
+  char line[32];
+  int y = kRowTop;
+
+  snprintf(line, sizeof line, "%.0f /h", st.dhtPerHour);   field(y, line); y += kRowPitch;
+  snprintf(line, sizeof line, "%.0f /h", st.soilPerHour);  field(y, line); y += kRowPitch;
+  snprintf(line, sizeof line, "%.0f /h", st.ldrPerHour);   field(y, line); y += kRowPitch;
+  snprintf(line, sizeof line, "%u of %u", (unsigned)st.reportsSent, (unsigned)st.reportsOffered);
+  field(y, line); y += kRowPitch;
+  snprintf(line, sizeof line, "%.1f mA avg", st.averageMa); field(y, line); y += kRowPitch;
+  snprintf(line, sizeof line, "level %u", st.governorLevel); field(y, line); y += kRowPitch;
+  snprintf(line, sizeof line, "%d mV %d %%%s", st.batteryMv, st.batteryPct, st.onUsb ? " USB" : "");
+  field(y, line);
+}
+
+/**
+ * Diagnostics page: memory, radio, CPU policy and UI timing
+ */
+void Display::drawDiagnostics(const History& hist, const UiStatus& st) {
+  char line[32];
+  int y = kRowTop;
+
+  snprintf(line, sizeof line, "%u KB (min %u)", (unsigned)(st.freeHeap / 1024), (unsigned)(st.minFreeHeap / 1024));
+  field(y, line); y += kRowPitch;
+  field(y, !st.wifiEnabled ? "off" : st.wifiConnected ? "connected" : "down"); y += kRowPitch;
+  field(y, kPolicyNames[st.pmPolicy < 3 ? st.pmPolicy : 0]); y += kRowPitch;
+  snprintf(line, sizeof line, "%u us, %d stripes", (unsigned)presentUs_, stripesPushed_);
+  field(y, line); y += kRowPitch;
+  snprintf(line, sizeof line, "%u ms (worst %u)", (unsigned)(latencyUs_ / 1000), (unsigned)(worstLatencyUs_ / 1000));
+  field(y, line); y += kRowPitch;
+  snprintf(line, sizeof line, "%u bounces", (unsigned)st.buttonBounces);
+  field(y, line); y += kRowPitch;
+  snprintf(line, sizeof line, "%u of %u", (unsigned)hist.size(), (unsigned)hist.capacity());
+  field(y, line);
+}
+
+/**
+ * Render the current page
+ * 
+ * The back frame starts as a copy of the cached chrome (a 16 KB memcpy),
+ * the live fields are drawn over it and present() sends the stripes that
+ * differ from the panel. After a page switch every stripe differs, so the
+ * switch costs one full push.
+ */
+void Display::render(const Readings& r, bool ldrCalibrating, const History& hist, const UiStatus& st) {
+  if (chromePage_ != (int8_t)page_) drawChrome(page_);
+  back() = chrome_;
+
+  switch (page_) {
+    case Page::Live:        drawLive(r, ldrCalibrating);  break;
+    case Page::Trends:      drawTrends(hist);             break;
+    case Page::Stats:       drawStats(st);                break;
+    case Page::Diagnostics: drawDiagnostics(hist, st);    break;
+    default:                                              break;
+  }
+
+  present();                           // Send the changed stripes in one pass
+
+  // Input-to-photon: button edge to the last stripe leaving the SPI bus
+  if (inputUs_) {
+    latencyUs_ = micros() - inputUs_;
+    if (latencyUs_ > worstLatencyUs_) worstLatencyUs_ = latencyUs_;
+    latencyNew_ = true;
+    inputUs_ = 0;
+  }
+}
+
+void Display::step(int dir, uint32_t inputUs) {
+  const int n = (int)Page::Count;
+  page_ = (Page)(((int)page_ + dir % n + n) % n);
+  if (!inputUs_) inputUs_ = inputUs ? inputUs : 1; // Keep the earliest unserved press
+}
+
+bool Display::takeLatency(uint32_t& us) {
+  if (!latencyNew_) return false;
+  latencyNew_ = false;
+  us = latencyUs_;
+  return true;
+}
+
+/**
+ * Set backlight brightness
+ * 
+ * The backlight is one of the largest loads on battery, so the energy
+ * governor dims it rather than switching it off.
+ */
+void Display::setBacklight(uint8_t pct) {
+  if (pct > 100) pct = 100;
+  backlightPct_ = pct;
+  ledcWrite(BACKLIGHT_PWM_CHANNEL, (uint32_t)pct * 255 / 100);
+}
+
+/**
+ * Show the composed frame
+ * 
+ * The back frame is compared with the front frame stripe by stripe and only
+ * changed stripes are sent; a once-a-second uptime change costs one stripe.
+ * The frames are then swapped, so the next frame is composed while the
+ * panel keeps showing this one (no clear-then-draw flicker).
+ */
+void Display::present() {
+  const uint32_t t0 = micros();
+  stripesPushed_ = pushRows(back(), 0, PalFrame::kHeight, frontValid_);
+  presentUs_ = micros() - t0;
+  frontValid_ = true;
+  back_ ^= 1;
+}
+
+/**
+ * Stripe pipeline
+ * 
+ * pushImageDMA() waits for the previous transfer before queuing the next,
+ * so expanding stripe k into one buffer overlaps the DMA of stripe k-1
+ * from the other. The palette lookup (one 32-bit load per pixel pair)
+ * is much faster than SPI at 40 MHz, so the push runs at wire speed.
+ */
+int Display::pushRows(const PalFrame& f, int y0, int rows, bool changedOnly) {
+  const PalFrame& front = frames_[back_ ^ 1];
+  int sent = 0;
+  tft.startWrite();
+  for (int y = y0; y < y0 + rows; y += kStripeRows) {
+    int h = kStripeRows;
+    if (y0 + rows - y < h) h = y0 + rows - y;      // Last stripe may be short
+    if (changedOnly && f.rowsEqual(front, y, h)) continue;
+    uint16_t* buf = stripes_[sent & 1];
+    lut_.expand(f.row(y), buf, h * PalFrame::kStride);
+    tft.pushImageDMA(0, y, PalFrame::kWidth, h, buf);
+    sent++;
+  }
+  tft.dmaWait();
+  tft.endWrite();
+  return sent;
+}
+
+/**
+ * Display benchmark, e.g.
+ *   Text size 1: print 41000 chars/s, atlas 152000 chars/s
+ *   Frame expand: naive 2100 us, pair table 620 us (32400 px)
+ *   Frame push: 14800 us (17 stripes)
+ * Text is drawn repeatedly with both methods; the atlas path includes
+ * expanding and pushing the stripes it covers.
+ */
+void Display::benchmark(Print& out) {
+  static const char* kLine = "Temp:    23.4 C  Light: 87 % sun";
+  const int n = strlen(kLine);
+  const int reps = 50;
+
+  for (uint8_t size = 1; size <= 2; size++) {
+    const int len = size == 1 ? n : 20;            // Size 2 fits 20 cells across
+    char line[41];
+    snprintf(line, sizeof line, "%.*s", len, kLine);
+
+    tft.setTextSize(size);
+    uint32_t t0 = micros();
+    for (int i = 0; i < reps; i++) {
+      tft.setCursor(0, 0);
+      tft.print(line);
+    }
+    const uint32_t printUs = micros() - t0;
+
+    t0 = micros();
+    for (int i = 0; i < reps; i++) {
+      back().text(0, 0, line, size, White, Black);
+      pushRows(back(), 0, 8 * size, false);
+    }
+    const uint32_t atlasUs = micros() - t0;
+
+    out.print(F("Text size ")); out.print(size);
+    out.print(F(": print ")); out.print((uint32_t)((uint64_t)len * reps * 1000000 / printUs));
+    out.print(F(" chars/s, atlas ")); out.print((uint32_t)((uint64_t)len * reps * 1000000 / atlasUs));
+    out.println(F(" chars/s"));
+  }
+  tft.setTextSize(1);
+
+  // Expansion alone, into the stripe buffers (no SPI)
+  const int bytes = kStripePx / 2;
+  uint32_t t0 = micros();
+  for (int y = 0; y < PalFrame::kHeight; y += kStripeRows) lut_.expandNaive(back().row(y), stripes_[0], bytes);
+  const uint32_t naiveUs = micros() - t0;
+  t0 = micros();
+  for (int y = 0; y < PalFrame::kHeight; y += kStripeRows) lut_.expand(back().row(y), stripes_[0], bytes);
+  const uint32_t pairUs = micros() - t0;
+  out.print(F("Frame expand: naive ")); out.print(naiveUs);
+  out.print(F(" us, pair table ")); out.print(pairUs);
+  out.print(F(" us (")); out.print(PalFrame::kWidth * PalFrame::kHeight);
+  out.println(F(" px)"));
+
+  // Full frame push with expansion overlapped
+  back().clear(Black);
+  t0 = micros();
+  const int sent = pushRows(back(), 0, PalFrame::kHeight, false);
+  out.print(F("Frame push: ")); out.print(micros() - t0);
+  out.print(F(" us (")); out.print(sent);
+  out.println(F(" stripes)"));
+  frontValid_ = false;                             // Panel no longer matches the front frame
 }
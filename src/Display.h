@@ -11,6 +11,35 @@
 #include <TFT_eSPI.h>
 #include "Config.h"
 #include "Sensors.h"
+#include "PalFrame.h"
+#include "History.h"
+
+/**
+ * UI pages, stepped through with the buttons
+ */
+enum class Page : uint8_t { Live, Trends, Stats, Diagnostics, Count };
+
+/**
+ * System figures for the stats and diagnostics pages (filled in by main)
+ */
+struct UiStatus {
+  float    dhtPerHour     = 0;     // Effective sample rates
+  float    soilPerHour    = 0;
+  float    ldrPerHour     = 0;
+  uint32_t reportsSent    = 0;     // Send-on-delta log lines
+  uint32_t reportsOffered = 0;
+  float    averageMa      = 0;     // Governor's average current
+  uint8_t  governorLevel  = 0;
+  int      batteryMv      = 0;
+  int      batteryPct     = 0;
+  bool     onUsb          = false;
+  uint32_t freeHeap       = 0;     // Bytes
+  uint32_t minFreeHeap    = 0;
+  bool     wifiEnabled    = false;
+  bool     wifiConnected  = false;
+  uint8_t  pmPolicy       = 0;     // Pm::Policy
+  uint32_t buttonBounces  = 0;
+};
 
 /**
  * Display controller class for TTGO T-Display
@@ -18,6 +47,12 @@
  * Manages the ST7789 TFT display including initialization, layout,
  * and rendering of sensor data. Uses a clean columnar layout with
  * error handling for sensor failures.
+ * 
+ * Frames are composed off-screen in a 4-bpp palettized buffer and then sent
+ * in one pass, so the panel never shows a half-drawn or cleared frame.
+ * The static chrome of the current page (title, labels, chart frames) is
+ * cached in its own frame; each render starts from a copy of it and only
+ * draws the live fields, and present() sends only the stripes that changed.
  */
 class Display {
 public:
@@ -36,31 +71,149 @@ public:
   void showSplash(const char* subtitle);
   
   /**
-   * Render the main sensor data display
+   * Render the current page
    * Shows all current sensor readings with appropriate formatting
    * and error indicators for failed sensors
    * 
    * @param r Current sensor readings structure
    * @param ldrCalibrating true if light sensor is still calibrating
+   * @param hist Reading history (trends page)
+   * @param st System figures (stats and diagnostics pages)
+   */
+  void render(const Readings& r, bool ldrCalibrating, const History& hist, const UiStatus& st);
+
+  /**
+   * Step to the next or previous page
+   * The next render() measures input-to-photon latency from inputUs.
+   * 
+   * @param dir +1 = next page, -1 = previous page
+   * @param inputUs micros() of the button press
+   */
+  void step(int dir, uint32_t inputUs);
+
+  Page page() const { return page_; }
+
+  /**
+   * Latency of the last page switch, from button edge to the end of the push
+   * @param us Receives the latency in microseconds
+   * @return true once per measured page switch
+   */
+  bool takeLatency(uint32_t& us);
+
+  uint32_t worstLatencyUs() const { return worstLatencyUs_; }
+
+  /**
+   * Set backlight brightness
+   * Drives TFT_BL with LEDC PWM
+   * 
+   * @param pct Brightness 0-100%
    */
-  void render(const Readings& r, bool ldrCalibrating);
+  void setBacklight(uint8_t pct);
+
+  /**
+   * Current backlight brightness
+   * @return Brightness 0-100%
+   */
+  uint8_t backlight() const { return backlightPct_; }
+
+  /**
+   * Palette indices of the frame buffers
+   */
+  enum Color : uint8_t { Black, White, Grey, Green, Red, Yellow, Cyan, Orange, Blue, ColorCount };
+
+  /**
+   * Compare display paths at boot
+   * Prints characters per second of TFT_eSPI text vs the glyph atlas, and
+   * the cost of expanding and pushing a palettized frame.
+   * 
+   * @param out Destination stream (usually Serial)
+   */
+  void benchmark(Print& out);
+
+  /**
+   * Time spent in the last present() and stripes it sent
+   */
+  uint32_t presentMicros() const { return presentUs_; }
+  int stripesPushed() const { return stripesPushed_; }
   
 private:
+  static const int kStripeRows = 8;                     // Rows per DMA transfer
+  static const int kStripePx = PalFrame::kWidth * kStripeRows;
+
   TFT_eSPI tft{135, 240};  // TFT display object with screen dimensions
+  uint8_t backlightPct_{100};  // Current backlight brightness
+
+  PalFrame   frames_[2];                                // Back (composing) and front (on panel)
+  uint8_t    back_{0};                                  // Index of the back frame
+  bool       frontValid_{false};                        // Front frame matches the panel
+  PaletteLut lut_;
+  alignas(4) uint16_t stripes_[2][kStripePx];           // Ping-pong RGB565 DMA buffers
+  uint32_t   presentUs_{0};
+  int        stripesPushed_{0};
+
+  PalFrame& back() { return frames_[back_]; }
+
+  Page       page_{Page::Live};
+  PalFrame   chrome_;                                   // Cached static layer of chromePage_
+  int8_t     chromePage_{-1};                           // -1 = cache empty
+  uint32_t   inputUs_{0};                               // Pending button press (0 = none)
+  uint32_t   latencyUs_{0};
+  uint32_t   worstLatencyUs_{0};
+  bool       latencyNew_{false};
+
+  /**
+   * Send the back frame to the panel and make it the front frame
+   * Only stripes that differ from the front frame are sent.
+   */
+  void present();
+
+  /**
+   * Expand and push a band of rows of a frame by DMA
+   * Each stripe is expanded while the previous one is still being sent.
+   * 
+   * @param f Frame to send
+   * @param y0 First row
+   * @param rows Number of rows
+   * @param changedOnly Skip stripes equal in the front frame
+   * @return Number of stripes sent
+   */
+  int pushRows(const PalFrame& f, int y0, int rows, bool changedOnly);
   
   /**
-   * Display a single data row
-   * Helper function to maintain consistent formatting across all data rows
+   * Draw the static layer of a page into the chrome cache
+   * @param p Page to draw
+   */
+  void drawChrome(Page p);
+
+  /**
+   * Draw the live fields of each page into the back frame
+   */
+  void drawLive(const Readings& r, bool ldrCalibrating);
+  void drawTrends(const History& hist);
+  void drawStats(const UiStatus& st);
+  void drawDiagnostics(const History& hist, const UiStatus& st);
+
+  /**
+   * Draw one trend chart (history reduced with LTTB, min/max labels)
+   * 
+   * @param hist Reading history
+   * @param channel 0 = temperature, 1 = soil moisture
+   * @param y Top of the chart box
+   * @param color Plot color
+   */
+  void chart(const History& hist, int channel, int y, uint8_t color);
+
+  /**
+   * Draw a value in the field column of a row
    * 
-   * @param y Reference to Y position (modified after drawing)
-   * @param key Label for the data (e.g., "Temp:")
+   * @param y Row position
    * @param val Value string to display
    */
-  void row(int& y, const char* key, const String& val);
+  void field(int y, const String& val);
   
   /**
-   * Draw the display header
-   * Clears screen and draws the SmartArium title at the top
+   * Draw the display header into a frame
+   * Title plus page number and name
    */
-  void header();
+  void header(PalFrame& f, Page p);
 };
@@ -0,0 +1,193 @@
+/**
+ * Series Downsampling
+ *
+ * Reduces a long series (e.g. a day of history) to the number of points a
+ * chart or export can use without losing the peaks that plain decimation
+ * skips over:
+ *
+ * - lttb():   Largest-Triangle-Three-Buckets. One point per bucket, the one
+ *             forming the largest triangle with the previously chosen point
+ *             and the mean of the next bucket. Keeps the visual shape.
+ * - minMax(): The minimum and maximum of each bucket, in time order. Keeps
+ *             every extreme exactly, at up to two points per bucket.
+ *
+ * Both walk the buckets once with a few words of state and hand each chosen
+ * point to a sink as soon as it is known, so the output never has to be
+ * held in RAM. lttb() reads the samples of a bucket twice (once for the
+ * next-bucket mean, once as candidates); the source must allow random
+ * access, which the history ring does.
+ *
+ * Arithmetic is single precision (the ESP32 FPU has no double), so x should
+ * be relative to the start of the series.
+ *
+ * Header-only (templates, so the source and sink calls inline) and plain
+ * C++ (no Arduino dependencies); see host/downsample_bench.cpp.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+namespace Downsample {
+
+  /**
+   * One sample; y is NAN for a gap
+   */
+  struct Point {
+    float x;
+    float y;
+  };
+
+  /**
+   * Sources and sinks
+   *
+   *   bool src(uint32_t i, Point& p)        Sample i; always set p.x, return
+   *                                         false if p.y is not valid
+   *   void out(uint32_t i, const Point& p)  Chosen sample i (p.y = NAN for a
+   *                                         bucket without valid samples)
+   */
+
+  /**
+   * Largest-Triangle-Three-Buckets
+   *
+   * The first and last samples are always kept. Buckets with no valid sample
+   * produce one gap point, so a chart can break its line there.
+   *
+   * @param src Sample source
+   * @param n Number of samples
+   * @param threshold Number of output points (< 3 or >= n passes all through)
+   * @param out Sink
+   * @return Number of points emitted
+   */
+  template <class Source, class Sink>
+  uint32_t lttb(Source&& src, uint32_t n, uint32_t threshold, Sink&& out) {
+    Point p;
+    if (threshold >= n || threshold < 3) {
+      for (uint32_t i = 0; i < n; i++) {
+        if (!src(i, p)) p.y = NAN;
+        out(i, p);
+      }
+      return n;
+    }
+
+    // Previously chosen point (a), carried across gaps
+    Point a;
+    const bool first = src(0, a);
+    if (!first) a.y = NAN;
+    out(0, a);
+    bool aValid = first;
+    uint32_t emitted = 1;
+
+    const uint32_t buckets = threshold - 2;
+    const uint64_t span = n - 2;
+    uint32_t lo = 1;
+    for (uint32_t b = 0; b < buckets; b++) {
+      const uint32_t hi  = 1 + (uint32_t)((b + 1) * span / buckets);
+      uint32_t nextHi    = 1 + (uint32_t)((b + 2) * span / buckets);
+      if (nextHi > n) nextHi = n;                    // Last "next bucket" is the final sample
+
+      // Mean of the next bucket (c)
+      float sx = 0, sy = 0;
+      uint32_t cnt = 0;
+      for (uint32_t i = hi; i < nextHi; i++) {
+        if (!src(i, p)) continue;
+        sx += p.x;
+        sy += p.y;
+        cnt++;
+      }
+      const float mx = cnt ? sx / cnt : 0;
+      const float my = cnt ? sy / cnt : 0;
+
+      // Candidate with the largest (doubled) triangle area
+      float bestArea = -1;
+      uint32_t best = lo;
+      Point bestP = a;
+      for (uint32_t i = lo; i < hi; i++) {
+        if (!src(i, p)) continue;
+        if (!aValid) { a.y = p.y; aValid = true; }    // Leading gap: start level with the data
+        const float cx = cnt ? mx : p.x;
+        const float cy = cnt ? my : a.y;              // No next mean: furthest from a
+        const float area = fabsf((a.x - cx) * (p.y - a.y) - (a.x - p.x) * (cy - a.y));
+        if (area > bestArea) {
+          bestArea = area;
+          best = i;
+          bestP = p;
+        }
+      }
+
+      if (bestArea < 0) {
+        src(lo, p);                                   // Gap marker at the bucket start
+        out(lo, Point{p.x, NAN});
+      } else {
+        out(best, bestP);
+        a = bestP;
+      }
+      emitted++;
+      lo = hi;
+    }
+
+    if (!src(n - 1, p)) p.y = NAN;
+    out(n - 1, p);
+    return emitted + 1;
+  }
+
+  /**
+   * Minimum and maximum per bucket
+   *
+   * Each sample is read once. A bucket emits its minimum and maximum in
+   * sample order (one point if they coincide, a gap point if it has no
+   * valid sample).
+   *
+   * @param src Sample source
+   * @param n Number of samples
+   * @param buckets Number of buckets (>= n passes all through)
+   * @param out Sink
+   * @return Number of points emitted
+   */
+  template <class Source, class Sink>
+  uint32_t minMax(Source&& src, uint32_t n, uint32_t buckets, Sink&& out) {
+    Point p;
+    if (buckets >= n || buckets == 0) {
+      for (uint32_t i = 0; i < n; i++) {
+        if (!src(i, p)) p.y = NAN;
+        out(i, p);
+      }
+      return n;
+    }
+
+    uint32_t emitted = 0;
+    uint32_t lo = 0;
+    for (uint32_t b = 0; b < buckets; b++) {
+      const uint32_t hi = (uint32_t)((uint64_t)(b + 1) * n / buckets);
+      uint32_t iMin = 0, iMax = 0;
+      Point pMin{0, NAN}, pMax{0, NAN}, start{0, NAN};
+      bool any = false;
+      for (uint32_t i = lo; i < hi; i++) {
+        const bool ok = src(i, p);
+        if (i == lo) start.x = p.x;
+        if (!ok) continue;
+        if (!any || p.y < pMin.y) { pMin = p; iMin = i; }
+        if (!any || p.y > pMax.y) { pMax = p; iMax = i; }
+        any = true;
+      }
+
+      if (!any) {
+        out(lo, start);
+        emitted++;
+      } else if (iMin == iMax) {
+        out(iMin, pMin);
+        emitted++;
+      } else if (iMin < iMax) {
+        out(iMin, pMin);
+        out(iMax, pMax);
+        emitted += 2;
+      } else {
+        out(iMax, pMax);
+        out(iMin, pMin);
+        emitted += 2;
+      }
+      lo = hi;
+    }
+    return emitted;
+  }
+}
@@ -0,0 +1,222 @@
+/**
+ * DS18B20 1-Wire Temperature Probes Implementation
+ */
+
+#include "Ds18b20.h"
+#include <Preferences.h>
+
+static const uint8_t DS_CMD_CONVERT    = 0x44;
+static const uint8_t DS_CMD_WRITE_PAD  = 0x4E;
+static const uint8_t DS_CMD_READ_PAD   = 0xBE;
+static const uint8_t DS_CMD_READ_POWER = 0xB4;
+static const uint8_t DS_FAMILY_DS18B20 = 0x28;
+static const uint8_t DS_FAMILY_DS1822  = 0x22;
+static const int16_t DS_POWER_ON_RAW   = 0x0550;   // 85.0 C: scratchpad reset value, no conversion ran
+
+static const char* NVS_NAMESPACE = "ds18b20";
+static const char* NVS_KEY_ROMS  = "roms";
+
+Ds18b20Bank::Ds18b20Bank(int pin, uint8_t resolution, uint32_t periodMs)
+  : ow_(pin), resolution_(constrain(resolution, 9, 12)), periodMs_(periodMs) {
+  // 750 ms at 12 bits, halved per bit less (rounded up: 94 ms at 9 bits)
+  const uint8_t shift = 12 - resolution_;
+  convertMs_ = (750u + (1u << shift) - 1) >> shift;
+}
+
+/**
+ * Discovery
+ *
+ * The stored list is loaded first so known probes keep their slots; the bus
+ * search then marks them present and appends new ones. NVS is only written
+ * when the list changed. The resolution goes to the scratchpad of all probes
+ * with one Skip ROM write (not copied to EEPROM, so it is redone every boot).
+ */
+int Ds18b20Bank::begin() {
+#if DS18B20_RESET_ROMS
+  Preferences prefs;
+  prefs.begin(NVS_NAMESPACE, false);
+  prefs.clear();
+  prefs.end();
+#endif
+  loadRoms();
+
+  bool changed = false;
+  uint8_t rom[8];
+  ow_.reset_search();
+  while (ow_.search(rom)) {
+    if (OneWire::crc8(rom, 7) != rom[7]) continue;
+    if (rom[0] != DS_FAMILY_DS18B20 && rom[0] != DS_FAMILY_DS1822) continue;
+    changed |= merge(rom);
+  }
+  if (changed) storeRoms();
+
+  int found = 0;
+  for (int i = 0; i < count_; i++) {
+    if (probes_[i].present) found++;
+  }
+  if (found == 0) return 0;
+
+  // A probe on parasite power pulls the line low during this time slot
+  ow_.reset();
+  ow_.skip();
+  ow_.write(DS_CMD_READ_POWER);
+  parasite_ = ow_.read_bit() == 0;
+
+  ow_.reset();
+  ow_.skip();
+  ow_.write(DS_CMD_WRITE_PAD);
+  ow_.write(0x4B);                                   // TH (alarm, unused)
+  ow_.write(0x46);                                   // TL (alarm, unused)
+  ow_.write((uint8_t)(((resolution_ - 9) << 5) | 0x1F));
+  ow_.reset();
+  return found;
+}
+
+bool Ds18b20Bank::pending(uint32_t nowMs) const {
+  if (count_ == 0) return false;
+  switch (phase_) {
+    case Phase::Idle:       return !started_ || (int32_t)(nowMs - nextConvertMs_) >= 0;
+    case Phase::Converting: return (int32_t)(nowMs - readyMs_) >= 0;
+    default:                return true;
+  }
+}
+
+/**
+ * Scheduler step
+ *
+ * Idle: broadcast Convert T to every probe (Skip ROM). Parasite-powered
+ * probes need the line held high through the conversion, which OneWire does
+ * after write(..., 1); nothing else uses the bus until the read phase.
+ * Converting: wait for the conversion window without touching the bus.
+ * Reading: one scratchpad per call, addressed by ROM ID, so the loop is
+ * never held for more than a single probe.
+ */
+bool Ds18b20Bank::update(uint32_t nowMs) {
+  if (count_ == 0) return false;
+  if (phase_ == Phase::Idle) {
+    if (started_ && (int32_t)(nowMs - nextConvertMs_) < 0) return false;
+    started_ = true;
+    nextConvertMs_ = nowMs + periodMs_;
+    if (!ow_.reset()) {                              // No presence pulse: bus empty or shorted
+      errors_++;
+      return false;
+    }
+    ow_.skip();
+    ow_.write(DS_CMD_CONVERT, parasite_ ? 1 : 0);
+    readyMs_ = nowMs + convertMs_;
+    next_ = 0;
+    phase_ = Phase::Converting;
+    return false;
+  }
+
+  if (phase_ == Phase::Converting) {
+    if ((int32_t)(nowMs - readyMs_) < 0) return false;
+    if (parasite_) ow_.depower();
+    phase_ = Phase::Reading;
+  }
+
+  // Every slot is tried, so a probe that was missing at boot comes back
+  Probe& p = probes_[next_];
+  p.present = readScratchpad(p.rom, p.tempC);
+  if (!p.present) {
+    p.tempC = NAN;
+    errors_++;
+  }
+
+  if (++next_ < count_) return false;
+  phase_ = Phase::Idle;
+  rounds_++;
+  return true;
+}
+
+float Ds18b20Bank::meanC() const {
+  float sum = 0;
+  int n = 0;
+  for (int i = 0; i < count_; i++) {
+    if (!isnan(probes_[i].tempC)) {
+      sum += probes_[i].tempC;
+      n++;
+    }
+  }
+  return n ? sum / n : NAN;
+}
+
+void Ds18b20Bank::print(Print& out) const {
+  out.print(F("DS18B20: ")); out.print(count_);
+  out.print(F(" probes, ")); out.print(convertMs_);
+  out.print(F(" ms/round, ")); out.print(rounds_);
+  out.print(F(" rounds, ")); out.print(errors_);
+  out.println(parasite_ ? F(" errors (parasite power)") : F(" errors"));
+  for (int i = 0; i < count_; i++) {
+    out.print(F("  ")); out.print(i + 1); out.print(' ');
+    for (int b = 0; b < 8; b++) {
+      if (probes_[i].rom[b] < 0x10) out.print('0');
+      out.print(probes_[i].rom[b], HEX);
+    }
+    out.print(F("  "));
+    if (isnan(probes_[i].tempC)) out.println(F("--.-")); else { out.print(probes_[i].tempC, 2); out.println(F(" C")); }
+  }
+}
+
+void Ds18b20Bank::loadRoms() {
+  Preferences prefs;
+  count_ = 0;
+  if (!prefs.begin(NVS_NAMESPACE, true)) return;     // Namespace not created yet
+  uint8_t buf[DS18B20_MAX_PROBES * 8];
+  const size_t len = prefs.getBytes(NVS_KEY_ROMS, buf, sizeof buf);
+  prefs.end();
+
+  for (size_t off = 0; off + 8 <= len; off += 8) {
+    Probe& p = probes_[count_++];
+    memcpy(p.rom, buf + off, 8);
+    p.present = false;
+    p.tempC = NAN;
+  }
+}
+
+void Ds18b20Bank::storeRoms() {
+  uint8_t buf[DS18B20_MAX_PROBES * 8];
+  for (int i = 0; i < count_; i++) memcpy(buf + i * 8, probes_[i].rom, 8);
+  Preferences prefs;
+  if (!prefs.begin(NVS_NAMESPACE, false)) return;
+  prefs.putBytes(NVS_KEY_ROMS, buf, count_ * 8);
+  prefs.end();
+}
+
+/**
+ * Mark a found probe present, appending it if it is new
+ * @return true if the stored list changed
+ */
+bool Ds18b20Bank::merge(const uint8_t* rom) {
+  for (int i = 0; i < count_; i++) {
+    if (memcmp(probes_[i].rom, rom, 8) == 0) {
+      probes_[i].present = true;
+      return false;
+    }
+  }
+  if (count_ >= DS18B20_MAX_PROBES) return false;
+  Probe& p = probes_[count_++];
+  memcpy(p.rom, rom, 8);
+  p.present = true;
+  p.tempC = NAN;
+  return true;
+}
+
+/**
+ * Read and check one scratchpad
+ * Undefined low bits are masked for resolutions below 12 bits.
+ */
+bool Ds18b20Bank::readScratchpad(const uint8_t* rom, float& tempC) {
+  uint8_t d[9];
+  if (!ow_.reset()) return false;
+  ow_.select(rom);
+  ow_.write(DS_CMD_READ_PAD);
+  ow_.read_bytes(d, sizeof d);
+  if (OneWire::crc8(d, 8) != d[8]) return false;
+
+  int16_t raw = (int16_t)(d[1] << 8 | d[0]);
+  if (raw == DS_POWER_ON_RAW) return false;
+  raw &= (int16_t)~((1 << (12 - resolution_)) - 1);
+  tempC = raw / 16.0f;
+  return true;
+}
@@ -0,0 +1,104 @@
+/**
+ * DS18B20 1-Wire Temperature Probes
+ *
+ * Reads several DS18B20 root-zone probes without blocking the loop. One
+ * Skip ROM + Convert T starts a conversion in every probe at once; the
+ * scratchpads are read by ROM ID after the conversion window, one probe per
+ * update() call. N probes therefore cost a single 750 ms window instead of
+ * N blocking 750 ms reads.
+ *
+ * Probe ROM IDs are discovered once at boot and stored in NVS (Preferences).
+ * Stored probes keep their slot numbers across reboots; newly found probes
+ * are appended, and probes that do not answer keep their slot and read NAN.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <OneWire.h>
+#include "Config.h"
+
+class Ds18b20Bank {
+public:
+  /**
+   * Constructor
+   * @param pin 1-Wire data GPIO
+   * @param resolution Conversion resolution in bits (9-12)
+   * @param periodMs Time between conversions
+   */
+  Ds18b20Bank(int pin, uint8_t resolution, uint32_t periodMs);
+
+  /**
+   * Load the stored ROM list, search the bus, merge and store the result,
+   * and set the resolution of all probes
+   * @return Number of probes that answered
+   */
+  int begin();
+
+  /**
+   * Check whether update() has bus work to do now
+   */
+  bool pending(uint32_t nowMs) const;
+
+  /**
+   * Start a conversion or read the next probe (non-blocking apart from one
+   * scratchpad read, ~10 ms of bit-banged bus time)
+   * @param nowMs Current time in milliseconds
+   * @return true if all probes have been read for this conversion
+   */
+  bool update(uint32_t nowMs);
+
+  int   count() const { return count_; }                    // Known probe slots
+  bool  present(int i) const { return probes_[i].present; }
+  float tempC(int i) const { return probes_[i].tempC; }     // NAN = no valid reading
+  const uint8_t* rom(int i) const { return probes_[i].rom; }
+
+  /**
+   * Mean temperature of all probes with a valid reading
+   * @return Temperature in Celsius, NAN if none
+   */
+  float meanC() const;
+
+  uint32_t conversionMs() const { return convertMs_; }
+  uint32_t rounds() const { return rounds_; }
+  uint32_t errors() const { return errors_; }               // CRC failures and missing probes
+  bool     parasite() const { return parasite_; }
+
+  /**
+   * Print slot, ROM ID and temperature of every probe, e.g.
+   *   DS18B20: 3 probes, 750 ms/round, 12 rounds, 0 errors
+   *     1 28FF4A1C60170345  21.44 C
+   */
+  void print(Print& out) const;
+
+private:
+  enum class Phase : uint8_t { Idle, Converting, Reading };
+
+  struct Probe {
+    uint8_t rom[8];
+    bool    present;
+    float   tempC;
+  };
+
+  OneWire  ow_;
+  uint8_t  resolution_;
+  uint32_t periodMs_;
+  uint32_t convertMs_;
+
+  Probe    probes_[DS18B20_MAX_PROBES] = {};
+  int      count_{0};
+  bool     parasite_{false};    // At least one probe draws power from the data line
+
+  Phase    phase_{Phase::Idle};
+  bool     started_{false};
+  uint32_t nextConvertMs_{0};
+  uint32_t readyMs_{0};
+  int      next_{0};            // Next probe slot to read
+
+  uint32_t rounds_{0};
+  uint32_t errors_{0};
+
+  void loadRoms();
+  void storeRoms();
+  bool merge(const uint8_t* rom);
+  bool readScratchpad(const uint8_t* rom, float& tempC);
+};
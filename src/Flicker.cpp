@@ -0,0 +1,116 @@
+/**
+ * Mains Flicker Detection Implementation
+ */
+
+#include "Flicker.h"
+#include <math.h>
+
+const char* lightSourceName(LightSource s) {
+  switch (s) {
+    case LightSource::Dark:       return "dark";
+    case LightSource::Natural:    return "sun";
+    case LightSource::Artificial: return "grow";
+    default:                      return "--";
+  }
+}
+
+FlickerDetector::FlickerDetector(float sampleHz, int n, float minRatio, float minRms, float darkMean)
+  : n_(n), c100_(coeffQ14(100.0f, sampleHz)), c120_(coeffQ14(120.0f, sampleHz)),
+    minRatio_(minRatio), minRms_(minRms), darkMean_(darkMean) {}
+
+int32_t FlickerDetector::coeffQ14(float targetHz, float sampleHz) {
+  return (int32_t)lroundf(2.0f * cosf(2.0f * (float)M_PI * targetHz / sampleHz) * 16384.0f);
+}
+
+/**
+ * Second-order Goertzel recurrence
+ *
+ *   s[n] = x[n] + c*s[n-1] - s[n-2]
+ *   P    = s1^2 + s2^2 - c*s1*s2
+ *
+ * The state grows at most by N * max|x| for an on-bin tone, which fits
+ * easily in 32 bits for short bursts of 12-bit samples.
+ */
+int64_t FlickerDetector::goertzelPower(const int16_t* x, int n, int32_t coeffQ14) {
+  int32_t s1 = 0, s2 = 0;
+  for (int i = 0; i < n; i++) {
+    const int32_t s0 = x[i] + (int32_t)(((int64_t)coeffQ14 * s1) >> 14) - s2;
+    s2 = s1;
+    s1 = s0;
+  }
+  const int64_t cross = ((int64_t)coeffQ14 * s1 >> 14) * s2;
+  return (int64_t)s1 * s1 + (int64_t)s2 * s2 - cross;
+}
+
+/**
+ * Classify a burst
+ *
+ * For a real tone on bin k, 2*|X_k|^2 / N equals its share of sum(x^2)
+ * (Parseval), so ratio = 2*P / (N * sum(x^2)) is the fraction of AC energy
+ * at that frequency, independent of light level and LDR gain.
+ */
+FlickerResult FlickerDetector::analyze(int16_t* x, int n) const {
+  FlickerResult r;
+  if (n <= 0) return r;
+  if (n > n_) n = n_;
+
+  int32_t sum = 0;
+  for (int i = 0; i < n; i++) sum += x[i];
+  const int16_t mean = (int16_t)(sum / n);
+  int64_t energy = 0;
+  for (int i = 0; i < n; i++) {
+    x[i] = (int16_t)(x[i] - mean);
+    energy += (int32_t)x[i] * x[i];
+  }
+  r.mean = (float)sum / (float)n;
+  r.rms = sqrtf((float)energy / (float)n);
+
+  if (r.mean < darkMean_) {
+    r.source = LightSource::Dark;
+    return r;
+  }
+  if (r.rms < minRms_ || energy == 0) {
+    r.source = LightSource::Natural;
+    return r;
+  }
+
+  const int64_t p100 = goertzelPower(x, n, c100_);
+  const int64_t p120 = goertzelPower(x, n, c120_);
+  const int64_t best = p100 > p120 ? p100 : p120;
+  r.ratio = 2.0f * (float)best / ((float)n * (float)energy);
+
+  if (r.ratio >= minRatio_) {
+    r.source = LightSource::Artificial;
+    r.mainsHz = p100 > p120 ? 50 : 60;
+  } else {
+    r.source = LightSource::Natural;
+  }
+  return r;
+}
+
+bool GrowLightLog::record(uint32_t nowMs, bool artificial) {
+  if (!started_) {
+    started_ = true;
+    startMs_ = nowMs;
+  }
+  if (artificial == on_) return false;
+
+  on_ = artificial;
+  if (on_) onSinceMs_ = nowMs;
+  else onTotalMs_ += nowMs - onSinceMs_;
+
+  events_[count_ % kEvents] = {nowMs, on_};
+  count_++;
+  return true;
+}
+
+const GrowLightLog::Event& GrowLightLog::event(int age) const {
+  return events_[(count_ - 1 - (uint32_t)age) % kEvents];
+}
+
+float GrowLightLog::dutyPct(uint32_t nowMs) const {
+  const uint32_t elapsed = nowMs - startMs_;
+  if (!started_ || elapsed == 0) return 0.0f;
+  const uint32_t onMs = onTotalMs_ + (on_ ? nowMs - onSinceMs_ : 0);
+  return 100.0f * (float)onMs / (float)elapsed;
+}
@@ -0,0 +1,140 @@
+/**
+ * Mains Flicker Detection
+ *
+ * Grow lights (LED drivers, HPS/fluorescent ballasts) flicker at twice the
+ * mains frequency: 100 Hz on 50 Hz grids, 120 Hz on 60 Hz grids. Sunlight
+ * does not. A short LDR burst at ~1 kS/s is run through two fixed-point
+ * Goertzel detectors and the share of AC energy at 100/120 Hz decides
+ * whether artificial light is present.
+ *
+ * Plain C++ (no Arduino dependencies) so the kernel can be tested and
+ * benchmarked on the host (see host/flicker_bench.cpp).
+ */
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * Light source classification
+ */
+enum class LightSource : uint8_t {
+  Unknown = 0,   // No analysis yet
+  Dark,          // Too little light to tell
+  Natural,       // Steady light (sunlight or flicker-free source)
+  Artificial     // Mains-frequency flicker present
+};
+
+/**
+ * Short label for display and logs ("--", "dark", "sun", "grow")
+ */
+const char* lightSourceName(LightSource s);
+
+/**
+ * Result of one burst analysis
+ */
+struct FlickerResult {
+  LightSource source = LightSource::Unknown;
+  uint8_t  mainsHz = 0;     // 50 or 60 when artificial, 0 otherwise
+  float    ratio = 0;       // Share of AC energy in the strongest flicker bin (0..1)
+  float    mean = 0;        // Mean raw ADC code of the burst
+  float    rms = 0;         // AC RMS in ADC codes
+};
+
+/**
+ * Goertzel detector pair at 100 Hz and 120 Hz
+ *
+ * Coefficients are Q14 fixed point; the recurrence runs in 32-bit integers
+ * with a 64-bit product, so a 200-sample burst of 12-bit codes cannot
+ * overflow.
+ */
+class FlickerDetector {
+public:
+  /**
+   * Constructor
+   * @param sampleHz Burst sample rate
+   * @param n Samples per burst
+   * @param minRatio Flicker energy share that counts as artificial
+   * @param minRms Smallest AC RMS (ADC codes) treated as signal rather than noise
+   * @param darkMean Mean code below which the scene is classified dark
+   */
+  FlickerDetector(float sampleHz, int n, float minRatio, float minRms, float darkMean);
+
+  /**
+   * Analyze one burst
+   *
+   * @param x Raw ADC codes; DC is removed in place
+   * @param n Number of samples (must match the constructor)
+   * @return Classification and signal statistics
+   */
+  FlickerResult analyze(int16_t* x, int n) const;
+
+  /**
+   * Goertzel power at one bin
+   *
+   * @param x DC-free samples
+   * @param n Number of samples
+   * @param coeffQ14 2*cos(2*pi*f/fs) in Q14
+   * @return |X(f)|^2 in code^2 units
+   */
+  static int64_t goertzelPower(const int16_t* x, int n, int32_t coeffQ14);
+
+  /**
+   * Compute a Q14 Goertzel coefficient for a target frequency
+   */
+  static int32_t coeffQ14(float targetHz, float sampleHz);
+
+private:
+  int     n_;
+  int32_t c100_;
+  int32_t c120_;
+  float   minRatio_;
+  float   minRms_;
+  float   darkMean_;
+};
+
+/**
+ * Grow-light on/off log
+ *
+ * Tracks transitions of the artificial-light classification, keeps the last
+ * few events and accumulates on-time so the lighting duty can be reported.
+ */
+class GrowLightLog {
+public:
+  struct Event {
+    uint32_t ms;    // Time of the transition
+    bool     on;    // true = grow light switched on
+  };
+  static const int kEvents = 16;
+
+  /**
+   * Record a classification
+   * @param nowMs Time of the analysis
+   * @param artificial true if grow light is present
+   * @return true if this is an on/off transition
+   */
+  bool record(uint32_t nowMs, bool artificial);
+
+  bool     on() const { return on_; }
+  int      count() const { return count_ < (uint32_t)kEvents ? (int)count_ : kEvents; }  // Events held
+  uint32_t transitions() const { return count_; }                                         // Events ever recorded
+
+  /**
+   * Event by age (0 = most recent)
+   */
+  const Event& event(int age) const;
+
+  /**
+   * Share of observed time the grow light was on
+   * @return Duty 0-100%
+   */
+  float dutyPct(uint32_t nowMs) const;
+
+private:
+  Event    events_[kEvents] = {};
+  uint32_t count_{0};
+  bool     on_{false};
+  bool     started_{false};
+  uint32_t startMs_{0};
+  uint32_t onSinceMs_{0};
+  uint32_t onTotalMs_{0};
+};
@@ -0,0 +1,169 @@
+/**
+ * Glyph Atlas (generated by tools/gen_glyph_atlas.py - do not edit)
+ *
+ * Pre-rendered 1-bpp glyphs of the 5x7 UI font (tools/font5x7.txt) for the 65
+ * characters the UI uses, at text sizes 1, 2. Each row of a cell is one
+ * word with the leftmost pixel in the most significant bit.
+ */
+
+#pragma once
+#include <stdint.h>
+
+namespace GlyphAtlas {
+
+  constexpr int     kCellW   = 6;     // Size-1 cell (glyph + spacing)
+  constexpr int     kCellH   = 8;
+  constexpr int     kGlyphs  = 65;
+  constexpr uint8_t kMissing = 21;    // Slot drawn for characters outside the atlas
+
+  // Characters in slot order: " %()*+,-./0123456789:?ABCDFGHIKLMNPRSTUVWabcdefghiklmnoprstuvwxyz"
+
+  // ASCII 0x20-0x7E -> atlas slot (0xFF = not in the atlas)
+  constexpr uint8_t kSlot[95] = {
+      0, 255, 255, 255, 255,   1, 255, 255,   2,   3,   4,   5,   6,   7,   8,   9,
+     10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20, 255, 255, 255, 255,  21,
+    255,  22,  23,  24,  25, 255,  26,  27,  28,  29, 255,  30,  31,  32,  33, 255,
+     34, 255,  35,  36,  37,  38,  39,  40, 255, 255, 255, 255, 255, 255, 255, 255,
+    255,  41,  42,  43,  44,  45,  46,  47,  48,  49, 255,  50,  51,  52,  53,  54,
+     55, 255,  56,  57,  58,  59,  60,  61,  62,  63,  64, 255, 255, 255, 255,
+  };
+
+  // Size 1: 6x8 cells, 8 rows per glyph
+  constexpr uint8_t kSize1[kGlyphs * 8] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // ' '
+    0xC0, 0xC8, 0x10, 0x20, 0x40, 0x98, 0x18, 0x00,  // '%'
+    0x10, 0x20, 0x40, 0x40, 0x40, 0x20, 0x10, 0x00,  // '('
+    0x40, 0x20, 0x10, 0x10, 0x10, 0x20, 0x40, 0x00,  // ')'
+    0x00, 0x20, 0xA8, 0x70, 0xA8, 0x20, 0x00, 0x00,  // '*'
+    0x00, 0x20, 0x20, 0xF8, 0x20, 0x20, 0x00, 0x00,  // '+'
+    0x00, 0x00, 0x00, 0x00, 0x60, 0x20, 0x40, 0x00,  // ','
+    0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00, 0x00,  // '-'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x60, 0x00,  // '.'
+    0x00, 0x08, 0x10, 0x20, 0x40, 0x80, 0x00, 0x00,  // '/'
+    0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70, 0x00,  // '0'
+    0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00,  // '1'
+    0x70, 0x88, 0x08, 0x10, 0x20, 0x40, 0xF8, 0x00,  // '2'
+    0xF8, 0x10, 0x20, 0x10, 0x08, 0x88, 0x70, 0x00,  // '3'
+    0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10, 0x00,  // '4'
+    0xF8, 0x80, 0xF0, 0x08, 0x08, 0x88, 0x70, 0x00,  // '5'
+    0x30, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70, 0x00,  // '6'
+    0xF8, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40, 0x00,  // '7'
+    0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70, 0x00,  // '8'
+    0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0x60, 0x00,  // '9'
+    0x00, 0x60, 0x60, 0x00, 0x60, 0x60, 0x00, 0x00,  // ':'
+    0x70, 0x88, 0x08, 0x10, 0x20, 0x00, 0x20, 0x00,  // '?'
+    0x70, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88, 0x00,  // 'A'
+    0xF0, 0x88, 0x88, 0xF0, 0x88, 0x88, 0xF0, 0x00,  // 'B'
+    0x70, 0x88, 0x80, 0x80, 0x80, 0x88, 0x70, 0x00,  // 'C'
+    0xE0, 0x90, 0x88, 0x88, 0x88, 0x90, 0xE0, 0x00,  // 'D'
+    0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0x80, 0x00,  // 'F'
+    0x70, 0x88, 0x80, 0xB8, 0x88, 0x88, 0x78, 0x00,  // 'G'
+    0x88, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88, 0x00,  // 'H'
+    0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00,  // 'I'
+    0x88, 0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x88, 0x00,  // 'K'
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xF8, 0x00,  // 'L'
+    0x88, 0xD8, 0xA8, 0xA8, 0x88, 0x88, 0x88, 0x00,  // 'M'
+    0x88, 0x88, 0xC8, 0xA8, 0x98, 0x88, 0x88, 0x00,  // 'N'
+    0xF0, 0x88, 0x88, 0xF0, 0x80, 0x80, 0x80, 0x00,  // 'P'
+    0xF0, 0x88, 0x88, 0xF0, 0xA0, 0x90, 0x88, 0x00,  // 'R'
+    0x78, 0x80, 0x80, 0x70, 0x08, 0x08, 0xF0, 0x00,  // 'S'
+    0xF8, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00,  // 'T'
+    0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70, 0x00,  // 'U'
+    0x88, 0x88, 0x88, 0x88, 0x88, 0x50, 0x20, 0x00,  // 'V'
+    0x88, 0x88, 0x88, 0xA8, 0xA8, 0xA8, 0x50, 0x00,  // 'W'
+    0x00, 0x00, 0x70, 0x08, 0x78, 0x88, 0x78, 0x00,  // 'a'
+    0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0xF0, 0x00,  // 'b'
+    0x00, 0x00, 0x70, 0x80, 0x80, 0x88, 0x70, 0x00,  // 'c'
+    0x08, 0x08, 0x68, 0x98, 0x88, 0x88, 0x78, 0x00,  // 'd'
+    0x00, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x70, 0x00,  // 'e'
+    0x30, 0x48, 0x40, 0xE0, 0x40, 0x40, 0x40, 0x00,  // 'f'
+    0x00, 0x78, 0x88, 0x88, 0x78, 0x08, 0x70, 0x00,  // 'g'
+    0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0x88, 0x00,  // 'h'
+    0x20, 0x00, 0x60, 0x20, 0x20, 0x20, 0x70, 0x00,  // 'i'
+    0x80, 0x80, 0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x00,  // 'k'
+    0x60, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00,  // 'l'
+    0x00, 0x00, 0xD0, 0xA8, 0xA8, 0x88, 0x88, 0x00,  // 'm'
+    0x00, 0x00, 0xB0, 0xC8, 0x88, 0x88, 0x88, 0x00,  // 'n'
+    0x00, 0x00, 0x70, 0x88, 0x88, 0x88, 0x70, 0x00,  // 'o'
+    0x00, 0x00, 0xF0, 0x88, 0xF0, 0x80, 0x80, 0x00,  // 'p'
+    0x00, 0x00, 0xB0, 0xC8, 0x80, 0x80, 0x80, 0x00,  // 'r'
+    0x00, 0x00, 0x70, 0x80, 0x70, 0x08, 0xF0, 0x00,  // 's'
+    0x40, 0x40, 0xE0, 0x40, 0x40, 0x48, 0x30, 0x00,  // 't'
+    0x00, 0x00, 0x88, 0x88, 0x88, 0x98, 0x68, 0x00,  // 'u'
+    0x00, 0x00, 0x88, 0x88, 0x88, 0x50, 0x20, 0x00,  // 'v'
+    0x00, 0x00, 0x88, 0x88, 0xA8, 0xA8, 0x50, 0x00,  // 'w'
+    0x00, 0x00, 0x88, 0x50, 0x20, 0x50, 0x88, 0x00,  // 'x'
+    0x00, 0x00, 0x88, 0x88, 0x78, 0x08, 0x70, 0x00,  // 'y'
+    0x00, 0x00, 0xF8, 0x10, 0x20, 0x40, 0xF8, 0x00,  // 'z'
+  };
+
+  // Size 2: 12x16 cells, 16 rows per glyph
+  constexpr uint16_t kSize2[kGlyphs * 16] = {
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // ' '
+    0xF000, 0xF000, 0xF0C0, 0xF0C0, 0x0300, 0x0300, 0x0C00, 0x0C00, 0x3000, 0x3000, 0xC3C0, 0xC3C0, 0x03C0, 0x03C0, 0x0000, 0x0000,  // '%'
+    0x0300, 0x0300, 0x0C00, 0x0C00, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x0C00, 0x0C00, 0x0300, 0x0300, 0x0000, 0x0000,  // '('
+    0x3000, 0x3000, 0x0C00, 0x0C00, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0300, 0x0C00, 0x0C00, 0x3000, 0x3000, 0x0000, 0x0000,  // ')'
+    0x0000, 0x0000, 0x0C00, 0x0C00, 0xCCC0, 0xCCC0, 0x3F00, 0x3F00, 0xCCC0, 0xCCC0, 0x0C00, 0x0C00, 0x0000, 0x0000, 0x0000, 0x0000,  // '*'
+    0x0000, 0x0000, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0xFFC0, 0xFFC0, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0000, 0x0000, 0x0000, 0x0000,  // '+'
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x3C00, 0x3C00, 0x0C00, 0x0C00, 0x3000, 0x3000, 0x0000, 0x0000,  // ','
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFFC0, 0xFFC0, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,  // '-'
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x3C00, 0x3C00, 0x3C00, 0x3C00, 0x0000, 0x0000,  // '.'
+    0x0000, 0x0000, 0x00C0, 0x00C0, 0x0300, 0x0300, 0x0C00, 0x0C00, 0x3000, 0x3000, 0xC000, 0xC000, 0x0000, 0x0000, 0x0000, 0x0000,  // '/'
+    0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0xC3C0, 0xC3C0, 0xCCC0, 0xCCC0, 0xF0C0, 0xF0C0, 0xC0C0, 0xC0C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // '0'
+    0x0C00, 0x0C00, 0x3C00, 0x3C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x3F00, 0x3F00, 0x0000, 0x0000,  // '1'
+    0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0x00C0, 0x00C0, 0x0300, 0x0300, 0x0C00, 0x0C00, 0x3000, 0x3000, 0xFFC0, 0xFFC0, 0x0000, 0x0000,  // '2'
+    0xFFC0, 0xFFC0, 0x0300, 0x0300, 0x0C00, 0x0C00, 0x0300, 0x0300, 0x00C0, 0x00C0, 0xC0C0, 0xC0C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // '3'
+    0x0300, 0x0300, 0x0F00, 0x0F00, 0x3300, 0x3300, 0xC300, 0xC300, 0xFFC0, 0xFFC0, 0x0300, 0x0300, 0x0300, 0x0300, 0x0000, 0x0000,  // '4'
+    0xFFC0, 0xFFC0, 0xC000, 0xC000, 0xFF00, 0xFF00, 0x00C0, 0x00C0, 0x00C0, 0x00C0, 0xC0C0, 0xC0C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // '5'
+    0x0F00, 0x0F00, 0x3000, 0x3000, 0xC000, 0xC000, 0xFF00, 0xFF00, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // '6'
+    0xFFC0, 0xFFC0, 0x00C0, 0x00C0, 0x0300, 0x0300, 0x0C00, 0x0C00, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x0000, 0x0000,  // '7'
+    0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // '8'
+    0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3FC0, 0x3FC0, 0x00C0, 0x00C0, 0x0300, 0x0300, 0x3C00, 0x3C00, 0x0000, 0x0000,  // '9'
+    0x0000, 0x0000, 0x3C00, 0x3C00, 0x3C00, 0x3C00, 0x0000, 0x0000, 0x3C00, 0x3C00, 0x3C00, 0x3C00, 0x0000, 0x0000, 0x0000, 0x0000,  // ':'
+    0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0x00C0, 0x00C0, 0x0300, 0x0300, 0x0C00, 0x0C00, 0x0000, 0x0000, 0x0C00, 0x0C00, 0x0000, 0x0000,  // '?'
+    0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xFFC0, 0xFFC0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x0000, 0x0000,  // 'A'
+    0xFF00, 0xFF00, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xFF00, 0xFF00, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xFF00, 0xFF00, 0x0000, 0x0000,  // 'B'
+    0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC0C0, 0xC0C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // 'C'
+    0xFC00, 0xFC00, 0xC300, 0xC300, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC300, 0xC300, 0xFC00, 0xFC00, 0x0000, 0x0000,  // 'D'
+    0xFFC0, 0xFFC0, 0xC000, 0xC000, 0xC000, 0xC000, 0xFF00, 0xFF00, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0x0000, 0x0000,  // 'F'
+    0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0xC000, 0xC000, 0xCFC0, 0xCFC0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3FC0, 0x3FC0, 0x0000, 0x0000,  // 'G'
+    0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xFFC0, 0xFFC0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x0000, 0x0000,  // 'H'
+    0x3F00, 0x3F00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x3F00, 0x3F00, 0x0000, 0x0000,  // 'I'
+    0xC0C0, 0xC0C0, 0xC300, 0xC300, 0xCC00, 0xCC00, 0xF000, 0xF000, 0xCC00, 0xCC00, 0xC300, 0xC300, 0xC0C0, 0xC0C0, 0x0000, 0x0000,  // 'K'
+    0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xFFC0, 0xFFC0, 0x0000, 0x0000,  // 'L'
+    0xC0C0, 0xC0C0, 0xF3C0, 0xF3C0, 0xCCC0, 0xCCC0, 0xCCC0, 0xCCC0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x0000, 0x0000,  // 'M'
+    0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xF0C0, 0xF0C0, 0xCCC0, 0xCCC0, 0xC3C0, 0xC3C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x0000, 0x0000,  // 'N'
+    0xFF00, 0xFF00, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xFF00, 0xFF00, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0x0000, 0x0000,  // 'P'
+    0xFF00, 0xFF00, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xFF00, 0xFF00, 0xCC00, 0xCC00, 0xC300, 0xC300, 0xC0C0, 0xC0C0, 0x0000, 0x0000,  // 'R'
+    0x3FC0, 0x3FC0, 0xC000, 0xC000, 0xC000, 0xC000, 0x3F00, 0x3F00, 0x00C0, 0x00C0, 0x00C0, 0x00C0, 0xFF00, 0xFF00, 0x0000, 0x0000,  // 'S'
+    0xFFC0, 0xFFC0, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0000, 0x0000,  // 'T'
+    0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // 'U'
+    0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3300, 0x3300, 0x0C00, 0x0C00, 0x0000, 0x0000,  // 'V'
+    0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xCCC0, 0xCCC0, 0xCCC0, 0xCCC0, 0xCCC0, 0xCCC0, 0x3300, 0x3300, 0x0000, 0x0000,  // 'W'
+    0x0000, 0x0000, 0x0000, 0x0000, 0x3F00, 0x3F00, 0x00C0, 0x00C0, 0x3FC0, 0x3FC0, 0xC0C0, 0xC0C0, 0x3FC0, 0x3FC0, 0x0000, 0x0000,  // 'a'
+    0xC000, 0xC000, 0xC000, 0xC000, 0xCF00, 0xCF00, 0xF0C0, 0xF0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xFF00, 0xFF00, 0x0000, 0x0000,  // 'b'
+    0x0000, 0x0000, 0x0000, 0x0000, 0x3F00, 0x3F00, 0xC000, 0xC000, 0xC000, 0xC000, 0xC0C0, 0xC0C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // 'c'
+    0x00C0, 0x00C0, 0x00C0, 0x00C0, 0x3CC0, 0x3CC0, 0xC3C0, 0xC3C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3FC0, 0x3FC0, 0x0000, 0x0000,  // 'd'
+    0x0000, 0x0000, 0x0000, 0x0000, 0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0xFFC0, 0xFFC0, 0xC000, 0xC000, 0x3F00, 0x3F00, 0x0000, 0x0000,  // 'e'
+    0x0F00, 0x0F00, 0x30C0, 0x30C0, 0x3000, 0x3000, 0xFC00, 0xFC00, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x3000, 0x0000, 0x0000,  // 'f'
+    0x0000, 0x0000, 0x3FC0, 0x3FC0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3FC0, 0x3FC0, 0x00C0, 0x00C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // 'g'
+    0xC000, 0xC000, 0xC000, 0xC000, 0xCF00, 0xCF00, 0xF0C0, 0xF0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x0000, 0x0000,  // 'h'
+    0x0C00, 0x0C00, 0x0000, 0x0000, 0x3C00, 0x3C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x3F00, 0x3F00, 0x0000, 0x0000,  // 'i'
+    0xC000, 0xC000, 0xC000, 0xC000, 0xC300, 0xC300, 0xCC00, 0xCC00, 0xF000, 0xF000, 0xCC00, 0xCC00, 0xC300, 0xC300, 0x0000, 0x0000,  // 'k'
+    0x3C00, 0x3C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x0C00, 0x3F00, 0x3F00, 0x0000, 0x0000,  // 'l'
+    0x0000, 0x0000, 0x0000, 0x0000, 0xF300, 0xF300, 0xCCC0, 0xCCC0, 0xCCC0, 0xCCC0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x0000, 0x0000,  // 'm'
+    0x0000, 0x0000, 0x0000, 0x0000, 0xCF00, 0xCF00, 0xF0C0, 0xF0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x0000, 0x0000,  // 'n'
+    0x0000, 0x0000, 0x0000, 0x0000, 0x3F00, 0x3F00, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // 'o'
+    0x0000, 0x0000, 0x0000, 0x0000, 0xFF00, 0xFF00, 0xC0C0, 0xC0C0, 0xFF00, 0xFF00, 0xC000, 0xC000, 0xC000, 0xC000, 0x0000, 0x0000,  // 'p'
+    0x0000, 0x0000, 0x0000, 0x0000, 0xCF00, 0xCF00, 0xF0C0, 0xF0C0, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0xC000, 0x0000, 0x0000,  // 'r'
+    0x0000, 0x0000, 0x0000, 0x0000, 0x3F00, 0x3F00, 0xC000, 0xC000, 0x3F00, 0x3F00, 0x00C0, 0x00C0, 0xFF00, 0xFF00, 0x0000, 0x0000,  // 's'
+    0x3000, 0x3000, 0x3000, 0x3000, 0xFC00, 0xFC00, 0x3000, 0x3000, 0x3000, 0x3000, 0x30C0, 0x30C0, 0x0F00, 0x0F00, 0x0000, 0x0000,  // 't'
+    0x0000, 0x0000, 0x0000, 0x0000, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC3C0, 0xC3C0, 0x3CC0, 0x3CC0, 0x0000, 0x0000,  // 'u'
+    0x0000, 0x0000, 0x0000, 0x0000, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3300, 0x3300, 0x0C00, 0x0C00, 0x0000, 0x0000,  // 'v'
+    0x0000, 0x0000, 0x0000, 0x0000, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0xCCC0, 0xCCC0, 0xCCC0, 0xCCC0, 0x3300, 0x3300, 0x0000, 0x0000,  // 'w'
+    0x0000, 0x0000, 0x0000, 0x0000, 0xC0C0, 0xC0C0, 0x3300, 0x3300, 0x0C00, 0x0C00, 0x3300, 0x3300, 0xC0C0, 0xC0C0, 0x0000, 0x0000,  // 'x'
+    0x0000, 0x0000, 0x0000, 0x0000, 0xC0C0, 0xC0C0, 0xC0C0, 0xC0C0, 0x3FC0, 0x3FC0, 0x00C0, 0x00C0, 0x3F00, 0x3F00, 0x0000, 0x0000,  // 'y'
+    0x0000, 0x0000, 0x0000, 0x0000, 0xFFC0, 0xFFC0, 0x0300, 0x0300, 0x0C00, 0x0C00, 0x3000, 0x3000, 0xFFC0, 0xFFC0, 0x0000, 0x0000,  // 'z'
+  };
+
+}  // namespace GlyphAtlas
@@ -0,0 +1,45 @@
+/**
+ * Reading History Implementation
+ */
+
+#include "History.h"
+#include <math.h>
+
+int16_t HistorySample::encode10(float v) {
+  if (isnan(v)) return kNoValue;
+  const float t = v * 10.0f;
+  if (t >= 32767.0f) return 32767;
+  if (t <= -32767.0f) return -32767;
+  return (int16_t)lroundf(t);
+}
+
+float HistorySample::decode10(int16_t v) {
+  return v == kNoValue ? NAN : v / 10.0f;
+}
+
+void History::add(const HistorySample& s) {
+  if (cap_ == 0) return;
+  buf_[next_ % cap_] = s;
+  next_++;
+  if (count_ < cap_) count_++;
+}
+
+const HistorySample& History::at(uint32_t i) const {
+  return buf_[(firstSeq() + i) % cap_];
+}
+
+bool History::bySeq(uint32_t seq, HistorySample& out) const {
+  if (seq - firstSeq() >= count_) return false;     // Unsigned: also rejects seq < firstSeq()
+  out = buf_[seq % cap_];
+  return true;
+}
+
+uint32_t History::seqAtOrAfter(uint32_t t) const {
+  uint32_t lo = 0, hi = count_;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (at(mid).t < t) lo = mid + 1;
+    else hi = mid;
+  }
+  return firstSeq() + lo;
+}
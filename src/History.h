@@ -0,0 +1,87 @@
+/**
+ * Reading History
+ *
+ * Fixed-size RAM ring of periodic readings for trend charts and exports.
+ * Values are stored as small fixed-point integers (10 bytes of payload per
+ * sample). Every sample gets a sequence number that keeps increasing when
+ * old samples are overwritten, so a reader can tell what it has already seen.
+ *
+ * Plain C++ (no Arduino dependencies); the storage is supplied by the caller.
+ */
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * One history sample
+ * Invalid values: kNoValue for the x10 fields, -1 for the percentages.
+ */
+struct HistorySample {
+  uint32_t t;              // Seconds since boot
+  int16_t  tempC10;        // Temperature in 0.1 C
+  int16_t  humidity10;     // Relative humidity in 0.1 %
+  int8_t   soilPct;        // Soil moisture 0-100 %
+  int8_t   lightPct;       // Light level 0-100 %
+
+  static const int16_t kNoValue = -32768;
+
+  /**
+   * Encode a float in tenths (NAN -> kNoValue)
+   */
+  static int16_t encode10(float v);
+
+  /**
+   * Decode tenths (kNoValue -> NAN)
+   */
+  static float decode10(int16_t v);
+};
+
+class History {
+public:
+  /**
+   * Constructor
+   * @param storage Sample buffer owned by the caller
+   * @param capacity Number of samples in the buffer
+   */
+  History(HistorySample* storage, uint32_t capacity) : buf_(storage), cap_(capacity) {}
+
+  /**
+   * Append a sample, overwriting the oldest when full
+   */
+  void add(const HistorySample& s);
+
+  uint32_t size() const { return count_; }
+  uint32_t capacity() const { return cap_; }
+
+  /**
+   * Sequence number of the oldest sample kept and of the next sample
+   * Samples [firstSeq(), nextSeq()) are available.
+   */
+  uint32_t firstSeq() const { return next_ - count_; }
+  uint32_t nextSeq() const { return next_; }
+
+  /**
+   * Sample by age order
+   * @param i 0 = oldest, size() - 1 = newest
+   */
+  const HistorySample& at(uint32_t i) const;
+
+  /**
+   * Sample by sequence number
+   * @return false if the sample was overwritten or does not exist yet
+   */
+  bool bySeq(uint32_t seq, HistorySample& out) const;
+
+  /**
+   * First sample at or after a time (binary search, samples are in time order)
+   * @param t Seconds since boot
+   * @return Its sequence number, or nextSeq() if all samples are older
+   */
+  uint32_t seqAtOrAfter(uint32_t t) const;
+
+private:
+  HistorySample* buf_;
+  uint32_t cap_;
+  uint32_t count_{0};
+  uint32_t next_{0};       // Sequence number of the next sample
+};
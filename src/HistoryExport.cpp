@@ -0,0 +1,41 @@
+/**
+ * History Export Implementation
+ */
+
+#include "HistoryExport.h"
+#include "Downsample.h"
+#include "HistoryStream.h"
+
+void HistoryExport::row(Print& out, uint32_t seq, const HistorySample& s) {
+  char line[HistoryStream::kMaxRow];
+  HistoryStream::csvRow(line, sizeof line, seq, s);
+  out.println(line);
+}
+
+uint32_t HistoryExport::csv(Print& out, const History& hist, Mode mode, uint32_t points, Channel channel) {
+  out.println(HistoryStream::csvHeader());
+  const uint32_t n = hist.size();
+  const uint32_t first = hist.firstSeq();
+
+  if (mode == Mode::Raw) {
+    for (uint32_t i = 0; i < n; i++) row(out, first + i, hist.at(i));
+    return n;
+  }
+
+  const uint32_t t0 = n ? hist.at(0).t : 0;
+  auto src = [&](uint32_t i, Downsample::Point& p) {
+    const HistorySample& s = hist.at(i);
+    p.x = (float)(s.t - t0);
+    switch (channel) {
+      case Channel::Temp:     p.y = HistorySample::decode10(s.tempC10);    break;
+      case Channel::Humidity: p.y = HistorySample::decode10(s.humidity10); break;
+      case Channel::Soil:     p.y = s.soilPct < 0 ? NAN : s.soilPct;       break;
+      case Channel::Light:    p.y = s.lightPct < 0 ? NAN : s.lightPct;     break;
+    }
+    return !isnan(p.y);
+  };
+  auto sink = [&](uint32_t i, const Downsample::Point&) { row(out, first + i, hist.at(i)); };
+
+  return mode == Mode::Lttb ? Downsample::lttb(src, n, points, sink)
+                            : Downsample::minMax(src, n, points, sink);
+}
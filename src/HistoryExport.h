@@ -0,0 +1,47 @@
+/**
+ * History Export
+ *
+ * Writes the reading history as CSV to any Print (Serial, a network
+ * client), one row at a time, so an export never buffers more than a line.
+ * Downsampled exports pick rows with LTTB or min/max buckets on one
+ * channel and write those rows whole.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "History.h"
+
+namespace HistoryExport {
+
+  /**
+   * Row selection
+   */
+  enum class Mode : uint8_t {
+    Raw,       // Every sample
+    Lttb,      // Largest-Triangle-Three-Buckets on the chosen channel
+    MinMax     // Minimum and maximum of the chosen channel per bucket
+  };
+
+  /**
+   * Channel the downsampler looks at
+   */
+  enum class Channel : uint8_t { Temp, Humidity, Soil, Light };
+
+  /**
+   * Write a CSV header and the selected rows
+   * Columns: seq,t_s,temp_c,humidity,soil_pct,light_pct (empty = invalid)
+   * 
+   * @param out Destination
+   * @param hist Reading history
+   * @param mode Row selection
+   * @param points Output points for Lttb / buckets for MinMax
+   * @param channel Channel the downsampler looks at
+   * @return Number of rows written
+   */
+  uint32_t csv(Print& out, const History& hist, Mode mode, uint32_t points, Channel channel);
+
+  /**
+   * Write one sample as a CSV row
+   */
+  void row(Print& out, uint32_t seq, const HistorySample& s);
+}
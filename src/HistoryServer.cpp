@@ -0,0 +1,222 @@
+/**
+ * History HTTP Endpoint Implementation
+ */
+
+#include "HistoryServer.h"
+#include "HistoryStream.h"
+#include "LzssPrint.h"
+#include "Net.h"
+#include "Pm.h"
+#include "Radio.h"
+#include "SyncServer.h"
+#include <new>
+
+#if WIFI_ENABLE && HTTP_ENABLE
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#endif
+
+namespace {
+  uint32_t g_requests = 0;
+  uint32_t g_bytes = 0;
+
+#if WIFI_ENABLE && HTTP_ENABLE
+  enum class State : uint8_t { Idle, Request, Sending };
+
+  const History* g_hist = nullptr;
+  WiFiServer     g_server(HTTP_PORT);
+  bool           g_listening = false;
+  WiFiClient     g_client;
+  State          g_state = State::Idle;
+  uint32_t       g_sinceMs = 0;
+
+  char           g_request[256];                   // Request line and headers
+  size_t         g_requestLen = 0;
+
+  uint8_t        g_buf[HTTP_CHUNK_BYTES];          // Chunk (or response head) in flight
+  size_t         g_len = 0;
+  size_t         g_off = 0;
+
+  // The stream lives in static storage; no heap per request
+  alignas(HistoryStream) uint8_t g_streamMem[sizeof(HistoryStream)];
+  HistoryStream* g_stream = nullptr;
+  uint32_t       g_startMs = 0;
+  uint32_t       g_streamBytes = 0;
+
+  void close() {
+    g_client.stop();
+    if (g_stream) {
+      const uint32_t ms = millis() - g_startMs;
+      Print& console = SyncServer::console();
+      console.print(F("HTTP /history: ")); console.print(g_stream->records());
+      console.print(F(" records, ")); console.print(g_streamBytes);
+      console.print(F(" bytes in ")); console.print(ms);
+      console.print(F(" ms (")); console.print(ms ? g_streamBytes / ms : 0);
+      console.print(F(" KB/s)"));
+      if (g_stream->skipped()) { console.print(F(", skipped ")); console.print(g_stream->skipped()); }
+      console.println();
+      g_stream->~HistoryStream();
+      g_stream = nullptr;
+    }
+    g_state = State::Idle;
+  }
+
+  /**
+   * Queue a response head (status line and headers)
+   */
+  void respond(const char* status, const char* contentType, bool chunked) {
+    g_len = snprintf((char*)g_buf, sizeof g_buf,
+                     "HTTP/1.1 %s\r\nContent-Type: %s\r\n%s\r\nConnection: close\r\n\r\n",
+                     status, contentType, chunked ? "Transfer-Encoding: chunked" : "Content-Length: 0");
+    g_off = 0;
+    g_state = State::Sending;
+  }
+
+  /**
+   * Parse "GET /history?... HTTP/1.1" and set up the response
+   */
+  void handleRequest() {
+    g_requests++;
+    char* line = g_request;
+    char* eol = strstr(line, "\r\n");
+    if (eol) *eol = '\0';
+
+    if (strncmp(line, "GET /history", 12) != 0 || (line[12] != ' ' && line[12] != '?')) {
+      respond("404 Not Found", "text/plain", false);
+      return;
+    }
+    char* query = line[12] == '?' ? line + 13 : line + 12;
+    char* sp = strchr(query, ' ');
+    if (sp) *sp = '\0';
+
+    HistoryQuery q;
+    if (!q.parse(query)) {
+      respond("400 Bad Request", "text/plain", false);
+      return;
+    }
+    g_stream = new (g_streamMem) HistoryStream(*g_hist, q);
+    if (q.compress) g_stream->compressWith(&LzssPrint::shared());
+    g_startMs = millis();
+    g_streamBytes = 0;
+    respond("200 OK", g_stream->contentType(), true);
+  }
+
+  /**
+   * Read the request until the blank line (non-blocking)
+   */
+  void readRequest(uint32_t nowMs) {
+    while (g_client.available() && g_requestLen < sizeof g_request - 1) {
+      g_request[g_requestLen++] = (char)g_client.read();
+      g_request[g_requestLen] = '\0';
+      if (g_requestLen >= 4 && !memcmp(g_request + g_requestLen - 4, "\r\n\r\n", 4)) {
+        handleRequest();
+        return;
+      }
+    }
+    if (g_requestLen >= sizeof g_request - 1) {
+      handleRequest();                             // Oversized headers: the request line is enough
+    } else if (!g_client.connected() || nowMs - g_sinceMs >= HTTP_REQUEST_TIMEOUT_MS) {
+      close();
+    }
+  }
+
+  /**
+   * Send until the socket would block
+   *
+   * send() with MSG_DONTWAIT returns EWOULDBLOCK once the lwIP send buffer
+   * is full, i.e. when the client's receive window is exhausted. The next
+   * chunk is only encoded after the current one has been taken in full.
+   */
+  void sendPending(uint32_t nowMs) {
+    Pm::Lock lock(Pm::Job::Network);
+    Radio::Activity radio(nowMs);
+    const int fd = g_client.fd();
+    const uint32_t t0 = millis();
+
+    while (millis() - t0 < HTTP_SLICE_MS) {
+      if (g_off == g_len) {
+        g_len = g_stream ? g_stream->nextChunk(g_buf, sizeof g_buf) : 0;
+        g_off = 0;
+        if (g_len == 0) {
+          close();
+          return;
+        }
+      }
+      const int n = send(fd, g_buf + g_off, g_len - g_off, MSG_DONTWAIT);
+      if (n > 0) {
+        g_off += n;
+        g_bytes += n;
+        g_streamBytes += n;
+      } else if (n < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) {
+        return;                                    // Window full: try again next pass
+      } else {
+        close();                                   // Client went away
+        return;
+      }
+    }
+  }
+#endif
+}
+
+void HistoryServer::begin(const History& hist) {
+#if WIFI_ENABLE && HTTP_ENABLE
+  g_hist = &hist;
+#else
+  (void)hist;
+#endif
+}
+
+/**
+ * Connection state machine
+ *
+ * Idle -> Request when a client connects; Request -> Sending once the
+ * header block is in; Sending -> Idle after the terminating chunk (or an
+ * error response) has been sent or the client has gone.
+ */
+void HistoryServer::update(uint32_t nowMs) {
+#if WIFI_ENABLE && HTTP_ENABLE
+  if (!g_hist) return;
+  if (!Net::connected()) {
+    if (g_state != State::Idle) close();
+    if (g_listening) { g_server.end(); g_listening = false; }
+    return;
+  }
+  if (!g_listening) {
+    g_server.begin();
+    g_listening = true;
+  }
+
+  switch (g_state) {
+    case State::Idle:
+      g_client = g_server.available();
+      if (g_client) {
+        g_client.setNoDelay(true);
+        g_requestLen = 0;
+        g_sinceMs = nowMs;
+        g_state = State::Request;
+      }
+      break;
+
+    case State::Request:
+      readRequest(nowMs);
+      break;
+
+    case State::Sending:
+      sendPending(nowMs);
+      break;
+  }
+#else
+  (void)nowMs;
+#endif
+}
+
+bool HistoryServer::compressing() {
+#if WIFI_ENABLE && HTTP_ENABLE
+  return g_stream && g_stream->compressed();
+#else
+  return false;
+#endif
+}
+
+uint32_t HistoryServer::requests() { return g_requests; }
+uint32_t HistoryServer::bytesSent() { return g_bytes; }
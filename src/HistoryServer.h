@@ -0,0 +1,41 @@
+/**
+ * History HTTP Endpoint
+ *
+ * Serves GET /history (see HistoryStream.h for the query) on HTTP_PORT,
+ * one client at a time, as a chunked response. The loop calls update();
+ * each call sends until the socket would block or HTTP_SLICE_MS has passed,
+ * so a slow client throttles the encoder instead of growing a buffer, and
+ * sampling and rendering keep running during a long transfer.
+ * Does nothing unless WIFI_ENABLE and HTTP_ENABLE are set.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "Config.h"
+#include "History.h"
+
+namespace HistoryServer {
+
+  /**
+   * Attach the history to serve
+   * The listening socket is opened once Wi-Fi connects.
+   */
+  void begin(const History& hist);
+
+  /**
+   * Accept, parse and stream (non-blocking)
+   * @param nowMs Current time in milliseconds
+   */
+  void update(uint32_t nowMs);
+
+  /**
+   * A z=1 response holds LzssPrint::shared()
+   */
+  bool compressing();
+
+  /**
+   * Transfer statistics
+   */
+  uint32_t requests();
+  uint32_t bytesSent();
+}
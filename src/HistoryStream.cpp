@@ -0,0 +1,209 @@
+/**
+ * History Stream Encoder Implementation
+ */
+
+#include "HistoryStream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// =============================================================================
+// Query Parsing
+// =============================================================================
+
+/**
+ * Parse one unsigned decimal value up to '&' or the end
+ */
+static bool parseU32(const char* s, size_t len, uint32_t& out) {
+  if (len == 0 || len > 10) return false;
+  uint64_t v = 0;
+  for (size_t i = 0; i < len; i++) {
+    if (s[i] < '0' || s[i] > '9') return false;
+    v = v * 10 + (uint32_t)(s[i] - '0');
+  }
+  if (v > 0xFFFFFFFFull) return false;
+  out = (uint32_t)v;
+  return true;
+}
+
+bool HistoryQuery::parse(const char* query) {
+  const char* p = query;
+  while (p && *p) {
+    const char* end = strchr(p, '&');
+    const size_t len = end ? (size_t)(end - p) : strlen(p);
+    const char* eq = (const char*)memchr(p, '=', len);
+    if (eq) {
+      const size_t klen = eq - p;
+      const char* v = eq + 1;
+      const size_t vlen = len - klen - 1;
+      if (klen == 4 && !strncmp(p, "from", 4)) { if (!parseU32(v, vlen, from)) return false; }
+      else if (klen == 2 && !strncmp(p, "to", 2)) { if (!parseU32(v, vlen, to)) return false; }
+      else if (klen == 4 && !strncmp(p, "step", 4)) { if (!parseU32(v, vlen, step)) return false; }
+      else if (klen == 3 && !strncmp(p, "fmt", 3)) {
+        if (vlen == 3 && !strncmp(v, "csv", 3)) format = Csv;
+        else if (vlen == 3 && !strncmp(v, "bin", 3)) format = Binary;
+        else return false;
+      }
+      else if (klen == 1 && *p == 'z') {
+        if (vlen == 1 && (*v == '0' || *v == '1')) compress = *v == '1';
+        else return false;
+      }
+    }
+    p = end ? end + 1 : nullptr;
+  }
+  return from <= to;
+}
+
+// =============================================================================
+// Record Encoding
+// =============================================================================
+
+int HistoryStream::csvRow(char* buf, size_t cap, uint32_t seq, const HistorySample& s) {
+  int n = snprintf(buf, cap, "%u,%u,", (unsigned)seq, (unsigned)s.t);
+  if (s.tempC10 != HistorySample::kNoValue) {
+    n += snprintf(buf + n, cap - n, "%s%d.%d", s.tempC10 < 0 ? "-" : "", abs(s.tempC10) / 10, abs(s.tempC10) % 10);
+  }
+  buf[n++] = ',';
+  if (s.humidity10 != HistorySample::kNoValue) {
+    n += snprintf(buf + n, cap - n, "%d.%d", s.humidity10 / 10, abs(s.humidity10) % 10);
+  }
+  buf[n++] = ',';
+  if (s.soilPct >= 0) n += snprintf(buf + n, cap - n, "%d", s.soilPct);
+  buf[n++] = ',';
+  if (s.lightPct >= 0) n += snprintf(buf + n, cap - n, "%d", s.lightPct);
+  buf[n] = '\0';
+  return n;
+}
+
+static uint8_t* putLe(uint8_t* p, uint32_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) *p++ = (uint8_t)(v >> (8 * i));
+  return p;
+}
+
+void HistoryStream::encodeBinary(uint8_t* out, uint32_t seq, const HistorySample& s) {
+  out = putLe(out, seq, 4);
+  out = putLe(out, s.t, 4);
+  out = putLe(out, (uint16_t)s.tempC10, 2);
+  out = putLe(out, (uint16_t)s.humidity10, 2);
+  out = putLe(out, (uint8_t)s.soilPct, 1);
+  putLe(out, (uint8_t)s.lightPct, 1);
+}
+
+size_t HistoryStream::encode(uint8_t* out, uint32_t seq, const HistorySample& s) const {
+  if (q_.format == HistoryQuery::Binary) {
+    encodeBinary(out, seq, s);
+    return kBinaryRecord;
+  }
+  const int n = csvRow((char*)out, kMaxRow, seq, s);
+  out[n] = '\r';
+  out[n + 1] = '\n';
+  return n + 2;
+}
+
+// =============================================================================
+// Chunk Production
+// =============================================================================
+
+HistoryStream::HistoryStream(const History& hist, const HistoryQuery& q)
+  : hist_(hist), q_(q), seq_(hist.seqAtOrAfter(q.from)) {}
+
+void HistoryStream::compressWith(LzssEncoder* enc) {
+  enc_ = enc;
+  if (enc_) enc_->reset();
+}
+
+const char* HistoryStream::contentType() const {
+  if (enc_) return "application/x-lzss";
+  return q_.format == HistoryQuery::Binary ? "application/octet-stream" : "text/csv";
+}
+
+/**
+ * Record selection
+ *
+ * A sample overwritten by the ring while the response is in flight is
+ * counted and skipped; step jumps straight to the next eligible sample.
+ */
+bool HistoryStream::nextRecord() {
+  if (q_.format == HistoryQuery::Csv && !headerSent_) {
+    const size_t h = strlen(csvHeader());
+    memcpy(row_, csvHeader(), h);
+    row_[h] = '\r';
+    row_[h + 1] = '\n';
+    rowLen_ = h + 2;
+    rowOff_ = 0;
+    headerSent_ = true;
+    return true;
+  }
+
+  for (;;) {
+    if ((int32_t)(seq_ - hist_.firstSeq()) < 0) {     // Overwritten since the last chunk
+      skipped_ += hist_.firstSeq() - seq_;
+      seq_ = hist_.firstSeq();
+    }
+    HistorySample s;
+    if (!hist_.bySeq(seq_, s) || s.t > q_.to) return false;
+    if (q_.step && any_ && s.t < nextT_) {
+      seq_ = hist_.seqAtOrAfter(nextT_);
+      continue;
+    }
+    rowLen_ = encode(row_, seq_, s);
+    rowOff_ = 0;
+    seq_++;
+    records_++;
+    any_ = true;
+    nextT_ = s.t + q_.step < s.t ? 0xFFFFFFFF : s.t + q_.step;
+    return true;
+  }
+}
+
+/**
+ * Fill one chunk
+ *
+ * The size line has a fixed width (4 hex digits, leading zeros are valid),
+ * so the payload is encoded in place after it. A record that does not fit
+ * stays in row_ for the next chunk. When compressing, records are fed to
+ * the encoder and the chunk is filled from its output.
+ */
+size_t HistoryStream::nextChunk(uint8_t* buf, size_t cap) {
+  if (state_ == State::Done) return 0;
+  if (state_ == State::Last) {
+    state_ = State::Done;
+    memcpy(buf, "0\r\n\r\n", 5);
+    return 5;
+  }
+
+  if (cap > 0xFFFF + 8) cap = 0xFFFF + 8;
+  const size_t room = cap - 8;                   // Size line (6) and trailing CRLF (2)
+  uint8_t* payload = buf + 6;
+  size_t len = 0;
+
+  for (;;) {
+    if (enc_) {
+      if (room - len >= 4) len += enc_->poll(payload + len, room - len);
+      if (room - len < 4) break;                 // Chunk full
+    }
+    if (rowOff_ == rowLen_ && (ended_ || !nextRecord())) {
+      ended_ = true;
+      if (!enc_) { state_ = State::Last; break; }
+      enc_->finish();
+      if (enc_->done()) { state_ = State::Last; break; }
+      continue;                                  // Drain the encoder
+    }
+    if (enc_) {
+      rowOff_ += enc_->sink(row_ + rowOff_, rowLen_ - rowOff_);
+    } else {
+      if (len + rowLen_ > room) break;           // Next chunk
+      memcpy(payload + len, row_, rowLen_);
+      len += rowLen_;
+      rowOff_ = rowLen_;
+    }
+  }
+
+  if (len == 0) return nextChunk(buf, cap);      // Nothing left: terminating chunk
+  char size[7];
+  snprintf(size, sizeof size, "%04X\r\n", (unsigned)len);
+  memcpy(buf, size, 6);
+  buf[6 + len] = '\r';
+  buf[7 + len] = '\n';
+  return len + 8;
+}
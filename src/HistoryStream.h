@@ -0,0 +1,128 @@
+/**
+ * History Stream Encoder
+ *
+ * Produces an HTTP/1.1 chunked response body for a time range of the
+ * reading history, one chunk at a time into a caller-supplied buffer. The
+ * only state is a sequence-number cursor, so memory is the same for ten
+ * samples or a week of them, and the caller asks for the next chunk only
+ * once the previous one has left the socket (TCP backpressure).
+ *
+ * Query string:  from=<s>&to=<s>&step=<s>&fmt=csv|bin&z=1
+ *   from, to   Time range in seconds since boot (inclusive, default all)
+ *   step       Minimum spacing between records in seconds (0 = every sample)
+ *   fmt        csv (default) or bin: 14-byte little-endian records
+ *              {u32 seq, u32 t, i16 temp x10, i16 humidity x10, i8 soil, i8 light}
+ *              (invalid: -32768 for the x10 fields, -1 for the percentages)
+ *   z          1 = LZSS-compress the body (see Lzss.h)
+ *
+ * Plain C++ (no Arduino dependencies); see host/history_http_bench.cpp.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "History.h"
+#include "Lzss.h"
+
+/**
+ * Parsed /history request
+ */
+struct HistoryQuery {
+  enum Format : uint8_t { Csv, Binary };
+
+  uint32_t from   = 0;
+  uint32_t to     = 0xFFFFFFFF;
+  uint32_t step   = 0;
+  Format   format = Csv;
+  bool     compress = false;
+
+  /**
+   * Parse a query string (without the '?')
+   * Unknown keys are ignored.
+   * @return false if a value is malformed
+   */
+  bool parse(const char* query);
+};
+
+class HistoryStream {
+public:
+  static const size_t kBinaryRecord = 14;        // Bytes per binary record
+  static const size_t kMaxRow       = 48;        // Longest CSV row including CRLF
+
+  /**
+   * Format one sample as a CSV row without a line ending
+   * Columns: seq,t_s,temp_c,humidity,soil_pct,light_pct (empty = invalid)
+   * @return Length written (excluding the terminator)
+   */
+  static int csvRow(char* buf, size_t cap, uint32_t seq, const HistorySample& s);
+
+  /**
+   * Encode one sample as a binary record (kBinaryRecord bytes)
+   */
+  static void encodeBinary(uint8_t* out, uint32_t seq, const HistorySample& s);
+
+  static const char* csvHeader() { return "seq,t_s,temp_c,humidity,soil_pct,light_pct"; }
+
+  /**
+   * Constructor
+   * @param hist Reading history (must outlive the stream)
+   * @param q Range, step and format
+   */
+  HistoryStream(const History& hist, const HistoryQuery& q);
+
+  /**
+   * Compress the body with this encoder (reset here, used until done)
+   * Must be set before the first chunk; nullptr = plain body.
+   */
+  void compressWith(LzssEncoder* enc);
+  bool compressed() const { return enc_ != nullptr; }
+
+  /**
+   * Content-Type of the response body
+   */
+  const char* contentType() const;
+
+  /**
+   * Encode the next chunk (size line, payload, CRLF)
+   * The final call produces the zero-length terminating chunk.
+   *
+   * @param buf Destination
+   * @param cap Buffer size (at least kMaxRow + 16, at most 65535 + 8)
+   * @return Bytes written, 0 once the terminating chunk has been produced
+   */
+  size_t nextChunk(uint8_t* buf, size_t cap);
+
+  bool done() const { return state_ == State::Done; }
+
+  /**
+   * Records sent so far and samples lost to ring overwrites mid-stream
+   */
+  uint32_t records() const { return records_; }
+  uint32_t skipped() const { return skipped_; }
+
+private:
+  enum class State : uint8_t { Records, Last, Done };
+
+  const History& hist_;
+  HistoryQuery   q_;
+  LzssEncoder*   enc_{nullptr};
+  State          state_{State::Records};
+  bool           headerSent_{false};
+  bool           ended_{false};                 // No more records
+  uint8_t        row_[kMaxRow + 2];             // Encoded record not yet in a chunk
+  size_t         rowLen_{0};
+  size_t         rowOff_{0};
+  uint32_t       seq_;                          // Next sample to consider
+  uint32_t       nextT_{0};                     // Earliest time of the next record (step)
+  bool           any_{false};
+  uint32_t       records_{0};
+  uint32_t       skipped_{0};
+
+  size_t encode(uint8_t* out, uint32_t seq, const HistorySample& s) const;
+
+  /**
+   * Encode the next record (or the CSV header) into row_
+   * @return false at the end of the range
+   */
+  bool nextRecord();
+};
@@ -0,0 +1,85 @@
+/**
+ * I2C Bus Scheduler Implementation
+ */
+
+#include "I2CBus.h"
+
+bool I2CScheduler::add(I2CDevice* dev) {
+  if (count_ >= kMaxDevices || !dev) return false;
+  slots_[count_++] = {dev, false, false, 0};
+  return true;
+}
+
+int I2CScheduler::begin() {
+  int found = 0;
+  for (int i = 0; i < count_; i++) {
+    slots_[i].present = slots_[i].dev->probe(bus_);
+    if (slots_[i].present) found++;
+  }
+  return found;
+}
+
+bool I2CScheduler::present(const I2CDevice* dev) const {
+  for (int i = 0; i < count_; i++) {
+    if (slots_[i].dev == dev) return slots_[i].present;
+  }
+  return false;
+}
+
+bool I2CScheduler::pending(uint32_t nowMs) const {
+  if (!sweeping_) return !started_ || (int32_t)(nowMs - nextSweepMs_) >= 0;
+  for (int i = 0; i < count_; i++) {
+    if (slots_[i].busy && (int32_t)(nowMs - slots_[i].readyMs) >= 0) return true;
+  }
+  return false;
+}
+
+/**
+ * Scheduler step
+ *
+ * Sweep start: every present device gets its start() transaction in turn;
+ * the conversions then run in parallel inside the sensors. Later calls
+ * collect whichever devices are ready. The sweep ends when no device is busy.
+ */
+bool I2CScheduler::update(uint32_t nowMs) {
+  if (!sweeping_) {
+    if (started_ && (int32_t)(nowMs - nextSweepMs_) < 0) return false;
+    started_ = true;
+    sweeping_ = true;
+    sweepStartMs_ = nowMs;
+    nextSweepMs_ = nowMs + periodMs_;
+
+    uint32_t sum = 0;
+    for (int i = 0; i < count_; i++) {
+      Slot& s = slots_[i];
+      if (!s.present) continue;
+      const uint32_t wait = s.dev->start(bus_);
+      if (wait == I2CDevice::kFailed) {
+        errors_++;
+        continue;
+      }
+      s.busy = true;
+      s.readyMs = nowMs + wait;
+      sum += wait;
+    }
+    sequentialMs_ = sum;
+  }
+
+  bool anyBusy = false;
+  for (int i = 0; i < count_; i++) {
+    Slot& s = slots_[i];
+    if (!s.busy) continue;
+    if ((int32_t)(nowMs - s.readyMs) < 0) {
+      anyBusy = true;
+      continue;
+    }
+    if (!s.dev->collect(bus_)) errors_++;
+    s.busy = false;
+  }
+
+  if (anyBusy) return false;
+  sweeping_ = false;
+  lastSweepMs_ = nowMs - sweepStartMs_;
+  sweeps_++;
+  return true;
+}
@@ -0,0 +1,140 @@
+/**
+ * Asynchronous I2C Sensor Bus Scheduler
+ *
+ * Digital climate sensors (SHT3x, BME280, ...) spend most of a measurement
+ * waiting for their own conversion, not on the bus. The scheduler starts a
+ * conversion on every device back to back, returns to the loop, and reads
+ * each device once its conversion time has passed. A bus sweep therefore
+ * costs the longest conversion instead of the sum of all of them, and the
+ * loop is never blocked for more than one short transaction.
+ *
+ * Plain C++ (no Arduino dependencies): the transport is an interface, so
+ * drivers and scheduler run unchanged against a fake bus on the host
+ * (see host/i2c_fake_bus.cpp). I2CEsp.h provides the ESP-IDF transport.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Byte-level I2C transport
+ * Each call is one complete transaction (START ... STOP). Returns false on
+ * NACK, timeout or arbitration loss.
+ */
+class I2CTransport {
+public:
+  virtual ~I2CTransport() {}
+  virtual bool write(uint8_t addr, const uint8_t* data, size_t len) = 0;
+  virtual bool read(uint8_t addr, uint8_t* data, size_t len) = 0;
+
+  /**
+   * Write then read with a repeated START (register reads)
+   */
+  virtual bool writeRead(uint8_t addr, const uint8_t* wr, size_t wrLen, uint8_t* rd, size_t rdLen) = 0;
+};
+
+/**
+ * Sensor driver interface
+ * A measurement is split into start() and collect() so the scheduler can
+ * overlap the conversion times of several devices.
+ */
+class I2CDevice {
+public:
+  virtual ~I2CDevice() {}
+
+  virtual const char* name() const = 0;
+
+  /**
+   * Detect and configure the device (called once at startup)
+   * @return true if the device answered and was configured
+   */
+  virtual bool probe(I2CTransport& bus) = 0;
+
+  /**
+   * Trigger one measurement
+   * @return Conversion time in milliseconds, or kFailed
+   */
+  virtual uint32_t start(I2CTransport& bus) = 0;
+
+  /**
+   * Read back the measurement started by start()
+   * @return true if a valid result was decoded
+   */
+  virtual bool collect(I2CTransport& bus) = 0;
+
+  static const uint32_t kFailed = 0xFFFFFFFFu;
+};
+
+/**
+ * Bus scheduler
+ *
+ * Runs a sweep every periodMs: starts all present devices, then collects
+ * each one when its conversion is done. Keeps timing statistics so the
+ * overlapped sweep time can be compared with the sequential cost.
+ */
+class I2CScheduler {
+public:
+  static const int kMaxDevices = 8;
+
+  /**
+   * Constructor
+   * @param bus Transport used for all devices
+   * @param periodMs Time between sweep starts
+   */
+  I2CScheduler(I2CTransport& bus, uint32_t periodMs) : bus_(bus), periodMs_(periodMs) {}
+
+  /**
+   * Register a driver (before begin())
+   * @return false if the device table is full
+   */
+  bool add(I2CDevice* dev);
+
+  /**
+   * Probe all registered devices
+   * @return Number of devices that answered
+   */
+  int begin();
+
+  /**
+   * Check whether update() has bus work to do now
+   * Lets callers take locks (full clock) only when needed.
+   */
+  bool pending(uint32_t nowMs) const;
+
+  /**
+   * Start a sweep or collect finished conversions (non-blocking)
+   * @param nowMs Current time in milliseconds
+   * @return true if a sweep completed during this call
+   */
+  bool update(uint32_t nowMs);
+
+  bool present(const I2CDevice* dev) const;
+  uint32_t lastSweepMs() const { return lastSweepMs_; }       // Start-to-last-collect time
+  uint32_t sequentialMs() const { return sequentialMs_; }     // Sum of conversion times (blocking cost)
+  uint32_t sweeps() const { return sweeps_; }
+  uint32_t errors() const { return errors_; }
+
+private:
+  struct Slot {
+    I2CDevice* dev;
+    bool       present;
+    bool       busy;        // Conversion started, not collected yet
+    uint32_t   readyMs;     // Earliest collect time
+  };
+
+  I2CTransport& bus_;
+  uint32_t periodMs_;
+  Slot     slots_[kMaxDevices] = {};
+  int      count_{0};
+
+  bool     sweeping_{false};
+  bool     started_{false};
+  uint32_t sweepStartMs_{0};
+  uint32_t nextSweepMs_{0};
+
+  uint32_t lastSweepMs_{0};
+  uint32_t sequentialMs_{0};
+  uint32_t sweeps_{0};
+  uint32_t errors_{0};
+};
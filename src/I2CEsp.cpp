@@ -0,0 +1,63 @@
+/**
+ * ESP-IDF I2C Transport Implementation
+ */
+
+#include "I2CEsp.h"
+
+static const TickType_t I2C_TIMEOUT_TICKS = pdMS_TO_TICKS(10);
+
+bool EspI2CTransport::begin() {
+  i2c_config_t conf = {};
+  conf.mode = I2C_MODE_MASTER;
+  conf.sda_io_num = sda_;
+  conf.scl_io_num = scl_;
+  conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
+  conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
+  conf.master.clk_speed = hz_;
+  if (i2c_param_config(port_, &conf) != ESP_OK) return false;
+  return i2c_driver_install(port_, I2C_MODE_MASTER, 0, 0, 0) == ESP_OK;
+}
+
+/**
+ * Execute and free a command link, timing the blocked period
+ */
+bool EspI2CTransport::run(i2c_cmd_handle_t cmd) {
+  const uint32_t t0 = micros();
+  const esp_err_t err = i2c_master_cmd_begin(port_, cmd, I2C_TIMEOUT_TICKS);
+  busyUs_ += micros() - t0;
+  transactions_++;
+  i2c_cmd_link_delete(cmd);
+  return err == ESP_OK;
+}
+
+bool EspI2CTransport::write(uint8_t addr, const uint8_t* data, size_t len) {
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+  i2c_master_start(cmd);
+  i2c_master_write_byte(cmd, (uint8_t)(addr << 1 | I2C_MASTER_WRITE), true);
+  if (len) i2c_master_write(cmd, data, len, true);
+  i2c_master_stop(cmd);
+  return run(cmd);
+}
+
+bool EspI2CTransport::read(uint8_t addr, uint8_t* data, size_t len) {
+  if (len == 0) return false;
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+  i2c_master_start(cmd);
+  i2c_master_write_byte(cmd, (uint8_t)(addr << 1 | I2C_MASTER_READ), true);
+  i2c_master_read(cmd, data, len, I2C_MASTER_LAST_NACK);
+  i2c_master_stop(cmd);
+  return run(cmd);
+}
+
+bool EspI2CTransport::writeRead(uint8_t addr, const uint8_t* wr, size_t wrLen, uint8_t* rd, size_t rdLen) {
+  if (rdLen == 0) return false;
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+  i2c_master_start(cmd);
+  i2c_master_write_byte(cmd, (uint8_t)(addr << 1 | I2C_MASTER_WRITE), true);
+  i2c_master_write(cmd, wr, wrLen, true);
+  i2c_master_start(cmd);                                  // Repeated START
+  i2c_master_write_byte(cmd, (uint8_t)(addr << 1 | I2C_MASTER_READ), true);
+  i2c_master_read(cmd, rd, rdLen, I2C_MASTER_LAST_NACK);
+  i2c_master_stop(cmd);
+  return run(cmd);
+}
@@ -0,0 +1,49 @@
+/**
+ * ESP-IDF I2C Transport
+ *
+ * I2CTransport on top of the ESP-IDF master driver. Each transaction is
+ * built as a command link and executed by the interrupt-driven driver; the
+ * calling task blocks only for the bytes on the wire (tens to hundreds of
+ * microseconds at 400 kHz), never for a sensor's conversion time.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <driver/i2c.h>
+#include "I2CBus.h"
+
+class EspI2CTransport : public I2CTransport {
+public:
+  /**
+   * Constructor
+   * @param port I2C controller (I2C_NUM_0 / I2C_NUM_1)
+   * @param sda SDA GPIO
+   * @param scl SCL GPIO
+   * @param hz Bus clock
+   */
+  EspI2CTransport(i2c_port_t port, int sda, int scl, uint32_t hz)
+    : port_(port), sda_(sda), scl_(scl), hz_(hz) {}
+
+  /**
+   * Configure the pins and install the master driver
+   * @return true on success
+   */
+  bool begin();
+
+  bool write(uint8_t addr, const uint8_t* data, size_t len) override;
+  bool read(uint8_t addr, uint8_t* data, size_t len) override;
+  bool writeRead(uint8_t addr, const uint8_t* wr, size_t wrLen, uint8_t* rd, size_t rdLen) override;
+
+  uint32_t transactions() const { return transactions_; }
+  uint32_t busyMicros() const { return busyUs_; }       // Time spent blocked on the bus
+
+private:
+  i2c_port_t port_;
+  int        sda_;
+  int        scl_;
+  uint32_t   hz_;
+  uint32_t   transactions_{0};
+  uint32_t   busyUs_{0};
+
+  bool run(i2c_cmd_handle_t cmd);
+};
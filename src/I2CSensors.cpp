@@ -0,0 +1,162 @@
+/**
+ * I2C Climate Sensor Drivers Implementation
+ */
+
+#include "I2CSensors.h"
+
+// =============================================================================
+// SHT3x
+// =============================================================================
+
+static const uint16_t SHT3X_CMD_MEASURE = 0x2400;   // Single shot, high repeatability, no stretch
+static const uint16_t SHT3X_CMD_STATUS  = 0xF32D;   // Read status register
+static const uint32_t SHT3X_CONVERT_MS  = 16;       // Max 15.5 ms at high repeatability
+
+uint8_t Sht3x::crc8(const uint8_t* data, int len) {
+  uint8_t crc = 0xFF;
+  for (int i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+/**
+ * Probe by reading the status register (checksummed, so a stray device at
+ * the same address is not mistaken for an SHT3x)
+ */
+bool Sht3x::probe(I2CTransport& bus) {
+  const uint8_t cmd[2] = {SHT3X_CMD_STATUS >> 8, SHT3X_CMD_STATUS & 0xFF};
+  uint8_t st[3];
+  if (!bus.writeRead(addr_, cmd, 2, st, 3)) return false;
+  return crc8(st, 2) == st[2];
+}
+
+uint32_t Sht3x::start(I2CTransport& bus) {
+  const uint8_t cmd[2] = {SHT3X_CMD_MEASURE >> 8, SHT3X_CMD_MEASURE & 0xFF};
+  valid_ = false;                                   // No stale result if the device drops off
+  return bus.write(addr_, cmd, 2) ? SHT3X_CONVERT_MS : kFailed;
+}
+
+bool Sht3x::collect(I2CTransport& bus) {
+  uint8_t d[6];
+  if (!bus.read(addr_, d, 6)) return false;
+  if (crc8(d, 2) != d[2] || crc8(d + 3, 2) != d[5]) return false;
+
+  const uint16_t rawT = (uint16_t)(d[0] << 8 | d[1]);
+  const uint16_t rawH = (uint16_t)(d[3] << 8 | d[4]);
+  tempC_ = -45.0f + 175.0f * (float)rawT / 65535.0f;
+  humidity_ = 100.0f * (float)rawH / 65535.0f;
+  valid_ = true;
+  return true;
+}
+
+// =============================================================================
+// BME280
+// =============================================================================
+
+static const uint8_t BME280_REG_CALIB0   = 0x88;
+static const uint8_t BME280_REG_CHIP_ID  = 0xD0;
+static const uint8_t BME280_REG_CALIB1   = 0xE1;
+static const uint8_t BME280_REG_CTRL_HUM = 0xF2;
+static const uint8_t BME280_REG_CTRL_MEAS = 0xF4;
+static const uint8_t BME280_REG_DATA     = 0xF7;
+static const uint8_t BME280_CHIP_ID      = 0x60;
+static const uint8_t BME280_FORCED_X1    = (1 << 5) | (1 << 2) | 0x01;  // osrs_t=1, osrs_p=1, forced
+static const uint32_t BME280_CONVERT_MS  = 10;   // 1.25 + 3 * 2.3 + 2 * 0.575 ms, rounded up
+
+bool Bme280::readReg(I2CTransport& bus, uint8_t reg, uint8_t* out, size_t len) {
+  return bus.writeRead(addr_, &reg, 1, out, len);
+}
+
+bool Bme280::writeReg(I2CTransport& bus, uint8_t reg, uint8_t value) {
+  const uint8_t d[2] = {reg, value};
+  return bus.write(addr_, d, 2);
+}
+
+/**
+ * Check the chip ID, load the calibration block and set humidity
+ * oversampling (ctrl_hum only takes effect on the next ctrl_meas write)
+ */
+bool Bme280::probe(I2CTransport& bus) {
+  uint8_t id = 0;
+  if (!readReg(bus, BME280_REG_CHIP_ID, &id, 1) || id != BME280_CHIP_ID) return false;
+
+  uint8_t a[26], b[7];
+  if (!readReg(bus, BME280_REG_CALIB0, a, sizeof a)) return false;
+  if (!readReg(bus, BME280_REG_CALIB1, b, sizeof b)) return false;
+
+  auto u16 = [](const uint8_t* p) { return (uint16_t)(p[0] | p[1] << 8); };
+  cal_.T1 = u16(a + 0);            cal_.T2 = (int16_t)u16(a + 2);  cal_.T3 = (int16_t)u16(a + 4);
+  cal_.P1 = u16(a + 6);            cal_.P2 = (int16_t)u16(a + 8);  cal_.P3 = (int16_t)u16(a + 10);
+  cal_.P4 = (int16_t)u16(a + 12);  cal_.P5 = (int16_t)u16(a + 14); cal_.P6 = (int16_t)u16(a + 16);
+  cal_.P7 = (int16_t)u16(a + 18);  cal_.P8 = (int16_t)u16(a + 20); cal_.P9 = (int16_t)u16(a + 22);
+  cal_.H1 = a[25];
+  cal_.H2 = (int16_t)u16(b + 0);
+  cal_.H3 = b[2];
+  cal_.H4 = (int16_t)((int8_t)b[3] * 16 | (b[4] & 0x0F));
+  cal_.H5 = (int16_t)((int8_t)b[5] * 16 | (b[4] >> 4));
+  cal_.H6 = (int8_t)b[6];
+
+  return writeReg(bus, BME280_REG_CTRL_HUM, 0x01);
+}
+
+uint32_t Bme280::start(I2CTransport& bus) {
+  valid_ = false;
+  return writeReg(bus, BME280_REG_CTRL_MEAS, BME280_FORCED_X1) ? BME280_CONVERT_MS : kFailed;
+}
+
+bool Bme280::collect(I2CTransport& bus) {
+  uint8_t d[8];
+  if (!readReg(bus, BME280_REG_DATA, d, sizeof d)) return false;
+
+  const int32_t adcP = (int32_t)d[0] << 12 | (int32_t)d[1] << 4 | d[2] >> 4;
+  const int32_t adcT = (int32_t)d[3] << 12 | (int32_t)d[4] << 4 | d[5] >> 4;
+  const int32_t adcH = (int32_t)d[6] << 8 | d[7];
+  if (adcT == 0x80000) return false;                // Measurement skipped / not ready
+
+  float pa;
+  compensate(cal_, adcT, adcP, adcH, tempC_, pa, humidity_);
+  pressureHpa_ = pa / 100.0f;
+  valid_ = true;
+  return true;
+}
+
+/**
+ * Datasheet integer compensation (BME280 datasheet section 4.2.3)
+ * Temperature in 0.01 C, pressure in Q24.8 Pa, humidity in Q22.10 %RH.
+ */
+void Bme280::compensate(const Calib& c, int32_t adcT, int32_t adcP, int32_t adcH,
+                        float& tempC, float& pressurePa, float& humidity) {
+  int32_t var1 = ((((adcT >> 3) - ((int32_t)c.T1 << 1))) * (int32_t)c.T2) >> 11;
+  int32_t var2 = (((((adcT >> 4) - (int32_t)c.T1) * ((adcT >> 4) - (int32_t)c.T1)) >> 12) *
+                  (int32_t)c.T3) >> 14;
+  const int32_t tFine = var1 + var2;
+  tempC = (float)((tFine * 5 + 128) >> 8) / 100.0f;
+
+  int64_t p1 = (int64_t)tFine - 128000;
+  int64_t p2 = p1 * p1 * (int64_t)c.P6;
+  p2 = p2 + ((p1 * (int64_t)c.P5) << 17);
+  p2 = p2 + ((int64_t)c.P4 << 35);
+  p1 = ((p1 * p1 * (int64_t)c.P3) >> 8) + ((p1 * (int64_t)c.P2) << 12);
+  p1 = ((((int64_t)1) << 47) + p1) * (int64_t)c.P1 >> 33;
+  if (p1 == 0) {
+    pressurePa = 0;
+  } else {
+    int64_t p = 1048576 - adcP;
+    p = (((p << 31) - p2) * 3125) / p1;
+    p1 = ((int64_t)c.P9 * (p >> 13) * (p >> 13)) >> 25;
+    p2 = ((int64_t)c.P8 * p) >> 19;
+    p = ((p + p1 + p2) >> 8) + ((int64_t)c.P7 << 4);
+    pressurePa = (float)p / 256.0f;
+  }
+
+  int32_t h = tFine - 76800;
+  h = (((((adcH << 14) - ((int32_t)c.H4 << 20) - ((int32_t)c.H5 * h)) + 16384) >> 15) *
+       (((((((h * (int32_t)c.H6) >> 10) * (((h * (int32_t)c.H3) >> 11) + 32768)) >> 10) + 2097152) *
+         (int32_t)c.H2 + 8192) >> 14));
+  h = h - (((((h >> 15) * (h >> 15)) >> 7) * (int32_t)c.H1) >> 4);
+  if (h < 0) h = 0;
+  if (h > 419430400) h = 419430400;
+  humidity = (float)(h >> 12) / 1024.0f;
+}
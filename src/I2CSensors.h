@@ -0,0 +1,90 @@
+/**
+ * I2C Climate Sensor Drivers
+ *
+ * Split-phase drivers (start / collect) for the I2C bus scheduler:
+ * - Sensirion SHT3x: temperature and humidity, single-shot mode
+ * - Bosch BME280: temperature, humidity and pressure, forced mode
+ *
+ * Plain C++ (no Arduino dependencies).
+ */
+
+#pragma once
+#include "I2CBus.h"
+
+/**
+ * Sensirion SHT30/31/35 in single-shot, high-repeatability mode
+ * without clock stretching (the bus stays free during conversion).
+ */
+class Sht3x : public I2CDevice {
+public:
+  explicit Sht3x(uint8_t addr = 0x44) : addr_(addr) {}
+
+  const char* name() const override { return "SHT3x"; }
+  bool probe(I2CTransport& bus) override;
+  uint32_t start(I2CTransport& bus) override;
+  bool collect(I2CTransport& bus) override;
+
+  bool  valid() const { return valid_; }
+  float tempC() const { return tempC_; }
+  float humidity() const { return humidity_; }
+
+  /**
+   * Sensirion CRC-8 (poly 0x31, init 0xFF) over a data word
+   */
+  static uint8_t crc8(const uint8_t* data, int len);
+
+private:
+  uint8_t addr_;
+  bool    valid_{false};
+  float   tempC_{0};
+  float   humidity_{0};
+};
+
+/**
+ * Bosch BME280 in forced mode with x1 oversampling on all channels
+ * Compensation uses the datasheet's integer reference formulas.
+ */
+class Bme280 : public I2CDevice {
+public:
+  explicit Bme280(uint8_t addr = 0x76) : addr_(addr) {}
+
+  const char* name() const override { return "BME280"; }
+  bool probe(I2CTransport& bus) override;
+  uint32_t start(I2CTransport& bus) override;
+  bool collect(I2CTransport& bus) override;
+
+  bool  valid() const { return valid_; }
+  float tempC() const { return tempC_; }
+  float humidity() const { return humidity_; }
+  float pressureHpa() const { return pressureHpa_; }
+
+  /**
+   * Factory compensation coefficients (registers 0x88-0xA1, 0xE1-0xE7)
+   */
+  struct Calib {
+    uint16_t T1; int16_t T2, T3;
+    uint16_t P1; int16_t P2, P3, P4, P5, P6, P7, P8, P9;
+    uint8_t  H1; int16_t H2; uint8_t H3; int16_t H4, H5; int8_t H6;
+  };
+
+  /**
+   * Compensate raw ADC values
+   *
+   * @param c Calibration coefficients
+   * @param adcT, adcP, adcH Raw 20/20/16-bit readings
+   * @param tempC, pressurePa, humidity Outputs
+   */
+  static void compensate(const Calib& c, int32_t adcT, int32_t adcP, int32_t adcH,
+                         float& tempC, float& pressurePa, float& humidity);
+
+private:
+  uint8_t addr_;
+  Calib   cal_{};
+  bool    valid_{false};
+  float   tempC_{0};
+  float   humidity_{0};
+  float   pressureHpa_{0};
+
+  bool readReg(I2CTransport& bus, uint8_t reg, uint8_t* out, size_t len);
+  bool writeReg(I2CTransport& bus, uint8_t reg, uint8_t value);
+};
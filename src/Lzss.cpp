@@ -0,0 +1,130 @@
+/**
+ * Streaming LZSS Compression Implementation
+ */
+
+#include "Lzss.h"
+#include <string.h>
+
+using namespace Lzss;
+
+void LzssEncoder::reset() {
+  pos_ = end_ = 0;
+  bits_ = 0;
+  bitCount_ = 0;
+  finishing_ = false;
+  bytesIn_ = bytesOut_ = 0;
+  memset(head_, 0xFF, sizeof head_);             // -1
+}
+
+size_t LzssEncoder::sink(const uint8_t* in, size_t len) {
+  const size_t room = (size_t)(kBufSize - end_);
+  if (len > room) len = room;
+  memcpy(buf_ + end_, in, len);
+  end_ += (int)len;
+  bytesIn_ += len;
+  return len;
+}
+
+/**
+ * Add a position to its hash chain (needs the byte after it)
+ */
+void LzssEncoder::insert(int p) {
+  if (p + 1 >= end_) return;
+  const int h = hash(buf_ + p);
+  prev_[p] = head_[h];
+  head_[h] = (int16_t)p;
+}
+
+/**
+ * Longest earlier match for the bytes at pos_
+ * Walks at most kMaxChain candidates of the hash chain, newest first, so
+ * ties go to the shortest distance.
+ */
+int LzssEncoder::longestMatch(int& dist) {
+  int maxLen = end_ - pos_;
+  if (maxLen > kMaxMatch) maxLen = kMaxMatch;
+  if (maxLen < kMinMatch) return 0;
+
+  const uint8_t* cur = buf_ + pos_;
+  int best = 0;
+  int cand = head_[hash(cur)];
+  for (int tries = 0; cand >= 0 && pos_ - cand <= kWindow && tries < kMaxChain; tries++) {
+    const uint8_t* c = buf_ + cand;
+    if (c[best] == cur[best]) {                  // Quick reject: must beat the current best
+      int n = 0;
+      while (n < maxLen && c[n] == cur[n]) n++;
+      if (n > best) {
+        best = n;
+        dist = pos_ - cand;
+        if (n == maxLen) break;
+      }
+    }
+    cand = prev_[cand];
+  }
+  return best;
+}
+
+/**
+ * Drop the oldest window of history once the encoder is two windows in
+ */
+void LzssEncoder::slide() {
+  const int keep = end_ - kWindow;
+  memmove(buf_, buf_ + kWindow, keep);
+  memmove(prev_, prev_ + kWindow, keep * sizeof prev_[0]);
+  for (int i = 0; i < keep; i++) prev_[i] = prev_[i] >= kWindow ? (int16_t)(prev_[i] - kWindow) : -1;
+  for (int i = 0; i < (1 << kHashBits); i++) head_[i] = head_[i] >= kWindow ? (int16_t)(head_[i] - kWindow) : -1;
+  pos_ -= kWindow;
+  end_ -= kWindow;
+}
+
+void LzssEncoder::put(uint32_t value, int count) {
+  bits_ = bits_ << count | value;
+  bitCount_ += count;
+}
+
+size_t LzssEncoder::flushBytes(uint8_t* out, size_t cap, bool all) {
+  size_t n = 0;
+  while (bitCount_ >= 8 && n < cap) {
+    out[n++] = (uint8_t)(bits_ >> (bitCount_ - 8));
+    bitCount_ -= 8;
+  }
+  if (all && bitCount_ > 0 && n < cap) {
+    out[n++] = (uint8_t)(bits_ << (8 - bitCount_));
+    bitCount_ = 0;
+  }
+  bits_ &= (1u << bitCount_) - 1;
+  return n;
+}
+
+/**
+ * Encode as much as the output and the lookahead allow
+ *
+ * Until finish(), a token is only chosen with a full kMaxMatch of
+ * lookahead, so stream chunking never changes the output.
+ */
+size_t LzssEncoder::poll(uint8_t* out, size_t cap) {
+  size_t n = flushBytes(out, cap, false);
+  while (cap - n >= 3) {                         // 7 pending + 16 token bits
+    const int avail = end_ - pos_;
+    if (avail == 0 || (!finishing_ && avail < kMaxMatch)) break;
+
+    int dist = 0;
+    const int len = longestMatch(dist);
+    if (len >= kMinMatch) {
+      put(0, 1);
+      put(dist - 1, kWindowBits);
+      put(len - kMinMatch, kLengthBits);
+      for (int k = 0; k < len; k++) insert(pos_ + k);
+      pos_ += len;
+    } else {
+      put(0x100 | buf_[pos_], 9);
+      insert(pos_);
+      pos_++;
+    }
+    n += flushBytes(out + n, cap - n, false);
+    if (pos_ >= 2 * kWindow) slide();
+  }
+  if (finishing_ && pos_ == end_) n += flushBytes(out + n, cap - n, true);
+  bytesOut_ += n;
+  return n;
+}
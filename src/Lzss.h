@@ -0,0 +1,146 @@
+/**
+ * Streaming LZSS Compression
+ *
+ * heatshrink-style LZSS with a 1 KB window: small enough to run next to the
+ * network stack, effective on CSV and record streams where rows repeat
+ * most of the previous row. The bitstream is a sequence of tokens:
+ *
+ *   1 <8-bit literal>
+ *   0 <10-bit distance - 1> <5-bit length - 2>     copy 2..33 bytes from
+ *                                                  1..1024 bytes back
+ *
+ * The last byte is padded with zero bits; a padding run is always shorter
+ * than a back-reference, so a decoder stops cleanly at the end of input.
+ *
+ * The encoder works like heatshrink's: sink() takes input while there is
+ * room in its buffer, poll() produces compressed bytes and finish() flushes
+ * the tail. Memory is fixed (about 7 KB, no heap), so it can be put in
+ * front of any export path that already streams.
+ *
+ * Plain C++ (no Arduino dependencies); host/lzss_tool.cpp decompresses and
+ * benchmarks it.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Lzss {
+  static const int kWindowBits = 10;
+  static const int kLengthBits = 5;
+  static const int kWindow     = 1 << kWindowBits;
+  static const int kMinMatch   = 2;                              // Break-even: 16 vs 18 bits
+  static const int kMaxMatch   = kMinMatch + (1 << kLengthBits) - 1;
+}
+
+class LzssEncoder {
+public:
+  LzssEncoder() { reset(); }
+
+  /**
+   * Start a new stream
+   */
+  void reset();
+
+  /**
+   * Copy input into the encoder
+   * @return Bytes taken (less than len when the buffer is full; poll() first)
+   */
+  size_t sink(const uint8_t* in, size_t len);
+
+  /**
+   * Produce compressed output
+   * @param out Destination
+   * @param cap Destination size (at least 4 bytes)
+   * @return Bytes written (0 when nothing more can be produced yet)
+   */
+  size_t poll(uint8_t* out, size_t cap);
+
+  /**
+   * Mark the end of input; poll() then drains everything, including the
+   * padded final byte
+   */
+  void finish() { finishing_ = true; }
+
+  /**
+   * True once finish() was called and all output has been polled
+   */
+  bool done() const { return finishing_ && pos_ == end_ && bitCount_ == 0; }
+
+  uint32_t bytesIn() const { return bytesIn_; }
+  uint32_t bytesOut() const { return bytesOut_; }
+
+private:
+  static const int kBufSize  = 2 * Lzss::kWindow + Lzss::kMaxMatch;
+  static const int kHashBits = 9;
+  static const int kMaxChain = 16;                               // Candidates tried per position
+
+  uint8_t  buf_[kBufSize];       // [0, pos_) = history, [pos_, end_) = lookahead
+  int16_t  head_[1 << kHashBits];// Latest position per 2-byte hash (-1 = none)
+  int16_t  prev_[kBufSize];      // Previous position with the same hash
+  int      pos_;                 // Next byte to encode
+  int      end_;                 // End of input
+  uint32_t bits_;                // Pending output bits (MSB first)
+  int      bitCount_;
+  bool     finishing_;
+  uint32_t bytesIn_;
+  uint32_t bytesOut_;
+
+  static int hash(const uint8_t* p) { return ((p[0] << 4) ^ p[1]) & ((1 << kHashBits) - 1); }
+
+  void insert(int p);
+  int  longestMatch(int& dist);
+  void slide();
+  void put(uint32_t value, int count);
+  size_t flushBytes(uint8_t* out, size_t cap, bool all);
+};
+
+/**
+ * Streaming decoder (window ring, no other state beyond the bit reader)
+ */
+class LzssDecoder {
+public:
+  /**
+   * Decode input as it arrives
+   * @param out Called with each decoded byte: void(uint8_t)
+   * @return Bytes of output produced by this call
+   */
+  template <class Sink>
+  size_t feed(const uint8_t* in, size_t len, Sink&& out) {
+    size_t produced = 0;
+    for (size_t i = 0; i < len; i++) {
+      bits_ = bits_ << 8 | in[i];
+      bitCount_ += 8;
+      for (;;) {
+        if (bitCount_ < 1) break;
+        const bool literal = (bits_ >> (bitCount_ - 1)) & 1;
+        const int need = literal ? 9 : 1 + Lzss::kWindowBits + Lzss::kLengthBits;
+        if (bitCount_ < need) break;
+        const uint32_t token = (bits_ >> (bitCount_ - need)) & ((1u << need) - 1);
+        bitCount_ -= need;
+        if (literal) {
+          emit((uint8_t)token, out);
+          produced++;
+        } else {
+          const int dist = (int)(token >> Lzss::kLengthBits & (Lzss::kWindow - 1)) + 1;
+          const int n = (int)(token & ((1 << Lzss::kLengthBits) - 1)) + Lzss::kMinMatch;
+          for (int k = 0; k < n; k++) emit(window_[(head_ - dist) & (Lzss::kWindow - 1)], out);
+          produced += n;
+        }
+      }
+    }
+    return produced;
+  }
+
+private:
+  uint8_t  window_[Lzss::kWindow] = {};
+  uint32_t head_{0};
+  uint32_t bits_{0};
+  int      bitCount_{0};
+
+  template <class Sink>
+  void emit(uint8_t b, Sink& out) {
+    window_[head_++ & (Lzss::kWindow - 1)] = b;
+    out(b);
+  }
+};
@@ -0,0 +1,53 @@
+/**
+ * Compressing Print Adapter Implementation
+ */
+
+#include "LzssPrint.h"
+
+LzssPrint::LzssPrint(Print& dst, LzssEncoder& enc) : dst_(dst), enc_(enc) {
+  enc_.reset();
+}
+
+LzssEncoder& LzssPrint::shared() {
+  static LzssEncoder enc;
+  return enc;
+}
+
+size_t LzssPrint::write(const uint8_t* buf, size_t len) {
+  size_t done = 0;
+  while (done < len) {
+    const uint32_t t0 = micros();
+    done += enc_.sink(buf + done, len - done);
+    encodeUs_ += micros() - t0;
+    drain();
+  }
+  return len;
+}
+
+/**
+ * Move encoder output into blocks, sending each block as it fills
+ */
+void LzssPrint::drain() {
+  for (;;) {
+    if (sizeof block_ - blockLen_ < 4) sendBlock();
+    const uint32_t t0 = micros();
+    const size_t n = enc_.poll(block_ + blockLen_, sizeof block_ - blockLen_);
+    encodeUs_ += micros() - t0;
+    if (n == 0) return;
+    blockLen_ += n;
+  }
+}
+
+void LzssPrint::sendBlock() {
+  if (blockLen_ == 0) return;
+  dst_.write(blockLen_);
+  dst_.write(block_, blockLen_);
+  blockLen_ = 0;
+}
+
+void LzssPrint::finish() {
+  enc_.finish();
+  while (!enc_.done()) drain();
+  sendBlock();
+  dst_.write((uint8_t)0);
+}
@@ -0,0 +1,55 @@
+/**
+ * Compressing Print Adapter
+ *
+ * Puts the LZSS encoder in front of any Print (Serial, a network client),
+ * so an existing text export can be sent compressed without changes.
+ * Output is framed for byte streams that carry other traffic too: blocks
+ * of [length (1..255)][compressed bytes], ended by a zero length byte.
+ * host/lzss_tool.cpp decodes a capture containing such a stream.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "Lzss.h"
+
+class LzssPrint : public Print {
+public:
+  /**
+   * Constructor
+   * @param dst Destination for the framed compressed stream
+   * @param enc Encoder to use (reset here; about 7 KB, so callers share one)
+   */
+  LzssPrint(Print& dst, LzssEncoder& enc);
+
+  /**
+   * The one encoder for the loop task's compressed exports (serial 'z' and
+   * HTTP z=1); only one of them may use it at a time
+   */
+  static LzssEncoder& shared();
+
+  size_t write(uint8_t b) override { return write(&b, 1); }
+  size_t write(const uint8_t* buf, size_t len) override;
+
+  /**
+   * Flush the encoder and write the end-of-stream block
+   */
+  void finish();
+
+  uint32_t bytesIn() const { return enc_.bytesIn(); }
+  uint32_t bytesOut() const { return enc_.bytesOut(); }
+
+  /**
+   * Time spent in the encoder (excludes writing to dst)
+   */
+  uint32_t encodeMicros() const { return encodeUs_; }
+
+private:
+  Print&       dst_;
+  LzssEncoder& enc_;
+  uint8_t      block_[255];
+  uint8_t      blockLen_{0};
+  uint32_t     encodeUs_{0};
+
+  void drain();
+  void sendBlock();
+};
@@ -0,0 +1,89 @@
+/**
+ * Wi-Fi Connection Management Implementation
+ */
+
+#include "Net.h"
+#include "Radio.h"
+#include "SyncServer.h"
+
+#if WIFI_ENABLE
+#include <WiFi.h>
+#include "Secrets.h"
+#endif
+
+namespace {
+  enum class State : uint8_t { Off, Connecting, Connected };
+
+  State    g_state = State::Off;
+  uint32_t g_sinceMs = 0;       // Time of the last state change
+
+#if WIFI_ENABLE
+  /**
+   * Begin an association attempt
+   * The whole attempt (scan, auth, DHCP) is TX-heavy, so it is one activity window.
+   */
+  void connect(uint32_t nowMs) {
+    Radio::begin(nowMs);
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    g_state = State::Connecting;
+    g_sinceMs = nowMs;
+  }
+#endif
+}
+
+void Net::begin() {
+#if WIFI_ENABLE
+  WiFi.mode(WIFI_STA);
+  WiFi.setSleep(true);                 // Modem sleep: radio wakes for DTIM beacons only
+  WiFi.setAutoReconnect(false);        // Reconnects are scheduled by update()
+  connect(millis());
+#endif
+}
+
+/**
+ * Connection state machine
+ *
+ * Connecting -> Connected when an IP is assigned; Connecting -> Off after
+ * WIFI_CONNECT_TIMEOUT_MS; Off -> Connecting again after WIFI_RETRY_MS
+ * (stretched by the radio duty cycle).
+ */
+void Net::update(uint32_t nowMs) {
+#if WIFI_ENABLE
+  const bool up = WiFi.status() == WL_CONNECTED;
+
+  switch (g_state) {
+    case State::Connecting:
+      if (up) {
+        Radio::end(nowMs);
+        g_state = State::Connected;
+        g_sinceMs = nowMs;
+        SyncServer::console().print(F("Wi-Fi connected: ")); SyncServer::console().println(WiFi.localIP());
+      } else if (nowMs - g_sinceMs >= WIFI_CONNECT_TIMEOUT_MS) {
+        WiFi.disconnect();
+        Radio::end(nowMs);
+        g_state = State::Off;
+        g_sinceMs = nowMs;
+        SyncServer::console().println(F("Wi-Fi connect timed out"));
+      }
+      break;
+
+    case State::Connected:
+      if (!up) {
+        g_state = State::Off;
+        g_sinceMs = nowMs;
+        SyncServer::console().println(F("Wi-Fi lost"));
+      }
+      break;
+
+    case State::Off:
+      if (nowMs - g_sinceMs >= Radio::stretch(WIFI_RETRY_MS)) connect(nowMs);
+      break;
+  }
+#else
+  (void)nowMs;
+#endif
+}
+
+bool Net::connected() {
+  return g_state == State::Connected;
+}
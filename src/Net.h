@@ -0,0 +1,32 @@
+/**
+ * Wi-Fi Connection Management
+ *
+ * Keeps the station connected to the network in Secrets.h with modem sleep
+ * enabled, reconnecting in the background after failures. Connection
+ * attempts are marked as radio activity so analog sampling can avoid them.
+ * Does nothing when WIFI_ENABLE is 0.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "Config.h"
+
+namespace Net {
+
+  /**
+   * Start connecting (non-blocking)
+   * Must be called once during setup
+   */
+  void begin();
+
+  /**
+   * Track connection state and retry after failures (non-blocking)
+   * @param nowMs Current time in milliseconds
+   */
+  void update(uint32_t nowMs);
+
+  /**
+   * Check whether the station has an IP address
+   */
+  bool connected();
+}
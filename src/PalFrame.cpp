@@ -0,0 +1,112 @@
+/**
+ * Palettized Frame Buffer Implementation
+ */
+
+#include "PalFrame.h"
+#include "GlyphAtlas.h"
+#include <string.h>
+
+void PalFrame::clear(uint8_t idx) {
+  memset(px_, (idx & 0x0F) * 0x11, sizeof px_);
+}
+
+/**
+ * Rectangle fill
+ * Whole byte pairs are set with memset; only odd edge pixels go through
+ * the nibble path.
+ */
+void PalFrame::fillRect(int x, int y, int w, int h, uint8_t idx) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > kWidth)  w = kWidth - x;
+  if (y + h > kHeight) h = kHeight - y;
+  if (w <= 0 || h <= 0) return;
+
+  idx &= 0x0F;
+  for (int r = y; r < y + h; r++) {
+    int x0 = x, x1 = x + w;
+    if (x0 & 1) pixel(x0++, r, idx);
+    if (x1 & 1) pixel(--x1, r, idx);
+    if (x1 > x0) memset(px_ + r * kStride + (x0 >> 1), idx * 0x11, (x1 - x0) >> 1);
+  }
+}
+
+/**
+ * Bresenham line
+ */
+void PalFrame::line(int x0, int y0, int x1, int y1, uint8_t idx) {
+  const int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+  const int dy = y1 > y0 ? y0 - y1 : y1 - y0;            // Negative
+  const int sx = x0 < x1 ? 1 : -1;
+  const int sy = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+
+  idx &= 0x0F;
+  for (;;) {
+    if (x0 >= 0 && x0 < kWidth && y0 >= 0 && y0 < kHeight) pixel(x0, y0, idx);
+    if (x0 == x1 && y0 == y1) break;
+    const int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+}
+
+int PalFrame::text(int x, int y, const char* s, uint8_t size, uint8_t fg, uint8_t bg) {
+  size = size >= 2 ? 2 : 1;
+  const int cw = GlyphAtlas::kCellW * size;
+  const int ch = GlyphAtlas::kCellH * size;
+  if (y < 0 || y + ch > kHeight || x < 0) return 0;
+
+  int drawn = 0;
+  for (; *s && x + cw <= kWidth; s++, x += cw, drawn += cw) {
+    const uint8_t c = (uint8_t)*s;
+    uint8_t slot = (c >= 0x20 && c <= 0x7E) ? GlyphAtlas::kSlot[c - 0x20] : 0xFF;
+    if (slot == 0xFF) slot = GlyphAtlas::kMissing;
+
+    for (int r = 0; r < ch; r++) {
+      uint16_t bits = size == 1 ? (uint16_t)(GlyphAtlas::kSize1[slot * 8 + r] << 8)
+                                : GlyphAtlas::kSize2[slot * 16 + r];
+      for (int px = 0; px < cw; px++, bits <<= 1) pixel(x + px, y + r, (bits & 0x8000) ? fg : bg);
+    }
+  }
+  return drawn;
+}
+
+bool PalFrame::rowsEqual(const PalFrame& other, int y0, int rows) const {
+  if (y0 + rows > kHeight) rows = kHeight - y0;
+  return memcmp(px_ + y0 * kStride, other.px_ + y0 * kStride, rows * kStride) == 0;
+}
+
+// =============================================================================
+// PaletteLut
+// =============================================================================
+
+void PaletteLut::set(const uint16_t* rgb565, int n) {
+  for (int i = 0; i < 16; i++) {
+    const uint16_t c = i < n ? rgb565[i] : 0;
+    pal_[i] = (uint16_t)(c << 8 | c >> 8);
+  }
+  // Little-endian: the left pixel (high nibble) goes to the lower address
+  for (int b = 0; b < 256; b++) {
+    pair_[b] = (uint32_t)pal_[b >> 4] | (uint32_t)pal_[b & 0x0F] << 16;
+  }
+}
+
+void PaletteLut::expand(const uint8_t* src, uint16_t* dst, int bytes) const {
+  uint32_t* out = (uint32_t*)dst;
+  int i = 0;
+  for (; i + 4 <= bytes; i += 4) {                   // Unrolled: one source word per pass
+    out[i]     = pair_[src[i]];
+    out[i + 1] = pair_[src[i + 1]];
+    out[i + 2] = pair_[src[i + 2]];
+    out[i + 3] = pair_[src[i + 3]];
+  }
+  for (; i < bytes; i++) out[i] = pair_[src[i]];
+}
+
+void PaletteLut::expandNaive(const uint8_t* src, uint16_t* dst, int bytes) const {
+  for (int i = 0; i < bytes; i++) {
+    *dst++ = pal_[src[i] >> 4];
+    *dst++ = pal_[src[i] & 0x0F];
+  }
+}
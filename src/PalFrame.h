@@ -0,0 +1,103 @@
+/**
+ * Palettized Frame Buffer
+ *
+ * A full 240x135 RGB565 frame is 64 KB; at 4 bits per pixel it is 16 KB, so
+ * two frames (back buffer being composed, front buffer = what the panel
+ * shows) fit in internal RAM next to the network stack. Pixels are palette
+ * indices; PaletteLut expands them to RGB565 a stripe at a time while the
+ * previous stripe is on its way to the panel by DMA.
+ *
+ * Plain C++ (no Arduino dependencies), so the expansion can be benchmarked
+ * on the host (host/palette_bench.cpp).
+ */
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * 4-bpp frame, two pixels per byte (left pixel in the high nibble)
+ */
+class PalFrame {
+public:
+  static const int kWidth  = 240;
+  static const int kHeight = 135;
+  static const int kStride = kWidth / 2;        // Bytes per row
+
+  /**
+   * Fill the whole frame with one palette index
+   */
+  void clear(uint8_t idx);
+
+  /**
+   * Fill a rectangle (clipped to the frame)
+   */
+  void fillRect(int x, int y, int w, int h, uint8_t idx);
+
+  /**
+   * Draw a one-pixel line between two points (clipped to the frame)
+   */
+  void line(int x0, int y0, int x1, int y1, uint8_t idx);
+
+  /**
+   * Draw a string from the glyph atlas (clipped at the right edge)
+   *
+   * @param x, y Top-left corner in pixels
+   * @param s Text (characters outside the atlas draw as '?')
+   * @param size Text size (1 = 6x8 cells, 2 = 12x16 cells)
+   * @param fg, bg Palette indices
+   * @return Width drawn in pixels
+   */
+  int text(int x, int y, const char* s, uint8_t size, uint8_t fg, uint8_t bg);
+
+  const uint8_t* row(int y) const { return px_ + y * kStride; }
+
+  /**
+   * Compare a band of rows with another frame
+   * @return true if rows [y0, y0 + rows) are identical
+   */
+  bool rowsEqual(const PalFrame& other, int y0, int rows) const;
+
+private:
+  alignas(4) uint8_t px_[kStride * kHeight];
+
+  void pixel(int x, int y, uint8_t idx) {
+    uint8_t& b = px_[y * kStride + (x >> 1)];
+    b = (x & 1) ? (uint8_t)((b & 0xF0) | idx) : (uint8_t)((b & 0x0F) | idx << 4);
+  }
+};
+
+/**
+ * 16-color palette with a pixel-pair lookup table
+ *
+ * Each source byte holds two pixels, so a 256-entry table of 32-bit words
+ * expands a byte into both RGB565 pixels with one load and one store.
+ * Colors are stored byte-swapped, ready to be sent to the panel as-is.
+ */
+class PaletteLut {
+public:
+  /**
+   * Set the palette and rebuild the pair table
+   * @param rgb565 Colors (native RGB565, up to 16)
+   * @param n Number of colors
+   */
+  void set(const uint16_t* rgb565, int n);
+
+  /**
+   * Expand 4-bpp pixels to panel-order RGB565
+   * @param src Source bytes (two pixels each)
+   * @param dst Destination (4-byte aligned), 2 * bytes pixels
+   * @param bytes Number of source bytes
+   */
+  void expand(const uint8_t* src, uint16_t* dst, int bytes) const;
+
+  /**
+   * Reference expansion, one nibble at a time (for benchmarks)
+   */
+  void expandNaive(const uint8_t* src, uint16_t* dst, int bytes) const;
+
+  uint16_t color(uint8_t idx) const { return pal_[idx & 0x0F]; }
+
+private:
+  uint16_t pal_[16] = {};          // Byte-swapped colors
+  uint32_t pair_[256] = {};        // Byte -> two byte-swapped pixels
+};
@@ -0,0 +1,130 @@
+/**
+ * CPU Power Management Implementation
+ */
+
+#include "Pm.h"
+
+#if defined(CONFIG_PM_ENABLE)
+#include "esp_pm.h"
+#endif
+
+namespace {
+  Pm::Policy g_policy = Pm::Fixed;
+  int        g_depth = 0;                                   // Nesting depth of held locks
+  uint32_t   g_outerStartUs = 0;                            // Start of outermost lock
+  uint64_t   g_activeUs = 0;                                // Total full-clock time
+  uint32_t   g_worstUs[(int)Pm::Job::Count] = {0};          // Longest hold per job
+  uint32_t   g_count[(int)Pm::Job::Count] = {0};            // Holds per job
+
+  const char* const kJobNames[(int)Pm::Job::Count] = {"render", "adc", "net"};
+  const char* const kPolicyNames[] = {"fixed 240 MHz", "DFS 80-240 MHz", "DFS + light sleep"};
+
+#if defined(CONFIG_PM_ENABLE)
+  esp_pm_lock_handle_t g_locks[(int)Pm::Job::Count] = {nullptr};
+#endif
+
+  /**
+   * Raise the clock (fallback path only; esp_pm handles it otherwise)
+   */
+  void enterFullClock() {
+#if !defined(CONFIG_PM_ENABLE)
+    if (g_policy != Pm::Fixed) setCpuFrequencyMhz(PM_MAX_FREQ_MHZ);
+#endif
+  }
+
+  void leaveFullClock() {
+#if !defined(CONFIG_PM_ENABLE)
+    if (g_policy != Pm::Fixed) setCpuFrequencyMhz(PM_MIN_FREQ_MHZ);
+#endif
+  }
+}
+
+/**
+ * Configure frequency scaling
+ *
+ * With esp_pm the idle task drops the clock automatically whenever no lock is
+ * held; without it we switch to the minimum clock here and raise it inside
+ * each Lock.
+ */
+void Pm::begin(Policy policy) {
+  g_policy = policy;
+  if (policy == Fixed) return;
+
+#if defined(CONFIG_PM_ENABLE)
+  esp_pm_config_esp32_t cfg = {};
+  cfg.max_freq_mhz = PM_MAX_FREQ_MHZ;
+  cfg.min_freq_mhz = PM_MIN_FREQ_MHZ;
+  cfg.light_sleep_enable = (policy == DfsLightSleep);
+  if (esp_pm_configure(&cfg) != ESP_OK) {
+    g_policy = Fixed;                                        // Core does not support it
+    return;
+  }
+  for (int i = 0; i < (int)Job::Count; i++) {
+    esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, kJobNames[i], &g_locks[i]);
+  }
+#else
+  if (policy == DfsLightSleep) g_policy = Dfs;               // Needs esp_pm + tickless idle
+  setCpuFrequencyMhz(PM_MIN_FREQ_MHZ);
+#endif
+}
+
+Pm::Policy Pm::policy() {
+  return g_policy;
+}
+
+void Pm::idle() {
+  if (g_policy != Fixed) delay(PM_IDLE_SLICE_MS);
+}
+
+uint64_t Pm::activeMicros() {
+  return g_activeUs;
+}
+
+float Pm::idleCurrentMa() {
+  switch (g_policy) {
+    case Dfs:           return CPU_IDLE_80MHZ_MA;
+    case DfsLightSleep: return CPU_LIGHT_SLEEP_MA;
+    default:            return CPU_ACTIVE_MA;
+  }
+}
+
+/**
+ * Print the power management report, e.g.
+ *   PM: DFS 80-240 MHz, idle ~20.0 mA | render 140 x, worst 9120 us | adc ...
+ */
+void Pm::print(Print& out) {
+  out.print(F("PM: ")); out.print(kPolicyNames[g_policy]);
+  out.print(F(", idle ~")); out.print(idleCurrentMa(), 1); out.print(F(" mA"));
+  for (int i = 0; i < (int)Job::Count; i++) {
+    out.print(F(" | ")); out.print(kJobNames[i]); out.print(' ');
+    out.print(g_count[i]); out.print(F(" x, worst "));
+    out.print(g_worstUs[i]); out.print(F(" us"));
+  }
+  out.println();
+}
+
+Pm::Lock::Lock(Job job) : job_(job) {
+#if defined(CONFIG_PM_ENABLE)
+  if (g_locks[(int)job]) esp_pm_lock_acquire(g_locks[(int)job]);
+#endif
+  if (g_depth++ == 0) {
+    enterFullClock();
+    g_outerStartUs = micros();
+  }
+  startUs_ = micros();
+}
+
+Pm::Lock::~Lock() {
+  const uint32_t now = micros();
+  const uint32_t held = now - startUs_;
+  if (held > g_worstUs[(int)job_]) g_worstUs[(int)job_] = held;
+  g_count[(int)job_]++;
+
+  if (--g_depth == 0) {
+    g_activeUs += now - g_outerStartUs;
+    leaveFullClock();
+  }
+#if defined(CONFIG_PM_ENABLE)
+  if (g_locks[(int)job_]) esp_pm_lock_release(g_locks[(int)job_]);
+#endif
+}
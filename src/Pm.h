@@ -0,0 +1,91 @@
+/**
+ * CPU Power Management
+ *
+ * Runs the ESP32 at a low clock while idle and at full clock only while
+ * throughput-critical work (TFT transfers, ADC/DHT reads, network I/O) holds
+ * a lock. Uses ESP-IDF esp_pm locks when the core is built with
+ * CONFIG_PM_ENABLE, otherwise falls back to switching the clock with
+ * setCpuFrequencyMhz() around the same locked sections.
+ *
+ * Also records how long each kind of job held the CPU at full clock, so the
+ * worst-case job latency under each policy can be reported.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "Config.h"
+
+namespace Pm {
+
+  /**
+   * Power policy (PM_POLICY in Config.h)
+   */
+  enum Policy : uint8_t {
+    Fixed         = 0,   // 240 MHz always (original behaviour)
+    Dfs           = 1,   // 80 MHz idle, 240 MHz while a lock is held
+    DfsLightSleep = 2    // As Dfs, plus automatic light sleep when idle
+  };
+
+  /**
+   * Kinds of work that take a full-clock lock
+   */
+  enum class Job : uint8_t {
+    Render,    // TFT SPI/DMA transfers
+    Adc,       // Analog and DHT sensor reads
+    Network,   // Wi-Fi / socket I/O
+    Count
+  };
+
+  /**
+   * Configure frequency scaling for the given policy
+   * Must be called once during setup
+   */
+  void begin(Policy policy);
+
+  /**
+   * Current policy
+   */
+  Policy policy();
+
+  /**
+   * Give the CPU back between loop iterations
+   * Under Dfs/DfsLightSleep the loop task blocks for PM_IDLE_SLICE_MS so the
+   * idle task can lower the clock or enter light sleep; Fixed returns at once.
+   */
+  void idle();
+
+  /**
+   * Total time any lock was held since boot, in microseconds
+   * Used by the energy meter to split CPU charge into idle and active.
+   */
+  uint64_t activeMicros();
+
+  /**
+   * Estimated CPU current while idle under the current policy (mA)
+   */
+  float idleCurrentMa();
+
+  /**
+   * Print policy, estimated idle current and worst-case hold time per job
+   * @param out Destination stream
+   */
+  void print(Print& out);
+
+  /**
+   * Scoped full-clock lock
+   *
+   * Holds the CPU at maximum frequency for the lifetime of the object.
+   * Locks nest; the clock drops again when the last one is released.
+   */
+  class Lock {
+  public:
+    explicit Lock(Job job);
+    ~Lock();
+    Lock(const Lock&) = delete;
+    Lock& operator=(const Lock&) = delete;
+
+  private:
+    Job      job_;
+    uint32_t startUs_;
+  };
+}
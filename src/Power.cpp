@@ -0,0 +1,151 @@
+/**
+ * Battery and Energy Budget Implementation
+ */
+
+#include "Power.h"
+#include "Pm.h"
+#include "AdcCal.h"
+
+// Typical 1-cell LiPo discharge curve at light load (mV, % remaining)
+static const struct { int16_t mv; uint8_t pct; } kDischargeCurve[] = {
+  {4200, 100}, {4150, 95}, {4110, 90}, {4080, 85}, {4020, 80}, {3980, 70},
+  {3950, 60},  {3910, 50}, {3870, 40}, {3850, 30}, {3840, 20}, {3800, 10},
+  {3750, 5},   {3600, 2},  {3300, 0},
+};
+
+// Power profiles, from full performance (level 0) to deepest saving
+static const PowerProfile kProfiles[] = {
+  {1, 250,  100, 100},
+  {2, 500,  60,  50},
+  {4, 1000, 30,  25},
+  {8, 2000, 10,  10},
+};
+static const uint8_t kLevels = sizeof(kProfiles) / sizeof(kProfiles[0]);
+
+static const char* const kLoadNames[(int)Load::Count] = {
+  "CPU", "Backlight", "Render", "Sensors", "Radio"
+};
+
+/**
+ * Curve lookup with linear interpolation between neighbouring points
+ */
+int batteryPercentFromMv(int mv) {
+  const int n = sizeof(kDischargeCurve) / sizeof(kDischargeCurve[0]);
+  if (mv >= kDischargeCurve[0].mv) return 100;
+  for (int i = 1; i < n; i++) {
+    if (mv >= kDischargeCurve[i].mv) {
+      const int hiMv = kDischargeCurve[i - 1].mv, loMv = kDischargeCurve[i].mv;
+      const int hiPct = kDischargeCurve[i - 1].pct, loPct = kDischargeCurve[i].pct;
+      return loPct + (mv - loMv) * (hiPct - loPct) / (hiMv - loMv);
+    }
+  }
+  return 0;
+}
+
+/**
+ * Initialize the battery monitor
+ * The divider stays disconnected (GPIO14 LOW) except during a read.
+ */
+void Battery::begin() {
+  pinMode(BAT_ADC_EN, OUTPUT);
+  digitalWrite(BAT_ADC_EN, LOW);
+  analogSetPinAttenuation(BAT_ADC_PIN, ADC_11db);
+  mv_ = readMv();
+  pct_ = batteryPercentFromMv(mv_);
+}
+
+void Battery::update(uint32_t nowMs) {
+  if (!sampleTick.due(nowMs)) return;
+  mv_ = readMv();
+  pct_ = batteryPercentFromMv(mv_);
+}
+
+/**
+ * Read the battery voltage
+ * Connects the divider, lets it settle briefly and averages a few
+ * calibrated conversions (AdcCal table, built in Sensors::begin()) to
+ * smooth ADC noise.
+ */
+int Battery::readMv() {
+  Pm::Lock lock(Pm::Job::Adc);
+  digitalWrite(BAT_ADC_EN, HIGH);
+  delayMicroseconds(200);                           // Divider + ADC input settle
+  uint32_t sum = 0;
+  for (int i = 0; i < 8; i++) sum += AdcCal::toMv(analogRead(BAT_ADC_PIN));
+  digitalWrite(BAT_ADC_EN, LOW);
+  return (int)((float)(sum / 8) * BATTERY_DIVIDER);
+}
+
+double EnergyMeter::totalMAms() const {
+  double total = 0;
+  for (int i = 0; i < (int)Load::Count; i++) total += charge_[i];
+  return total;
+}
+
+/**
+ * Print the energy report, e.g.
+ *   Energy: 12.31 mAh, avg 49.2 mA | CPU 9.10 (74%) Backlight 2.80 (23%) ...
+ */
+void EnergyMeter::print(Print& out, uint32_t elapsedMs) const {
+  const float total = totalMAh();
+  out.print(F("Energy: ")); out.print(total, 2);
+  out.print(F(" mAh, avg "));
+  out.print(elapsedMs ? total * 3600000.0f / (float)elapsedMs : 0.0f, 1);
+  out.print(F(" mA |"));
+  for (int i = 0; i < (int)Load::Count; i++) {
+    const float m = mAh((Load)i);
+    out.print(' '); out.print(kLoadNames[i]); out.print(' ');
+    out.print(m, 2); out.print(F(" ("));
+    out.print(total > 0 ? (int)(100.0f * m / total + 0.5f) : 0);
+    out.print(F("%)"));
+  }
+  out.println();
+}
+
+/**
+ * Governor step
+ *
+ * The budget is the current that would drain the remaining charge exactly at
+ * the end of the target runtime. Moving up a level when above budget and down
+ * only when comfortably below (80 %) keeps the profile from oscillating.
+ */
+bool EnergyGovernor::update(uint32_t nowMs, const Battery& bat, const EnergyMeter& meter) {
+  if (!started_) {
+    started_ = true;
+    lastMs_ = nowMs;
+    lastMAms_ = meter.totalMAms();
+    return false;
+  }
+  if (nowMs - lastMs_ < GOVERNOR_PERIOD_MS) return false;
+
+  const double used = meter.totalMAms();
+  avgMa_ = (float)((used - lastMAms_) / (double)(nowMs - lastMs_));
+  lastMAms_ = used;
+  lastMs_ = nowMs;
+
+  const uint8_t before = level_;
+  if (bat.percent() < 0 || bat.onUsb()) {
+    onBattery_ = false;
+    budgetMa_ = 0;
+    level_ = 0;
+    return level_ != before;
+  }
+  if (!onBattery_) {
+    onBattery_ = true;
+    onBatterySinceMs_ = nowMs;
+  }
+
+  const float hoursOn = (float)(nowMs - onBatterySinceMs_) / 3600000.0f;
+  float hoursLeft = (float)TARGET_RUNTIME_H - hoursOn;
+  if (hoursLeft < 1.0f) hoursLeft = 1.0f;
+  const float remaining = (float)BATTERY_CAPACITY_MAH * (float)bat.percent() / 100.0f;
+  budgetMa_ = remaining / hoursLeft;
+
+  if (avgMa_ > budgetMa_ && level_ + 1 < kLevels) level_++;
+  else if (avgMa_ < 0.8f * budgetMa_ && level_ > 0) level_--;
+  return level_ != before;
+}
+
+const PowerProfile& EnergyGovernor::profile() const {
+  return kProfiles[level_];
+}
@@ -0,0 +1,154 @@
+/**
+ * Battery Monitoring and Energy Budget
+ *
+ * Reads the TTGO T-Display battery voltage (GPIO34 through the divider that
+ * GPIO14 enables), keeps a running estimate of where the energy goes, and
+ * runs a governor that trades sample rate, render rate, backlight and radio
+ * duty cycle for runtime so the unit reaches its target time on battery.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "Config.h"
+#include "Utils.h"
+
+/**
+ * Convert a LiPo cell voltage to state of charge
+ * Piecewise-linear lookup on a typical 1-cell discharge curve at light load.
+ *
+ * @param mv Cell voltage in millivolts
+ * @return State of charge 0-100%
+ */
+int batteryPercentFromMv(int mv);
+
+/**
+ * Battery voltage monitor
+ *
+ * The divider is only connected while a reading is taken, so it does not
+ * drain the cell between samples.
+ */
+class Battery {
+public:
+  /**
+   * Configure the divider enable pin and ADC attenuation
+   */
+  void begin();
+
+  /**
+   * Read the battery if the sample period has elapsed (non-blocking)
+   * @param nowMs Current time in milliseconds
+   */
+  void update(uint32_t nowMs);
+
+  int  millivolts() const { return mv_; }          // Last battery voltage (-1 = not read yet)
+  int  percent() const { return pct_; }            // State of charge (-1 = not read yet)
+  bool onUsb() const { return mv_ >= BATTERY_USB_MV; }
+
+private:
+  int mv_{-1};
+  int pct_{-1};
+  Utils::Ticker sampleTick{BATTERY_SAMPLE_MS};
+
+  int readMv();
+};
+
+/**
+ * Subsystems tracked by the energy meter
+ */
+enum class Load : uint8_t {
+  Cpu,        // Core and memory while awake
+  Backlight,  // TFT backlight
+  Render,     // SPI transfers to the panel
+  Sensors,    // DHT, ADC reads and sensor supply current
+  Radio,      // Wi-Fi
+  Count
+};
+
+/**
+ * Estimated charge accounting per subsystem
+ *
+ * Charge is accumulated in mA*ms from known durations and the current
+ * constants in Config.h; it is an estimate, not a measurement. The sums are
+ * doubles: a float stops taking small additions once it holds a few hours
+ * of charge (24 bits), a double keeps sub-uA*ms steps for years.
+ */
+class EnergyMeter {
+public:
+  /**
+   * Add charge drawn by a subsystem
+   * @param l Subsystem
+   * @param mAms Charge in mA*ms
+   */
+  void add(Load l, float mAms) { charge_[(int)l] += mAms; }
+
+  /**
+   * Add a constant load over a duration
+   * @param l Subsystem
+   * @param mA Current in milliamps
+   * @param ms Duration in milliseconds
+   */
+  void addActive(Load l, float mA, uint32_t ms) { add(l, mA * (float)ms); }
+
+  float mAh(Load l) const { return (float)(charge_[(int)l] / 3600000.0); }
+  float totalMAh() const { return (float)(totalMAms() / 3600000.0); }
+
+  /**
+   * Total charge in mA*ms at full precision (for differences over a period)
+   */
+  double totalMAms() const;
+
+  /**
+   * Print per-subsystem charge and share of the total
+   * @param out Destination stream
+   * @param elapsedMs Accounting period (for average current)
+   */
+  void print(Print& out, uint32_t elapsedMs) const;
+
+private:
+  double charge_[(int)Load::Count] = {0};
+};
+
+/**
+ * Power profile applied by the governor
+ */
+struct PowerProfile {
+  uint8_t  rateScale;     // Multiplier on sensor sample intervals
+  uint32_t renderMs;      // Display refresh period
+  uint8_t  backlightPct;  // Backlight brightness
+  uint8_t  radioDutyPct;  // Share of time the radio may be awake
+};
+
+/**
+ * Energy-budget governor
+ *
+ * Every GOVERNOR_PERIOD_MS compares the average current over the period
+ * with the budget remaining capacity / remaining target hours and moves one
+ * profile up or down (with hysteresis). On USB power it runs at full rate.
+ */
+class EnergyGovernor {
+public:
+  /**
+   * Re-evaluate the profile if the governor period has elapsed
+   *
+   * @param nowMs Current time in milliseconds
+   * @param bat Battery monitor
+   * @param meter Energy meter (read only)
+   * @return true if the profile changed
+   */
+  bool update(uint32_t nowMs, const Battery& bat, const EnergyMeter& meter);
+
+  const PowerProfile& profile() const;
+  uint8_t level() const { return level_; }         // 0 = full performance
+  float budgetMa() const { return budgetMa_; }     // Allowed average current
+  float averageMa() const { return avgMa_; }       // Measured average current
+
+private:
+  uint8_t  level_{0};
+  float    budgetMa_{0};
+  float    avgMa_{0};
+  double   lastMAms_{0};
+  uint32_t lastMs_{0};
+  uint32_t onBatterySinceMs_{0};
+  bool     onBattery_{false};
+  bool     started_{false};
+};
@@ -0,0 +1,109 @@
+/**
+ * UDP Push Uplink Implementation
+ */
+
+#include "PushClient.h"
+#include "PushProtocol.h"
+#include "Net.h"
+#include "Pm.h"
+#include "Radio.h"
+#include <new>
+
+#if WIFI_ENABLE && PUSH_ENABLE
+#include <WiFi.h>
+#include "Secrets.h"
+#endif
+
+namespace {
+#if WIFI_ENABLE && PUSH_ENABLE
+  // Constructed in begin(), once the device id is known
+  alignas(Push::Sender) uint8_t g_senderMem[sizeof(Push::Sender)];
+  Push::Sender* g_sender = nullptr;
+  WiFiUDP       g_udp;
+  bool          g_open = false;
+#endif
+}
+
+void PushClient::begin() {
+#if WIFI_ENABLE && PUSH_ENABLE
+  // A fresh epoch per boot tells the collector the sequence starts again
+  g_sender = new (g_senderMem) Push::Sender(ESP.getEfuseMac(), esp_random(), PUSH_BATCH, PUSH_WINDOW, PUSH_RTO_MS,
+                                            PUSH_MAX_DELAY_MS);
+#endif
+}
+
+void PushClient::offer(const HistorySample& s, uint32_t nowMs) {
+#if WIFI_ENABLE && PUSH_ENABLE
+  if (g_sender) g_sender->add(s, nowMs);
+#else
+  (void)s; (void)nowMs;
+#endif
+}
+
+/**
+ * While Wi-Fi is down nothing is sent, but offer() keeps sealing full
+ * batches into the window, so the last PUSH_WINDOW x PUSH_BATCH readings
+ * go out once it is back
+ */
+void PushClient::update(uint32_t nowMs) {
+#if WIFI_ENABLE && PUSH_ENABLE
+  if (!g_sender) return;
+  g_sender->setMaxDelay(Radio::stretch(PUSH_MAX_DELAY_MS));   // Fewer, fuller datagrams on a low radio duty
+  if (!Net::connected()) {
+    if (g_open) { g_udp.stop(); g_open = false; }
+    return;
+  }
+  Pm::Lock lock(Pm::Job::Network);
+  if (!g_open) g_open = g_udp.begin(PUSH_PORT);
+
+  uint8_t buf[Push::kMaxDatagram];
+  int n;
+  while ((n = g_udp.parsePacket()) > 0) {
+    if (n > (int)sizeof buf) continue;             // Not ours; parsePacket() drops the rest
+    g_udp.read(buf, n);
+    g_sender->onDatagram(buf, n, nowMs);
+  }
+
+  size_t len;
+  while ((len = g_sender->nextDatagram(buf, nowMs)) > 0) {
+    Radio::Activity radio(nowMs);
+    g_udp.beginPacket(PUSH_HOST, PUSH_PORT);
+    g_udp.write(buf, len);
+    g_udp.endPacket();
+  }
+#else
+  (void)nowMs;
+#endif
+}
+
+uint32_t PushClient::sent() {
+#if WIFI_ENABLE && PUSH_ENABLE
+  return g_sender ? g_sender->sent() : 0;
+#else
+  return 0;
+#endif
+}
+
+uint32_t PushClient::retransmits() {
+#if WIFI_ENABLE && PUSH_ENABLE
+  return g_sender ? g_sender->retransmits() : 0;
+#else
+  return 0;
+#endif
+}
+
+uint32_t PushClient::acked() {
+#if WIFI_ENABLE && PUSH_ENABLE
+  return g_sender ? g_sender->acked() : 0;
+#else
+  return 0;
+#endif
+}
+
+uint32_t PushClient::evicted() {
+#if WIFI_ENABLE && PUSH_ENABLE
+  return g_sender ? g_sender->evicted() : 0;
+#else
+  return 0;
+#endif
+}
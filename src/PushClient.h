@@ -0,0 +1,38 @@
+/**
+ * UDP Push Uplink
+ *
+ * Sends reports to PUSH_HOST:PUSH_PORT with the push protocol
+ * (PushProtocol.h): PUSH_BATCH readings per datagram, kept in a window of
+ * PUSH_WINDOW datagrams until the collector acknowledges them. No socket
+ * state beyond one UDP port, so it suits many devices on one collector.
+ * Does nothing unless WIFI_ENABLE and PUSH_ENABLE are set.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "Config.h"
+#include "History.h"
+
+namespace PushClient {
+
+  void begin();
+
+  /**
+   * Queue a reading for the next datagram
+   */
+  void offer(const HistorySample& s, uint32_t nowMs);
+
+  /**
+   * Send due datagrams and read acknowledgements (non-blocking)
+   * @param nowMs Current time in milliseconds
+   */
+  void update(uint32_t nowMs);
+
+  /**
+   * Datagrams sent, retransmissions, readings acknowledged and evicted
+   */
+  uint32_t sent();
+  uint32_t retransmits();
+  uint32_t acked();
+  uint32_t evicted();
+}
@@ -0,0 +1,264 @@
+/**
+ * UDP Push Protocol Implementation
+ */
+
+#include "PushProtocol.h"
+#include <string.h>
+
+using namespace Push;
+
+static uint8_t* putLe(uint8_t* p, uint64_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) *p++ = (uint8_t)(v >> (8 * i));
+  return p;
+}
+
+static uint64_t getLe(const uint8_t* p, int bytes) {
+  uint64_t v = 0;
+  for (int i = bytes - 1; i >= 0; i--) v = v << 8 | p[i];
+  return v;
+}
+
+static uint8_t* putHeader(uint8_t* p, Type type, uint8_t count, uint8_t flags, uint64_t id, uint32_t a, uint32_t b,
+                          uint32_t epoch) {
+  p[0] = kMagic;
+  p[1] = type;
+  p[2] = count;
+  p[3] = flags;
+  p = putLe(p + 4, id, 8);
+  p = putLe(p, a, 4);
+  p = putLe(p, b, 4);
+  return putLe(p, epoch, 4);
+}
+
+bool Push::parse(const uint8_t* p, size_t len, Header& h) {
+  if (len < kHeader || p[0] != kMagic) return false;
+  h.type = (Type)p[1];
+  h.count = p[2];
+  h.flags = p[3];
+  h.id = getLe(p + 4, 8);
+  h.seq = (uint32_t)getLe(p + 12, 4);
+  h.base = (uint32_t)getLe(p + 16, 4);
+  h.epoch = (uint32_t)getLe(p + 20, 4);
+  if (h.type == Data) return h.count >= 1 && h.count <= kMaxBatch && len == kHeader + h.count * kRecord;
+  return h.type == Ack && len == kAckSize;
+}
+
+HistorySample Push::record(const uint8_t* datagram, int i) {
+  const uint8_t* r = datagram + kHeader + i * kRecord;
+  HistorySample s;
+  s.t = (uint32_t)getLe(r, 4);
+  s.tempC10 = (int16_t)getLe(r + 4, 2);
+  s.humidity10 = (int16_t)getLe(r + 6, 2);
+  s.soilPct = (int8_t)r[8];
+  s.lightPct = (int8_t)r[9];
+  return s;
+}
+
+// =============================================================================
+// Device Side
+// =============================================================================
+
+Sender::Sender(uint64_t id, uint32_t epoch, int batch, int window, uint32_t rtoMs, uint32_t maxDelayMs)
+  : id_(id), epoch_(epoch),
+    batch_(batch < 1 ? 1 : batch > kMaxBatch ? kMaxBatch : batch),
+    window_(window < 1 ? 1 : window > kMaxWindow ? kMaxWindow : window),
+    rtoMs_(rtoMs), maxDelayMs_(maxDelayMs) {
+  memset(slots_, 0, sizeof slots_);
+}
+
+/**
+ * A full batch goes into the window at once, whether or not it can be sent,
+ * so an offline device holds window x batch readings
+ */
+void Sender::add(const HistorySample& s, uint32_t nowMs) {
+  if (openCount_ == 0) openSinceMs_ = nowMs;
+  open_[openCount_++] = s;
+  if (openCount_ >= batch_) seal();
+}
+
+int Sender::inFlight() const {
+  int n = 0;
+  for (int i = 0; i < window_; i++) n += slots_[i].used;
+  return n;
+}
+
+uint32_t Sender::base() const {
+  uint32_t b = nextSeq_;
+  for (int i = 0; i < window_; i++) {
+    if (slots_[i].used && (int32_t)(slots_[i].seq - b) < 0) b = slots_[i].seq;
+  }
+  return b;
+}
+
+size_t Sender::encode(const Slot& s, uint8_t flags, uint8_t* out) const {
+  uint8_t* p = putHeader(out, Data, s.count, flags, id_, s.seq, base(), epoch_);
+  for (int i = 0; i < s.count; i++) {
+    const HistorySample& r = s.rec[i];
+    p = putLe(p, r.t, 4);
+    p = putLe(p, (uint16_t)r.tempC10, 2);
+    p = putLe(p, (uint16_t)r.humidity10, 2);
+    *p++ = (uint8_t)r.soilPct;
+    *p++ = (uint8_t)r.lightPct;
+  }
+  return p - out;
+}
+
+size_t Sender::transmit(Slot& s, uint8_t flags, uint32_t nowMs, uint8_t* out) {
+  if (s.tries) retransmits_++;
+  s.tries++;
+  s.resend = false;
+  s.sentMs = nowMs;
+  sent_++;
+  return encode(s, flags, out);
+}
+
+Sender::Slot* Sender::due(uint32_t nowMs) {
+  Slot* due = nullptr;
+  for (int i = 0; i < window_; i++) {
+    Slot& s = slots_[i];
+    if (!s.used || !s.tries) continue;              // Sealed, not sent yet
+    const uint32_t rto = rtoMs_ << (s.tries > 4 ? 4 : s.tries - 1);
+    if (!s.resend && nowMs - s.sentMs < rto) continue;
+    if (!due || (int32_t)(s.seq - due->seq) < 0) due = &s;
+  }
+  return due;
+}
+
+bool Sender::batchReady(uint32_t nowMs) const {
+  return openCount_ > 0 && nowMs - openSinceMs_ >= maxDelayMs_;
+}
+
+Sender::Slot* Sender::seal() {
+  Slot* slot = nullptr;
+  for (int i = 0; i < window_; i++) {
+    if (!slots_[i].used) { slot = &slots_[i]; break; }
+    if (!slot || (int32_t)(slots_[i].seq - slot->seq) < 0) slot = &slots_[i];
+  }
+  if (slot->used) evicted_ += slot->count;          // Window full: the oldest gives way
+  slot->used = true;
+  slot->resend = false;
+  slot->tries = 0;
+  slot->seq = nextSeq_++;
+  slot->count = (uint8_t)openCount_;
+  memcpy(slot->rec, open_, openCount_ * sizeof open_[0]);
+  openCount_ = 0;
+  return slot;
+}
+
+Sender::Slot* Sender::unsent(const Slot* except) {
+  Slot* oldest = nullptr;
+  for (int i = 0; i < window_; i++) {
+    Slot& s = slots_[i];
+    if (!s.used || s.tries || &s == except) continue;
+    if (!oldest || (int32_t)(s.seq - oldest->seq) < 0) oldest = &s;
+  }
+  return oldest;
+}
+
+size_t Sender::nextDatagram(uint8_t* out, uint32_t nowMs) {
+  // Holes the collector reported, then timeouts (oldest first)
+  if (Slot* s = due(nowMs)) return transmit(*s, kAckRequest, nowMs, out);
+
+  // Sealed batches in order, then the open batch once old enough
+  Slot* slot = unsent(nullptr);
+  if (!slot && batchReady(nowMs)) slot = seal();
+  if (!slot) return 0;
+  // The collector acknowledges every kAckEvery datagrams by itself, which only
+  // helps within a burst: the last datagram of one (usually the only one, at
+  // report rates) asks, so an idle link does not wait out the timeout
+  const bool last = !due(nowMs) && !unsent(slot) && !batchReady(nowMs);
+  return transmit(*slot, last || inFlight() * 2 >= window_ ? kAckRequest : 0, nowMs, out);
+}
+
+/**
+ * Free what the Ack covers; flag unacknowledged datagrams below the highest
+ * selectively acknowledged one for an immediate resend
+ */
+void Sender::onDatagram(const uint8_t* p, size_t len, uint32_t nowMs) {
+  Header h;
+  if (!parse(p, len, h) || h.type != Ack || h.id != id_ || h.epoch != epoch_) return;
+  const uint32_t next = h.seq, bits = h.base;
+  uint32_t highest = next;                          // One past the highest acknowledged
+  for (int b = 31; b >= 0; b--) {
+    if (bits >> b & 1) { highest = next + 2 + b; break; }
+  }
+
+  for (int i = 0; i < window_; i++) {
+    Slot& s = slots_[i];
+    if (!s.used) continue;
+    const int32_t d = (int32_t)(s.seq - next);
+    const bool acked = d < 0 || (d >= 1 && d <= 32 && (bits >> (d - 1) & 1));
+    if (acked) {
+      ackedReadings_ += s.count;
+      s.used = false;
+    } else if ((int32_t)(s.seq - highest) < 0 && nowMs - s.sentMs >= rtoMs_ / 4) {
+      s.resend = true;                              // Not if it was just resent (Acks come in bursts)
+    }
+  }
+}
+
+// =============================================================================
+// Collector Side
+// =============================================================================
+
+/**
+ * Move `next` forward, counting seqs that never arrived
+ */
+void Peer::advance(uint32_t steps) {
+  while (steps > 0 && seen != 0) {
+    if (!(seen & 1)) lost++;
+    seen >>= 1;
+    next++;
+    steps--;
+  }
+  lost += steps;                                    // Nothing seen past here
+  next += steps;
+}
+
+bool Peer::accept(const Header& h, bool& ackNow) {
+  datagrams++;
+  // A late datagram from the boot before: its readings were delivered or are lost
+  if (init && h.epoch != epoch && h.epoch == oldEpoch) {
+    ackNow = false;
+    duplicates++;
+    return false;
+  }
+  // A new epoch is a reboot: its seqs start again and owe nothing to the old ones
+  if (init && h.epoch != epoch) {
+    oldEpoch = epoch;
+    init = false;
+    restarts++;
+  }
+  if (!init) {
+    init = true;
+    epoch = h.epoch;
+    next = h.base;
+    seen = 0;
+  }
+  if ((int32_t)(h.base - next) > 0) advance(h.base - next);   // Evicted by the device
+
+  int32_t d = (int32_t)(h.seq - next);
+  if (d >= 64) {                                    // Cannot happen with base; stay safe
+    advance(d - 63);
+    d = 63;
+  }
+  const bool dup = d < 0 || (seen >> d & 1);
+  ackNow = (h.flags & kAckRequest) || dup || d > 0 || ++sinceAck >= kAckEvery;
+  if (dup) {
+    duplicates++;
+    return false;
+  }
+  seen |= 1ull << d;
+  while (seen & 1) {
+    seen >>= 1;
+    next++;
+  }
+  readings += h.count;
+  return true;
+}
+
+size_t Peer::ack(uint64_t id, uint8_t* out) {
+  sinceAck = 0;
+  putHeader(out, Ack, 0, 0, id, next, (uint32_t)(seen >> 1), epoch);
+  return kAckSize;
+}
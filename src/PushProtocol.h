@@ -0,0 +1,193 @@
+/**
+ * UDP Push Protocol
+ *
+ * Connectionless telemetry uplink for dense deployments: no TCP state, no
+ * handshake, several readings per datagram. Reliability comes from a small
+ * retransmit window on the device and sparse, selective acknowledgements
+ * from the collector.
+ *
+ * Datagrams (little-endian):
+ *
+ *   Data  'P' 1 <count u8> <flags u8> <id u64> <seq u32> <base u32> <epoch u32>
+ *         count x {u32 t, i16 temp x10, i16 humidity x10, i8 soil, i8 light}
+ *   Ack   'P' 2 0 0 <id u64> <next u32> <bits u32> <epoch u32>
+ *
+ * seq numbers datagrams. base is the oldest seq the device still holds;
+ * anything older was evicted from its window and will never come, so the
+ * collector stops waiting for it. An Ack says "every seq below next
+ * arrived", and bit i of bits says next + 1 + i arrived too (SACK).
+ * epoch is drawn at random on every boot, when seq starts again from 0;
+ * the collector resets its state for the device when it changes, and the
+ * device ignores Acks for another epoch.
+ *
+ * The collector acknowledges every kAckEvery datagrams, at once when it
+ * sees a hole or a duplicate, and when the device sets kAckRequest (last
+ * datagram of a burst, window half full, or a retransmission). A backlog
+ * sent after an outage thus costs one Ack per few datagrams, a trickle of
+ * reports one each. The device resends holes below the
+ * highest acknowledged seq as soon as an Ack shows them, and anything
+ * unacknowledged after the retransmit timeout (doubling per try).
+ *
+ * Plain C++ (no Arduino dependencies); host/push_collector.cpp runs the
+ * collector side and a lossy-link simulation.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "History.h"
+
+namespace Push {
+
+  enum Type : uint8_t { Data = 1, Ack = 2 };
+
+  static const uint8_t kMagic      = 'P';
+  static const size_t  kHeader     = 24;
+  static const size_t  kRecord     = 10;
+  static const size_t  kAckSize    = 24;
+  static const int     kMaxBatch   = 16;            // Readings per datagram
+  static const int     kMaxWindow  = 16;            // Datagrams held for retransmission
+  static const uint8_t kAckRequest = 0x01;          // Flag: acknowledge now
+  static const uint32_t kAckEvery  = 8;             // Datagrams per unsolicited Ack
+  static const size_t  kMaxDatagram = kHeader + kMaxBatch * kRecord;
+
+  /**
+   * Parsed datagram header
+   */
+  struct Header {
+    Type     type;
+    uint8_t  count;
+    uint8_t  flags;
+    uint64_t id;
+    uint32_t seq;                                   // Data: datagram; Ack: next
+    uint32_t base;                                  // Data: oldest held; Ack: SACK bits
+    uint32_t epoch;                                 // Boot of the device
+  };
+
+  /**
+   * Parse and validate a datagram
+   * @return false if it is not a well-formed Push datagram
+   */
+  bool parse(const uint8_t* p, size_t len, Header& h);
+
+  /**
+   * Reading i of a Data datagram
+   */
+  HistorySample record(const uint8_t* datagram, int i);
+
+  /**
+   * Device side: batching and the retransmit window
+   */
+  class Sender {
+  public:
+    /**
+     * Constructor
+     * @param id Device id
+     * @param epoch Random per boot (tells the collector the sequence restarted)
+     * @param batch Readings per datagram (1..kMaxBatch)
+     * @param window Datagrams kept until acknowledged (1..kMaxWindow)
+     * @param rtoMs Retransmit timeout (doubles per try)
+     * @param maxDelayMs Send a partial batch after this long
+     */
+    Sender(uint64_t id, uint32_t epoch, int batch, int window, uint32_t rtoMs, uint32_t maxDelayMs);
+
+    /**
+     * Queue a reading; a full batch is sealed into the window even while
+     * nothing can be sent (the oldest datagram gives way when it is full)
+     */
+    void add(const HistorySample& s, uint32_t nowMs);
+
+    /**
+     * Next datagram to send, if any: a hole the collector reported, then a
+     * timed-out datagram, then sealed batches not sent yet, then the open
+     * batch once old enough
+     * @param out At least kMaxDatagram bytes
+     * @return Length, 0 when there is nothing to send now
+     */
+    size_t nextDatagram(uint8_t* out, uint32_t nowMs);
+
+    /**
+     * Handle an Ack datagram (others are ignored)
+     */
+    void onDatagram(const uint8_t* p, size_t len, uint32_t nowMs);
+
+    /**
+     * Change how long a partial batch may wait (e.g. with the radio duty cycle)
+     */
+    void setMaxDelay(uint32_t ms) { maxDelayMs_ = ms; }
+
+    uint32_t sent() const { return sent_; }
+    uint32_t retransmits() const { return retransmits_; }
+    uint32_t evicted() const { return evicted_; }     // Readings dropped unacknowledged
+    uint32_t acked() const { return ackedReadings_; }
+    int inFlight() const;
+
+  private:
+    struct Slot {
+      bool     used;
+      bool     resend;                              // Reported missing by an Ack
+      uint8_t  tries;
+      uint8_t  count;
+      uint32_t seq;
+      uint32_t sentMs;
+      HistorySample rec[kMaxBatch];
+    };
+
+    uint64_t id_;
+    uint32_t epoch_;
+    int      batch_;
+    int      window_;
+    uint32_t rtoMs_;
+    uint32_t maxDelayMs_;
+    Slot     slots_[kMaxWindow];
+    HistorySample open_[kMaxBatch];                 // Batch being filled
+    int      openCount_{0};
+    uint32_t openSinceMs_{0};
+    uint32_t nextSeq_{0};
+    uint32_t sent_{0};
+    uint32_t retransmits_{0};
+    uint32_t evicted_{0};
+    uint32_t ackedReadings_{0};
+
+    uint32_t base() const;
+    Slot* due(uint32_t nowMs);                      // Oldest slot to resend now
+    bool batchReady(uint32_t nowMs) const;          // Open batch waited maxDelayMs
+    Slot* seal();                                   // Open batch into the window
+    Slot* unsent(const Slot* except);               // Oldest sealed, never sent
+    size_t encode(const Slot& s, uint8_t flags, uint8_t* out) const;
+    size_t transmit(Slot& s, uint8_t flags, uint32_t nowMs, uint8_t* out);
+  };
+
+  /**
+   * Collector side: per-device receive state (dedupe and Ack contents)
+   */
+  struct Peer {
+    bool     init = false;
+    uint32_t epoch = 0;                             // Of the device's current boot
+    uint32_t oldEpoch = 0;                          // Boot before (its stragglers are dropped)
+    uint32_t next = 0;                              // All seqs below arrived
+    uint64_t seen = 0;                              // Bit i: next + i arrived (bit 0 always clear)
+    uint32_t sinceAck = 0;
+    uint32_t datagrams = 0;
+    uint32_t readings = 0;
+    uint32_t duplicates = 0;
+    uint32_t lost = 0;                              // Datagrams given up by the device
+    uint32_t restarts = 0;                          // Device rebooted (new epoch)
+
+    /**
+     * Account for a Data datagram
+     * @param ackNow Set when an Ack should go out now
+     * @return true if it is new (deliver its readings), false for a duplicate
+     */
+    bool accept(const Header& h, bool& ackNow);
+
+    /**
+     * Build the Ack for this peer
+     * @param out At least kAckSize bytes
+     */
+    size_t ack(uint64_t id, uint8_t* out);
+
+  private:
+    void advance(uint32_t steps);
+  };
+}
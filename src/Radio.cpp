@@ -0,0 +1,51 @@
+/**
+ * Radio Activity Windows Implementation
+ */
+
+#include "Radio.h"
+#include <Arduino.h>
+#include "Config.h"
+
+namespace {
+  int      g_depth = 0;         // Nested activity count
+  uint32_t g_startMs = 0;       // Start of the current outer window
+  uint32_t g_quietAtMs = 0;     // End of the guard time after the last window
+  uint32_t g_busyTotalMs = 0;   // Completed busy time
+  uint8_t  g_dutyPct = 100;     // Allowed radio duty cycle
+}
+
+void Radio::begin(uint32_t nowMs) {
+  if (g_depth++ == 0) g_startMs = nowMs;
+}
+
+void Radio::end(uint32_t nowMs) {
+  if (g_depth == 0) return;
+  if (--g_depth == 0) {
+    g_busyTotalMs += nowMs - g_startMs;
+    g_quietAtMs = nowMs + RF_GUARD_MS;
+  }
+}
+
+bool Radio::quiet(uint32_t nowMs) {
+  return g_depth == 0 && (int32_t)(nowMs - g_quietAtMs) >= 0;
+}
+
+uint32_t Radio::busyMs(uint32_t nowMs) {
+  return g_busyTotalMs + (g_depth ? nowMs - g_startMs : 0);
+}
+
+void Radio::setDutyPct(uint8_t pct) {
+  g_dutyPct = pct < 1 ? 1 : pct > 100 ? 100 : pct;
+}
+
+uint8_t Radio::dutyPct() {
+  return g_dutyPct;
+}
+
+uint32_t Radio::stretch(uint32_t ms) {
+  return (uint32_t)((uint64_t)ms * 100 / g_dutyPct);
+}
+
+Radio::Activity::~Activity() {
+  end(millis());
+}
@@ -0,0 +1,71 @@
+/**
+ * Radio Activity Windows
+ *
+ * Wi-Fi transmit bursts couple into the ADC1 inputs. Code that drives the
+ * radio (connection attempts, uplinks) marks its activity here, and the
+ * acquisition layer uses quiet() to place analog reads outside those windows
+ * and to tag samples that could not avoid them.
+ *
+ * Only activity the firmware initiates is known; background frames (ACKs,
+ * ARP, DHCP renewals) are not visible, which is why tagged samples are
+ * down-weighted rather than trusted to be the only noisy ones.
+ */
+
+#pragma once
+#include <stdint.h>
+
+namespace Radio {
+
+  /**
+   * Mark the start of radio activity (nests)
+   * @param nowMs Current time in milliseconds
+   */
+  void begin(uint32_t nowMs);
+
+  /**
+   * Mark the end of radio activity
+   * The window stays "busy" for a short guard time afterwards to cover
+   * retransmissions and the ACK exchange.
+   * @param nowMs Current time in milliseconds
+   */
+  void end(uint32_t nowMs);
+
+  /**
+   * Check whether the radio is quiet
+   * @param nowMs Current time in milliseconds
+   * @return true if no activity is in progress and the guard time has passed
+   */
+  bool quiet(uint32_t nowMs);
+
+  /**
+   * Total time marked busy (for energy accounting)
+   * @param nowMs Current time in milliseconds
+   */
+  uint32_t busyMs(uint32_t nowMs);
+
+  /**
+   * Share of time the radio may be awake, from the energy governor's
+   * profile (100 = unrestricted, clamped to 1-100). Radio work that can
+   * wait (reconnect attempts, partial push batches, uplink reports) spaces
+   * itself out with stretch().
+   */
+  void setDutyPct(uint8_t pct);
+  uint8_t dutyPct();
+
+  /**
+   * A wait scaled to the duty cycle: ms x 100 / dutyPct()
+   */
+  uint32_t stretch(uint32_t ms);
+
+  /**
+   * Scoped activity window
+   * Wraps a block of radio I/O: begin() on construction, end() on exit.
+   */
+  class Activity {
+  public:
+    explicit Activity(uint32_t nowMs) { begin(nowMs); }
+    ~Activity();
+    Activity(const Activity&) = delete;
+    Activity& operator=(const Activity&) = delete;
+  };
+}
@@ -4,4 +4,12 @@
 #define WIFI_SSID       "Your WiFi SSID"
 #define WIFI_PASSWORD   "Your WiFi Password"
 
+// Secure uplink (UPLINK_ENABLE): report endpoint and the CA that signed its
+// certificate (PEM). The uplink does not connect without a valid CA (see
+// UPLINK_INSECURE in Config.h).
+#define UPLINK_HOST     "broker.local"
+#define UPLINK_PATH     "/api/readings"
+#define UPLINK_CA_CERT  ""
 
+// UDP push collector (PUSH_ENABLE)
+#define PUSH_HOST       "collector.local"
@@ -0,0 +1,79 @@
+/**
+ * Send-on-Delta Implementation
+ */
+
+#include "SendOnDelta.h"
+#include <math.h>
+
+SendOnDelta::SendOnDelta(const Deadband* bands, int channels, uint32_t maxSilenceMs, uint32_t settleMs)
+  : channels_(channels > kMaxChannels ? kMaxChannels : channels),
+    maxSilenceMs_(maxSilenceMs), settleMs_(settleMs) {
+  for (int i = 0; i < channels_; i++) {
+    bands_[i] = bands[i];
+    sentVal_[i] = prevVal_[i] = NAN;
+  }
+}
+
+/**
+ * Deadband test for one channel
+ * NAN on exactly one side is a validity change and always significant.
+ */
+bool SendOnDelta::significant(int ch, float v) const {
+  const float s = sentVal_[ch];
+  if (isnan(v) || isnan(s)) return isnan(v) != isnan(s);
+  const float rel = bands_[ch].relDelta * fabsf(s);
+  const float band = rel > bands_[ch].absDelta ? rel : bands_[ch].absDelta;
+  return fabsf(v - s) > band;
+}
+
+static bool sameValue(float a, float b) {
+  return (isnan(a) && isnan(b)) || a == b;
+}
+
+/**
+ * Evaluate one record
+ *
+ * Order of checks: first record, deadband excursion, settle flush, heartbeat.
+ * The settle flush fires once per quiet period: after the offered values have
+ * stopped changing for settleMs while still differing from the last sent ones.
+ */
+SendOnDelta::Reason SendOnDelta::offer(uint32_t nowMs, const float* values) {
+  offered_++;
+
+  bool changed = false;
+  bool differs = false;
+  bool excursion = false;
+  for (int i = 0; i < channels_; i++) {
+    if (!sameValue(values[i], prevVal_[i])) changed = true;
+    if (!sameValue(values[i], sentVal_[i])) differs = true;
+    if (significant(i, values[i])) excursion = true;
+    prevVal_[i] = values[i];
+  }
+  if (changed) changedMs_ = nowMs;
+  dirty_ = differs;
+
+  if (!anySent_)                                        return commit(nowMs, values, First);
+  if (excursion)                                        return commit(nowMs, values, Delta);
+  if (dirty_ && (nowMs - changedMs_) >= settleMs_)      return commit(nowMs, values, Settled);
+  if ((nowMs - sentMs_) >= maxSilenceMs_)               return commit(nowMs, values, Heartbeat);
+  return None;
+}
+
+SendOnDelta::Reason SendOnDelta::commit(uint32_t nowMs, const float* values, Reason why) {
+  for (int i = 0; i < channels_; i++) sentVal_[i] = values[i];
+  sentMs_ = nowMs;
+  anySent_ = true;
+  dirty_ = false;
+  sent_++;
+  return why;
+}
+
+const char* sendReasonName(SendOnDelta::Reason r) {
+  switch (r) {
+    case SendOnDelta::First:     return "first";
+    case SendOnDelta::Delta:     return "delta";
+    case SendOnDelta::Settled:   return "settle";
+    case SendOnDelta::Heartbeat: return "heartbeat";
+    default:                     return "none";
+  }
+}
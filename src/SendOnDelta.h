@@ -0,0 +1,92 @@
+/**
+ * Send-on-Delta Reporting Filter
+ *
+ * Decides whether a telemetry record is worth transmitting. A record is sent
+ * when any channel leaves its deadband around the last transmitted value,
+ * when the link has been silent for too long (heartbeat), or when values have
+ * settled at something different from what was last sent, so the receiver
+ * always ends up holding the final value before a quiet period.
+ *
+ * Plain C++ (no Arduino dependencies) so the same filter can be benchmarked
+ * on recorded traces on the host (see host/trace_replay.cpp).
+ */
+
+#pragma once
+#include <stdint.h>
+
+/**
+ * Deadband for one channel
+ * A change is significant when |v - sent| > max(absDelta, relDelta * |sent|).
+ */
+struct Deadband {
+  float absDelta;   // Absolute deadband in channel units
+  float relDelta;   // Relative deadband as a fraction of the last sent value
+};
+
+/**
+ * Multi-channel send-on-delta filter
+ *
+ * All channels are reported together as one record; NAN marks an invalid
+ * channel and a valid<->invalid transition always counts as significant.
+ */
+class SendOnDelta {
+public:
+  static const int kMaxChannels = 8;
+
+  /**
+   * Why a record was (or was not) sent
+   */
+  enum Reason : uint8_t {
+    None = 0,      // Suppressed
+    First,         // Nothing has been sent yet
+    Delta,         // A channel left its deadband
+    Settled,       // Values settled at an unsent value
+    Heartbeat      // Maximum silence reached
+  };
+
+  /**
+   * Constructor
+   * @param bands Per-channel deadbands (copied)
+   * @param channels Number of channels (<= kMaxChannels)
+   * @param maxSilenceMs Longest gap between transmitted records
+   * @param settleMs Quiet time after which an unsent value is flushed
+   */
+  SendOnDelta(const Deadband* bands, int channels, uint32_t maxSilenceMs, uint32_t settleMs);
+
+  /**
+   * Offer a new record
+   *
+   * @param nowMs Current time in milliseconds
+   * @param values Array of `channels` values (NAN = invalid)
+   * @return Reason the record should be sent, or None to suppress it.
+   *         When not None the record is taken as transmitted.
+   */
+  Reason offer(uint32_t nowMs, const float* values);
+
+  uint32_t offered() const { return offered_; }   // Records seen
+  uint32_t sent() const { return sent_; }         // Records passed through
+
+private:
+  Deadband bands_[kMaxChannels];
+  int      channels_;
+  uint32_t maxSilenceMs_;
+  uint32_t settleMs_;
+
+  float    sentVal_[kMaxChannels];   // Last transmitted values
+  float    prevVal_[kMaxChannels];   // Previous offered values
+  uint32_t sentMs_{0};               // Time of last transmission
+  uint32_t changedMs_{0};            // Time the offered values last changed
+  bool     anySent_{false};
+  bool     dirty_{false};            // Offered values differ from sent values
+
+  uint32_t offered_{0};
+  uint32_t sent_{0};
+
+  bool significant(int ch, float v) const;
+  Reason commit(uint32_t nowMs, const float* values, Reason why);
+};
+
+/**
+ * Short label for a Reason (for logs)
+ */
+const char* sendReasonName(SendOnDelta::Reason r);
@@ -6,6 +6,9 @@
  */
 
 #include "Sensors.h"
+#include "Pm.h"
+#include "AdcCal.h"
+#include "Radio.h"
 #include <DHT.h>
 
 // Global DHT sensor instance (required by the DHT library)
@@ -30,23 +33,77 @@ void Sensors::begin() {
   // ADC_11db allows reading up to ~3.3V input voltage
   analogSetPinAttenuation(SOIL_ADC_PIN, ADC_11db);
   analogSetPinAttenuation(LDR_ADC_PIN,  ADC_11db);
+
+  // Per-chip millivolt table: every later conversion is a single lookup
+  AdcCal::begin();
+
+#if I2C_ENABLE
+  // Digital climate sensors: probe once, then poll through the scheduler
+  if (i2cBus_.begin()) {
+    i2c_.add(&sht_);
+    i2c_.add(&bme_);
+    i2c_.begin();
+    i2cClimate_ = i2c_.present(&sht_) || i2c_.present(&bme_);
+  }
+#endif
+
+#if DS18B20_ENABLE
+  // Root-zone probes: stored ROM list merged with a bus search
+  probes_.begin();
+#endif
+
+  // Gated sensor supplies start switched off
+  soilSupply_.begin(bootMs_);
+  ldrSupply_.begin(bootMs_);
 }
 
 /**
  * Non-blocking sensor update function
  * 
- * Checks if it's time to sample sensors based on the configured interval.
- * Only performs sensor readings when the sample timer expires to avoid
- * overwhelming the DHT22 sensor (which needs time between readings).
+ * Each channel has its own sampler, so only the sensors that are due are read.
+ * The DHT22 minimum interval respects its 2 s conversion time; the analog
+ * channels can run much faster while their values are moving.
  */
 void Sensors::update(uint32_t nowMs) {
-  // Check if it's time for the next sensor sample
-  if (!sampleTick.due(nowMs)) return;
-  
-  // Sample all sensors
-  sampleDHT();      // Temperature and humidity
-  sampleSoil();     // Soil moisture  
-  sampleLDR(nowMs); // Light level with auto-calibration
+  // Power gated sensors up one settle time ahead of their next sample, so the
+  // settling overlaps with the DHT read and rendering instead of a delay()
+  if (soilSampler_.due(nowMs + soilSupply_.settleMs())) soilSupply_.on(nowMs);
+  if (ldrSampler_.due(nowMs + ldrSupply_.settleMs()))   ldrSupply_.on(nowMs);
+
+  // Temperature and humidity: I2C sensors when present, DHT22 otherwise
+#if I2C_ENABLE
+  if (i2c_.pending(nowMs)) {
+    Pm::Lock lock(Pm::Job::Adc);
+    if (i2c_.update(nowMs)) applyI2C();
+  }
+#endif
+  if (!i2cClimate_ && dhtSampler_.due(nowMs)) sampleDHT(nowMs);
+
+  // Root-zone temperature: all probes convert together, read one per pass
+#if DS18B20_ENABLE
+  if (probes_.pending(nowMs)) {
+    Pm::Lock lock(Pm::Job::Adc);            // 1-Wire slots are bit-banged
+    if (probes_.update(nowMs)) cur_.rootTempC = probes_.meanC();
+  }
+#endif
+
+  // Analog reads only once their supply has settled and the radio is quiet
+  if (soilSampler_.due(nowMs) && soilSupply_.ready(nowMs) && rfWindow(nowMs, soilWaitMs_)) {
+    sampleSoil(nowMs);                                // Soil moisture
+  }
+  if (ldrSampler_.due(nowMs) && ldrSupply_.ready(nowMs) && rfWindow(nowMs, ldrWaitMs_)) {
+    sampleLDR(nowMs);                                 // Light level
+  }
+
+#if FLICKER_DETECT
+  // Sunlight vs grow light: same supply lead as the LDR sampler, burst once settled
+  const uint32_t sinceBurst = nowMs - flickerLastMs_;
+  if (sinceBurst + ldrSupply_.settleMs() >= FLICKER_PERIOD_MS) ldrSupply_.on(nowMs);
+  if (sinceBurst >= FLICKER_PERIOD_MS && ldrSupply_.ready(nowMs)) {
+    flickerLastMs_ = nowMs;
+    sampleFlicker(nowMs);
+  }
+#endif
 }
 
 /**
@@ -54,11 +111,23 @@ void Sensors::update(uint32_t nowMs) {
  * 
  * The DHT22 is a digital sensor that communicates over a single wire.
  * Readings can occasionally fail, resulting in NAN values which are
- * handled gracefully by the display system.
+ * handled gracefully by the display system. A failed read is treated as
+ * "active" so it is retried at the minimum interval.
  */
-void Sensors::sampleDHT() {
+void Sensors::sampleDHT(uint32_t nowMs) {
+  Pm::Lock lock(Pm::Job::Adc);            // Full clock for timing-critical reads
   cur_.tempC    = dht.readTemperature();  // Celsius by default
   cur_.humidity = dht.readHumidity();     // Relative humidity percentage
+
+  const uint32_t horizon = dhtSampler_.intervalMs() * 2;
+  bool active = isnan(cur_.tempC) || isnan(cur_.humidity);
+  if (!active) {
+    // Evaluate both estimators so each keeps its history current
+    const bool t = tempEst_.update(nowMs, cur_.tempC, horizon);
+    const bool h = humEst_.update(nowMs, cur_.humidity, horizon);
+    active = t || h;
+  }
+  dhtSampler_.reschedule(nowMs, active);
 }
 
 /**
@@ -68,13 +137,22 @@ void Sensors::sampleDHT() {
  * which changes with moisture content. Higher water content = lower resistance = lower ADC reading.
  * The raw ADC value is mapped to a 0-100% scale using calibration constants.
  */
-void Sensors::sampleSoil() {
-  cur_.soilRaw = analogRead(SOIL_ADC_PIN);
+void Sensors::sampleSoil(uint32_t nowMs) {
+  Pm::Lock lock(Pm::Job::Adc);
+  const bool tagged = !Radio::quiet(nowMs);  // Could not avoid radio activity
+  float var;
+  const float mv = readBurst(SOIL_ADC_PIN, cur_.soilRaw, var);
+  soilSupply_.off(nowMs);                 // Done: remove excitation until next sample
+  soilNoise_.add(var, tagged);
+  cur_.soilMv = (int)(soilFilter_.update(mv, tagged ? RF_NOISY_WEIGHT : 1.0f) + 0.5f);
   
-  // Map raw ADC to percentage using bidirectional mapping
-  // SOIL_RAW_WATER (low ADC) = 100% moisture
-  // SOIL_RAW_AIR (high ADC) = 0% moisture  
-  cur_.soilPct = Utils::mapConstrainBi(cur_.soilRaw, SOIL_RAW_WATER, SOIL_RAW_AIR, 100, 0);
+  // Map calibrated voltage to percentage using bidirectional mapping
+  // SOIL_MV_WATER (low voltage) = 100% moisture
+  // SOIL_MV_AIR (high voltage) = 0% moisture  
+  cur_.soilPct = Utils::mapConstrainBi(cur_.soilMv, SOIL_MV_WATER, SOIL_MV_AIR, 100, 0);
+
+  const bool active = soilEst_.update(nowMs, cur_.soilPct, soilSampler_.intervalMs() * 2);
+  soilSampler_.reschedule(nowMs, active);
 }
 
 /**
@@ -85,22 +163,253 @@ void Sensors::sampleSoil() {
  * first 10 seconds of operation by recording min/max values encountered.
  */
 void Sensors::sampleLDR(uint32_t nowMs) {
-  cur_.ldrRaw = analogRead(LDR_ADC_PIN);
+  Pm::Lock lock(Pm::Job::Adc);
+  const bool tagged = !Radio::quiet(nowMs);
+  float var;
+  const float mv = readBurst(LDR_ADC_PIN, cur_.ldrRaw, var);
+  ldrSupply_.off(nowMs);
+  ldrNoise_.add(var, tagged);
+  cur_.ldrMv = (int)(ldrFilter_.update(mv, tagged ? RF_NOISY_WEIGHT : 1.0f) + 0.5f);
   
   // Auto-calibration during the first 10 seconds of operation
   if (calibrating(nowMs)) {
     // Track minimum and maximum light levels encountered
-    if (cur_.ldrRaw < ldrMin_) ldrMin_ = cur_.ldrRaw;
-    if (cur_.ldrRaw > ldrMax_) ldrMax_ = cur_.ldrRaw;
+    if (cur_.ldrMv < ldrMin_) ldrMin_ = cur_.ldrMv;
+    if (cur_.ldrMv > ldrMax_) ldrMax_ = cur_.ldrMv;
   }
   
   // Handle edge case where min equals max (no variation during calibration)
   // Create a small artificial range to prevent division by zero
   if (ldrMin_ == ldrMax_) { 
-    ldrMin_ = max(0, cur_.ldrRaw - 50);       // Ensure we don't go below 0
-    ldrMax_ = min(4095, cur_.ldrRaw + 50);    // Ensure we don't exceed ADC max
+    ldrMin_ = max(0, cur_.ldrMv - 40);               // Ensure we don't go below 0
+    ldrMax_ = min(ADC_MAX_MV, cur_.ldrMv + 40);      // Ensure we don't exceed ADC max
   }
   
   // Map calibrated range to 0-100% scale
-  cur_.lightPct = Utils::mapConstrainBi(cur_.ldrRaw, ldrMin_, ldrMax_, 0, 100);
+  cur_.lightPct = Utils::mapConstrainBi(cur_.ldrMv, ldrMin_, ldrMax_, 0, 100);
+
+  // Stay at the fastest rate while the calibration window is open
+  const bool moving = lightEst_.update(nowMs, cur_.lightPct, ldrSampler_.intervalMs() * 2);
+  ldrSampler_.reschedule(nowMs, moving || calibrating(nowMs));
+}
+
+/**
+ * Take the I2C results of a finished sweep
+ * 
+ * The SHT3x is preferred for temperature/humidity (better accuracy); the
+ * BME280 fills in when the SHT3x is absent or failed this sweep, and always
+ * supplies pressure. A failed read shows as NAN, like a DHT22 failure.
+ */
+void Sensors::applyI2C() {
+#if I2C_ENABLE
+  if (sht_.valid()) {
+    cur_.tempC    = sht_.tempC();
+    cur_.humidity = sht_.humidity();
+  } else if (bme_.valid()) {
+    cur_.tempC    = bme_.tempC();
+    cur_.humidity = bme_.humidity();
+  } else {
+    cur_.tempC    = NAN;
+    cur_.humidity = NAN;
+  }
+  if (i2c_.present(&bme_)) {
+    cur_.pressureHpa = bme_.valid() ? bme_.pressureHpa() : NAN;
+  }
+#endif
+}
+
+/**
+ * Print I2C statistics, e.g.
+ *   I2C: SHT3x BME280 | sweep 16 ms vs 26 ms sequential, 120 sweeps, 0 errors, bus 1840 us
+ */
+void Sensors::printI2CStats(Print& out) const {
+#if I2C_ENABLE
+  out.print(F("I2C:"));
+  if (i2c_.present(&sht_)) out.print(F(" SHT3x"));
+  if (i2c_.present(&bme_)) out.print(F(" BME280"));
+  if (!i2cClimate_) out.print(F(" (none)"));
+  out.print(F(" | sweep ")); out.print(i2c_.lastSweepMs());
+  out.print(F(" ms vs ")); out.print(i2c_.sequentialMs());
+  out.print(F(" ms sequential, ")); out.print(i2c_.sweeps());
+  out.print(F(" sweeps, ")); out.print(i2c_.errors());
+  out.print(F(" errors, bus ")); out.print(i2cBus_.busyMicros());
+  out.println(F(" us"));
+#else
+  (void)out;
+#endif
+}
+
+/**
+ * Radio-aware read scheduling
+ * 
+ * A due read is held back while the radio is busy. Once it has waited
+ * RF_MAX_DEFER_MS it runs anyway (and is tagged), so a chatty link can
+ * delay samples but never starve them.
+ */
+bool Sensors::rfWindow(uint32_t nowMs, uint32_t& waitingSince) {
+#if RF_AWARE_SAMPLING
+  if (Radio::quiet(nowMs)) {
+    waitingSince = 0;
+    return true;
+  }
+  if (waitingSince == 0) waitingSince = nowMs | 1;   // 0 is reserved for "not waiting"
+  if (nowMs - waitingSince < RF_MAX_DEFER_MS) return false;
+  waitingSince = 0;
+  return true;
+#else
+  (void)nowMs; (void)waitingSince;
+  return true;
+#endif
+}
+
+/**
+ * Burst read
+ * 
+ * Each conversion goes through the calibration table before averaging, so
+ * the mean is taken on the linearized scale. A handful of back-to-back
+ * conversions takes well under a millisecond.
+ */
+float Sensors::readBurst(int pin, int& raw, float& var) {
+  int32_t rawSum = 0;
+  float sum = 0, sumSq = 0;
+  for (int i = 0; i < ADC_BURST_SAMPLES; i++) {
+    const int code = analogRead(pin);
+    const float mv = AdcCal::toMv(code);
+    rawSum += code;
+    sum += mv;
+    sumSq += mv * mv;
+  }
+  const float n = (float)ADC_BURST_SAMPLES;
+  const float mean = sum / n;
+  var = (n > 1) ? (sumSq - sum * mean) / (n - 1) : 0.0f;
+  if (var < 0) var = 0;                                 // Rounding on near-constant bursts
+  raw = (int)(rawSum / ADC_BURST_SAMPLES);
+  return mean;
+}
+
+/**
+ * Print ADC noise statistics, e.g.
+ *   ADC noise var (mV^2): Soil quiet 2.1 (n=812) RF 14.7 (n=9), LDR quiet 1.4 (n=640) RF 0.0 (n=0)
+ * Compare runs with RF_AWARE_SAMPLING 1 and 0 to see the effect of coordination.
+ */
+void Sensors::printNoiseStats(Print& out) const {
+  out.print(F("ADC noise var (mV^2): Soil quiet "));
+  out.print(soilNoise_.variance(false), 1);
+  out.print(F(" (n=")); out.print(soilNoise_.count(false));
+  out.print(F(") RF ")); out.print(soilNoise_.variance(true), 1);
+  out.print(F(" (n=")); out.print(soilNoise_.count(true));
+  out.print(F("), LDR quiet ")); out.print(ldrNoise_.variance(false), 1);
+  out.print(F(" (n=")); out.print(ldrNoise_.count(false));
+  out.print(F(") RF ")); out.print(ldrNoise_.variance(true), 1);
+  out.print(F(" (n=")); out.print(ldrNoise_.count(true));
+  out.println(F(")"));
+}
+
+/**
+ * Capture a flicker burst from the LDR
+ * 
+ * Samples are paced from micros() rather than delayed, so the sample period
+ * stays at 1/FLICKER_RATE_HZ regardless of analogRead() duration. The whole
+ * burst runs at full clock; update() only calls it once the LDR supply has
+ * settled, so nothing waits under the ADC lock.
+ */
+void Sensors::sampleFlicker(uint32_t nowMs) {
+#if FLICKER_DETECT
+  static int16_t burst[FLICKER_SAMPLES];   // Static: keeps 400 bytes off the loop stack
+
+  {
+    Pm::Lock lock(Pm::Job::Adc);
+    const uint32_t periodUs = 1000000UL / FLICKER_RATE_HZ;
+    const uint32_t t0 = micros();
+    for (int i = 0; i < FLICKER_SAMPLES; i++) {
+      while ((uint32_t)(micros() - t0) < (uint32_t)i * periodUs) { }
+      burst[i] = (int16_t)analogRead(LDR_ADC_PIN);
+    }
+    ldrSupply_.off(millis());
+  }
+
+  const FlickerResult res = flicker_.analyze(burst, FLICKER_SAMPLES);
+  cur_.lightSource = res.source;
+  growLog_.record(nowMs, res.source == LightSource::Artificial);
+#else
+  (void)nowMs;
+#endif
+}
+
+/**
+ * Apply an interval multiplier to every channel
+ * 
+ * The bounds are recomputed from the Config.h values (not the current ones)
+ * so repeated calls do not compound.
+ */
+void Sensors::setRateScale(uint8_t scale) {
+  if (scale == 0) scale = 1;
+#if ADAPTIVE_SAMPLING
+  dhtSampler_.setBounds(DHT_SAMPLE_MIN_MS * scale, DHT_SAMPLE_MAX_MS * scale);
+  soilSampler_.setBounds(SOIL_SAMPLE_MIN_MS * scale, SOIL_SAMPLE_MAX_MS * scale);
+  ldrSampler_.setBounds(LDR_SAMPLE_MIN_MS * scale, LDR_SAMPLE_MAX_MS * scale);
+#else
+  dhtSampler_.setBounds(SENSOR_SAMPLE_MS * scale, SENSOR_SAMPLE_MS * scale);
+  soilSampler_.setBounds(SENSOR_SAMPLE_MS * scale, SENSOR_SAMPLE_MS * scale);
+  ldrSampler_.setBounds(SENSOR_SAMPLE_MS * scale, SENSOR_SAMPLE_MS * scale);
+#endif
+}
+
+/**
+ * Print sampling statistics
+ * 
+ * One line per call, e.g.
+ *   Sampling/h: DHT 1800 (2000 ms), Soil 240 (60000 ms), LDR 120 (30000 ms)
+ * Useful to compare the adaptive policy against the fixed 3600 samples/h.
+ */
+void Sensors::printSamplingStats(Print& out, uint32_t nowMs) const {
+  out.print(F("Sampling/h: DHT "));
+  out.print(dhtSampler_.samplesPerHour(nowMs), 0);
+  out.print(F(" (")); out.print(dhtSampler_.intervalMs()); out.print(F(" ms), Soil "));
+  out.print(soilSampler_.samplesPerHour(nowMs), 0);
+  out.print(F(" (")); out.print(soilSampler_.intervalMs()); out.print(F(" ms), LDR "));
+  out.print(ldrSampler_.samplesPerHour(nowMs), 0);
+  out.print(F(" (")); out.print(ldrSampler_.intervalMs()); out.println(F(" ms)"));
+
+  // Excitation duty cycle (100 % for sensors wired to 3V3)
+  out.print(F("Supply duty: Soil "));
+  out.print(soilSupply_.dutyPct(nowMs), 2);
+  out.print(F(" %, LDR "));
+  out.print(ldrSupply_.dutyPct(nowMs), 2);
+  out.println(F(" %"));
+}
+
+// =============================================================================
+// Sensor Supply Gating
+// =============================================================================
+
+void SensorSupply::begin(uint32_t nowMs) {
+  beginMs_ = nowMs;
+  if (pin_ < 0) return;
+  pinMode(pin_, OUTPUT);
+  digitalWrite(pin_, LOW);
+}
+
+void SensorSupply::on(uint32_t nowMs) {
+  if (pin_ < 0 || on_) return;
+  digitalWrite(pin_, HIGH);
+  on_ = true;
+  onSinceMs_ = nowMs;
+}
+
+void SensorSupply::off(uint32_t nowMs) {
+  if (pin_ < 0 || !on_) return;
+  digitalWrite(pin_, LOW);
+  on_ = false;
+  totalOnMs_ += nowMs - onSinceMs_;
+}
+
+uint32_t SensorSupply::poweredMs(uint32_t nowMs) const {
+  if (pin_ < 0) return nowMs - beginMs_;
+  return totalOnMs_ + (on_ ? nowMs - onSinceMs_ : 0);
+}
+
+float SensorSupply::dutyPct(uint32_t nowMs) const {
+  const uint32_t elapsed = nowMs - beginMs_;
+  return elapsed ? 100.0f * (float)poweredMs(nowMs) / (float)elapsed : 100.0f;
 }
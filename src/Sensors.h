@@ -14,6 +14,17 @@
 #include <Arduino.h>
 #include "Config.h"
 #include "Utils.h"
+#include "AdaptiveSampler.h"
+#include "Flicker.h"
+#include "AnalogFilter.h"
+#include "I2CBus.h"
+#include "I2CSensors.h"
+#if I2C_ENABLE
+#include "I2CEsp.h"
+#endif
+#if DS18B20_ENABLE
+#include "Ds18b20.h"
+#endif
 
 /**
  * Structure containing all sensor readings
@@ -29,6 +40,73 @@ struct Readings {
   int   lightPct = -1;   // Light level 0-100% (-1 = calibrating/error)
   int   soilRaw  = -1;   // Raw ADC value from soil sensor (for debugging)
   int   ldrRaw   = -1;   // Raw ADC value from light sensor (for debugging)
+  int   soilMv   = -1;   // Calibrated soil sensor voltage in millivolts
+  int   ldrMv    = -1;   // Calibrated light sensor voltage in millivolts
+  LightSource lightSource = LightSource::Unknown;  // Sunlight vs grow light (flicker)
+  float pressureHpa = NAN;  // Barometric pressure in hPa (NAN = no BME280)
+  float rootTempC   = NAN;  // Mean root-zone temperature of the DS18B20 probes (NAN = none)
+};
+
+/**
+ * Switchable sensor supply with settle time
+ * 
+ * Powers an analog sensor from a GPIO only around its read. A pin of -1
+ * means the sensor is wired to 3V3: always on and always settled.
+ * Tracks total powered time so the duty cycle can be reported.
+ */
+class SensorSupply {
+public:
+  /**
+   * Constructor
+   * @param pin Supply GPIO (-1 = always powered)
+   * @param settleMs Time from power-on until readings are valid
+   */
+  SensorSupply(int pin, uint32_t settleMs) : pin_(pin), settleMs_(settleMs) {}
+
+  /**
+   * Configure the supply pin (off)
+   * @param nowMs Current time in milliseconds
+   */
+  void begin(uint32_t nowMs);
+
+  /**
+   * Switch the supply on (no-op if already on)
+   */
+  void on(uint32_t nowMs);
+
+  /**
+   * Switch the supply off (no-op for always-powered sensors)
+   */
+  void off(uint32_t nowMs);
+
+  /**
+   * Check whether the sensor is powered and settled
+   */
+  bool ready(uint32_t nowMs) const {
+    return pin_ < 0 || (on_ && nowMs - onSinceMs_ >= settleMs_);
+  }
+
+  uint32_t settleMs() const { return pin_ < 0 ? 0 : settleMs_; }
+
+  /**
+   * Total powered time since begin()
+   * @param nowMs Current time in milliseconds
+   */
+  uint32_t poweredMs(uint32_t nowMs) const;
+
+  /**
+   * Powered share of time since begin()
+   * @return Duty cycle 0-100%
+   */
+  float dutyPct(uint32_t nowMs) const;
+
+private:
+  int      pin_;
+  uint32_t settleMs_;
+  bool     on_{false};
+  uint32_t onSinceMs_{0};    // Time the supply was last switched on
+  uint32_t totalOnMs_{0};    // Accumulated powered time (completed periods)
+  uint32_t beginMs_{0};
 };
 
 /**
@@ -36,6 +114,8 @@ struct Readings {
  * 
  * Handles initialization, periodic sampling, and calibration of all sensors.
  * Uses non-blocking timing to ensure the main loop remains responsive.
+ * Each sensor is scheduled by its own AdaptiveSampler, so moving channels
+ * are read often and stable channels back off (see ADAPTIVE_SAMPLING).
  */
 class Sensors {
 public:
@@ -47,7 +127,8 @@ public:
   
   /**
    * Update all sensor readings (non-blocking)
-   * Should be called frequently from the main loop
+   * Should be called frequently from the main loop; only the channels
+   * whose sampler is due are read
    * 
    * @param nowMs Current time in milliseconds from millis()
    */
@@ -70,34 +151,133 @@ public:
   
   /**
    * Get the minimum light value recorded during calibration
-   * @return Minimum ADC value (darkest condition)
+   * @return Minimum voltage in millivolts (darkest condition)
    */
   int ldrMin() const { return ldrMin_; }
   
   /**
    * Get the maximum light value recorded during calibration  
-   * @return Maximum ADC value (brightest condition)
+   * @return Maximum voltage in millivolts (brightest condition)
    */
   int ldrMax() const { return ldrMax_; }
 
+  /**
+   * Per-channel schedulers (for statistics and external rate control)
+   */
+  AdaptiveSampler& dhtSampler()  { return dhtSampler_; }
+  AdaptiveSampler& soilSampler() { return soilSampler_; }
+  AdaptiveSampler& ldrSampler()  { return ldrSampler_; }
+
+  /**
+   * Supplies of the analog sensors (for duty-cycle and energy accounting)
+   */
+  const SensorSupply& soilSupply() const { return soilSupply_; }
+  const SensorSupply& ldrSupply() const  { return ldrSupply_; }
+
+  /**
+   * Print mean in-burst ADC noise variance, clean vs radio-tagged samples
+   * @param out Destination stream (usually Serial)
+   */
+  void printNoiseStats(Print& out) const;
+
+  /**
+   * Print I2C sweep timing: overlapped sweep vs sequential conversion cost
+   * @param out Destination stream (usually Serial)
+   */
+  void printI2CStats(Print& out) const;
+
+#if DS18B20_ENABLE
+  /**
+   * Root-zone probes (per-probe temperatures and bus statistics)
+   */
+  const Ds18b20Bank& rootProbes() const { return probes_; }
+#endif
+
+  /**
+   * Grow-light on/off history and duty from flicker detection
+   */
+  const GrowLightLog& growLights() const { return growLog_; }
+
+  /**
+   * Stretch all sample intervals by a factor (energy governor)
+   * The configured min/max bounds of every channel are multiplied by scale.
+   * 
+   * @param scale Interval multiplier (1 = configured rates)
+   */
+  void setRateScale(uint8_t scale);
+
+  /**
+   * Print effective samples per hour and current interval of each channel
+   * @param out Destination stream (usually Serial)
+   * @param nowMs Current time in milliseconds
+   */
+  void printSamplingStats(Print& out, uint32_t nowMs) const;
+
 private:
   Readings  cur_;                                    // Current sensor readings
   uint32_t  bootMs_{0};                             // System boot time for calibration
-  int ldrMin_{4095};                                // Min light value (starts at ADC max)
-  int ldrMax_{0};                                   // Max light value (starts at ADC min)
-  Utils::Ticker sampleTick{SENSOR_SAMPLE_MS};      // Non-blocking sampling timer
+  int ldrMin_{ADC_MAX_MV};                          // Min light value in mV (starts at ADC max)
+  int ldrMax_{0};                                   // Max light value in mV (starts at ADC min)
+
+#if ADAPTIVE_SAMPLING
+  AdaptiveSampler dhtSampler_{DHT_SAMPLE_MIN_MS, DHT_SAMPLE_MAX_MS};
+  AdaptiveSampler soilSampler_{SOIL_SAMPLE_MIN_MS, SOIL_SAMPLE_MAX_MS};
+  AdaptiveSampler ldrSampler_{LDR_SAMPLE_MIN_MS, LDR_SAMPLE_MAX_MS};
+#else
+  AdaptiveSampler dhtSampler_{SENSOR_SAMPLE_MS, SENSOR_SAMPLE_MS};
+  AdaptiveSampler soilSampler_{SENSOR_SAMPLE_MS, SENSOR_SAMPLE_MS};
+  AdaptiveSampler ldrSampler_{SENSOR_SAMPLE_MS, SENSOR_SAMPLE_MS};
+#endif
+
+  SensorSupply soilSupply_{SOIL_PWR_PIN, SOIL_SETTLE_MS};  // Excitation power gating
+  SensorSupply ldrSupply_{LDR_PWR_PIN, LDR_SETTLE_MS};
+
+  WeightedEwma soilFilter_{ANALOG_FILTER_ALPHA};    // Voltage filters (RF-weighted)
+  WeightedEwma ldrFilter_{ANALOG_FILTER_ALPHA};
+  NoiseMeter soilNoise_;                             // In-burst variance, clean vs RF-tagged
+  NoiseMeter ldrNoise_;
+  uint32_t soilWaitMs_{0};                           // Start of wait for a quiet radio window
+  uint32_t ldrWaitMs_{0};
+
+#if I2C_ENABLE
+  EspI2CTransport i2cBus_{I2C_NUM_0, I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQ_HZ};
+  Sht3x  sht_;
+  Bme280 bme_;
+  I2CScheduler i2c_{i2cBus_, I2C_SWEEP_MS};          // Overlaps conversions across devices
+#endif
+  bool i2cClimate_{false};                           // An I2C sensor replaces the DHT22
+
+#if DS18B20_ENABLE
+  Ds18b20Bank probes_{ONEWIRE_PIN, DS18B20_RESOLUTION, DS18B20_PERIOD_MS};  // One conversion for all probes
+#endif
+
+#if FLICKER_DETECT
+  uint32_t flickerLastMs_ = 0;                       // Last flicker burst
+  FlickerDetector flicker_{(float)FLICKER_RATE_HZ, FLICKER_SAMPLES,
+                           FLICKER_MIN_RATIO, FLICKER_MIN_RMS, FLICKER_DARK_MEAN};
+#endif
+  GrowLightLog growLog_;                             // Grow-light transitions
+
+  ChangeEstimator tempEst_{TEMP_CHANGE_C};           // Movement detectors per channel
+  ChangeEstimator humEst_{HUMIDITY_CHANGE};
+  ChangeEstimator soilEst_{SOIL_CHANGE_PCT};
+  ChangeEstimator lightEst_{LIGHT_CHANGE_PCT};
 
   /**
    * Read temperature and humidity from DHT22 sensor
    * Updates cur_.tempC and cur_.humidity
+   * 
+   * @param nowMs Current time for scheduling
    */
-  void sampleDHT();
+  void sampleDHT(uint32_t nowMs);
   
   /**
    * Read soil moisture from capacitive sensor
    * Updates cur_.soilRaw and cur_.soilPct
+   * 
+   * @param nowMs Current time for scheduling
    */
-  void sampleSoil();
+  void sampleSoil(uint32_t nowMs);
   
   /**
    * Read light level from LDR and perform auto-calibration
@@ -106,4 +286,37 @@ private:
    * @param nowMs Current time for calibration timing
    */
   void sampleLDR(uint32_t nowMs);
+
+  /**
+   * Copy the latest I2C results into the current readings
+   */
+  void applyI2C();
+
+  /**
+   * Decide whether an analog read may run now
+   * Waits for a quiet radio window, but never longer than RF_MAX_DEFER_MS
+   * 
+   * @param nowMs Current time in milliseconds
+   * @param waitingSince Per-channel wait start (0 = not waiting)
+   * @return true if the read should run now
+   */
+  bool rfWindow(uint32_t nowMs, uint32_t& waitingSince);
+
+  /**
+   * Read a burst of conversions and return the mean voltage
+   * 
+   * @param pin ADC pin
+   * @param raw Receives the mean raw code
+   * @param var Receives the in-burst voltage variance (mV^2)
+   * @return Mean calibrated voltage in millivolts
+   */
+  float readBurst(int pin, int& raw, float& var);
+
+  /**
+   * Capture a high-rate LDR burst and classify the light source
+   * Updates cur_.lightSource and the grow-light log
+   * 
+   * @param nowMs Current time in milliseconds
+   */
+  void sampleFlicker(uint32_t nowMs);
 };
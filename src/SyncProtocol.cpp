@@ -0,0 +1,205 @@
+/**
+ * History Sync Protocol Implementation
+ */
+
+#include "SyncProtocol.h"
+#include "HistoryStream.h"
+#include <string.h>
+
+using namespace Sync;
+
+// =============================================================================
+// Framing
+// =============================================================================
+
+/**
+ * CRC-32 with a 16-entry table (64 bytes of flash instead of 1 KB)
+ */
+uint32_t Sync::crc32(const uint8_t* data, size_t len, uint32_t crc) {
+  static const uint32_t kNibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+  };
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ kNibble[crc & 0x0F];
+    crc = (crc >> 4) ^ kNibble[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+static uint8_t* putLe(uint8_t* p, uint32_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) *p++ = (uint8_t)(v >> (8 * i));
+  return p;
+}
+
+static uint32_t getLe(const uint8_t* p, int bytes) {
+  uint32_t v = 0;
+  for (int i = bytes - 1; i >= 0; i--) v = v << 8 | p[i];
+  return v;
+}
+
+size_t Sync::frame(uint8_t* out, Type type, const uint8_t* payload, size_t len) {
+  out[0] = kMagic0;
+  out[1] = kMagic1;
+  out[2] = type;
+  putLe(out + 3, (uint32_t)len, 2);
+  if (payload && payload != out + 5) memmove(out + 5, payload, len);
+  putLe(out + 5 + len, crc32(out + 2, len + 3), 4);
+  return len + kOverhead;
+}
+
+/**
+ * Parser states: 0 = hunting for magic, 1 = magic 1, 2-4 = type and
+ * length, 5 = payload, 6 = CRC
+ */
+bool Parser::feed(uint8_t b) {
+  switch (state_) {
+    case 0:
+      if (b == kMagic0) state_ = 1;
+      return false;
+    case 1:
+      state_ = b == kMagic1 ? 2 : (b == kMagic0 ? 1 : 0);
+      return false;
+    case 2:
+      type_ = b;
+      state_ = 3;
+      return false;
+    case 3:
+      len_ = b;
+      state_ = 4;
+      return false;
+    case 4:
+      len_ |= (uint16_t)b << 8;
+      got_ = 0;
+      if (len_ > kMaxPayload) { crcErrors_++; state_ = 0; return false; }
+      state_ = len_ ? 5 : 6;
+      return false;
+    case 5:
+      buf_[got_++] = b;
+      if (got_ == len_) { got_ = 0; state_ = 6; }
+      return false;
+    default: {
+      buf_[len_ + got_++] = b;
+      if (got_ < 4) return false;
+      state_ = 0;
+      const uint8_t head[3] = { type_, (uint8_t)len_, (uint8_t)(len_ >> 8) };
+      const uint32_t crc = crc32(buf_, len_, crc32(head, 3));
+      if (crc == getLe(buf_ + len_, 4)) return true;
+      crcErrors_++;
+      return false;
+    }
+  }
+}
+
+// =============================================================================
+// Device Side
+// =============================================================================
+
+Sender::Sender(const History& hist, uint64_t deviceId, uint32_t ackTimeoutMs)
+  : hist_(hist), id_(deviceId), timeoutMs_(ackTimeoutMs) {}
+
+void Sender::onFrame(Type type, const uint8_t* payload, size_t len, uint32_t nowMs) {
+  switch (type) {
+    case Hello:                                    // New or resumed session
+      state_ = State::SendInfo;
+      sessions_++;
+      break;
+
+    case Start: {
+      if (state_ != State::WaitStart || len < 7) break;
+      uint32_t from = getLe(payload, 4);
+      if ((int32_t)(from - hist_.nextSeq()) > 0) from = hist_.nextSeq();
+      sendSeq_ = ackSeq_ = from;
+      window_ = payload[4] ? payload[4] : 1;
+      perChunk_ = (uint16_t)getLe(payload + 5, 2);
+      if (perChunk_ == 0 || perChunk_ > kMaxRecords) perChunk_ = kMaxRecords;
+      lastAckMs_ = nowMs;
+      state_ = State::Streaming;
+      break;
+    }
+
+    case Ack:
+    case Nak: {
+      if (state_ != State::Streaming || len < 4) break;
+      const uint32_t next = getLe(payload, 4);
+      if ((int32_t)(next - ackSeq_) > 0 && (int32_t)(next - sendSeq_) <= 0) {
+        ackSeq_ = next;                            // Cumulative
+        lastAckMs_ = nowMs;
+      }
+      if (type == Nak) {
+        sendSeq_ = ackSeq_;                        // Go back and resend
+        resends_++;
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+/**
+ * Produce the next frame
+ *
+ * While streaming, chunks are sent until `window` of them are unacknowledged.
+ * Without an acknowledgement for timeoutMs, everything after the last one
+ * is sent again (go-back-N) straight from the history ring.
+ */
+size_t Sender::nextFrame(uint8_t* out, uint32_t nowMs) {
+  uint8_t* p = out + 5;                            // Payload is built in place
+
+  switch (state_) {
+    case State::SendInfo:
+      putLe(p, (uint32_t)id_, 4);
+      putLe(p + 4, (uint32_t)(id_ >> 32), 4);
+      putLe(p + 8, hist_.firstSeq(), 4);
+      putLe(p + 12, hist_.nextSeq(), 4);
+      p[16] = HistoryStream::kBinaryRecord;
+      state_ = State::WaitStart;
+      return frame(out, Info, p, 17);
+
+    case State::Streaming: {
+      if (nowMs - lastAckMs_ >= timeoutMs_ && sendSeq_ != ackSeq_) {
+        sendSeq_ = ackSeq_;                        // Timed out: resend the window
+        lastAckMs_ = nowMs;
+        resends_++;
+      }
+
+      if ((int32_t)(sendSeq_ - hist_.firstSeq()) < 0) {
+        sendSeq_ = hist_.firstSeq();               // Overwritten: nothing older to resend
+        if ((int32_t)(ackSeq_ - sendSeq_) < 0) ackSeq_ = sendSeq_;
+      }
+      const uint8_t flags = sendSeq_ == hist_.firstSeq() ? kDataGap : 0;
+
+      if (sendSeq_ == hist_.nextSeq()) {
+        if (ackSeq_ == sendSeq_) state_ = State::SendDone;
+        return 0;
+      }
+      if (sendSeq_ - ackSeq_ >= (uint32_t)window_ * perChunk_) return 0;   // Window full
+
+      uint16_t count = 0;
+      uint8_t* rec = p + kDataHeader;
+      HistorySample s;
+      while (count < perChunk_ && hist_.bySeq(sendSeq_ + count, s)) {
+        HistoryStream::encodeBinary(rec, sendSeq_ + count, s);
+        rec += HistoryStream::kBinaryRecord;
+        count++;
+      }
+      putLe(p, sendSeq_, 4);
+      putLe(p + 4, count, 2);
+      p[6] = flags;
+      sendSeq_ += count;
+      return frame(out, Data, p, rec - p);
+    }
+
+    case State::SendDone:
+      putLe(p, ackSeq_, 4);
+      state_ = State::Idle;
+      return frame(out, Done, p, 4);
+
+    default:
+      return 0;
+  }
+}
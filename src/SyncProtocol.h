@@ -0,0 +1,156 @@
+/**
+ * History Sync Protocol
+ *
+ * Incremental, resumable transfer of history records to a host over any
+ * byte stream (serial or TCP). The host remembers, per device, the sequence
+ * number it has acknowledged, so a sync only moves new records and a broken
+ * transfer resumes where the last acknowledgement left off.
+ *
+ * Frames (all integers little-endian):
+ *
+ *   A5 5A <type u8> <length u16> <payload> <crc32 u32>
+ *
+ * The CRC-32 (IEEE) covers type, length and payload. Bytes outside a frame
+ * are skipped, so frames can share a serial port with the text log.
+ *
+ *   Host                                  Device
+ *   Hello                            ->
+ *                                    <-   Info  {u64 id, u32 first, u32 next, u8 record size}
+ *   Start {u32 from, u8 window,      ->
+ *          u16 records per chunk}
+ *                                    <-   Data  {u32 seq, u16 count, u8 flags, records...}
+ *   Ack   {u32 next expected}        ->         (up to `window` chunks unacknowledged)
+ *   Nak   {u32 next expected}        ->   (bad CRC or gap: resend from there)
+ *                                    <-   Done  {u32 next}  once all are acknowledged
+ *
+ * Records use the binary /history format (HistoryStream::encodeBinary).
+ * kDataGap marks a chunk that starts at the oldest record the device still
+ * has: when the host expected an earlier one, that history was overwritten
+ * (not lost in transit) and it carries on from here instead of a Nak.
+ *
+ * Plain C++ (no Arduino dependencies); the host tool and the simulated
+ * device in host/sync_tool.cpp run this same code.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "History.h"
+
+namespace Sync {
+
+  enum Type : uint8_t { Hello = 1, Info = 2, Start = 3, Data = 4, Ack = 5, Nak = 6, Done = 7 };
+
+  static const uint8_t  kMagic0       = 0xA5;
+  static const uint8_t  kMagic1       = 0x5A;
+  static const size_t   kOverhead     = 2 + 1 + 2 + 4;   // Magic, type, length, CRC
+  static const size_t   kMaxPayload   = 4096;
+  static const size_t   kDataHeader   = 7;               // seq, count, flags
+  static const uint8_t  kDataGap      = 0x01;            // seq is the oldest record kept
+  static const uint16_t kMaxRecords   = (kMaxPayload - kDataHeader) / 14;
+
+  /**
+   * CRC-32 (IEEE 802.3, reflected), table-free nibble variant
+   * @param crc Previous value for incremental use (0 to start)
+   */
+  uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+  /**
+   * Build a frame
+   * @param out Destination (payload length + kOverhead bytes)
+   * @return Frame length
+   */
+  size_t frame(uint8_t* out, Type type, const uint8_t* payload, size_t len);
+
+  /**
+   * Frame parser, one byte at a time
+   * Resynchronises on the magic bytes after noise or a bad frame.
+   */
+  class Parser {
+  public:
+    /**
+     * @return true when a complete frame with a valid CRC has arrived
+     *         (valid until the next call)
+     */
+    bool feed(uint8_t b);
+
+    Type type() const { return (Type)type_; }
+    const uint8_t* payload() const { return buf_; }
+    size_t length() const { return len_; }
+
+    /**
+     * True while inside a frame (the byte stream belongs to the parser)
+     */
+    bool busy() const { return state_ != 0; }
+
+    uint32_t crcErrors() const { return crcErrors_; }
+
+  private:
+    uint8_t  state_{0};
+    uint8_t  type_{0};
+    uint16_t len_{0};
+    uint16_t got_{0};
+    uint8_t  buf_[kMaxPayload + 4];
+    uint32_t crcErrors_{0};
+  };
+
+  /**
+   * Device side of a sync session
+   *
+   * The transport feeds received frames to onFrame() and sends whatever
+   * nextFrame() returns. Only one chunk is encoded at a time; anything not
+   * yet acknowledged is re-read from the history ring when resent, so no
+   * retransmit buffer is needed.
+   */
+  class Sender {
+  public:
+    /**
+     * Constructor
+     * @param hist Reading history
+     * @param deviceId Unique device id (e.g. the Wi-Fi MAC)
+     * @param ackTimeoutMs Resend from the last acknowledgement after this long
+     */
+    Sender(const History& hist, uint64_t deviceId, uint32_t ackTimeoutMs);
+
+    /**
+     * Handle a frame from the host
+     */
+    void onFrame(Type type, const uint8_t* payload, size_t len, uint32_t nowMs);
+
+    /**
+     * Next frame to send, if any
+     * @param out Destination (at least kMaxPayload + kOverhead bytes)
+     * @return Frame length, 0 when there is nothing to send now
+     */
+    size_t nextFrame(uint8_t* out, uint32_t nowMs);
+
+    /**
+     * The link went down: stop until the next Hello
+     */
+    void stop() { state_ = State::Idle; }
+
+    /**
+     * A session is running (between Hello and Done)
+     */
+    bool active() const { return state_ != State::Idle; }
+
+    uint32_t acked() const { return ackSeq_; }
+    uint32_t resends() const { return resends_; }
+    uint32_t sessions() const { return sessions_; }
+
+  private:
+    enum class State : uint8_t { Idle, SendInfo, WaitStart, Streaming, SendDone };
+
+    const History& hist_;
+    uint64_t id_;
+    uint32_t timeoutMs_;
+    State    state_{State::Idle};
+    uint32_t sendSeq_{0};           // Next record to send
+    uint32_t ackSeq_{0};            // Everything before this is acknowledged
+    uint8_t  window_{1};            // Chunks in flight
+    uint16_t perChunk_{1};          // Records per chunk
+    uint32_t lastAckMs_{0};
+    uint32_t resends_{0};
+    uint32_t sessions_{0};
+  };
+}
@@ -0,0 +1,202 @@
+/**
+ * History Sync Endpoint Implementation
+ */
+
+#include "SyncServer.h"
+#include "SyncProtocol.h"
+#include "Net.h"
+#include "Pm.h"
+#include "Radio.h"
+#include <new>
+
+#if WIFI_ENABLE && SYNC_ENABLE
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#endif
+
+namespace {
+#if SYNC_ENABLE
+  enum class Link : uint8_t { Serial, Tcp };
+
+  // The sender needs the history, so it is constructed in begin()
+  alignas(Sync::Sender) uint8_t g_senderMem[sizeof(Sync::Sender)];
+  Sync::Sender*  g_sender = nullptr;
+  Sync::Parser   g_serialIn;
+  Link           g_link = Link::Serial;
+
+  uint8_t        g_out[Sync::kMaxPayload + Sync::kOverhead];   // Frame in flight
+  size_t         g_len = 0;
+  size_t         g_off = 0;
+  uint32_t       g_lastSessions = 0;
+  uint32_t       g_lastRxMs = 0;                   // Last frame from the host
+
+#if WIFI_ENABLE
+  WiFiServer     g_server(SYNC_PORT);
+  bool           g_listening = false;
+  WiFiClient     g_client;
+  Sync::Parser   g_tcpIn;
+#endif
+
+  void onFrame(const Sync::Parser& in, Link link, uint32_t nowMs) {
+    if (in.type() == Sync::Hello) {
+      g_link = link;
+      g_len = g_off = 0;                           // Drop what was left of the old session
+    } else if (link != g_link) {
+      return;
+    }
+    g_lastRxMs = nowMs;
+    g_sender->onFrame(in.type(), in.payload(), in.length(), nowMs);
+  }
+
+  /**
+   * Write as much of the pending frame as the link takes without blocking
+   * @return true once the frame has gone
+   */
+  bool flush() {
+    while (g_off < g_len) {
+      int n;
+      if (g_link == Link::Serial) {
+        n = Serial.availableForWrite();
+        if (n <= 0) return false;
+        n = Serial.write(g_out + g_off, min((size_t)n, g_len - g_off));
+      } else {
+#if WIFI_ENABLE
+        n = send(g_client.fd(), g_out + g_off, g_len - g_off, MSG_DONTWAIT);
+        if (n < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) return false;
+        if (n < 0) { g_client.stop(); g_len = g_off = 0; return false; }
+#else
+        n = 0;
+#endif
+      }
+      if (n <= 0) return false;
+      g_off += n;
+    }
+    return true;
+  }
+
+#if WIFI_ENABLE
+  void pollTcp(uint32_t nowMs) {
+    if (!Net::connected()) {
+      if (g_client) g_client.stop();
+      if (g_link == Link::Tcp) g_sender->stop();
+      if (g_listening) { g_server.end(); g_listening = false; }
+      return;
+    }
+    if (!g_listening) {
+      g_server.begin();
+      g_listening = true;
+    }
+    if (!g_client.connected()) {
+      if (g_link == Link::Tcp && g_sender->active()) {
+        g_sender->stop();                          // Host went away; it resumes with a Hello
+        g_len = g_off = 0;
+      }
+      WiFiClient c = g_server.available();
+      if (!c) return;
+      g_client = c;
+      g_client.setNoDelay(true);
+    }
+    Radio::Activity radio(nowMs);
+    while (g_client.available()) {
+      if (g_tcpIn.feed((uint8_t)g_client.read())) onFrame(g_tcpIn, Link::Tcp, nowMs);
+    }
+  }
+#endif
+#endif
+
+  /**
+   * Serial, minus whatever is written during a serial sync session
+   */
+  class Console : public Print {
+  public:
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t* p, size_t n) override {
+      return SyncServer::serialBusy() ? n : Serial.write(p, n);
+    }
+  };
+
+  Console g_console;
+}
+
+void SyncServer::begin(const History& hist) {
+#if SYNC_ENABLE
+  g_sender = new (g_senderMem) Sync::Sender(hist, ESP.getEfuseMac(), SYNC_ACK_TIMEOUT_MS);
+#else
+  (void)hist;
+#endif
+}
+
+/**
+ * Frames start with 0xA5, which is not a command, and the parser keeps the
+ * rest of a frame once it has started
+ */
+bool SyncServer::serialByte(uint8_t b) {
+#if SYNC_ENABLE
+  if (!g_sender || (b != Sync::kMagic0 && !g_serialIn.busy())) return false;
+  if (g_serialIn.feed(b)) onFrame(g_serialIn, Link::Serial, millis());
+  return true;
+#else
+  (void)b;
+  return false;
+#endif
+}
+
+void SyncServer::update(uint32_t nowMs) {
+#if SYNC_ENABLE
+  if (!g_sender) return;
+#if WIFI_ENABLE
+  pollTcp(nowMs);
+#endif
+  // Serial has no disconnect; a host that stopped answering ends the session
+  if (g_link == Link::Serial && g_sender->active() && nowMs - g_lastRxMs >= SYNC_SERIAL_IDLE_MS) {
+    g_sender->stop();
+    g_len = g_off = 0;
+  }
+  if (!g_sender->active() && g_off == g_len) return;
+
+  Pm::Lock lock(Pm::Job::Network);
+  const uint32_t t0 = millis();
+  while (millis() - t0 < SYNC_SLICE_MS) {
+    if (!flush()) break;
+    g_len = g_sender->nextFrame(g_out, nowMs);
+    g_off = 0;
+    if (g_len == 0) break;
+  }
+
+  if (!g_sender->active() && g_sender->sessions() != g_lastSessions && g_off == g_len) {
+    g_lastSessions = g_sender->sessions();
+    Serial.print(F("Sync: acknowledged up to ")); Serial.print(g_sender->acked());
+    Serial.print(F(", resends ")); Serial.println(g_sender->resends());
+  }
+#else
+  (void)nowMs;
+#endif
+}
+
+bool SyncServer::serialBusy() {
+#if SYNC_ENABLE
+  return g_sender && g_link == Link::Serial && (g_sender->active() || g_off < g_len);
+#else
+  return false;
+#endif
+}
+
+Print& SyncServer::console() {
+  return g_console;
+}
+
+uint32_t SyncServer::sessions() {
+#if SYNC_ENABLE
+  return g_sender ? g_sender->sessions() : 0;
+#else
+  return 0;
+#endif
+}
+
+uint32_t SyncServer::resends() {
+#if SYNC_ENABLE
+  return g_sender ? g_sender->resends() : 0;
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,54 @@
+/**
+ * History Sync Endpoint
+ *
+ * Runs the device side of the sync protocol (SyncProtocol.h) over the
+ * serial port and, with Wi-Fi up, a TCP port. Replies go to whichever
+ * transport sent the last Hello. Output is paced: a frame is written only
+ * as fast as the UART buffer or the TCP send window takes it, so the loop
+ * never blocks on a transfer. Does nothing unless SYNC_ENABLE is set.
+ *
+ * Frames are larger than the UART buffer, so text written to Serial while
+ * one goes out would land inside it. Log output goes through console(),
+ * which drops it while a serial session is in progress.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "Config.h"
+#include "History.h"
+
+namespace SyncServer {
+
+  /**
+   * Attach the history to sync
+   */
+  void begin(const History& hist);
+
+  /**
+   * Offer a byte read from the serial port
+   * @return true if it belongs to a sync frame (not a command)
+   */
+  bool serialByte(uint8_t b);
+
+  /**
+   * Receive and send (non-blocking)
+   * @param nowMs Current time in milliseconds
+   */
+  void update(uint32_t nowMs);
+
+  /**
+   * A sync session over the serial port is in progress
+   */
+  bool serialBusy();
+
+  /**
+   * Serial for log output, silent while serialBusy()
+   */
+  Print& console();
+
+  /**
+   * Sessions started and go-back-N resends
+   */
+  uint32_t sessions();
+  uint32_t resends();
+}
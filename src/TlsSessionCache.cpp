@@ -0,0 +1,40 @@
+/**
+ * TLS Session Cache Implementation
+ */
+
+#include "TlsSessionCache.h"
+#include <string.h>
+
+uint32_t TlsSessionCache::fnv1a(const uint8_t* p, size_t len, uint32_t h) {
+  for (size_t i = 0; i < len; i++) h = (h ^ p[i]) * 16777619u;
+  return h;
+}
+
+uint32_t TlsSessionCache::checksum() const {
+  uint32_t h = fnv1a((const uint8_t*)&slot_.hostHash, sizeof slot_.hostHash);
+  h = fnv1a((const uint8_t*)&slot_.length, sizeof slot_.length, h);
+  return fnv1a(slot_.data, slot_.length, h);
+}
+
+bool TlsSessionCache::store(const char* host, const uint8_t* session, size_t len) {
+  if (len == 0 || len > kCapacity) {
+    clear();
+    return false;
+  }
+  slot_.magic = 0;                               // Invalid while half-written
+  slot_.hostHash = fnv1a((const uint8_t*)host, strlen(host));
+  slot_.length = (uint16_t)len;
+  memcpy(slot_.data, session, len);
+  slot_.check = checksum();
+  slot_.magic = kMagic;
+  return true;
+}
+
+const uint8_t* TlsSessionCache::lookup(const char* host, size_t& len) const {
+  len = 0;
+  if (slot_.magic != kMagic || slot_.length == 0 || slot_.length > kCapacity) return nullptr;
+  if (slot_.hostHash != fnv1a((const uint8_t*)host, strlen(host))) return nullptr;
+  if (slot_.check != checksum()) return nullptr;
+  len = slot_.length;
+  return slot_.data;
+}
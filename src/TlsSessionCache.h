@@ -0,0 +1,69 @@
+/**
+ * TLS Session Cache
+ *
+ * Keeps one serialized TLS session (session ID or ticket, as produced by
+ * mbedtls_ssl_session_save) per uplink host in a fixed slot. The slot is
+ * plain data, so it can live in uninitialised RTC memory (survives deep
+ * sleep and resets, including watchdog and panic resets) and be copied to
+ * NVS (survives power loss). A magic number, the
+ * host hash and a checksum reject slots left with garbage after power-on or
+ * written for a different host.
+ *
+ * Plain C++ (no Arduino dependencies); host/tls_resume_bench.cpp stores
+ * OpenSSL sessions in it.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+class TlsSessionCache {
+public:
+  static const size_t kCapacity = 2048;          // Session with ticket and peer certificate
+
+  /**
+   * Storage (trivially copyable; place it where it should persist)
+   */
+  struct Slot {
+    uint32_t magic;
+    uint32_t hostHash;
+    uint32_t check;
+    uint16_t length;
+    uint8_t  data[kCapacity];
+  };
+
+  explicit TlsSessionCache(Slot& slot) : slot_(slot) {}
+
+  /**
+   * Remember the session for a host
+   * @return false if it does not fit (the slot is cleared)
+   */
+  bool store(const char* host, const uint8_t* session, size_t len);
+
+  /**
+   * Session stored for this host
+   * @param len Receives its length
+   * @return Session bytes, nullptr if there is no valid one
+   */
+  const uint8_t* lookup(const char* host, size_t& len) const;
+
+  /**
+   * Forget the session (e.g. after the server refused to resume it)
+   */
+  void clear() { slot_.magic = 0; }
+
+  /**
+   * Bytes of the slot worth persisting (header and session)
+   */
+  size_t usedBytes() const { return offsetof(Slot, data) + slot_.length; }
+
+  Slot& slot() { return slot_; }
+
+private:
+  static const uint32_t kMagic = 0x544C5331;     // "TLS1"
+
+  Slot& slot_;
+
+  static uint32_t fnv1a(const uint8_t* p, size_t len, uint32_t h = 2166136261u);
+  uint32_t checksum() const;
+};
@@ -0,0 +1,484 @@
+/**
+ * Secure Uplink Implementation
+ */
+
+#include "Uplink.h"
+#include "Net.h"
+#include "Pm.h"
+#include "Radio.h"
+#include "SyncServer.h"
+#include "TlsSessionCache.h"
+
+#if WIFI_ENABLE && UPLINK_ENABLE
+#include <Preferences.h>
+#include <lwip/netdb.h>
+#include <lwip/sockets.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ssl.h>
+#include "Secrets.h"
+#endif
+
+namespace {
+  uint32_t g_published = 0;
+  uint32_t g_full = 0;
+  uint32_t g_resumed = 0;
+  uint32_t g_handshakeMs = 0;
+
+#if WIFI_ENABLE && UPLINK_ENABLE
+  enum class State : uint8_t { Idle, Connecting, Handshake, Sending, Response, Open };
+
+  const char* const NVS_NAMESPACE   = "uplink";
+  const char* const NVS_KEY_SESSION = "session";
+
+  // Not initialised at boot, so it survives deep sleep and every reset
+  // (restart, watchdog, panic); validated before use
+  RTC_NOINIT_ATTR TlsSessionCache::Slot g_slot;
+  TlsSessionCache g_cache(g_slot);
+
+  mbedtls_entropy_context  g_entropy;
+  mbedtls_ctr_drbg_context g_drbg;
+  mbedtls_x509_crt         g_ca;
+  mbedtls_ssl_config       g_conf;
+  mbedtls_ssl_context      g_ssl;
+  bool                     g_ready = false;        // TLS configured
+  bool                     g_sslUp = false;        // g_ssl set up (I/O buffers allocated)
+
+  State    g_state = State::Idle;
+  int      g_fd = -1;
+  uint32_t g_sinceMs = 0;                          // Start of the current step (timeouts)
+  uint32_t g_lastUseMs = 0;                        // Last completed exchange (keep-alive)
+  bool     g_offered = false;                      // A saved session was offered
+  bool     g_fullHandshake = false;
+
+  char     g_body[192];                            // Report waiting to be sent
+  bool     g_pending = false;
+  bool     g_hold = false;                         // Re-queued report waits UPLINK_RETRY_MS
+  uint32_t g_holdSinceMs = 0;
+  uint8_t  g_exchanges = 0;                        // Responses read on this connection
+  char     g_request[384];
+  size_t   g_requestLen = 0;
+  size_t   g_requestOff = 0;
+  char     g_response[256];                        // Status line and headers
+  size_t   g_responseLen = 0;
+  int32_t  g_bodyLeft = -1;                        // Response body bytes to skip (-1 = in headers)
+  int      g_status = 0;                           // HTTP status of the response
+  bool     g_serverCloses = false;
+
+  int bioSend(void* ctx, const unsigned char* buf, size_t len) {
+    const int n = send(*(int*)ctx, buf, len, MSG_DONTWAIT);
+    if (n < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) return MBEDTLS_ERR_SSL_WANT_WRITE;
+    return n;
+  }
+
+  int bioRecv(void* ctx, unsigned char* buf, size_t len) {
+    const int n = recv(*(int*)ctx, buf, len, MSG_DONTWAIT);
+    if (n < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) return MBEDTLS_ERR_SSL_WANT_READ;
+    return n;
+  }
+
+  /**
+   * Drop the connection; the saved session stays for the next one
+   */
+  void disconnect(bool notify) {
+    if (g_sslUp) {
+      if (notify) mbedtls_ssl_close_notify(&g_ssl);
+      mbedtls_ssl_free(&g_ssl);                    // Frees the record buffers
+      g_sslUp = false;
+    }
+    if (g_fd >= 0) {
+      close(g_fd);
+      g_fd = -1;
+    }
+    g_state = State::Idle;
+  }
+
+  /**
+   * Queue the report in flight again, unless publish() replaced it since;
+   * with wait, not before UPLINK_RETRY_MS
+   */
+  void requeue(bool wait) {
+    if (g_pending) return;
+    g_pending = true;
+    g_hold = wait;
+    g_holdSinceMs = millis();
+  }
+
+  bool holding(uint32_t nowMs) { return g_hold && nowMs - g_holdSinceMs < UPLINK_RETRY_MS; }
+
+  /**
+   * A queued report may go: not held for a retry and, below full radio
+   * duty, UPLINK_GAP_MS stretched by the duty after the last exchange (a
+   * newer report replaces the waiting one meanwhile)
+   */
+  bool canSend(uint32_t nowMs) {
+    if (!g_pending || holding(nowMs)) return false;
+    return Radio::dutyPct() >= 100 || nowMs - g_lastUseMs >= Radio::stretch(UPLINK_GAP_MS);
+  }
+
+  void fail(const __FlashStringHelper* what) {
+    Print& console = SyncServer::console();
+    console.print(F("Uplink: ")); console.println(what);
+    if (g_state == State::Handshake && g_offered) g_cache.clear();   // Do not offer it again
+    // The report may not have arrived. A kept connection the server closed
+    // is retried on a new one at once; a new connection that failed waits.
+    if (g_state == State::Sending || g_state == State::Response) {
+      requeue(g_exchanges == 0);
+    } else if (g_pending) {                        // DNS, connect or handshake
+      g_hold = true;
+      g_holdSinceMs = millis();
+    }
+    disconnect(false);
+  }
+
+  /**
+   * Start a non-blocking TCP connect
+   * The host name is resolved here (lwIP caches the answer).
+   */
+  void startConnect(uint32_t nowMs) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    char port[8];
+    snprintf(port, sizeof port, "%u", (unsigned)UPLINK_PORT);
+    if (getaddrinfo(UPLINK_HOST, port, &hints, &res) != 0 || !res) {
+      fail(F("DNS lookup failed"));
+      return;
+    }
+    g_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (g_fd < 0) { freeaddrinfo(res); fail(F("no socket")); return; }
+    fcntl(g_fd, F_SETFL, fcntl(g_fd, F_GETFL, 0) | O_NONBLOCK);
+    const int one = 1;
+    setsockopt(g_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+    const int rc = connect(g_fd, res->ai_addr, res->ai_addrlen);
+    freeaddrinfo(res);
+    if (rc != 0 && errno != EINPROGRESS) { fail(F("connect failed")); return; }
+    g_state = State::Connecting;
+    g_sinceMs = nowMs;
+    g_exchanges = 0;
+  }
+
+  /**
+   * Set up the TLS context and offer the saved session, if any
+   */
+  void startHandshake(uint32_t nowMs) {
+    mbedtls_ssl_init(&g_ssl);
+    g_sslUp = true;
+    if (mbedtls_ssl_setup(&g_ssl, &g_conf) != 0 || mbedtls_ssl_set_hostname(&g_ssl, UPLINK_HOST) != 0) {
+      fail(F("TLS setup failed (heap?)"));
+      return;
+    }
+    mbedtls_ssl_set_bio(&g_ssl, &g_fd, bioSend, bioRecv, nullptr);
+
+    g_offered = false;
+    size_t len;
+    const uint8_t* saved = g_cache.lookup(UPLINK_HOST, len);
+    if (saved) {
+      mbedtls_ssl_session s;
+      mbedtls_ssl_session_init(&s);
+      g_offered = mbedtls_ssl_session_load(&s, saved, len) == 0 && mbedtls_ssl_set_session(&g_ssl, &s) == 0;
+      mbedtls_ssl_session_free(&s);
+      if (!g_offered) g_cache.clear();             // From another mbedTLS build
+    }
+    g_fullHandshake = false;
+    g_state = State::Handshake;
+    g_sinceMs = nowMs;
+  }
+
+  /**
+   * Save the session after a handshake
+   * RTC memory is updated every time (servers may issue a fresh ticket);
+   * NVS only after a full handshake, to spare the flash.
+   */
+  void saveSession() {
+    static uint8_t buf[TlsSessionCache::kCapacity];
+    mbedtls_ssl_session s;
+    mbedtls_ssl_session_init(&s);
+    size_t len = 0;
+    const bool ok = mbedtls_ssl_get_session(&g_ssl, &s) == 0 &&
+                    mbedtls_ssl_session_save(&s, buf, sizeof buf, &len) == 0 &&
+                    g_cache.store(UPLINK_HOST, buf, len);
+    mbedtls_ssl_session_free(&s);
+#if UPLINK_SESSION_NVS
+    if (ok && g_fullHandshake) {
+      Preferences prefs;
+      if (prefs.begin(NVS_NAMESPACE, false)) {
+        prefs.putBytes(NVS_KEY_SESSION, &g_slot, g_cache.usedBytes());
+        prefs.end();
+      }
+    }
+#else
+    (void)ok;
+#endif
+  }
+
+  /**
+   * Run handshake steps until they need the network
+   *
+   * With mbedTLS 2.x (Arduino-ESP32 2.x) the client only passes through
+   * SERVER_CERTIFICATE on a full handshake; an accepted session goes from
+   * SERVER_HELLO straight to the ChangeCipherSpec.
+   */
+  void stepHandshake(uint32_t nowMs) {
+    while (g_ssl.state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+      if (g_ssl.state == MBEDTLS_SSL_SERVER_CERTIFICATE) g_fullHandshake = true;
+      const int rc = mbedtls_ssl_handshake_step(&g_ssl);
+      if (rc == MBEDTLS_ERR_SSL_WANT_READ || rc == MBEDTLS_ERR_SSL_WANT_WRITE) {
+        if (nowMs - g_sinceMs >= UPLINK_TIMEOUT_MS) fail(F("handshake timed out"));
+        return;
+      }
+      if (rc != 0) {
+        fail(F("handshake failed"));
+        return;
+      }
+    }
+
+    g_handshakeMs = millis() - g_sinceMs;          // Includes the last (often slowest) step
+    if (g_fullHandshake) g_full++; else g_resumed++;
+    saveSession();
+    Print& console = SyncServer::console();
+    console.print(g_fullHandshake ? F("Uplink: full handshake ") : F("Uplink: resumed session, handshake "));
+    console.print(g_handshakeMs); console.print(F(" ms ("));
+    console.print(g_resumed); console.print(F(" resumed, ")); console.print(g_full); console.println(F(" full)"));
+    g_lastUseMs = nowMs;
+    g_state = State::Open;
+  }
+
+  void buildRequest() {
+    const size_t bodyLen = strlen(g_body);
+    g_requestLen = snprintf(g_request, sizeof g_request,
+                            "POST %s HTTP/1.1\r\nHost: %s\r\nContent-Type: application/json\r\n"
+                            "Content-Length: %u\r\nConnection: keep-alive\r\n\r\n%s",
+                            UPLINK_PATH, UPLINK_HOST, (unsigned)bodyLen, g_body);
+    if (g_requestLen >= sizeof g_request) g_requestLen = sizeof g_request - 1;
+    g_requestOff = 0;
+    g_responseLen = 0;
+    g_bodyLeft = -1;
+    g_status = 0;
+    g_serverCloses = false;
+    g_pending = false;
+  }
+
+  /**
+   * Parse the response head once it is complete
+   * @return HTTP status (0 if there is none)
+   */
+  int parseHead() {
+    g_response[g_responseLen] = '\0';
+    const int status = strncmp(g_response, "HTTP/1.", 7) == 0 ? atoi(g_response + 9) : 0;
+    g_bodyLeft = 0;
+    for (char* line = strstr(g_response, "\r\n"); line; line = strstr(line + 2, "\r\n")) {
+      if (strncasecmp(line + 2, "Content-Length:", 15) == 0) g_bodyLeft = atoi(line + 17);
+      if (strncasecmp(line + 2, "Connection: close", 17) == 0) g_serverCloses = true;
+    }
+    return status;
+  }
+
+  /**
+   * Read the response: headers into g_response, the body discarded
+   * (expects Content-Length; a chunked body ends the kept connection)
+   */
+  void readResponse(uint32_t nowMs) {
+    uint8_t scratch[64];
+    while (g_bodyLeft != 0) {
+      const bool inHead = g_bodyLeft < 0;
+      uint8_t* dst = inHead ? (uint8_t*)g_response + g_responseLen : scratch;
+      const size_t cap = inHead ? 1 : min((size_t)g_bodyLeft, sizeof scratch);
+      const int n = mbedtls_ssl_read(&g_ssl, dst, cap);
+      if (n == MBEDTLS_ERR_SSL_WANT_READ || n == MBEDTLS_ERR_SSL_WANT_WRITE) {
+        if (nowMs - g_sinceMs >= UPLINK_TIMEOUT_MS) fail(F("no response"));
+        return;
+      }
+      if (n <= 0) { fail(F("connection closed")); return; }
+      if (!inHead) { g_bodyLeft -= n; continue; }
+
+      g_responseLen++;                             // Byte at a time: stop exactly at the blank line
+      if (g_responseLen >= 4 && !memcmp(g_response + g_responseLen - 4, "\r\n\r\n", 4)) {
+        g_status = parseHead();
+      } else if (g_responseLen >= sizeof g_response - 1) {
+        fail(F("response head too long"));
+        return;
+      }
+    }
+    // Only 2xx is published; the server may take the report later
+    // (5xx, 408, 429), anything else it refused for good
+    if (g_status >= 200 && g_status < 300) {
+      g_published++;
+      g_hold = false;
+    } else if (g_status >= 500 || g_status == 408 || g_status == 429) {
+      Print& console = SyncServer::console();
+      console.print(F("Uplink: server error ")); console.print(g_status); console.println(F(", report re-queued"));
+      requeue(true);
+    } else {
+      Print& console = SyncServer::console();
+      console.print(F("Uplink: server rejected report (")); console.print(g_status); console.println(F(")"));
+    }
+    g_exchanges++;
+    g_lastUseMs = nowMs;
+    if (g_serverCloses) disconnect(true);
+    else g_state = State::Open;
+  }
+
+  /**
+   * Idle connection: notice the server closing it, close it ourselves
+   * after UPLINK_IDLE_MS
+   */
+  void checkOpen(uint32_t nowMs) {
+    uint8_t b;
+    const int n = mbedtls_ssl_read(&g_ssl, &b, 1);
+    if (n != MBEDTLS_ERR_SSL_WANT_READ && n != MBEDTLS_ERR_SSL_WANT_WRITE) {
+      disconnect(false);                           // Close notify, EOF or stray data
+      return;
+    }
+    if (nowMs - g_lastUseMs >= UPLINK_IDLE_MS) disconnect(true);
+  }
+#endif
+}
+
+void Uplink::begin() {
+#if WIFI_ENABLE && UPLINK_ENABLE
+  mbedtls_entropy_init(&g_entropy);
+  mbedtls_ctr_drbg_init(&g_drbg);
+  mbedtls_x509_crt_init(&g_ca);
+  mbedtls_ssl_config_init(&g_conf);
+  if (mbedtls_ctr_drbg_seed(&g_drbg, mbedtls_entropy_func, &g_entropy, nullptr, 0) != 0 ||
+      mbedtls_ssl_config_defaults(&g_conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                  MBEDTLS_SSL_PRESET_DEFAULT) != 0) {
+    Serial.println(F("Uplink: TLS init failed"));
+    return;
+  }
+  mbedtls_ssl_conf_rng(&g_conf, mbedtls_ctr_drbg_random, &g_drbg);
+  mbedtls_ssl_conf_session_tickets(&g_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+
+  // Fail closed: a missing or unparsable CA leaves the uplink off (g_ready
+  // stays false) unless skipping authentication was asked for explicitly
+  static const char kCa[] = UPLINK_CA_CERT;
+  if (sizeof kCa > 1) {
+    if (mbedtls_x509_crt_parse(&g_ca, (const unsigned char*)kCa, sizeof kCa) != 0) {
+      Serial.println(F("Uplink: UPLINK_CA_CERT does not parse, uplink disabled"));
+      return;
+    }
+    mbedtls_ssl_conf_ca_chain(&g_conf, &g_ca, nullptr);
+    mbedtls_ssl_conf_authmode(&g_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+  } else {
+#if UPLINK_INSECURE
+    mbedtls_ssl_conf_authmode(&g_conf, MBEDTLS_SSL_VERIFY_NONE);
+    Serial.println(F("Uplink: UPLINK_INSECURE, server is NOT authenticated"));
+#else
+    Serial.println(F("Uplink: no CA certificate (UPLINK_CA_CERT), uplink disabled"));
+    return;
+#endif
+  }
+
+  // RTC memory is lost on power-up; fall back to the copy in NVS
+  size_t len;
+#if UPLINK_SESSION_NVS
+  if (!g_cache.lookup(UPLINK_HOST, len)) {
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, true)) {
+      if (prefs.getBytes(NVS_KEY_SESSION, &g_slot, sizeof g_slot) == 0) g_cache.clear();
+      prefs.end();
+    }
+  }
+#endif
+  Serial.println(g_cache.lookup(UPLINK_HOST, len) ? F("Uplink: saved TLS session found") : F("Uplink: no saved TLS session"));
+  g_ready = true;
+#endif
+}
+
+void Uplink::publish(const char* json) {
+#if WIFI_ENABLE && UPLINK_ENABLE
+  strncpy(g_body, json, sizeof g_body - 1);
+  g_body[sizeof g_body - 1] = '\0';
+  g_pending = true;
+#else
+  (void)json;
+#endif
+}
+
+/**
+ * Connection state machine
+ *
+ * Idle -> Connecting when a report is waiting; Connecting -> Handshake once
+ * the socket is writable; Handshake -> Open; Open -> Sending -> Response ->
+ * Open for each report. Errors, timeouts and the idle limit go to Idle.
+ */
+void Uplink::update(uint32_t nowMs) {
+#if WIFI_ENABLE && UPLINK_ENABLE
+  if (!g_ready) return;
+  if (!Net::connected()) {
+    if (g_state == State::Sending || g_state == State::Response) requeue(false);   // Sent once Wi-Fi is back
+    if (g_state != State::Idle) disconnect(false);
+    return;
+  }
+  if (g_state == State::Idle && !canSend(nowMs)) return;
+
+  Pm::Lock lock(Pm::Job::Network);
+  Radio::Activity radio(nowMs);
+
+  switch (g_state) {
+    case State::Idle:
+      startConnect(nowMs);
+      break;
+
+    case State::Connecting: {
+      fd_set w;
+      FD_ZERO(&w);
+      FD_SET(g_fd, &w);
+      timeval zero{0, 0};
+      if (select(g_fd + 1, nullptr, &w, nullptr, &zero) > 0) {
+        int err = 0;
+        socklen_t len = sizeof err;
+        getsockopt(g_fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err) fail(F("connect failed"));
+        else startHandshake(nowMs);
+      } else if (nowMs - g_sinceMs >= UPLINK_TIMEOUT_MS) {
+        fail(F("connect timed out"));
+      }
+      break;
+    }
+
+    case State::Handshake:
+      stepHandshake(nowMs);
+      break;
+
+    case State::Open:
+      if (canSend(nowMs)) {
+        buildRequest();
+        g_state = State::Sending;
+        g_sinceMs = nowMs;
+      } else {
+        checkOpen(nowMs);
+      }
+      break;
+
+    case State::Sending:
+      while (g_requestOff < g_requestLen) {
+        const int n = mbedtls_ssl_write(&g_ssl, (const unsigned char*)g_request + g_requestOff, g_requestLen - g_requestOff);
+        if (n == MBEDTLS_ERR_SSL_WANT_READ || n == MBEDTLS_ERR_SSL_WANT_WRITE) {
+          if (nowMs - g_sinceMs >= UPLINK_TIMEOUT_MS) fail(F("send timed out"));
+          return;
+        }
+        if (n <= 0) {
+          fail(F("send failed"));                   // Server closed the kept connection: re-queued
+          return;
+        }
+        g_requestOff += n;
+      }
+      g_state = State::Response;
+      break;
+
+    case State::Response:
+      readResponse(nowMs);
+      break;
+  }
+#else
+  (void)nowMs;
+#endif
+}
+
+uint32_t Uplink::published() { return g_published; }
+uint32_t Uplink::fullHandshakes() { return g_full; }
+uint32_t Uplink::resumedHandshakes() { return g_resumed; }
+uint32_t Uplink::lastHandshakeMs() { return g_handshakeMs; }
@@ -0,0 +1,52 @@
+/**
+ * Secure Uplink
+ *
+ * POSTs reports as JSON to UPLINK_HOST over HTTPS (mbedTLS). A full TLS
+ * handshake costs the ESP32 hundreds of milliseconds of CPU and two round
+ * trips, so the uplink avoids repeating it:
+ *   - The connection stays open for UPLINK_IDLE_MS after a publish, and
+ *     publishes in that time reuse it (HTTP keep-alive).
+ *   - The negotiated session (ID or ticket) is kept in RTC memory and, with
+ *     UPLINK_SESSION_NVS, in NVS, so the next connection (after the server
+ *     closed it, a Wi-Fi drop, deep sleep or a reset) resumes it with an
+ *     abbreviated handshake: no certificate, no key exchange, one round trip.
+ *
+ * The connection is a non-blocking state machine driven by update(); only
+ * the handshake's public-key steps take longer than a loop pass.
+ * Does nothing unless WIFI_ENABLE and UPLINK_ENABLE are set.
+ */
+
+#pragma once
+#include <Arduino.h>
+#include "Config.h"
+
+namespace Uplink {
+
+  /**
+   * Set up TLS (CA chain, RNG) and load a saved session
+   */
+  void begin();
+
+  /**
+   * Queue a report body (JSON); a report still waiting is replaced. A
+   * report is kept until the server answers 2xx: a 5xx, 408 or 429, or a
+   * connection lost before the answer, queues it again (unless a newer one
+   * replaced it), after UPLINK_RETRY_MS if the server answered or the
+   * connection was new.
+   */
+  void publish(const char* json);
+
+  /**
+   * Connect, handshake, send and keep alive (non-blocking)
+   * @param nowMs Current time in milliseconds
+   */
+  void update(uint32_t nowMs);
+
+  /**
+   * Statistics (published: reports answered with 2xx)
+   */
+  uint32_t published();
+  uint32_t fullHandshakes();
+  uint32_t resumedHandshakes();
+  uint32_t lastHandshakeMs();
+}
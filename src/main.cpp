@@ -24,6 +24,20 @@
 #include "Utils.h"
 #include "Sensors.h"
 #include "Display.h"
+#include "SendOnDelta.h"
+#include "Power.h"
+#include "Pm.h"
+#include "AdcCal.h"
+#include "Net.h"
+#include "Radio.h"
+#include "Buttons.h"
+#include "History.h"
+#include "HistoryExport.h"
+#include "HistoryServer.h"
+#include "SyncServer.h"
+#include "Uplink.h"
+#include "PushClient.h"
+#include "LzssPrint.h"
 
 // =============================================================================
 // Global Objects
@@ -31,10 +45,239 @@
 
 Sensors sensors;    // Sensor management system
 Display screen;     // TFT display controller
+Battery battery;    // Battery voltage monitor
+EnergyMeter energy; // Estimated charge per subsystem
+EnergyGovernor governor; // Runtime-driven power profile selection
 
 // Non-blocking timers for different update rates
 Utils::Ticker serialTick{1000};  // Serial output every 1 second
 Utils::Ticker renderTick{250};   // Display update every 250ms (smooth updates)
+Utils::Ticker statsTick{SAMPLING_STATS_MS}; // Sampling statistics
+Utils::Ticker energyTick{ENERGY_REPORT_MS};  // Energy budget report
+Utils::Ticker historyTick{HISTORY_PERIOD_MS}; // Trend history samples
+
+// Reading history for the trends page (statically allocated ring)
+static HistorySample historyBuf[HISTORY_CAPACITY];
+History history{historyBuf, HISTORY_CAPACITY};
+
+// Send-on-delta filter for the serial telemetry log (temp, humidity, soil, light)
+static const Deadband kReportBands[4] = {
+  {TEMP_DEADBAND_ABS,     TEMP_DEADBAND_REL},
+  {HUMIDITY_DEADBAND_ABS, HUMIDITY_DEADBAND_REL},
+  {SOIL_DEADBAND_ABS,     SOIL_DEADBAND_REL},
+  {LIGHT_DEADBAND_ABS,    LIGHT_DEADBAND_REL},
+};
+SendOnDelta reportFilter{kReportBands, 4, REPORT_MAX_SILENCE_MS, REPORT_SETTLE_MS};
+
+// =============================================================================
+// Telemetry Filtering
+// =============================================================================
+
+/**
+ * Decide whether the current readings should be logged
+ * 
+ * Invalid integer channels (-1) are passed as NAN so that sensor dropouts
+ * and recoveries are always reported.
+ */
+static bool shouldReport(const Readings& r, uint32_t now) {
+#if REPORT_DEADBAND
+  const float values[4] = {
+    r.tempC,
+    r.humidity,
+    r.soilPct  < 0 ? NAN : (float)r.soilPct,
+    r.lightPct < 0 ? NAN : (float)r.lightPct,
+  };
+  return reportFilter.offer(now, values) != SendOnDelta::None;
+#else
+  (void)r; (void)now;
+  return true;
+#endif
+}
+
+#if UPLINK_ENABLE
+/**
+ * Queue a report for the secure uplink (invalid channels as null)
+ */
+static void publishReport(const Readings& r, uint32_t now) {
+  char temp[12] = "null", hum[12] = "null", soil[8] = "null", light[8] = "null";
+  if (!isnan(r.tempC))    snprintf(temp, sizeof temp, "%.1f", r.tempC);
+  if (!isnan(r.humidity)) snprintf(hum, sizeof hum, "%.1f", r.humidity);
+  if (r.soilPct >= 0)     snprintf(soil, sizeof soil, "%d", r.soilPct);
+  if (r.lightPct >= 0)    snprintf(light, sizeof light, "%d", r.lightPct);
+  char json[160];
+  snprintf(json, sizeof json, "{\"t\":%lu,\"temp_c\":%s,\"humidity\":%s,\"soil_pct\":%s,\"light_pct\":%s}",
+           (unsigned long)(now / 1000), temp, hum, soil, light);
+  Uplink::publish(json);
+}
+#endif
+
+// =============================================================================
+// Energy Accounting
+// =============================================================================
+
+/**
+ * Charge continuous loads and sensor reads since the last call
+ * 
+ * Continuous loads (CPU, backlight, sensor supply) are integrated over
+ * elapsed time; sensor reads are charged per sample from the sampler counts.
+ */
+static void accountEnergy(uint32_t now) {
+  static uint32_t lastMs = now;
+  static uint32_t lastDht = 0, lastAdc = 0;
+
+  const uint32_t dt = now - lastMs;
+  if (dt == 0) return;
+  lastMs = now;
+
+  // CPU: idle current of the PM policy, plus the full-clock premium while locked
+  static uint64_t lastActiveUs = 0;
+  const uint64_t activeUs = Pm::activeMicros();
+  energy.addActive(Load::Cpu, Pm::idleCurrentMa(), dt);
+  energy.add(Load::Cpu, (CPU_ACTIVE_MA - Pm::idleCurrentMa()) * (float)(activeUs - lastActiveUs) / 1000.0f);
+  lastActiveUs = activeUs;
+  energy.addActive(Load::Backlight, BACKLIGHT_FULL_MA * screen.backlight() / 100.0f, dt);
+
+  // Sensor supplies: charged for their powered time (all of it when wired to 3V3)
+  static uint32_t lastSoilOn = 0, lastLdrOn = 0;
+  const uint32_t soilOn = sensors.soilSupply().poweredMs(now);
+  const uint32_t ldrOn = sensors.ldrSupply().poweredMs(now);
+  energy.addActive(Load::Sensors, SOIL_SUPPLY_MA, soilOn - lastSoilOn);
+  energy.addActive(Load::Sensors, LDR_SUPPLY_MA, ldrOn - lastLdrOn);
+  lastSoilOn = soilOn;
+  lastLdrOn = ldrOn;
+
+  // Radio: active time from marked windows, modem-sleep average while associated
+  static uint32_t lastRadioMs = 0;
+  const uint32_t radioMs = Radio::busyMs(now);
+  energy.addActive(Load::Radio, RADIO_ACTIVE_MA, radioMs - lastRadioMs);
+  if (Net::connected()) energy.addActive(Load::Radio, RADIO_IDLE_MA, dt);
+  lastRadioMs = radioMs;
+
+  const uint32_t dht = sensors.dhtSampler().samples();
+  const uint32_t adc = sensors.soilSampler().samples() + sensors.ldrSampler().samples();
+  energy.add(Load::Sensors, (dht - lastDht) * DHT_READ_MAMS + (adc - lastAdc) * ADC_READ_MAMS);
+  lastDht = dht;
+  lastAdc = adc;
+}
+
+/**
+ * Apply the governor's current power profile to all subsystems
+ */
+static void applyPowerProfile() {
+  const PowerProfile& p = governor.profile();
+  sensors.setRateScale(p.rateScale);
+  renderTick.set(p.renderMs);
+  screen.setBacklight(p.backlightPct);
+  Radio::setDutyPct(p.radioDutyPct);
+
+  Print& console = SyncServer::console();
+  console.print(F("Governor: level ")); console.print(governor.level());
+  console.print(F(", avg ")); console.print(governor.averageMa(), 1);
+  console.print(F(" mA, budget ")); console.print(governor.budgetMa(), 1);
+  console.println(F(" mA"));
+}
+
+// =============================================================================
+// User Interface
+// =============================================================================
+
+/**
+ * Compact form of the readings (history ring, UDP push)
+ */
+static HistorySample sampleOf(const Readings& r, uint32_t now) {
+  HistorySample s;
+  s.t = now / 1000;
+  s.tempC10 = HistorySample::encode10(r.tempC);
+  s.humidity10 = HistorySample::encode10(r.humidity);
+  s.soilPct = (int8_t)r.soilPct;
+  s.lightPct = (int8_t)r.lightPct;
+  return s;
+}
+
+/**
+ * Record the current readings in the history ring
+ */
+static void recordHistory(const Readings& r, uint32_t now) {
+  history.add(sampleOf(r, now));
+}
+
+/**
+ * Figures for the stats and diagnostics pages
+ */
+static UiStatus uiStatus(uint32_t now) {
+  UiStatus st;
+  st.dhtPerHour = sensors.dhtSampler().samplesPerHour(now);
+  st.soilPerHour = sensors.soilSampler().samplesPerHour(now);
+  st.ldrPerHour = sensors.ldrSampler().samplesPerHour(now);
+  st.reportsSent = reportFilter.sent();
+  st.reportsOffered = reportFilter.offered();
+  st.averageMa = governor.averageMa();
+  st.governorLevel = governor.level();
+  st.batteryMv = battery.millivolts();
+  st.batteryPct = battery.percent();
+  st.onUsb = battery.onUsb();
+  st.freeHeap = ESP.getFreeHeap();
+  st.minFreeHeap = ESP.getMinFreeHeap();
+  st.wifiEnabled = WIFI_ENABLE;
+  st.wifiConnected = Net::connected();
+  st.pmPolicy = Pm::policy();
+  st.buttonBounces = Buttons::bounces();
+  return st;
+}
+
+/**
+ * Serial commands: 'h' = raw history, 'd' = LTTB, 'm' = min/max (CSV),
+ * 'z' = raw history LZSS-compressed (after an "LZSS" line, see LzssPrint.h)
+ * Sync frames (starting with 0xA5) go to SyncServer instead.
+ */
+static void handleSerial() {
+  while (Serial.available()) {
+    const int c = Serial.read();
+    if (SyncServer::serialByte((uint8_t)c)) continue;
+    HistoryExport::Mode mode;
+    if (c == 'h' || c == 'z') mode = HistoryExport::Mode::Raw;
+    else if (c == 'd')        mode = HistoryExport::Mode::Lttb;
+    else if (c == 'm')        mode = HistoryExport::Mode::MinMax;
+    else continue;
+    if (c == 'z' && HistoryServer::compressing()) {      // One shared encoder
+      Serial.println(F("LZSS: encoder busy with an HTTP export"));
+      continue;
+    }
+
+    const uint32_t t0 = micros();
+    uint32_t rows;
+    if (c == 'z') {
+      Serial.println(F("LZSS"));
+      LzssPrint z(Serial, LzssPrint::shared());
+      rows = HistoryExport::csv(z, history, mode, 0, HistoryExport::Channel::Temp);
+      z.finish();
+      Serial.println();
+      Serial.print(F("LZSS: ")); Serial.print(z.bytesIn());
+      Serial.print(F(" -> ")); Serial.print(z.bytesOut());
+      Serial.print(F(" bytes, encode ")); Serial.print(z.encodeMicros() / 1000);
+      Serial.print(F(" ms (")); Serial.print(z.encodeMicros() ? (uint32_t)((uint64_t)z.bytesIn() * 1000 / z.encodeMicros()) : 0);
+      Serial.println(F(" KB/s)"));
+    } else {
+      rows = HistoryExport::csv(Serial, history, mode, HISTORY_EXPORT_POINTS, HistoryExport::Channel::Temp);
+    }
+    Serial.print(F("History: ")); Serial.print(rows);
+    Serial.print(F(" of ")); Serial.print(history.size());
+    Serial.print(F(" rows in ")); Serial.print((micros() - t0) / 1000);
+    Serial.println(F(" ms"));
+  }
+}
+
+/**
+ * Render the current page (charged to the render load)
+ */
+static void renderScreen(const Readings& r, uint32_t now) {
+  const uint32_t t0 = micros();
+  {
+    Pm::Lock lock(Pm::Job::Render);  // Full clock while pushing pixels
+    screen.render(r, sensors.calibrating(now), history, uiStatus(now));
+  }
+  energy.add(Load::Render, RENDER_MA * (micros() - t0) / 1000.0f);
+}
 
 // =============================================================================
 // Arduino Setup Function
@@ -51,15 +294,34 @@ void setup() {
   Serial.begin(SERIAL_BAUD);
   delay(200);                         // Allow serial to stabilize
 
+  // Frequency scaling before anything takes PM locks
+  Pm::begin((Pm::Policy)PM_POLICY);
+
   // Initialize and show splash screen
   screen.begin();
   screen.showSplash("Sensors only");  // Indicate this is sensor-only version
 
   // Initialize all sensors
   sensors.begin();
+  battery.begin();
+  Buttons::begin();
+
+  // Network (no-op unless WIFI_ENABLE)
+  Net::begin();
+  HistoryServer::begin(history);
+  SyncServer::begin(history);
+  Uplink::begin();
+  PushClient::begin();
   
   // Announce system startup
   Serial.println(F("SmartArium (monitor-only): DHT22 + Soil + LDR"));
+  AdcCal::print(Serial);
+#if ADC_CAL_BENCH
+  AdcCal::benchmark(Serial);
+#endif
+#if DISPLAY_BENCH
+  screen.benchmark(Serial);
+#endif
 }
 
 // =============================================================================
@@ -75,32 +337,114 @@ void setup() {
  */
 void loop() {
   const uint32_t now = millis();      // Get current time once per loop
+  Print& console = SyncServer::console();   // Serial log, quiet during a serial sync
+
+  // Keep the Wi-Fi link up (non-blocking)
+  Net::update(now);
+  HistoryServer::update(now);    // Streams /history a slice at a time
+  SyncServer::update(now);       // Incremental sync with host/sync_tool
+  Uplink::update(now);           // HTTPS reports over a kept/resumed TLS session
+  PushClient::update(now);       // Batched UDP reports and retransmissions
 
   // Update all sensors (non-blocking, rate-limited internally)
   sensors.update(now);
   const Readings r = sensors.current(); // Get latest readings
 
-  // Serial data logging (every 1 second)
-  if (serialTick.due(now)) {
+  // Battery and energy budget
+  battery.update(now);
+  accountEnergy(now);
+  if (governor.update(now, battery, energy)) {
+    applyPowerProfile();
+  }
+
+  // Serial data logging (checked every 1 second, emitted on change/heartbeat)
+  if (serialTick.due(now) && shouldReport(r, now)) {
     // Output sensor data in comma-friendly format for logging/analysis
-    Serial.print(F("Temp: "));
-    if (isnan(r.tempC)) Serial.print(F("--.-")); else Serial.print(r.tempC, 1);
+    console.print(F("Temp: "));
+    if (isnan(r.tempC)) console.print(F("--.-")); else console.print(r.tempC, 1);
     
-    Serial.print(F(" C, Humidity: "));
-    if (isnan(r.humidity)) Serial.print(F("--.-")); else Serial.print(r.humidity, 1);
+    console.print(F(" C, Humidity: "));
+    if (isnan(r.humidity)) console.print(F("--.-")); else console.print(r.humidity, 1);
     
-    Serial.print(F(" %, Soil: "));
-    if (r.soilPct < 0) Serial.print(F("--")); else Serial.print(r.soilPct);
+    console.print(F(" %, Soil: "));
+    if (r.soilPct < 0) console.print(F("--")); else console.print(r.soilPct);
     
-    Serial.print(F(" %, Light: "));
-    if (r.lightPct < 0) Serial.print(F("--")); else Serial.print(r.lightPct);
+    console.print(F(" %, Light: "));
+    if (r.lightPct < 0) console.print(F("--")); else console.print(r.lightPct);
     
-    Serial.println(F(" %"));
+#if DS18B20_ENABLE
+    console.print(F(" %, Root: "));
+    if (isnan(r.rootTempC)) console.print(F("--.-")); else console.print(r.rootTempC, 1);
+    console.println(F(" C"));
+#else
+    console.println(F(" %"));
+#endif
+#if UPLINK_ENABLE
+    publishReport(r, now);
+#endif
+    PushClient::offer(sampleOf(r, now), now);
+  }
+
+  // Grow-light switching events from flicker detection
+  static uint32_t growEventsSeen = 0;
+  const GrowLightLog& grow = sensors.growLights();
+  if (grow.transitions() != growEventsSeen) {
+    growEventsSeen = grow.transitions();
+    console.print(F("Grow light "));
+    console.print(grow.on() ? F("ON") : F("OFF"));
+    console.print(F(" at ")); console.print(grow.event(0).ms / 1000);
+    console.print(F(" s, duty ")); console.print(grow.dutyPct(now), 1);
+    console.println(F(" %"));
+  }
+
+  // Effective sampling rates (adaptive policy diagnostics)
+  if (statsTick.due(now)) {
+    sensors.printSamplingStats(console, now);
+    sensors.printNoiseStats(console);
+#if I2C_ENABLE
+    sensors.printI2CStats(console);
+#endif
+#if DS18B20_ENABLE
+    sensors.rootProbes().print(console);
+#endif
+#if REPORT_DEADBAND
+    console.print(F("Reports: ")); console.print(reportFilter.sent());
+    console.print(F(" of ")); console.println(reportFilter.offered());
+#endif
+  }
+
+  // Energy budget report: where the charge went and how the battery is doing
+  if (energyTick.due(now)) {
+    energy.print(console, now);
+    console.print(F("Battery: ")); console.print(battery.millivolts());
+    console.print(F(" mV, ")); console.print(battery.percent());
+    console.println(battery.onUsb() ? F(" % (USB)") : F(" %"));
+    Pm::print(console);
+  }
+
+  // Trend history and exports
+  if (historyTick.due(now)) recordHistory(r, now);
+  handleSerial();
+
+  // Page switching: render at once instead of waiting for the next tick
+  Buttons::Event e;
+  bool pageChanged = false;
+  while (Buttons::poll(e)) {
+    screen.step(e.id == Buttons::Id::Right ? 1 : -1, e.us);
+    pageChanged = true;
   }
 
   // Display update (every 250ms for smooth visual updates)
-  if (renderTick.due(now)) {
-    // Pass calibration status to display appropriate messages
-    screen.render(r, sensors.calibrating(now));
+  if (renderTick.due(now) || pageChanged) {
+    renderScreen(r, now);
+    uint32_t latencyUs;
+    if (screen.takeLatency(latencyUs)) {
+      console.print(F("Input: ")); console.print(latencyUs / 1000.0f, 1);
+      console.print(F(" ms (worst ")); console.print(screen.worstLatencyUs() / 1000.0f, 1);
+      console.println(F(" ms)"));
+    }
   }
+
+  // Let the idle task scale the clock down (no-op under the fixed policy)
+  Pm::idle();
 }
@@ -0,0 +1,138 @@
+"""
+Glyph atlas generator
+
+Builds src/GlyphAtlas.h: pre-rendered 1-bpp glyphs at the text sizes the UI
+uses, for only the characters that can appear on screen. The character set
+is every character in a string literal of the UI sources plus the characters
+numbers are formatted with.
+
+Runs before each PlatformIO build (extra_scripts = pre:...) and rewrites the
+header only when its content changes, so it does not force a rebuild.
+Standalone:  python3 tools/gen_glyph_atlas.py
+"""
+
+import os
+import re
+
+FONT_FILE = "tools/font5x7.txt"
+OUT_FILE = "src/GlyphAtlas.h"
+UI_SOURCES = ["src/Display.cpp", "src/Flicker.cpp"]
+ALWAYS = "0123456789+-.% ?"          # Formatted numbers, units, missing-glyph marker
+SIZES = (1, 2)                       # Text sizes used by Display
+
+GLYPH_W, GLYPH_H = 5, 7
+CELL_W, CELL_H = 6, 8                # One column / row of spacing
+
+
+def load_font(path):
+    font = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            parts = line.split()
+            code, rows = int(parts[0], 16), parts[1:]
+            if len(rows) != GLYPH_H or any(len(r) != GLYPH_W for r in rows):
+                raise ValueError("%s: bad glyph 0x%02X" % (path, code))
+            font[chr(code)] = rows
+    return font
+
+
+def ui_charset(root):
+    chars = set(ALWAYS)
+    literal = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+    for src in UI_SOURCES:
+        with open(os.path.join(root, src)) as f:
+            for s in literal.findall(f.read()):
+                chars.update(re.sub(r"\\.", "", s))
+    return sorted(c for c in chars if " " <= c <= "~")
+
+
+def render(rows, size):
+    """Cell bitmap rows for one glyph, leftmost pixel in the MSB"""
+    width = CELL_W * size
+    bits = 16 if size > 1 else 8
+    out = []
+    for y in range(CELL_H):
+        src = rows[y] if y < GLYPH_H else "." * GLYPH_W
+        v = 0
+        for x in range(GLYPH_W):
+            if src[x] == "#":
+                for s in range(size):
+                    v |= 1 << (bits - 1 - (x * size + s))
+        out.extend([v] * size)
+    assert width <= bits
+    return out
+
+
+def generate(root):
+    font = load_font(os.path.join(root, FONT_FILE))
+    chars = [c for c in ui_charset(root) if c in font]
+    slot = {c: i for i, c in enumerate(chars)}
+
+    lines = [
+        "/**",
+        " * Glyph Atlas (generated by tools/gen_glyph_atlas.py - do not edit)",
+        " *",
+        " * Pre-rendered 1-bpp glyphs of the 5x7 UI font (%s) for the %d"
+        % (FONT_FILE, len(chars)),
+        " * characters the UI uses, at text sizes %s. Each row of a cell is one"
+        % ", ".join(str(s) for s in SIZES),
+        " * word with the leftmost pixel in the most significant bit.",
+        " */",
+        "",
+        "#pragma once",
+        "#include <stdint.h>",
+        "",
+        "namespace GlyphAtlas {",
+        "",
+        "  constexpr int     kCellW   = %d;     // Size-1 cell (glyph + spacing)" % CELL_W,
+        "  constexpr int     kCellH   = %d;" % CELL_H,
+        "  constexpr int     kGlyphs  = %d;" % len(chars),
+        "  constexpr uint8_t kMissing = %d;    // Slot drawn for characters outside the atlas" % slot["?"],
+        "",
+        "  // Characters in slot order: \"%s\"" % "".join(chars).replace("\\", "\\\\"),
+        "",
+        "  // ASCII 0x20-0x7E -> atlas slot (0xFF = not in the atlas)",
+        "  constexpr uint8_t kSlot[95] = {",
+    ]
+    table = [slot.get(chr(c), 0xFF) for c in range(0x20, 0x7F)]
+    for i in range(0, 95, 16):
+        lines.append("    " + ", ".join("%3d" % v for v in table[i:i + 16]) + ",")
+    lines.append("  };")
+
+    total = 95
+    for size in SIZES:
+        ctype = "uint16_t" if size > 1 else "uint8_t"
+        h = CELL_H * size
+        lines.append("")
+        lines.append("  // Size %d: %dx%d cells, %d rows per glyph" % (size, CELL_W * size, h, h))
+        lines.append("  constexpr %s kSize%d[kGlyphs * %d] = {" % (ctype, size, h))
+        for c in chars:
+            rows = render(font[c], size)
+            fmt = "0x%04X" if size > 1 else "0x%02X"
+            lines.append("    " + ", ".join(fmt % v for v in rows) + ",  // '%s'" % c)
+        lines.append("  };")
+        total += len(chars) * h * (2 if size > 1 else 1)
+
+    lines += ["", "}  // namespace GlyphAtlas", ""]
+    return "\n".join(lines), len(chars), total
+
+
+def main(root):
+    text, glyphs, size = generate(root)
+    out = os.path.join(root, OUT_FILE)
+    old = open(out).read() if os.path.exists(out) else None
+    if text != old:
+        with open(out, "w") as f:
+            f.write(text)
+        print("Glyph atlas: %d glyphs, sizes %s, %d bytes -> %s" % (glyphs, SIZES, size, OUT_FILE))
+
+
+try:
+    Import("env")                                 # noqa: F821 (PlatformIO SCons)
+    main(env["PROJECT_DIR"])                      # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        main(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))